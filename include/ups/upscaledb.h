@@ -197,6 +197,11 @@ typedef struct ups_cursor_t ups_cursor_t;
  * The record->data pointer is not threadsafe. For threadsafe access it is
  * recommended to use @a UPS_RECORD_USER_ALLOC or have each thread manage its
  * own Transaction.
+ *
+ * Databases without Transactions, duplicate keys and compression allow
+ * concurrent lookups and cursor moves (@ref ups_db_find, @ref ups_cursor_find,
+ * @ref ups_cursor_move) from several threads. In this case each thread
+ * has its own temporary buffer for the record data.
  */
 typedef struct {
   /** The size of the record data, in bytes */
@@ -248,6 +253,10 @@ typedef struct {
  * The key->data pointer is not threadsafe. For threadsafe access it is
  * recommended to use @a UPS_KEY_USER_ALLOC or have each thread manage its
  * own Transaction.
+ *
+ * Databases without Transactions, duplicate keys and compression allow
+ * concurrent lookups and cursor moves from several threads. In this case
+ * each thread has its own temporary buffer for the key data.
  */
 typedef struct {
   /** The size of the key, in bytes */
@@ -526,7 +535,9 @@ ups_get_version(uint32_t *major, uint32_t *minor,
  *
  * For performance reasons the Journal does not use fsync(2) (or
  * FlushFileBuffers on Win32) to flush modified buffers to disk. Use the flag
- * @ref UPS_ENABLE_FSYNC to force the use of fsync.
+ * @ref UPS_ENABLE_FSYNC to force the use of fsync. Transactions which are
+ * committed concurrently by several threads share a single fsync ("group
+ * commit"); @ref ups_txn_commit returns as soon as the commit is durable.
  *
  * If Transactions are enabled, a journal file is written in order
  * to provide recovery if the system crashes. These journal files can be
@@ -594,6 +605,70 @@ ups_get_version(uint32_t *major, uint32_t *minor,
  *      posix_fadvise(). Only on supported platforms. Allowed values are
  *      @ref UPS_POSIX_FADVICE_NORMAL (which is the default) or
  *      @ref UPS_POSIX_FADVICE_RANDOM.
+ *    <li>@ref UPS_PARAM_CACHE_POLICY</li> Sets the replacement policy
+ *      of the cache. Allowed values are @ref UPS_CACHE_POLICY_LRU (which
+ *      is the default) or @ref UPS_CACHE_POLICY_2Q.
+ *    <li>@ref UPS_PARAM_IO_QUEUE_DEPTH</li> Submits page reads and
+ *      batched page writes asynchronously through io_uring, with up to
+ *      this number of requests in flight (max. 4096). Only on Linux;
+ *      ignored if io_uring is not available or if encryption is enabled.
+ *      Disabled (0) by default.
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY</li> If
+ *      @ref UPS_ENABLE_FSYNC is set: the max. time (in microseconds) a
+ *      journal fsync is delayed to collect more commits of concurrent
+ *      threads. Default is 0 (no delay).
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE</li> If a delay is set:
+ *      the fsync starts as soon as this number of commits is waiting.
+ *      Default is 0 (wait for the full delay).
+ *    <li>@ref UPS_PARAM_QUERY_THREADS</li> The number of threads which
+ *      scan a Database in parallel when running UQI queries. Can be
+ *      overwritten with the PARALLEL clause of a query. Default is 0
+ *      (single-threaded).
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP</li> If non-zero: the addresses of
+ *      the cached pages are stored in a file ("<filename>.warmup") when
+ *      the Environment is closed, and the pages are loaded in the
+ *      background when it is opened again. Ignored for In-Memory
+ *      Environments. Disabled (0) by default.
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP_INTERVAL</li> If the cache warm-up
+ *      is enabled: the addresses of the cached pages are also stored
+ *      periodically, every time this number of seconds has passed.
+ *      Default is 0 (only when the Environment is closed).
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_SIZE</li> The size (in bytes)
+ *      of a second cache tier which keeps compressed copies of the pages
+ *      which were evicted from the cache. Pages are looked up in this
+ *      tier before they are read from disk. Not allowed in combination
+ *      with @ref UPS_IN_MEMORY. Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR</li> The algorithm
+ *      of the compressed cache tier; one of @ref UPS_COMPRESSOR_LZF,
+ *      @ref UPS_COMPRESSOR_SNAPPY or @ref UPS_COMPRESSOR_ZLIB. Default is
+ *      @ref UPS_COMPRESSOR_LZF.
+ *    <li>@ref UPS_PARAM_FLUSH_THREADS</li> The number of threads which
+ *      write dirty pages to disk. The pages are written in file order;
+ *      adjacent pages are coalesced. Default is 0 (the pages are written
+ *      by the background thread of the Environment).
+ *    <li>@ref UPS_PARAM_FLUSH_RATE_LIMIT</li> Limits the throughput (in
+ *      bytes per second) when dirty pages are flushed in the background
+ *      because the cache is full. Does not affect flushes of
+ *      @ref ups_env_flush, @ref ups_env_close etc. Default is 0
+ *      (unlimited).
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_INTERVAL</li> The interval (in
+ *      milliseconds) in which a background thread writes and fsyncs
+ *      the journal entries of Transactions committed with
+ *      @ref UPS_TXN_ASYNC_COMMIT. 0 disables the periodic flush. Default
+ *      is 10.
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_SIZE</li> The background thread
+ *      also flushes the journal as soon as this number of bytes was
+ *      appended since the previous flush. Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_SIZE</li> A background thread
+ *      performs a checkpoint as soon as this number of bytes was written
+ *      to the journal since the previous checkpoint. A checkpoint flushes
+ *      all committed Transactions and dirty pages to the database file and
+ *      truncates the journal files which are no longer required, thus
+ *      limiting the size of the journal and the duration of the recovery.
+ *      Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL</li> The background
+ *      thread also performs a checkpoint if the previous checkpoint is
+ *      older than this number of seconds. Default is 0 (disabled).
  *    <li>@ref UPS_PARAM_PAGE_SIZE</li> The size of a file page, in
  *      bytes. It is recommended not to change the default size. The
  *      default size depends on hardware and operating system.
@@ -709,6 +784,75 @@ ups_env_create(ups_env_t **env, const char *filename,
  *      posix_fadvise(). Only on supported platforms. Allowed values are
  *      @ref UPS_POSIX_FADVICE_NORMAL (which is the default) or
  *      @ref UPS_POSIX_FADVICE_RANDOM.
+ *    <li>@ref UPS_PARAM_CACHE_POLICY</li> Sets the replacement policy
+ *      of the cache. Allowed values are @ref UPS_CACHE_POLICY_LRU (which
+ *      is the default) or @ref UPS_CACHE_POLICY_2Q.
+ *    <li>@ref UPS_PARAM_IO_QUEUE_DEPTH</li> Submits page reads and
+ *      batched page writes asynchronously through io_uring, with up to
+ *      this number of requests in flight (max. 4096). Only on Linux;
+ *      ignored if io_uring is not available or if encryption is enabled.
+ *      Disabled (0) by default.
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY</li> If
+ *      @ref UPS_ENABLE_FSYNC is set: the max. time (in microseconds) a
+ *      journal fsync is delayed to collect more commits of concurrent
+ *      threads. Default is 0 (no delay).
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE</li> If a delay is set:
+ *      the fsync starts as soon as this number of commits is waiting.
+ *      Default is 0 (wait for the full delay).
+ *    <li>@ref UPS_PARAM_QUERY_THREADS</li> The number of threads which
+ *      scan a Database in parallel when running UQI queries. Can be
+ *      overwritten with the PARALLEL clause of a query. Default is 0
+ *      (single-threaded).
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP</li> If non-zero: the addresses of
+ *      the cached pages are stored in a file ("<filename>.warmup") when
+ *      the Environment is closed, and the pages are loaded in the
+ *      background when it is opened again. Ignored for In-Memory
+ *      Environments. Disabled (0) by default.
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP_INTERVAL</li> If the cache warm-up
+ *      is enabled: the addresses of the cached pages are also stored
+ *      periodically, every time this number of seconds has passed.
+ *      Default is 0 (only when the Environment is closed).
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_SIZE</li> The size (in bytes)
+ *      of a second cache tier which keeps compressed copies of the pages
+ *      which were evicted from the cache. Pages are looked up in this
+ *      tier before they are read from disk. Not allowed in combination
+ *      with @ref UPS_IN_MEMORY. Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR</li> The algorithm
+ *      of the compressed cache tier; one of @ref UPS_COMPRESSOR_LZF,
+ *      @ref UPS_COMPRESSOR_SNAPPY or @ref UPS_COMPRESSOR_ZLIB. Default is
+ *      @ref UPS_COMPRESSOR_LZF.
+ *    <li>@ref UPS_PARAM_FLUSH_THREADS</li> The number of threads which
+ *      write dirty pages to disk. The pages are written in file order;
+ *      adjacent pages are coalesced. Default is 0 (the pages are written
+ *      by the background thread of the Environment).
+ *    <li>@ref UPS_PARAM_FLUSH_RATE_LIMIT</li> Limits the throughput (in
+ *      bytes per second) when dirty pages are flushed in the background
+ *      because the cache is full. Does not affect flushes of
+ *      @ref ups_env_flush, @ref ups_env_close etc. Default is 0
+ *      (unlimited).
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_INTERVAL</li> The interval (in
+ *      milliseconds) in which a background thread writes and fsyncs
+ *      the journal entries of Transactions committed with
+ *      @ref UPS_TXN_ASYNC_COMMIT. 0 disables the periodic flush. Default
+ *      is 10.
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_SIZE</li> The background thread
+ *      also flushes the journal as soon as this number of bytes was
+ *      appended since the previous flush. Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_SIZE</li> A background thread
+ *      performs a checkpoint as soon as this number of bytes was written
+ *      to the journal since the previous checkpoint. A checkpoint flushes
+ *      all committed Transactions and dirty pages to the database file and
+ *      truncates the journal files which are no longer required, thus
+ *      limiting the size of the journal and the duration of the recovery.
+ *      Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL</li> The background
+ *      thread also performs a checkpoint if the previous checkpoint is
+ *      older than this number of seconds. Default is 0 (disabled).
+ *    <li>@ref UPS_PARAM_RECOVERY_THREADS</li> The number of threads
+ *      used by @ref UPS_AUTO_RECOVERY. The journal entries are read and
+ *      decompressed ahead of the re-applied operations, and the pages of
+ *      the changesets are written concurrently. Default is 0 (recovery
+ *      runs in the calling thread).
  *    <li>@ref UPS_PARAM_FILE_SIZE_LIMIT</li> Sets a file size limit (in bytes).
  *      Disabled by default. If the limit is exceeded, API functions
  *      return @ref UPS_LIMITS_REACHED.
@@ -765,6 +909,38 @@ ups_env_open(ups_env_t **env, const char *filename,
  *    <li>@ref UPS_PARAM_JOURNAL_COMPRESSION</li> Returns the
  *        selected algorithm for journal compression, or 0 if compression
  *        is disabled
+ *    <li>@ref UPS_PARAM_CACHE_POLICY</li> Returns the replacement
+ *        policy of the cache
+ *    <li>@ref UPS_PARAM_IO_QUEUE_DEPTH</li> Returns the queue depth for
+ *        asynchronous page I/O, or 0 if disabled
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY</li> Returns the
+ *        max. delay of a journal fsync (in microseconds)
+ *    <li>@ref UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE</li> Returns the
+ *        number of commits which end the delay
+ *    <li>@ref UPS_PARAM_QUERY_THREADS</li> Returns the number of
+ *        threads for parallel UQI queries
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP</li> Returns 1 if the cache
+ *        warm-up is enabled, otherwise 0
+ *    <li>@ref UPS_PARAM_CACHE_WARMUP_INTERVAL</li> Returns the interval
+ *        (in seconds) for storing the addresses of the cached pages
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_SIZE</li> Returns the size of
+ *        the compressed cache tier, or 0 if it is disabled
+ *    <li>@ref UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR</li> Returns the
+ *        algorithm of the compressed cache tier
+ *    <li>@ref UPS_PARAM_FLUSH_THREADS</li> Returns the number of
+ *        threads which write dirty pages to disk
+ *    <li>@ref UPS_PARAM_FLUSH_RATE_LIMIT</li> Returns the throughput
+ *        limit (in bytes per second) of background flushes, or 0
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_INTERVAL</li> Returns the
+ *        interval (in milliseconds) of the background journal flush
+ *    <li>@ref UPS_PARAM_JOURNAL_FLUSH_SIZE</li> Returns the number of
+ *        journal bytes which trigger a background flush, or 0
+ *    <li>@ref UPS_PARAM_RECOVERY_THREADS</li> Returns the number of
+ *        threads used for recovery
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_SIZE</li> Returns the number
+ *        of journal bytes which trigger a checkpoint, or 0
+ *    <li>@ref UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL</li> Returns the
+ *        interval (in seconds) of the journal checkpoints, or 0
  *    </ul>
  *
  * @param env A valid Environment handle
@@ -871,6 +1047,11 @@ ups_env_get_parameters(ups_env_t *env, ups_parameter_t *param);
  * @ref UPS_PARAM_KEY_COMPRESSION. See the upscaledb documentation
  * for more details.
  *
+ * Variable length keys of type @ref UPS_TYPE_BINARY can be stored with
+ * @ref UPS_COMPRESSOR_PREFIX: the bytes which are shared by all keys of a
+ * btree node are only stored once per node. This is a good choice for keys
+ * with long common prefixes (i.e. URLs or path names).
+ *
  * In addition, *experimental* integer compression algorithms are available
  * for Databases created with the type @ref UPS_TYPE_UINT32. These
  * algorithms (@ref UPS_COMPRESSOR_UINT32_VARBYTE,
@@ -880,6 +1061,12 @@ ups_env_get_parameters(ups_env_t *env, ups_parameter_t *param);
  * change and might be removed in following versions. They only work with the
  * default page size of 16kb.
  *
+ * Databases created with the type @ref UPS_TYPE_UINT64 (i.e. record number
+ * Databases created with @ref UPS_RECORD_NUMBER64) can use the
+ * *experimental* algorithms @ref UPS_COMPRESSOR_UINT64_VARBYTE and
+ * @ref UPS_COMPRESSOR_UINT64_FOR. They also require the default page size
+ * of 16kb.
+ *
  * @param env A valid Environment handle.
  * @param db A valid Database handle, which will point to the created
  *      Database. To close the handle, use @ref ups_db_close.
@@ -1045,6 +1232,48 @@ ups_env_rename_db(ups_env_t *env, uint16_t oldname,
 UPS_EXPORT ups_status_t UPS_CALLCONV
 ups_env_erase_db(ups_env_t *env, uint16_t name, uint32_t flags);
 
+/**
+ * Returns the durable log sequence number (lsn) of an Environment
+ *
+ * All journal entries up to (and including) the durable lsn are flushed
+ * to disk. Transactions which were committed with
+ * @ref UPS_TXN_ASYNC_COMMIT are durable as soon as the durable lsn reaches
+ * the lsn of their commit.
+ *
+ * @param env A valid Environment handle
+ * @param durable_lsn Returns the durable lsn
+ * @param commit_lsn Optional; returns the lsn of the most recent commit
+ *
+ * @return @ref UPS_SUCCESS upon success
+ * @return @ref UPS_INV_PARAMETER if @a env or @a durable_lsn is NULL, or
+ *        if the Environment has no journal (i.e. neither
+ *        @ref UPS_ENABLE_TRANSACTIONS nor @ref UPS_ENABLE_RECOVERY is set)
+ * @return @ref UPS_NOT_IMPLEMENTED if @a env is a remote Environment
+ */
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_env_get_durable_lsn(ups_env_t *env, uint64_t *durable_lsn,
+            uint64_t *commit_lsn);
+
+/**
+ * Waits till the journal of an Environment is durable up to a log
+ * sequence number (lsn)
+ *
+ * Writes and fsyncs the buffered journal entries if necessary; concurrent
+ * callers share a single fsync. If @a lsn is 0 then the function waits
+ * till the most recent commit is durable (see @ref ups_env_get_durable_lsn).
+ *
+ * @param env A valid Environment handle
+ * @param lsn The lsn, or 0 for the most recent commit
+ *
+ * @return @ref UPS_SUCCESS upon success
+ * @return @ref UPS_INV_PARAMETER if @a env is NULL or if the Environment
+ *        has no journal
+ * @return @ref UPS_IO_ERROR if writing to the journal failed
+ * @return @ref UPS_NOT_IMPLEMENTED if @a env is a remote Environment
+ */
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_env_wait_durable_lsn(ups_env_t *env, uint64_t lsn);
+
 /* internal flag - only flush committed transactions, not the btree pages */
 #define UPS_FLUSH_COMMITTED_TRANSACTIONS    1
 
@@ -1209,9 +1438,23 @@ ups_txn_get_name(ups_txn_t *txn);
  * a Cursor was attached to this Transaction (with @ref ups_cursor_create
  * or @ref ups_cursor_clone), and the Cursor was not closed.
  *
+ * By default the commit is written to the journal (and, if
+ * @ref UPS_ENABLE_FSYNC is set, flushed to disk) before this function
+ * returns. With @ref UPS_TXN_ASYNC_COMMIT the commit record is only
+ * appended to the journal buffer; it is written and fsynced later by
+ * a background thread (see @ref UPS_PARAM_JOURNAL_FLUSH_INTERVAL and
+ * @ref UPS_PARAM_JOURNAL_FLUSH_SIZE). If the process crashes before then,
+ * the Transaction is lost. Use @ref ups_env_wait_durable_lsn to wait till
+ * an asynchronous commit is durable.
+ *
  * @param txn Pointer to a Transaction structure
  * @param flags Optional flags for committing the Transaction, combined with
- *    bitwise OR. Unused, set to 0.
+ *    bitwise OR. Possible flags are:
+ *    <ul>
+ *     <li>@ref UPS_TXN_ASYNC_COMMIT </li> Returns as soon as the commit
+ *      record is in the journal buffer. Ignored if the Environment has
+ *      no journal.
+ *    </ul>
  *
  * @return @ref UPS_SUCCESS upon success
  * @return @ref UPS_IO_ERROR if writing to the file failed
@@ -1221,6 +1464,9 @@ ups_txn_get_name(ups_txn_t *txn);
 UPS_EXPORT ups_status_t
 ups_txn_commit(ups_txn_t *txn, uint32_t flags);
 
+/** Flag for @ref ups_txn_commit */
+#define UPS_TXN_ASYNC_COMMIT                  0x10
+
 /**
  * Aborts a Transaction
  *
@@ -1469,6 +1715,48 @@ UPS_EXPORT ups_status_t UPS_CALLCONV
 ups_db_find(ups_db_t *db, ups_txn_t *txn, ups_key_t *key,
             ups_record_t *record, uint32_t flags);
 
+/**
+ * Searches a batch of items in the Database
+ *
+ * This function looks up @a count keys and returns their records; it
+ * is much faster than calling @ref ups_db_find for each key. The keys
+ * are sorted internally, and keys which are stored in the same page as
+ * their predecessor are found without traversing the Btree again.
+ *
+ * The record of @a keys[i] is returned in @a records[i], and the
+ * status of the lookup (@ref UPS_SUCCESS or @ref UPS_KEY_NOT_FOUND) is
+ * stored in @a results[i]. The record data which is not allocated by the
+ * application is stored in a buffer which remains valid till the next
+ * call to @ref ups_db_find or @ref ups_db_find_many (see
+ * @ref ups_db_find).
+ *
+ * Only exact matches are supported. If a key has duplicates then only
+ * the first duplicate is returned.
+ *
+ * @param db A valid Database handle
+ * @param txn A Transaction handle, or NULL
+ * @param count The number of keys
+ * @param keys An array of @a count keys
+ * @param records An array of @a count records
+ * @param results An array of @a count status codes
+ * @param flags Unused, set to 0
+ *
+ * @return @ref UPS_SUCCESS upon success, even if some of the keys were
+ *        not found; check @a results for the status of each key
+ * @return @ref UPS_INV_PARAMETER if @a db, @a keys, @a records or
+ *        @a results is NULL, or if @a flags is not 0
+ * @return @ref UPS_TXN_CONFLICT if one of the keys was inserted in another
+ *        Transaction which was not yet committed or aborted; the
+ *        remaining keys are not processed
+ *
+ * @sa ups_db_find
+ * @sa ups_db_insert_many
+ */
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_find_many(ups_db_t *db, ups_txn_t *txn, uint32_t count,
+            ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+            uint32_t flags);
+
 /**
  * Inserts a Database item
  *
@@ -1606,6 +1894,121 @@ ups_db_insert(ups_db_t *db, ups_txn_t *txn, ups_key_t *key,
  */
 #define UPS_HINTS_MASK                  0x001F0000
 
+/**
+ * Inserts a batch of Database items
+ *
+ * This function inserts @a count key/record pairs; it is much faster than
+ * calling @ref ups_db_insert for each pair. The keys are sorted
+ * internally and inserted in ascending order, which allows the Btree to
+ * insert most of them into the same page as their predecessor. Record
+ * number keys are not sorted but inserted in the order of the batch.
+ *
+ * The status of each insert operation is stored in @a results[i]. If a
+ * key already exists then @a results[i] is @ref UPS_DUPLICATE_KEY (unless
+ * @ref UPS_OVERWRITE or @ref UPS_DUPLICATE is specified), and the
+ * remaining pairs are still inserted.
+ *
+ * If Transactions are enabled and @a txn is NULL then each pair is
+ * inserted in its own temporary Transaction.
+ *
+ * For Record Number Databases, the generated keys are returned in
+ * @a keys; their memory remains valid till the next call to
+ * @ref ups_db_insert or @ref ups_db_insert_many.
+ *
+ * @param db A valid Database handle
+ * @param txn A Transaction handle, or NULL
+ * @param count The number of key/record pairs
+ * @param keys An array of @a count keys
+ * @param records An array of @a count records
+ * @param results An array of @a count status codes
+ * @param flags Optional flags for inserting; the same as for
+ *        @ref ups_db_insert
+ *
+ * @return @ref UPS_SUCCESS upon success, even if some of the keys were
+ *        not inserted; check @a results for the status of each key
+ * @return @ref UPS_INV_PARAMETER if @a db, @a keys, @a records or
+ *        @a results is NULL, or if the @a flags are invalid
+ * @return @ref UPS_WRITE_PROTECTED if you tried to insert a key in a
+ *        read-only Database
+ * @return any other error of @ref ups_db_insert, in which case the
+ *        remaining pairs are not inserted
+ *
+ * @sa ups_db_insert
+ * @sa ups_db_find_many
+ */
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_insert_many(ups_db_t *db, ups_txn_t *txn, uint32_t count,
+            ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+            uint32_t flags);
+
+/**
+ * Typedef for a function which supplies the key/record pairs for
+ * @ref ups_db_bulk_load
+ *
+ * @remark The function stores the next key/record pair in @a key and
+ * @a record, and returns @ref UPS_SUCCESS. The memory of the key and
+ * the record is owned by the callback; it must remain valid till the
+ * function is called again. At the end of the input the function returns
+ * @ref UPS_KEY_NOT_FOUND. Any other return value aborts the bulk load.
+ * @a context is the pointer that was passed to @ref ups_db_bulk_load.
+ */
+typedef ups_status_t UPS_CALLCONV (*ups_bulk_load_func_t)(ups_db_t *db,
+                  ups_key_t *key, ups_record_t *record, void *context);
+
+/**
+ * Loads a sorted sequence of key/record pairs into an empty Database
+ *
+ * This function is much faster than inserting the keys one by one
+ * with @ref ups_db_insert. The Btree is built bottom-up: the keys are
+ * appended to the right-most leaf page, and the internal pages are
+ * created when the leaf pages are full. The leaf pages are filled up to
+ * @a fill_factor percent; inserting keys one by one leaves them only
+ * half full. A lower fill factor leaves room for keys which are inserted
+ * later, and avoids page splits.
+ *
+ * The keys are requested from the callback function @a func. They must be
+ * sorted in ascending order (according to the Database's key comparison).
+ * If the Database supports duplicate keys then a key can be repeated;
+ * its records are stored as duplicates. Otherwise a repeated key fails
+ * with @ref UPS_DUPLICATE_KEY.
+ *
+ * The Database must be empty. The loaded pages bypass the journal and the
+ * Transaction index. Before the load starts, all committed Transactions
+ * are flushed, and the journal is cleared; there must not be any pending
+ * Transactions. When the function returns then all pages are written to
+ * disk. If the load fails or the application crashes then the
+ * Database has to be re-created.
+ *
+ * The callback function is called while the Environment is locked; it must
+ * not call other functions of the same Environment.
+ *
+ * This function is not supported by remote Databases.
+ *
+ * @param db A valid Database handle
+ * @param func The callback function which supplies the key/record pairs
+ * @param context A user-supplied pointer which is passed to @a func
+ * @param fill_factor The fill factor of the leaf pages, in percent
+ *        (1 - 100). Use 0 for the default (100).
+ * @param flags Optional flags; unused, set to 0
+ *
+ * @return @ref UPS_SUCCESS upon success
+ * @return @ref UPS_INV_PARAMETER if @a db or @a func is NULL, or if
+ *        @a fill_factor is larger than 100
+ * @return @ref UPS_INV_PARAMETER if the Database is not empty, or if
+ *        the keys are not sorted
+ * @return @ref UPS_WRITE_PROTECTED if the Database is read-only
+ * @return @ref UPS_TXN_STILL_OPEN if there are pending Transactions
+ * @return @ref UPS_DUPLICATE_KEY if a key is repeated, but the Database
+ *        does not support duplicate keys
+ * @return @ref UPS_INV_KEY_SIZE or @ref UPS_INV_RECORD_SIZE if a key or
+ *        record does not match the Database's fixed key size or record size
+ * @return @ref UPS_NOT_IMPLEMENTED if the Database is a remote Database
+ * @return any other error which is returned by @a func
+ */
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_bulk_load(ups_db_t *db, ups_bulk_load_func_t func, void *context,
+            uint32_t fill_factor, uint32_t flags);
+
 /**
  * Erases a Database item
  *
@@ -1761,6 +2164,81 @@ ups_db_get_parameters(ups_db_t *db, ups_parameter_t *param);
 /** Value for @ref UPS_PARAM_POSIX_FADVISE */
 #define UPS_POSIX_FADVICE_RANDOM                 1
 
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; sets the
+ * replacement policy of the cache */
+#define UPS_PARAM_CACHE_POLICY          0x00000113
+
+/** Value for @ref UPS_PARAM_CACHE_POLICY: least recently used (default) */
+#define UPS_CACHE_POLICY_LRU                     0
+
+/** Value for @ref UPS_PARAM_CACHE_POLICY: 2Q; frequently used pages
+ * stay cached during large sequential scans */
+#define UPS_CACHE_POLICY_2Q                      1
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; enables
+ * asynchronous page I/O (io_uring) with the specified queue depth */
+#define UPS_PARAM_IO_QUEUE_DEPTH        0x00000114
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the max.
+ * time (in microseconds) a journal fsync is delayed to collect more
+ * commits */
+#define UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY 0x00000115
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; a delayed
+ * journal fsync starts as soon as this number of commits is waiting */
+#define UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE  0x00000116
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the number
+ * of threads which scan a Database in parallel when running UQI queries */
+#define UPS_PARAM_QUERY_THREADS         0x00000117
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; persists
+ * the addresses of the cached pages and preloads them when the Environment
+ * is opened */
+#define UPS_PARAM_CACHE_WARMUP          0x00000118
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the interval
+ * (in seconds) for periodically persisting the addresses of the cached
+ * pages */
+#define UPS_PARAM_CACHE_WARMUP_INTERVAL 0x00000119
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the size
+ * of the compressed cache tier (in bytes) */
+#define UPS_PARAM_COMPRESSED_CACHE_SIZE 0x0000011a
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the
+ * compression algorithm of the compressed cache tier */
+#define UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR 0x0000011b
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the number
+ * of threads which write dirty pages to disk */
+#define UPS_PARAM_FLUSH_THREADS         0x0000011c
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; limits the
+ * throughput (in bytes per second) of background flushes */
+#define UPS_PARAM_FLUSH_RATE_LIMIT      0x0000011d
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the interval
+ * (in milliseconds) of the background journal flush for asynchronous
+ * commits */
+#define UPS_PARAM_JOURNAL_FLUSH_INTERVAL 0x0000011e
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the number
+ * of journal bytes which trigger a background flush */
+#define UPS_PARAM_JOURNAL_FLUSH_SIZE    0x0000011f
+
+/** Parameter name for @ref ups_env_open; the number of threads used
+ * for recovery */
+#define UPS_PARAM_RECOVERY_THREADS      0x00000120
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the number
+ * of journal bytes which trigger a checkpoint */
+#define UPS_PARAM_JOURNAL_CHECKPOINT_SIZE 0x00000121
+
+/** Parameter name for @ref ups_env_create, @ref ups_env_open; the interval
+ * (in seconds) of the journal checkpoints */
+#define UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL 0x00000122
+
 /** Value for unlimited record sizes */
 #define UPS_RECORD_SIZE_UNLIMITED       ((uint32_t)-1)
 
@@ -1874,6 +2352,24 @@ ups_db_get_parameters(ups_db_t *db, ups_parameter_t *param);
  */
 #define UPS_COMPRESSOR_UINT32_SIMDFOR      11
 
+/**
+ * prefix compression for variable length binary keys; stores the common
+ * prefix of all keys of a btree node only once
+ */
+#define UPS_COMPRESSOR_PREFIX              12
+
+/**
+ * uint64 key compression (varbyte)
+ * (experimental)
+ */
+#define UPS_COMPRESSOR_UINT64_VARBYTE      13
+
+/**
+ * uint64 key compression (FOR - Frame Of Reference)
+ * (experimental)
+ */
+#define UPS_COMPRESSOR_UINT64_FOR          14
+
 /**
  * Retrieves the Environment handle of a Database
  *
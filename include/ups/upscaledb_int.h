@@ -207,7 +207,7 @@ typedef struct btree_metrics_t {
  * Metrics marked "global" are stored globally and shared between multiple
  * Environments.
  */
-#define UPS_METRICS_VERSION         9
+#define UPS_METRICS_VERSION         10
 
 typedef struct ups_env_metrics_t {
   /* the version indicator - must be UPS_METRICS_VERSION */
@@ -308,6 +308,81 @@ typedef struct ups_env_metrics_t {
   // PRO: set to true if AVX is enabled
   ups_bool_t is_avx_enabled;
 
+  /* the replacement policy of the cache (UPS_CACHE_POLICY_*) */
+  uint32_t cache_policy;
+
+  /* cache hits of pages in the "cold" queue (2Q: pages which were
+   * fetched only once; LRU: all pages) */
+  uint64_t cache_hits_cold;
+
+  /* cache hits of pages in the "hot" queue (2Q only) */
+  uint64_t cache_hits_hot;
+
+  /* cache misses of recently evicted pages, which are then moved to
+   * the "hot" queue (2Q only) */
+  uint64_t cache_misses_ghost;
+
+  /* number of pages in the "cold" queue */
+  uint64_t cache_pages_cold;
+
+  /* number of pages in the "hot" queue (2Q only) */
+  uint64_t cache_pages_hot;
+
+  /* number of Transactions committed to the journal */
+  uint64_t journal_commits;
+
+  /* number of journal fsyncs; with group commit, several commits share
+   * a single fsync */
+  uint64_t journal_fsyncs;
+
+  /* number of bytes allocated for the operations and index nodes of
+   * Transactions (incl. cached memory chunks) */
+  uint64_t txn_arena_size;
+
+  /* number of bytes which are currently in use by the operations and
+   * index nodes of Transactions */
+  uint64_t txn_arena_usage;
+
+  /* number of pages which were read ahead by sequential scans */
+  uint64_t page_count_prefetched;
+
+  /* number of pages which are preloaded when the Environment is opened */
+  uint64_t cache_warmup_pages_total;
+
+  /* number of these pages which were already processed; pages which are
+   * cached or which do not fit into the cache are skipped */
+  uint64_t cache_warmup_pages_processed;
+
+  /* number of pages which were found in the compressed cache tier */
+  uint64_t compressed_cache_hits;
+
+  /* number of pages which were not found in the compressed cache tier */
+  uint64_t compressed_cache_misses;
+
+  /* number of pages in the compressed cache tier */
+  uint64_t compressed_cache_pages;
+
+  /* number of (compressed) bytes in the compressed cache tier */
+  uint64_t compressed_cache_bytes;
+
+  /* number of asynchronous commits (@ref UPS_TXN_ASYNC_COMMIT) */
+  uint64_t journal_async_commits;
+
+  /* number of background flushes of the journal */
+  uint64_t journal_background_flushes;
+
+  /* duration of the last recovery, in microseconds */
+  uint64_t journal_recovery_time_usec;
+
+  /* number of pages restored from changesets during recovery */
+  uint64_t journal_recovered_pages;
+
+  /* number of journal operations re-applied during recovery */
+  uint64_t journal_recovered_operations;
+
+  /* number of journal checkpoints */
+  uint64_t journal_checkpoints;
+
 } ups_env_metrics_t;
 
 /**
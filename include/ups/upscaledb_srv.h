@@ -54,6 +54,17 @@ typedef struct {
    * - currently NOT USED! */
   const char *error_log_path;
 
+  /** The number of event loops (each with its own thread) performing the
+   * network I/O; the connections are distributed round-robin. If 0 then
+   * a single loop is used. Always 1 on Windows. */
+  uint32_t io_threads;
+
+  /** The number of worker threads executing the requests. The requests
+   * of each connection are still executed in the order in which they
+   * were received. If 0 then the requests are executed by the event
+   * loops. */
+  uint32_t worker_threads;
+
 } ups_srv_config_t;
 
 /**
@@ -322,6 +322,7 @@ uqi_select(ups_env_t *env, const char *query, uqi_result_t **result);
  *   [DISTINCT] <FUNCTION>(<STREAM>) FROM DATABASE <DB>
  *          [WHERE <PREDICATE>(<STREAM>)]
  *          [LIMIT <LIMIT>]
+ *          [PARALLEL <THREADS>]
  *
  *   DISTINCT: an optional key word which strips the query input from all
  *          duplicate keys. (This is different from SQL where duplicate results
@@ -343,6 +344,13 @@ uqi_select(ups_env_t *env, const char *query, uqi_result_t **result);
  *          functions "TOP" and "BOTTOM"! When used with other functions then
  *          an error is returned.
  *
+ *   THREADS: the number of threads which scan the Database in parallel;
+ *          overwrites @ref UPS_PARAM_QUERY_THREADS. Parallel scans are
+ *          only used for the built-in functions SUM, COUNT, AVERAGE, TOP,
+ *          BOTTOM, MIN and MAX, if neither @a begin nor @a end is
+ *          specified and if the Database has no Transactions, duplicate
+ *          keys or compression. Otherwise the query runs single-threaded.
+ *
  * The @a result object is allocated automatically and has to be released
  * with @a uqi_result_close by the caller.
  *
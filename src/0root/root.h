@@ -72,6 +72,13 @@
 #   define unlikely(x) (x)
 #endif
 
+// helper macro to prefetch memory into the CPU cache
+#if defined __GNUC__
+#   define UPS_PREFETCH(p) __builtin_prefetch ((p))
+#else
+#   define UPS_PREFETCH(p) (void)(p)
+#endif
+
 // MSVC: disable warning about use of 'this' in base member initializer list
 #ifdef WIN32
 #  pragma warning(disable:4355)
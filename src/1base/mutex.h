@@ -28,6 +28,7 @@
 #include <boost/version.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
 #include <boost/thread/condition.hpp>
@@ -44,6 +45,8 @@ typedef boost::mutex::scoped_lock ScopedLock;
 typedef boost::thread Thread;
 typedef boost::condition Condition;
 typedef boost::recursive_mutex RecursiveMutex;
+typedef boost::shared_mutex SharedMutex;
+typedef boost::unique_lock<SharedMutex> ScopedExclusiveLock;
 
 struct Mutex : public boost::mutex 
 {
@@ -77,6 +80,46 @@ struct ScopedTryLock
   T &mutex_;
 };
 
+// Locks a SharedMutex either in shared mode (for concurrent readers) or
+// in exclusive mode
+struct ScopedReadLock
+{
+  ScopedReadLock()
+    : mutex_(0), shared_(false) {
+  }
+
+  ScopedReadLock(SharedMutex &mutex, bool shared)
+    : mutex_(0), shared_(false) {
+    lock(mutex, shared);
+  }
+
+  ~ScopedReadLock() {
+    if (mutex_) {
+      if (shared_)
+        mutex_->unlock_shared();
+      else
+        mutex_->unlock();
+    }
+  }
+
+  void lock(SharedMutex &mutex, bool shared) {
+    assert(mutex_ == 0);
+    if (shared)
+      mutex.lock_shared();
+    else
+      mutex.lock();
+    mutex_ = &mutex;
+    shared_ = shared;
+  }
+
+  bool is_shared() const {
+    return shared_;
+  }
+
+  SharedMutex *mutex_;
+  bool shared_;
+};
+
 } // namespace upscaledb
 
 #endif /* UPS_MUTEX_H */
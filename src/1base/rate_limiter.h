@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * Limits the throughput (in bytes per second) of several threads.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: yes
+ */
+
+#ifndef UPS_RATE_LIMITER_H
+#define UPS_RATE_LIMITER_H
+
+#include "0root/root.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+// Always verify that a file of level N does not include headers > N!
+#include "1base/mutex.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+//
+// Each caller reserves a time slot which is proportional to the number
+// of bytes it wants to process, and then sleeps till the slot begins.
+// Unused time is not accumulated, i.e. there are no bursts after a
+// period of inactivity.
+//
+struct RateLimiter
+{
+  // Constructor; a |rate| of 0 disables the limit
+  RateLimiter(uint64_t rate = 0)
+    : bytes_per_sec(rate) {
+  }
+
+  // Returns true if the throughput is limited
+  bool is_enabled() const {
+    return bytes_per_sec > 0;
+  }
+
+  // Blocks till |bytes| can be processed
+  void acquire(uint64_t bytes) {
+    if (!bytes_per_sec)
+      return;
+
+    boost::posix_time::ptime now
+            = boost::posix_time::microsec_clock::universal_time();
+    boost::posix_time::ptime start;
+
+    {
+      ScopedLock lock(mutex);
+      if (next.is_not_a_date_time() || next < now)
+        next = now;
+      start = next;
+      next += boost::posix_time::microseconds(
+                      (int64_t)(bytes * 1000000 / bytes_per_sec));
+    }
+
+    if (start > now)
+      boost::this_thread::sleep(start - now);
+  }
+
+  // The limit (in bytes per second)
+  uint64_t bytes_per_sec;
+
+  // The time when the next caller can start
+  boost::posix_time::ptime next;
+
+  // Protects |next|
+  Mutex mutex;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_RATE_LIMITER_H */
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * A region-based allocator for objects with a common lifetime
+ *
+ * @exception_safe: strong
+ * @thread_safe: no
+ */
+
+#ifndef UPS_ARENA_H
+#define UPS_ARENA_H
+
+#include "0root/root.h"
+
+#include <vector>
+
+// Always verify that a file of level N does not include headers > N!
+#include "1mem/mem.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+//
+// Provides the memory chunks of several Arenas. Released chunks are
+// cached and handed out again, therefore Arenas which are frequently
+// cleared (i.e. those of short-lived Transactions) do not have to allocate
+// their chunks from the heap. Also keeps track of the memory usage of
+// all attached Arenas.
+//
+struct ArenaPool
+{
+  enum {
+    // the size of each chunk
+    kChunkSize = 16 * 1024,
+
+    // the maximum number of cached chunks
+    kMaxCachedChunks = 64
+  };
+
+  // Constructor
+  ArenaPool()
+    : size(0), usage(0) {
+  }
+
+  // Destructor; releases the cached chunks. All Arenas must have been
+  // cleared before.
+  ~ArenaPool() {
+    for (std::vector<uint8_t *>::iterator it = cached_chunks.begin();
+            it != cached_chunks.end(); it++)
+      Memory::release(*it);
+  }
+
+  // Returns a chunk of |kChunkSize| bytes
+  uint8_t *allocate_chunk() {
+    if (!cached_chunks.empty()) {
+      uint8_t *chunk = cached_chunks.back();
+      cached_chunks.pop_back();
+      return (chunk);
+    }
+    uint8_t *chunk = Memory::allocate<uint8_t>(kChunkSize);
+    size += kChunkSize;
+    return (chunk);
+  }
+
+  // Returns a chunk to the pool
+  void release_chunk(uint8_t *chunk) {
+    if (cached_chunks.size() < kMaxCachedChunks) {
+      cached_chunks.push_back(chunk);
+      return;
+    }
+    Memory::release(chunk);
+    size -= kChunkSize;
+  }
+
+  // Unused chunks which can be handed out again
+  std::vector<uint8_t *> cached_chunks;
+
+  // The number of bytes allocated from the heap (incl. cached chunks
+  // and allocations which did not fit into a chunk)
+  uint64_t size;
+
+  // The number of bytes handed out by the Arenas
+  uint64_t usage;
+};
+
+//
+// A region-based allocator. Memory is handed out sequentially from
+// chunks of |ArenaPool::kChunkSize| bytes, and all of it is released in
+// bulk with |clear()|; single allocations cannot be released. Allocations
+// which do not fit into a chunk are allocated from the heap.
+//
+// The chunks are borrowed from an ArenaPool. If there is no pool then
+// the Arena manages its own chunks.
+//
+class Arena
+{
+    // Each chunk (and each oversized allocation) starts with a pointer
+    // to the previous one
+    enum {
+      kHeaderSize = sizeof(uint64_t)
+    };
+
+  public:
+    // Constructor
+    Arena(ArenaPool *pool = 0)
+      : m_pool(pool), m_chunks(0), m_large(0), m_ptr(0), m_end(0),
+        m_size(0), m_usage(0) {
+    }
+
+    // Destructor; releases all memory
+    ~Arena() {
+      clear();
+    }
+
+    // Allocates |size| bytes, aligned to 8 bytes
+    void *allocate(size_t size) {
+      size = (size + 7) & ~(size_t)7;
+      m_usage += size;
+      if (m_pool)
+        m_pool->usage += size;
+
+      // oversized allocations are allocated directly from the heap
+      if (size > ArenaPool::kChunkSize - kHeaderSize) {
+        uint8_t *p = Memory::allocate<uint8_t>(size + kHeaderSize);
+        *(uint8_t **)p = m_large;
+        m_large = p;
+        add_size(size + kHeaderSize);
+        return (p + kHeaderSize);
+      }
+
+      if (!m_ptr || m_ptr + size > m_end) {
+        uint8_t *chunk = m_pool
+                            ? m_pool->allocate_chunk()
+                            : Memory::allocate<uint8_t>(ArenaPool::kChunkSize);
+        *(uint8_t **)chunk = m_chunks;
+        m_chunks = chunk;
+        m_ptr = chunk + kHeaderSize;
+        m_end = chunk + ArenaPool::kChunkSize;
+        if (!m_pool)
+          m_size += ArenaPool::kChunkSize;
+      }
+
+      void *p = m_ptr;
+      m_ptr += size;
+      return (p);
+    }
+
+    // Releases all allocations; the chunks are returned to the pool
+    void clear() {
+      while (m_chunks) {
+        uint8_t *previous = *(uint8_t **)m_chunks;
+        if (m_pool)
+          m_pool->release_chunk(m_chunks);
+        else
+          Memory::release(m_chunks);
+        m_chunks = previous;
+      }
+
+      while (m_large) {
+        uint8_t *previous = *(uint8_t **)m_large;
+        Memory::release(m_large);
+        m_large = previous;
+      }
+
+      if (m_pool) {
+        m_pool->size -= m_size;
+        m_pool->usage -= m_usage;
+      }
+
+      m_ptr = m_end = 0;
+      m_size = 0;
+      m_usage = 0;
+    }
+
+    // Returns the number of bytes which this Arena allocated from the
+    // heap; chunks borrowed from a pool are not included
+    size_t size() const {
+      return (m_size);
+    }
+
+    // Returns the number of bytes handed out since the last |clear()|
+    size_t usage() const {
+      return (m_usage);
+    }
+
+  private:
+    // Adds |size| bytes of heap memory
+    void add_size(size_t size) {
+      m_size += size;
+      if (m_pool)
+        m_pool->size += size;
+    }
+
+    // The pool which provides the chunks; can be null
+    ArenaPool *m_pool;
+
+    // The linked list of chunks; the head is the current chunk
+    uint8_t *m_chunks;
+
+    // The linked list of oversized allocations
+    uint8_t *m_large;
+
+    // The free range of the current chunk
+    uint8_t *m_ptr;
+    uint8_t *m_end;
+
+    // The number of bytes allocated from the heap
+    size_t m_size;
+
+    // The number of bytes handed out
+    size_t m_usage;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_ARENA_H */
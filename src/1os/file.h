@@ -96,6 +96,11 @@ class File
       return m_fd != UPS_INVALID_FD;
     }
 
+    // Returns the file handle (i.e. for asynchronous I/O)
+    ups_fd_t fd() const {
+      return m_fd;
+    }
+
     // Flushes a file
     void flush();
 
@@ -119,6 +124,11 @@ class File
     // Positional write to a file
     void pwrite(uint64_t addr, const void *buffer, size_t len);
 
+    // Positional write of |count| buffers of |len| bytes each; the buffers
+    // are written to consecutive positions, starting at |addr|
+    void pwritev(uint64_t addr, void * const *buffers, size_t count,
+                    size_t len);
+
     // Write data to a file; uses the current file position
     void write(const void *buffer, size_t len);
 
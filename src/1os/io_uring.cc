@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+#include "0root/root.h"
+
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#ifdef HAVE_LINUX_IO_URING_H
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+// Always verify that a file of level N does not include headers > N!
+#include "1base/error.h"
+#include "1os/io_uring.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+// IORING_OP_READ and IORING_OP_WRITE require linux 5.6; IORING_FEAT_FAST_POLL
+// is the first feature flag which guarantees that they are supported
+#if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup) \
+      && defined(IORING_FEAT_FAST_POLL)
+#  define UPS_HAVE_IO_URING 1
+#endif
+
+namespace upscaledb {
+
+#ifdef UPS_HAVE_IO_URING
+static inline uint32_t
+load_acquire(uint32_t *p)
+{
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void
+store_release(uint32_t *p, uint32_t value)
+{
+  __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static inline int
+io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete,
+                uint32_t flags)
+{
+  return (int)::syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                  flags, 0, 0);
+}
+#endif
+
+IoUring::IoUring()
+  : m_ring_fd(-1), m_sq_ring(0), m_cq_ring(0), m_sq_ring_size(0),
+    m_cq_ring_size(0), m_sqes(0), m_sqes_size(0), m_sq_head(0), m_sq_tail(0),
+    m_sq_mask(0), m_sq_array(0), m_cq_head(0), m_cq_tail(0), m_cq_mask(0),
+    m_cqes(0), m_cq_entries(0), m_in_flight(0)
+{
+}
+
+bool
+IoUring::open(uint32_t queue_depth)
+{
+  assert(!is_open());
+#ifdef UPS_HAVE_IO_URING
+  if (queue_depth > kMaxQueueDepth)
+    queue_depth = kMaxQueueDepth;
+
+  struct io_uring_params p;
+  ::memset(&p, 0, sizeof(p));
+  int fd = (int)::syscall(__NR_io_uring_setup, queue_depth, &p);
+  if (fd < 0) {
+    ups_log(("io_uring_setup failed with status %u (%s)", errno,
+                            strerror(errno)));
+    return false;
+  }
+  if ((p.features & IORING_FEAT_FAST_POLL) == 0) {
+    ups_log(("io_uring is not supported by this kernel"));
+    ::close(fd);
+    return false;
+  }
+
+  m_sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+  m_cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size,
+                                                m_cq_ring_size);
+
+  m_sq_ring = ::mmap(0, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    m_sq_ring = 0;
+    ::close(fd);
+    return false;
+  }
+
+  if (single_mmap)
+    m_cq_ring = m_sq_ring;
+  else {
+    m_cq_ring = ::mmap(0, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      m_cq_ring = 0;
+      ::munmap(m_sq_ring, m_sq_ring_size);
+      m_sq_ring = 0;
+      ::close(fd);
+      return false;
+    }
+  }
+
+  m_sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  m_sqes = ::mmap(0, m_sqes_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (m_sqes == MAP_FAILED) {
+    m_sqes = 0;
+    if (m_cq_ring != m_sq_ring)
+      ::munmap(m_cq_ring, m_cq_ring_size);
+    ::munmap(m_sq_ring, m_sq_ring_size);
+    m_sq_ring = m_cq_ring = 0;
+    ::close(fd);
+    return false;
+  }
+
+  uint8_t *sq = (uint8_t *)m_sq_ring;
+  m_sq_head = (uint32_t *)(sq + p.sq_off.head);
+  m_sq_tail = (uint32_t *)(sq + p.sq_off.tail);
+  m_sq_mask = (uint32_t *)(sq + p.sq_off.ring_mask);
+  m_sq_array = (uint32_t *)(sq + p.sq_off.array);
+
+  uint8_t *cq = (uint8_t *)m_cq_ring;
+  m_cq_head = (uint32_t *)(cq + p.cq_off.head);
+  m_cq_tail = (uint32_t *)(cq + p.cq_off.tail);
+  m_cq_mask = (uint32_t *)(cq + p.cq_off.ring_mask);
+  m_cqes = cq + p.cq_off.cqes;
+  m_cq_entries = p.cq_entries;
+  m_in_flight = 0;
+  m_ring_fd = fd;
+  return true;
+#else
+  (void)queue_depth;
+  return false;
+#endif
+}
+
+void
+IoUring::close()
+{
+#ifdef UPS_HAVE_IO_URING
+  if (!is_open())
+    return;
+
+  assert(m_in_flight == 0);
+  ::munmap(m_sqes, m_sqes_size);
+  if (m_cq_ring != m_sq_ring)
+    ::munmap(m_cq_ring, m_cq_ring_size);
+  ::munmap(m_sq_ring, m_sq_ring_size);
+  ::close(m_ring_fd);
+
+  m_sqes = m_sq_ring = m_cq_ring = 0;
+  m_ring_fd = -1;
+#endif
+}
+
+size_t
+IoUring::submit(ups_fd_t fd, IoRequest *requests, size_t count)
+{
+#ifdef UPS_HAVE_IO_URING
+  ScopedLock lock(m_sq_mutex);
+
+  uint32_t mask = *m_sq_mask;
+  uint32_t tail = *m_sq_tail;
+  uint32_t head = load_acquire(m_sq_head);
+  size_t n = 0;
+
+  // the completion queue must never overflow, therefore the number of
+  // requests in flight is limited as well
+  while (n < count
+          && tail - head <= mask
+          && m_in_flight < m_cq_entries) {
+    IoRequest *r = &requests[n];
+    uint32_t index = tail & mask;
+    struct io_uring_sqe *sqe = &((struct io_uring_sqe *)m_sqes)[index];
+    ::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = r->is_write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->off = r->offset;
+    sqe->addr = (uint64_t)(uintptr_t)r->buffer;
+    sqe->len = (uint32_t)r->length;
+    sqe->user_data = (uint64_t)(uintptr_t)r;
+    m_sq_array[index] = index;
+    tail++;
+    n++;
+    m_in_flight++;
+  }
+
+  if (n == 0)
+    return 0;
+
+  store_release(m_sq_tail, tail);
+
+  uint32_t to_submit = (uint32_t)n;
+  while (to_submit > 0) {
+    int r = io_uring_enter(m_ring_fd, to_submit, 0, 0);
+    if (r < 0) {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      ups_log(("io_uring_enter failed with status %u (%s)", errno,
+                              strerror(errno)));
+      throw Exception(UPS_IO_ERROR);
+    }
+    to_submit -= (uint32_t)r;
+  }
+  return n;
+#else
+  (void)fd;
+  (void)requests;
+  (void)count;
+  throw Exception(UPS_NOT_IMPLEMENTED);
+#endif
+}
+
+size_t
+IoUring::reap(bool wait)
+{
+#ifdef UPS_HAVE_IO_URING
+  uint32_t head = *m_cq_head;
+  uint32_t tail = load_acquire(m_cq_tail);
+
+  while (wait && head == tail) {
+    int r = io_uring_enter(m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+    if (r < 0 && errno != EINTR) {
+      ups_log(("io_uring_enter failed with status %u (%s)", errno,
+                              strerror(errno)));
+      throw Exception(UPS_IO_ERROR);
+    }
+    tail = load_acquire(m_cq_tail);
+  }
+
+  uint32_t mask = *m_cq_mask;
+  size_t n = 0;
+  for (; head != tail; head++, n++) {
+    struct io_uring_cqe *cqe = &((struct io_uring_cqe *)m_cqes)[head & mask];
+    IoRequest *r = (IoRequest *)(uintptr_t)cqe->user_data;
+    r->result = cqe->res;
+    r->is_completed = true;
+  }
+  store_release(m_cq_head, head);
+
+  if (n > 0) {
+    ScopedLock lock(m_sq_mutex);
+    m_in_flight -= (uint32_t)n;
+  }
+  return n;
+#else
+  (void)wait;
+  throw Exception(UPS_NOT_IMPLEMENTED);
+#endif
+}
+
+void
+IoUring::execute(ups_fd_t fd, IoRequest *requests, size_t count)
+{
+  assert(is_open());
+
+  size_t submitted = 0;
+  size_t completed = 0;
+
+  while (completed < count) {
+    bool stalled = false;
+    if (submitted < count) {
+      size_t n = submit(fd, &requests[submitted], count - submitted);
+      submitted += n;
+      stalled = (n == 0);
+    }
+
+    {
+      ScopedLock lock(m_cq_mutex);
+      while (completed < submitted && requests[completed].is_completed)
+        completed++;
+      // |requests[completed]| is in flight and can only be reaped by this
+      // thread; therefore it is safe to block if nothing else can be
+      // submitted
+      if (completed < submitted)
+        reap(submitted == count || stalled);
+      while (completed < submitted && requests[completed].is_completed)
+        completed++;
+    }
+
+    // the queue is full, but none of the requests in flight belongs to
+    // this thread; give the other threads time to reap them
+    if (stalled && completed == submitted)
+      boost::this_thread::yield();
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (requests[i].result < 0 || (size_t)requests[i].result
+            != requests[i].length) {
+      ups_log(("io_uring request failed with status %d", requests[i].result));
+      throw Exception(UPS_IO_ERROR);
+    }
+  }
+}
+
+} // namespace upscaledb
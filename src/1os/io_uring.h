@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * An asynchronous I/O queue based on the Linux io_uring interface.
+ *
+ * Several threads can share the same queue; each thread submits its own
+ * batch of requests and then waits till the batch is completed. Whoever
+ * waits reaps the completions of all threads, therefore requests of
+ * concurrent callers overlap in the device.
+ *
+ * If io_uring is not supported (i.e. on other platforms or on old kernels)
+ * then |open()| returns false, and the caller has to fall back to
+ * synchronous I/O.
+ *
+ * @exception_safe: basic
+ * @thread_safe: yes
+ */
+
+#ifndef UPS_IO_URING_H
+#define UPS_IO_URING_H
+
+#include "0root/root.h"
+
+#include "ups/types.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "1base/mutex.h"
+#include "1os/os.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+// A single positional read or write request
+struct IoRequest
+{
+  IoRequest(uint64_t offset_ = 0, void *buffer_ = 0, size_t length_ = 0,
+                  bool is_write_ = false)
+    : offset(offset_), buffer(buffer_), length(length_), is_write(is_write_),
+      result(0), is_completed(false) {
+  }
+
+  // the file offset
+  uint64_t offset;
+
+  // the buffer which is read or written
+  void *buffer;
+
+  // the number of bytes to transfer
+  size_t length;
+
+  // true for a write request, false for a read request
+  bool is_write;
+
+  // the number of transferred bytes, or a negative errno value
+  int result;
+
+  // set by the queue as soon as the request was completed
+  bool is_completed;
+};
+
+class IoUring
+{
+  public:
+    // the maximum queue depth
+    enum { kMaxQueueDepth = 4096 };
+
+    // Constructor: creates an empty queue
+    IoUring();
+
+    // Destructor: closes the queue
+    ~IoUring() {
+      close();
+    }
+
+    // Creates the queue with |queue_depth| submission entries. Returns
+    // false if io_uring is not supported
+    bool open(uint32_t queue_depth);
+
+    // Returns true if the queue is open
+    bool is_open() const {
+      return m_ring_fd != -1;
+    }
+
+    // Closes the queue; must not be called while requests are in flight
+    void close();
+
+    // Submits all requests for the file |fd| and waits till they are
+    // completed. Throws UPS_IO_ERROR if at least one of them failed.
+    void execute(ups_fd_t fd, IoRequest *requests, size_t count);
+
+  private:
+    // Moves as many requests as possible to the submission queue; returns
+    // the number of submitted requests
+    size_t submit(ups_fd_t fd, IoRequest *requests, size_t count);
+
+    // Reaps the completion queue; if |wait| is true then blocks till
+    // at least one request was completed. Returns the number of
+    // reaped requests
+    size_t reap(bool wait);
+
+    // The file descriptor of the ring
+    int m_ring_fd;
+
+    // The mapped submission and completion rings
+    void *m_sq_ring;
+    void *m_cq_ring;
+    size_t m_sq_ring_size;
+    size_t m_cq_ring_size;
+
+    // The mapped submission queue entries
+    void *m_sqes;
+    size_t m_sqes_size;
+
+    // Pointers into the mapped rings
+    uint32_t *m_sq_head;
+    uint32_t *m_sq_tail;
+    uint32_t *m_sq_mask;
+    uint32_t *m_sq_array;
+    uint32_t *m_cq_head;
+    uint32_t *m_cq_tail;
+    uint32_t *m_cq_mask;
+    void *m_cqes;
+
+    // The number of entries in the completion queue
+    uint32_t m_cq_entries;
+
+    // The number of requests which were submitted but not yet reaped
+    uint32_t m_in_flight;
+
+    // Protects the submission queue and |m_in_flight|
+    Mutex m_sq_mutex;
+
+    // Protects the completion queue; held while waiting for completions
+    Mutex m_cq_mutex;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_IO_URING_H */
@@ -30,6 +30,14 @@ namespace upscaledb {
 //  Windows
 #  include <intrin.h>
 #  define cpuid    __cpuid
+static void
+cpuid_count(int info[4], int level, int count) {
+  __cpuidex(info, level, count);
+}
+static uint64_t
+xgetbv(uint32_t index) {
+  return _xgetbv(index);
+}
 #else
 #  include <cpuid.h>
 static void
@@ -46,30 +54,81 @@ cpuid(int info[4], int level) {
       "a" (infotype)
   );*/
 }
+
+static void
+cpuid_count(int info[4], int level, int count) {
+  __cpuid_count(level, count, info[0], info[1], info[2], info[3]);
+}
+
+static uint64_t
+xgetbv(uint32_t index) {
+  uint32_t eax, edx;
+  __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (index));
+  return ((uint64_t)edx << 32) | eax;
+}
 #endif
 
+enum {
+  kCpuSse41 = 1,
+  kCpuAvx   = 2,
+  kCpuAvx2  = 4
+};
+
+// Detects the instruction sets which are supported by the CPU (and
+// the operating system)
+static int
+detect_cpu_features()
+{
+  int features = 0;
+  int info[4];
+  cpuid(info, 0);
+  int num_ids = info[0];
+
+  if (num_ids >= 1) {
+    cpuid(info, 0x00000001);
+    if (info[2] & ((int)1 << 19))
+      features |= kCpuSse41;
+
+    // AVX also requires that the OS saves the YMM registers
+    bool osxsave = (info[2] & ((int)1 << 27)) != 0;
+    if (osxsave && (info[2] & ((int)1 << 28)) != 0
+          && (xgetbv(0) & 6) == 6)
+      features |= kCpuAvx;
+  }
+
+  if (num_ids >= 7 && (features & kCpuAvx)) {
+    cpuid_count(info, 7, 0);
+    if (info[1] & ((int)1 << 5))
+      features |= kCpuAvx2;
+  }
+
+  return features;
+}
+
+// Returns the features of the CPU; they are detected only once
+static int
+cpu_features()
+{
+  static int features = detect_cpu_features();
+  return features;
+}
+
+bool
+os_has_sse41()
+{
+  return (cpu_features() & kCpuSse41) != 0;
+}
+
 bool
 os_has_avx()
 {
-  static bool available = false;
-  static bool initialized = false;
-  if (!initialized) {
-    initialized = true;
-
-    int info[4];
-    cpuid(info, 0);
-    int num_ids = info[0];
-
-    cpuid(info, 0x80000000);
-
-    //  Detect Instruction Set
-    if (num_ids >= 1) {
-      cpuid(info, 0x00000001);
-      available = (info[2] & ((int)1 << 28)) != 0;
-    }
-  }
+  return (cpu_features() & kCpuAvx) != 0;
+}
 
-  return available;
+bool
+os_has_avx2()
+{
+  return (cpu_features() & kCpuAvx2) != 0;
 }
 
 int
@@ -80,12 +139,24 @@ os_get_simd_lane_width()
 
 #else // !HAVE_SSE2
 
+bool
+os_has_sse41()
+{
+  return false;
+}
+
 bool
 os_has_avx()
 {
   return false;
 }
 
+bool
+os_has_avx2()
+{
+  return false;
+}
+
 int
 os_get_simd_lane_width()
 {
@@ -65,10 +65,18 @@ typedef SOCKET             ups_socket_t;
 #  define UPS_INVALID_FD   (0)
 #endif
 
-// Returns true if the CPU supports AVX
+// Returns true if the CPU supports SSE4.1
+extern bool
+os_has_sse41();
+
+// Returns true if the CPU (and the operating system) support AVX
 extern bool
 os_has_avx();
 
+// Returns true if the CPU (and the operating system) support AVX2
+extern bool
+os_has_avx2();
+
 // Returns the number of 32bit integers that the CPU can process in
 // parallel (the SIMD lane width) 
 extern int
@@ -26,7 +26,7 @@
 #if HAVE_MMAP
 #  include <sys/mman.h>
 #endif
-#if HAVE_WRITEV
+#if HAVE_WRITEV || HAVE_PWRITEV
 #  include <sys/uio.h>
 #endif
 #include <sys/types.h>
@@ -279,6 +279,53 @@ File::pwrite(uint64_t addr, const void *buffer, size_t len)
 #endif
 }
 
+void
+File::pwritev(uint64_t addr, void * const *buffers, size_t count, size_t len)
+{
+  os_log(("File::pwritev: fd=%d, address=%lld, count=%lld, size=%lld",
+              m_fd, addr, count, len));
+
+#if HAVE_PWRITEV
+  const size_t kMaxBuffers = 64;
+  struct iovec iov[kMaxBuffers];
+
+  while (count > 0) {
+    size_t n = count < kMaxBuffers ? count : kMaxBuffers;
+    for (size_t i = 0; i < n; i++) {
+      iov[i].iov_base = buffers[i];
+      iov[i].iov_len = len;
+    }
+
+    ssize_t s = ::pwritev(m_fd, &iov[0], (int)n, addr);
+    if (s < 0) {
+      ups_log(("pwritev() failed with status %u (%s)", errno,
+                  strerror(errno)));
+      throw Exception(UPS_IO_ERROR);
+    }
+
+    // a short write: the remaining data is written buffer by buffer
+    if ((size_t)s < n * len) {
+      size_t i = (size_t)s / len;
+      size_t offset = (size_t)s % len;
+      if (offset > 0) {
+        pwrite(addr + i * len + offset, (uint8_t *)buffers[i] + offset,
+                        len - offset);
+        i++;
+      }
+      for (; i < n; i++)
+        pwrite(addr + i * len, buffers[i], len);
+    }
+
+    addr += n * len;
+    buffers += n;
+    count -= n;
+  }
+#else
+  for (size_t i = 0; i < count; i++)
+    pwrite(addr + i * len, buffers[i], len);
+#endif
+}
+
 void
 File::write(const void *buffer, size_t len)
 {
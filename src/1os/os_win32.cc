@@ -230,6 +230,13 @@ File::pwrite(uint64_t addr, const void *buffer, size_t len)
     throw Exception(UPS_IO_ERROR);
 }
 
+void
+File::pwritev(uint64_t addr, void * const *buffers, size_t count, size_t len)
+{
+  for (size_t i = 0; i < count; i++)
+    pwrite(addr + i * len, buffers[i], len);
+}
+
 void
 File::write(const void *buffer, size_t len)
 {
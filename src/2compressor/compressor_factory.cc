@@ -18,6 +18,7 @@
 #include "0root/root.h"
 
 // Always verify that a file of level N does not include headers > N!
+#include "1os/os.h"
 #include "2compressor/compressor_factory.h"
 #include "2compressor/compressor_zlib.h"
 #include "2compressor/compressor_snappy.h"
@@ -33,18 +34,19 @@ bool
 CompressorFactory::is_available(int type)
 {
   switch (type) {
+    // The SIMD codecs are built for SSE4.1 (or AVX), but the library
+    // also runs on older CPUs; therefore check the CPU at run time
     case UPS_COMPRESSOR_UINT32_STREAMVBYTE:
+      return os_has_avx();
     case UPS_COMPRESSOR_UINT32_MASKEDVBYTE:
     case UPS_COMPRESSOR_UINT32_SIMDFOR:
     case UPS_COMPRESSOR_UINT32_SIMDCOMP:
-#ifdef HAVE_SSE2
-      return true;
-#else
-      return false;
-#endif
+      return os_has_sse41();
     case UPS_COMPRESSOR_UINT32_VARBYTE:
     case UPS_COMPRESSOR_UINT32_GROUPVARINT:
     case UPS_COMPRESSOR_UINT32_FOR:
+    case UPS_COMPRESSOR_UINT64_VARBYTE:
+    case UPS_COMPRESSOR_UINT64_FOR:
       return true;
     case UPS_COMPRESSOR_ZLIB:
 #ifdef HAVE_ZLIB_H
@@ -52,7 +52,15 @@ struct EnvConfig
       file_size_limit_bytes(std::numeric_limits<size_t>::max()), 
       remote_timeout_sec(0), journal_compressor(0),
       is_encryption_enabled(false), journal_switch_threshold(0),
-      posix_advice(UPS_POSIX_FADVICE_NORMAL) {
+      posix_advice(UPS_POSIX_FADVICE_NORMAL),
+      cache_policy(UPS_CACHE_POLICY_LRU), io_queue_depth(0),
+      group_commit_delay_usec(0), group_commit_size(0), query_threads(0),
+      cache_warmup(false), cache_warmup_interval_sec(0),
+      compressed_cache_size_bytes(0),
+      compressed_cache_compressor(UPS_COMPRESSOR_LZF), flush_threads(0),
+      flush_rate_limit(0), journal_flush_interval_msec(10),
+      journal_flush_size(0), recovery_threads(0), journal_checkpoint_size(0),
+      journal_checkpoint_interval_sec(0) {
   }
 
   // the environment's flags
@@ -96,6 +104,60 @@ struct EnvConfig
 
   // parameter for posix_fadvise()
   int posix_advice;
+
+  // the replacement policy of the cache
+  int cache_policy;
+
+  // the queue depth for asynchronous I/O; 0 if disabled
+  uint32_t io_queue_depth;
+
+  // group commit: max. delay (in microseconds) for collecting commits
+  uint32_t group_commit_delay_usec;
+
+  // group commit: max. number of commits per fsync (0: unlimited)
+  uint32_t group_commit_size;
+
+  // the default number of threads for UQI queries (0, 1: single-threaded)
+  uint32_t query_threads;
+
+  // true if the cached pages are persisted and preloaded
+  bool cache_warmup;
+
+  // the interval (in seconds) for persisting the cached pages; 0 if
+  // they are only persisted when the Environment is closed
+  uint32_t cache_warmup_interval_sec;
+
+  // the size of the compressed cache tier (in bytes); 0 if disabled
+  uint64_t compressed_cache_size_bytes;
+
+  // the compression algorithm of the compressed cache tier
+  int compressed_cache_compressor;
+
+  // the number of threads which flush dirty pages; 0 if the pages are
+  // flushed by the PageManager's worker thread
+  uint32_t flush_threads;
+
+  // the throughput limit (in bytes per second) of background flushes;
+  // 0 if unlimited
+  uint64_t flush_rate_limit;
+
+  // the interval (in milliseconds) of the background journal flush for
+  // asynchronous commits; 0 if disabled
+  uint32_t journal_flush_interval_msec;
+
+  // the number of journal bytes which trigger a background flush; 0 if
+  // disabled
+  uint64_t journal_flush_size;
+
+  // the number of threads used for recovery; 0 if recovery runs in the
+  // calling thread
+  uint32_t recovery_threads;
+
+  // the number of journal bytes which trigger a checkpoint; 0 if disabled
+  uint64_t journal_checkpoint_size;
+
+  // the interval (in seconds) of the journal checkpoints; 0 if disabled
+  uint32_t journal_checkpoint_interval_sec;
 };
 
 } // namespace upscaledb
@@ -89,6 +89,10 @@ struct Device {
   // Writes to the device; this function does not use mmap
   virtual void write(uint64_t offset, void *buffer, size_t len) = 0;
 
+  // Writes a batch of pages to the device; the pages are sorted by
+  // address. Does not modify the pages (i.e. does not clear the dirty flag)
+  virtual void write_pages(Page **pages, size_t count) = 0;
+
   // Allocate storage from this device; this function
   // will *NOT* use mmap. returns the offset of the allocated storage.
   virtual uint64_t alloc(size_t len) = 0;
@@ -29,6 +29,8 @@
 
 #include "0root/root.h"
 
+#include <vector>
+
 // Always verify that a file of level N does not include headers > N!
 #include "1base/error.h"
 #include "1base/dynamic_array.h"
@@ -208,6 +210,42 @@ class DiskDevice : public Device {
       m_state.file.pwrite(offset, buffer, len);
     }
 
+    // writes a batch of pages (sorted by address) to the device; adjacent
+    // pages are coalesced and written with a single vectored write.
+    // The device is not locked during the I/O, therefore several threads
+    // can write concurrently.
+    virtual void write_pages(Page **pages, size_t count) {
+#ifdef UPS_ENABLE_ENCRYPTION
+      // encrypted pages are written one at a time
+      if (config.is_encryption_enabled) {
+        for (size_t i = 0; i < count; i++)
+          write(pages[i]->address(), pages[i]->data(),
+                          pages[i]->persisted_data.size);
+        return;
+      }
+#endif
+
+      size_t page_size = config.page_size_bytes;
+      std::vector<void *> buffers;
+      buffers.reserve(count);
+
+      size_t i = 0;
+      while (i < count) {
+        buffers.clear();
+        buffers.push_back(pages[i]->data());
+        size_t j = i + 1;
+        while (j < count
+                && pages[j]->address() == pages[j - 1]->address() + page_size) {
+          buffers.push_back(pages[j]->data());
+          j++;
+        }
+
+        m_state.file.pwritev(pages[i]->address(), &buffers[0],
+                        buffers.size(), page_size);
+        i = j;
+      }
+    }
+
     // allocate storage from this device; this function
     // will *NOT* return mmapped memory
     virtual uint64_t alloc(size_t requested_length) {
@@ -320,7 +358,7 @@ class DiskDevice : public Device {
       return &m_state.mmapptr[address];
     }
 
-  private:
+  protected:
     // truncate/resize the device, sans locking
     void truncate_nolock(uint64_t new_file_size) {
       if (new_file_size > config.file_size_limit_bytes)
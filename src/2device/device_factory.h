@@ -31,6 +31,7 @@
 #include "2config/env_config.h"
 #include "2device/device_disk.h"
 #include "2device/device_inmem.h"
+#include "2device/device_uring.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -43,8 +44,10 @@ struct DeviceFactory {
   static Device *create(const EnvConfig &config) {
     if (ISSET(config.flags, UPS_IN_MEMORY))
       return new InMemoryDevice(config);
-    else
-      return new DiskDevice(config);
+    // encryption requires the synchronous code path
+    if (config.io_queue_depth > 0 && !config.is_encryption_enabled)
+      return new UringDevice(config);
+    return new DiskDevice(config);
   }
 };
 
@@ -105,6 +105,10 @@ struct InMemoryDevice : public Device {
   virtual void write(uint64_t offset, void *buffer, size_t len) {
   }
 
+  // writes a batch of pages to the device
+  virtual void write_pages(Page **pages, size_t count) {
+  }
+
   // reads a page from the device 
   virtual void read_page(Page *page, uint64_t address) {
     assert(!"operation is not possible for in-memory-databases");
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * Device-implementation for disk-based files which submits page reads and
+ * batched page writes through io_uring (see 1os/io_uring.h). Reads of
+ * mapped pages and all other operations are inherited from the DiskDevice.
+ *
+ * The file is accessed without holding the device lock while requests are
+ * in flight, therefore concurrent page reads and the background flushes
+ * overlap in the device. If io_uring is not supported then this device
+ * behaves exactly like the DiskDevice.
+ *
+ * @exception_safe: basic
+ * @thread_safe: no
+ */
+
+#ifndef UPS_DEVICE_URING_H
+#define UPS_DEVICE_URING_H
+
+#include "0root/root.h"
+
+#include <vector>
+
+// Always verify that a file of level N does not include headers > N!
+#include "1os/io_uring.h"
+#include "2device/device_disk.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+class UringDevice : public DiskDevice {
+  public:
+    UringDevice(const EnvConfig &config)
+      : DiskDevice(config) {
+    }
+
+    // Create a new device
+    virtual void create() {
+      DiskDevice::create();
+      m_queue.open(config.io_queue_depth);
+    }
+
+    // opens an existing device
+    virtual void open() {
+      DiskDevice::open();
+      m_queue.open(config.io_queue_depth);
+    }
+
+    // closes the device
+    virtual void close() {
+      m_queue.close();
+      DiskDevice::close();
+    }
+
+    // Returns true if io_uring is used; false if the device fell back
+    // to synchronous I/O
+    bool is_async() const {
+      return m_queue.is_open();
+    }
+
+    // writes a batch of pages to the device; all writes are submitted
+    // at once
+    virtual void write_pages(Page **pages, size_t count) {
+      if (!m_queue.is_open()) {
+        DiskDevice::write_pages(pages, count);
+        return;
+      }
+
+      std::vector<IoRequest> requests(count);
+      for (size_t i = 0; i < count; i++)
+        requests[i] = IoRequest(pages[i]->address(), pages[i]->data(),
+                                pages[i]->persisted_data.size, true);
+
+      ups_fd_t fd;
+      {
+        ScopedSpinlock lock(m_mutex);
+        fd = m_state.file.fd();
+      }
+      m_queue.execute(fd, &requests[0], count);
+    }
+
+    // reads a page from the device; this function CAN return a
+    // pointer to mmapped memory
+    virtual void read_page(Page *page, uint64_t address) {
+      if (!m_queue.is_open()) {
+        DiskDevice::read_page(page, address);
+        return;
+      }
+
+      ups_fd_t fd;
+      {
+        ScopedSpinlock lock(m_mutex);
+        if (address < m_state.mapped_size && m_state.mmapptr != 0) {
+          page->assign_mapped_buffer(&m_state.mmapptr[address], address);
+          return;
+        }
+        fd = m_state.file.fd();
+      }
+
+      // this page is not in the mapped area; allocate a buffer
+      if (page->data() == 0) {
+        uint8_t *p = Memory::allocate<uint8_t>(config.page_size_bytes);
+        page->assign_allocated_buffer(p, address);
+      }
+
+      IoRequest request(address, page->data(), config.page_size_bytes, false);
+      m_queue.execute(fd, &request, 1);
+    }
+
+  private:
+    // the asynchronous I/O queue
+    IoUring m_queue;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_DEVICE_URING_H */
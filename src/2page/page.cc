@@ -18,6 +18,7 @@
 #include "0root/root.h"
 
 #include <string.h>
+#include <algorithm>
 #include "3rdparty/murmurhash3/MurmurHash3.h"
 
 #include "1base/error.h"
@@ -31,7 +32,8 @@ namespace upscaledb {
 uint64_t Page::ms_page_count_flushed = 0;
 
 Page::Page(Device *device, LocalDatabase *db)
-  : device_(device), db_(db), cursor_list_(0), node_proxy_(0)
+  : device_(device), db_(db), cursor_list_(0), node_proxy_(0),
+    changeset_(0)
 {
   persisted_data.raw_data = 0;
   persisted_data.is_dirty = false;
@@ -74,18 +76,17 @@ Page::fetch(uint64_t address)
   set_address(address);
 }
 
+static bool
+page_address_less(Page *lhs, Page *rhs)
+{
+  return lhs->address() < rhs->address();
+}
+
 void
 Page::flush()
 {
   if (persisted_data.is_dirty) {
-    // update crc32
-    if (ISSET(device_->config.flags, UPS_ENABLE_CRC32)
-        && likely(!persisted_data.is_without_header)) {
-      MurmurHash3_x86_32(persisted_data.raw_data->header.payload,
-                         persisted_data.size - (sizeof(PPageHeader) - 1),
-                         (uint32_t)persisted_data.address,
-                         &persisted_data.raw_data->header.crc32);
-    }
+    update_crc32();
     device_->write(persisted_data.address, persisted_data.raw_data,
                     persisted_data.size);
     persisted_data.is_dirty = false;
@@ -93,6 +94,44 @@ Page::flush()
   }
 }
 
+void
+Page::flush(std::vector<Page *> &pages)
+{
+  std::vector<Page *> dirty;
+  dirty.reserve(pages.size());
+  for (std::vector<Page *>::iterator it = pages.begin();
+                  it != pages.end();
+                  it++) {
+    if ((*it)->is_dirty()) {
+      (*it)->update_crc32();
+      dirty.push_back(*it);
+    }
+  }
+  if (dirty.empty())
+    return;
+
+  std::sort(dirty.begin(), dirty.end(), page_address_less);
+  dirty[0]->device_->write_pages(&dirty[0], dirty.size());
+
+  for (std::vector<Page *>::iterator it = dirty.begin();
+                  it != dirty.end();
+                  it++)
+    (*it)->persisted_data.is_dirty = false;
+  ms_page_count_flushed += dirty.size();
+}
+
+void
+Page::update_crc32()
+{
+  if (ISSET(device_->config.flags, UPS_ENABLE_CRC32)
+      && likely(!persisted_data.is_without_header)) {
+    MurmurHash3_x86_32(persisted_data.raw_data->header.payload,
+                       persisted_data.size - (sizeof(PPageHeader) - 1),
+                       (uint32_t)persisted_data.address,
+                       &persisted_data.raw_data->header.crc32);
+  }
+}
+
 void
 Page::free_buffer()
 {
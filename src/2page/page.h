@@ -25,6 +25,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <vector>
 
 #include "1base/error.h"
 #include "1base/spinlock.h"
@@ -36,6 +37,7 @@ namespace upscaledb {
 struct Device;
 struct BtreeCursor;
 struct BtreeNodeProxy;
+struct Changeset;
 class LocalDatabase;
 
 #include "1base/packstart.h"
@@ -148,8 +150,14 @@ class Page {
       // a bucket in the hash table of the cache
       kListBucket             = 2,
 
+      // the "cold" queue of the cache's replacement policy
+      kListCacheCold          = 3,
+
+      // the "hot" queue of the cache's replacement policy
+      kListCacheHot           = 4,
+
       // array limit
-      kListMax                = 3
+      kListMax                = 5
     };
 
     // non-persistent page flags
@@ -343,6 +351,11 @@ class Page {
     // Flushes the page to disk, clears the "dirty" flag
     void flush();
 
+    // Flushes a batch of pages (sorted by address) with a single device
+    // request, clears the "dirty" flags. All pages must belong to the
+    // same device
+    static void flush(std::vector<Page *> &pages);
+
     // Returns the cached BtreeNodeProxy
     BtreeNodeProxy *node_proxy() {
       return node_proxy_;
@@ -353,6 +366,16 @@ class Page {
       node_proxy_ = proxy;
     }
 
+    // Returns the Changeset which currently locks this page (can be NULL)
+    Changeset *changeset() const {
+      return changeset_;
+    }
+
+    // Sets the Changeset which currently locks this page
+    void set_changeset(Changeset *changeset) {
+      changeset_ = changeset;
+    }
+
     // Returns the next page in a linked list
     Page *next(int list) {
       return list_node.next[list];
@@ -373,6 +396,9 @@ class Page {
     IntrusiveListNode<Page, Page::kListMax> list_node;
 
   private:
+    // Updates the crc32 checksum before the page is written
+    void update_crc32();
+
     // the Device for allocating storage
     Device *device_;
 
@@ -384,6 +410,9 @@ class Page {
 
     // the cached BtreeNodeProxy object
     BtreeNodeProxy *node_proxy_;
+
+    // the Changeset which currently locks this page
+    Changeset *changeset_;
 };
 
 } // namespace upscaledb
@@ -26,6 +26,7 @@
 #include "0root/root.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "ups/upscaledb.h"
 
@@ -74,7 +75,44 @@ enum {
   kCursorOverwriteRequest,
   kCursorOverwriteReply,
   kCursorMoveRequest,
-  kCursorMoveReply
+  kCursorMoveReply,
+  kDbFindManyRequest,
+  kDbFindManyReply,
+  kDbInsertManyRequest,
+  kDbInsertManyReply
+};
+
+/*
+ * The batched requests (kDbFindManyRequest, kDbInsertManyRequest) pack
+ * their keys and records into a single "bytes" field. Each item is
+ * stored as a 32bit size, followed by the data (aligned to 32bits).
+ */
+struct SerializedBatch {
+  // Returns the number of bytes which are required for an item
+  static size_t get_size(uint32_t size) {
+    return (sizeof(uint32_t) + ((size + 3) & ~3));
+  }
+
+  // Appends an item at |ptr|; returns the position of the next item
+  static uint8_t *append(uint8_t *ptr, const void *data, uint32_t size) {
+    *(uint32_t *)ptr = size;
+    if (size)
+      ::memcpy(ptr + sizeof(uint32_t), data, size);
+    return (ptr + get_size(size));
+  }
+
+  // Reads the item at |ptr|; returns the position of the next item, or
+  // NULL if the item exceeds |end|
+  static uint8_t *next(uint8_t *ptr, uint8_t *end, void **data,
+                  uint32_t *size) {
+    if (ptr + sizeof(uint32_t) > end)
+      return (0);
+    *size = *(uint32_t *)ptr;
+    if ((size_t)(end - ptr) < get_size(*size))
+      return (0);
+    *data = *size ? ptr + sizeof(uint32_t) : 0;
+    return (ptr + get_size(*size));
+  }
 };
 
 template<typename Ex, typename In>
@@ -823,6 +861,180 @@ struct SerializedDbFindReply {
   }
 };
 
+struct SerializedDbFindManyRequest {
+  SerializedUint64 db_handle;
+  SerializedUint64 txn_handle;
+  SerializedUint32 flags;
+  SerializedUint32 count;
+  SerializedBytes keys;
+
+  SerializedDbFindManyRequest() {
+    clear();
+  }
+
+  size_t get_size() const {
+    return (
+          db_handle.get_size() + 
+          txn_handle.get_size() + 
+          flags.get_size() + 
+          count.get_size() + 
+          keys.get_size() + 
+          0);
+  }
+
+  void clear() {
+    db_handle.clear();
+    txn_handle.clear();
+    flags.clear();
+    count.clear();
+    keys.clear();
+  }
+
+  void serialize(unsigned char **pptr, int *psize) const {
+    db_handle.serialize(pptr, psize);
+    txn_handle.serialize(pptr, psize);
+    flags.serialize(pptr, psize);
+    count.serialize(pptr, psize);
+    keys.serialize(pptr, psize);
+  }
+
+  void deserialize(unsigned char **pptr, int *psize) {
+    db_handle.deserialize(pptr, psize);
+    txn_handle.deserialize(pptr, psize);
+    flags.deserialize(pptr, psize);
+    count.deserialize(pptr, psize);
+    keys.deserialize(pptr, psize);
+  }
+};
+
+struct SerializedDbFindManyReply {
+  SerializedSint32 status;
+  SerializedBytes results;
+  SerializedBytes records;
+
+  SerializedDbFindManyReply() {
+    clear();
+  }
+
+  size_t get_size() const {
+    return (
+          status.get_size() + 
+          results.get_size() + 
+          records.get_size() + 
+          0);
+  }
+
+  void clear() {
+    status.clear();
+    results.clear();
+    records.clear();
+  }
+
+  void serialize(unsigned char **pptr, int *psize) const {
+    status.serialize(pptr, psize);
+    results.serialize(pptr, psize);
+    records.serialize(pptr, psize);
+  }
+
+  void deserialize(unsigned char **pptr, int *psize) {
+    status.deserialize(pptr, psize);
+    results.deserialize(pptr, psize);
+    records.deserialize(pptr, psize);
+  }
+};
+
+struct SerializedDbInsertManyRequest {
+  SerializedUint64 db_handle;
+  SerializedUint64 txn_handle;
+  SerializedUint32 flags;
+  SerializedUint32 count;
+  SerializedBytes keys;
+  SerializedBytes records;
+
+  SerializedDbInsertManyRequest() {
+    clear();
+  }
+
+  size_t get_size() const {
+    return (
+          db_handle.get_size() + 
+          txn_handle.get_size() + 
+          flags.get_size() + 
+          count.get_size() + 
+          keys.get_size() + 
+          records.get_size() + 
+          0);
+  }
+
+  void clear() {
+    db_handle.clear();
+    txn_handle.clear();
+    flags.clear();
+    count.clear();
+    keys.clear();
+    records.clear();
+  }
+
+  void serialize(unsigned char **pptr, int *psize) const {
+    db_handle.serialize(pptr, psize);
+    txn_handle.serialize(pptr, psize);
+    flags.serialize(pptr, psize);
+    count.serialize(pptr, psize);
+    keys.serialize(pptr, psize);
+    records.serialize(pptr, psize);
+  }
+
+  void deserialize(unsigned char **pptr, int *psize) {
+    db_handle.deserialize(pptr, psize);
+    txn_handle.deserialize(pptr, psize);
+    flags.deserialize(pptr, psize);
+    count.deserialize(pptr, psize);
+    keys.deserialize(pptr, psize);
+    records.deserialize(pptr, psize);
+  }
+};
+
+struct SerializedDbInsertManyReply {
+  SerializedSint32 status;
+  SerializedBytes results;
+  SerializedBool has_keys;
+  SerializedBytes keys;
+
+  SerializedDbInsertManyReply() {
+    clear();
+  }
+
+  size_t get_size() const {
+    return (
+          status.get_size() + 
+          results.get_size() + 
+          has_keys.get_size() + 
+          (has_keys.value ? keys.get_size() : 0) + 
+          0);
+  }
+
+  void clear() {
+    status.clear();
+    results.clear();
+    has_keys = false;
+    keys.clear();
+  }
+
+  void serialize(unsigned char **pptr, int *psize) const {
+    status.serialize(pptr, psize);
+    results.serialize(pptr, psize);
+    has_keys.serialize(pptr, psize);
+    if (has_keys.value) keys.serialize(pptr, psize);
+  }
+
+  void deserialize(unsigned char **pptr, int *psize) {
+    status.deserialize(pptr, psize);
+    results.deserialize(pptr, psize);
+    has_keys.deserialize(pptr, psize);
+    if (has_keys.value) keys.deserialize(pptr, psize);
+  }
+};
+
 struct SerializedCursorCreateRequest {
   SerializedUint64 db_handle;
   SerializedUint64 txn_handle;
@@ -1511,6 +1723,10 @@ struct SerializedWrapper {
   SerializedCursorOverwriteReply cursor_overwrite_reply;
   SerializedCursorMoveRequest cursor_move_request;
   SerializedCursorMoveReply cursor_move_reply;
+  SerializedDbFindManyRequest db_find_many_request;
+  SerializedDbFindManyReply db_find_many_reply;
+  SerializedDbInsertManyRequest db_insert_many_request;
+  SerializedDbInsertManyReply db_insert_many_reply;
 
   SerializedWrapper() {
     clear();
@@ -1596,6 +1812,14 @@ struct SerializedWrapper {
         return (s + cursor_move_request.get_size());
       case kCursorMoveReply: 
         return (s + cursor_move_reply.get_size());
+      case kDbFindManyRequest: 
+        return (s + db_find_many_request.get_size());
+      case kDbFindManyReply: 
+        return (s + db_find_many_reply.get_size());
+      case kDbInsertManyRequest: 
+        return (s + db_insert_many_request.get_size());
+      case kDbInsertManyReply: 
+        return (s + db_insert_many_reply.get_size());
       default:
         assert(!"shouldn't be here");
         return (0);
@@ -1710,6 +1934,18 @@ struct SerializedWrapper {
       case kCursorMoveReply: 
         cursor_move_reply.serialize(pptr, psize);
         break;
+      case kDbFindManyRequest: 
+        db_find_many_request.serialize(pptr, psize);
+        break;
+      case kDbFindManyReply: 
+        db_find_many_reply.serialize(pptr, psize);
+        break;
+      case kDbInsertManyRequest: 
+        db_insert_many_request.serialize(pptr, psize);
+        break;
+      case kDbInsertManyReply: 
+        db_insert_many_reply.serialize(pptr, psize);
+        break;
       default:
         assert(!"shouldn't be here");
     }
@@ -1823,6 +2059,18 @@ struct SerializedWrapper {
       case kCursorMoveReply: 
         cursor_move_reply.deserialize(pptr, psize);
         break;
+      case kDbFindManyRequest: 
+        db_find_many_request.deserialize(pptr, psize);
+        break;
+      case kDbFindManyReply: 
+        db_find_many_reply.deserialize(pptr, psize);
+        break;
+      case kDbInsertManyRequest: 
+        db_insert_many_request.deserialize(pptr, psize);
+        break;
+      case kDbInsertManyReply: 
+        db_insert_many_reply.deserialize(pptr, psize);
+        break;
       default:
         assert(!"shouldn't be here");
     }
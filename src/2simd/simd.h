@@ -19,6 +19,10 @@
 /*
  * SIMD search functions.
  *
+ * The kernels for SSE4.1 and AVX2 are compiled even if the build only
+ * targets the SSE2 baseline. The fastest kernel which is supported by
+ * the CPU is selected at run time.
+ *
  * @exception_safe: unknown
  * @thread_safe: unknown
  */
@@ -49,6 +53,7 @@ uint32_t __inline ctz(uint32_t value)
 
 // Always verify that a file of level N does not include headers > N!
 #include "1base/error.h"
+#include "1os/os.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -91,104 +96,33 @@ linear_search(T *data, int start, int count, T key)
   return -1;
 }
 
-template<typename T>
-inline int
-linear_search_sse(T *data, int start, int count, T key)
-{
-  return linear_search(data, start, count, key);
-}
+// Attributes for compiling a single function for an instruction set which
+// is not enabled for the whole build. The function must only be called
+// if the CPU supports the instruction set (see os_has_sse41() etc).
+#ifdef WIN32
+#  define UPS_TARGET_SSE41
+#  define UPS_TARGET_AVX2
+#else
+#  define UPS_TARGET_SSE41  __attribute__((target("sse4.1")))
+#  define UPS_TARGET_AVX2   __attribute__((target("avx2")))
+#endif
 
+// A linear search kernel; compares |count| keys starting at |start|.
+// The kernel is selected at run time (see simd_search()).
 template<typename T>
-inline int
-sse_threshold()
+struct SimdSearch
 {
-  return 16;
-}
+  typedef int (*Function)(T *data, int start, int count, T key);
 
-template<>
-inline int
-sse_threshold<uint32_t>()
-{
-  return 16;
-}
+  // the kernel
+  Function function;
 
-template<>
-inline int
-sse_threshold<float>()
-{
-  return 16;
-}
+  // the number of keys which are compared by |function|
+  int threshold;
+};
 
-template<>
 inline int
-sse_threshold<uint64_t>()
-{
-  return 4;
-}
-
-template<>
-inline int
-sse_threshold<double>()
-{
-  return 4;
-}
-
-template<typename T>
-int
-find_simd_sse(size_t node_count, T *data, const ups_key_t *hkey)
-{
-  assert(hkey->size == sizeof(T));
-  T key = *(T *)hkey->data;
-
-  // Run a binary search, but fall back to linear search as soon as
-  // the remaining range is too small
-  int threshold = sse_threshold<T>();
-  int i, l = 0, r = (int)node_count;
-  int last = (int)node_count + 1;
-
-  /* repeat till we found the key or the remaining range is so small that
-   * we rather perform a linear search (which is faster for small ranges) */
-  while (r - l > threshold) {
-    /* get the median item; if it's identical with the "last" item,
-     * we've found the slot */
-    i = (l + r) / 2;
-
-    if (i == last) {
-      assert(i >= 0);
-      assert(i < (int)node_count);
-      return -1;
-    }
-
-    /* found it? */
-    register T d = data[i];
-    /* if the key is < the current item: search "to the left" */
-    if (key < d) {
-      if (r == 0) {
-        assert(i == 0);
-        return -1;
-      }
-      r = i;
-    }
-    /* if the key is > the current item: search "to the right" */
-    else if (key > d) {
-      last = i;
-      l = i;
-    }
-    /* otherwise we found the key */
-    else
-      return i;
-  }
-
-  // still here? then perform a linear search for the remaining range
-  assert(r - l <= threshold);
-  if (r + threshold < (int)node_count)
-    return linear_search_sse(data, l, threshold, key);
-  return linear_search(data, l, r - l, key);
-}
-
-template<>
-inline int
-linear_search_sse<uint16_t>(uint16_t *data, int start, int count, uint16_t key)
+linear_search_sse2(uint16_t *data, int start, int count, uint16_t key)
 {
   assert(count == 16);
   __m128i key8 = _mm_set1_epi16(key);
@@ -210,9 +144,8 @@ linear_search_sse<uint16_t>(uint16_t *data, int start, int count, uint16_t key)
   return -1;
 }
 
-template<>
 inline int
-linear_search_sse<uint32_t>(uint32_t *data, int start, int count, uint32_t key)
+linear_search_sse2(uint32_t *data, int start, int count, uint32_t key)
 {
   assert(count == 16);
   __m128i key4 = _mm_set1_epi32(key);
@@ -240,9 +173,8 @@ linear_search_sse<uint32_t>(uint32_t *data, int start, int count, uint32_t key)
   return -1;
 }
 
-template<>
 inline int
-linear_search_sse<float>(float *data, int start, int count, float key)
+linear_search_sse2(float *data, int start, int count, float key)
 {
   assert(count == 16);
   __m128 key4 = _mm_set1_ps(key);
@@ -272,10 +204,8 @@ linear_search_sse<float>(float *data, int start, int count, float key)
   return -1;
 }
 
-#ifdef __SSE4_1__
-template<>
 inline int
-linear_search_sse<double>(double *data, int start, int count, double key)
+linear_search_sse2(double *data, int start, int count, double key)
 {
   assert(count == 4);
   __m128d key2 = _mm_set1_pd(key);
@@ -302,9 +232,8 @@ linear_search_sse<double>(double *data, int start, int count, double key)
   return -1;
 }
 
-template<>
-inline int
-linear_search_sse<uint64_t>(uint64_t *data, int start, int count, uint64_t key)
+UPS_TARGET_SSE41 inline int
+linear_search_sse41(uint64_t *data, int start, int count, uint64_t key)
 {
   assert(count == 4);
   __m128i key2 = _mm_set1_epi64x(key);
@@ -330,7 +259,240 @@ linear_search_sse<uint64_t>(uint64_t *data, int start, int count, uint64_t key)
   /* the new key is > the last key in the page */
   return -1;
 }
-#endif
+
+// The AVX2 kernels compare twice as many keys per instruction; the
+// comparison results are collected with one bit per key
+
+UPS_TARGET_AVX2 inline int
+linear_search_avx2(uint16_t *data, int start, int count, uint16_t key)
+{
+  assert(count == 16);
+  __m256i key16 = _mm256_set1_epi16(key);
+
+  __m256i v1 = _mm256_loadu_si256((const __m256i *)&data[start + 0]);
+
+  // two bits per key
+  uint32_t res = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(key16, v1));
+  if (res)
+    return start + ctz(res) / 2;
+
+  /* the new key is > the last key in the page */
+  return -1;
+}
+
+UPS_TARGET_AVX2 inline int
+linear_search_avx2(uint32_t *data, int start, int count, uint32_t key)
+{
+  assert(count == 16);
+  __m256i key8 = _mm256_set1_epi32(key);
+
+  __m256i v1 = _mm256_loadu_si256((const __m256i *)&data[start + 0]);
+  __m256i v2 = _mm256_loadu_si256((const __m256i *)&data[start + 8]);
+
+  __m256 cmp0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(key8, v1));
+  __m256 cmp1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(key8, v2));
+
+  uint32_t res = (uint32_t)_mm256_movemask_ps(cmp0)
+                    | ((uint32_t)_mm256_movemask_ps(cmp1) << 8);
+  if (res)
+    return start + ctz(res);
+
+  /* the new key is > the last key in the page */
+  return -1;
+}
+
+UPS_TARGET_AVX2 inline int
+linear_search_avx2(float *data, int start, int count, float key)
+{
+  assert(count == 16);
+  __m256 key8 = _mm256_set1_ps(key);
+
+  __m256 v1 = _mm256_loadu_ps(&data[start + 0]);
+  __m256 v2 = _mm256_loadu_ps(&data[start + 8]);
+
+  __m256 cmp0 = _mm256_cmp_ps(key8, v1, _CMP_EQ_OQ);
+  __m256 cmp1 = _mm256_cmp_ps(key8, v2, _CMP_EQ_OQ);
+
+  uint32_t res = (uint32_t)_mm256_movemask_ps(cmp0)
+                    | ((uint32_t)_mm256_movemask_ps(cmp1) << 8);
+  if (res)
+    return start + ctz(res);
+
+  /* the new key is > the last key in the page */
+  return -1;
+}
+
+UPS_TARGET_AVX2 inline int
+linear_search_avx2(uint64_t *data, int start, int count, uint64_t key)
+{
+  assert(count == 8);
+  __m256i key4 = _mm256_set1_epi64x(key);
+
+  __m256i v1 = _mm256_loadu_si256((const __m256i *)&data[start + 0]);
+  __m256i v2 = _mm256_loadu_si256((const __m256i *)&data[start + 4]);
+
+  __m256d cmp0 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(key4, v1));
+  __m256d cmp1 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(key4, v2));
+
+  uint32_t res = (uint32_t)_mm256_movemask_pd(cmp0)
+                    | ((uint32_t)_mm256_movemask_pd(cmp1) << 4);
+  if (res)
+    return start + ctz(res);
+
+  /* the new key is > the last key in the page */
+  return -1;
+}
+
+UPS_TARGET_AVX2 inline int
+linear_search_avx2(double *data, int start, int count, double key)
+{
+  assert(count == 8);
+  __m256d key4 = _mm256_set1_pd(key);
+
+  __m256d v1 = _mm256_loadu_pd(&data[start + 0]);
+  __m256d v2 = _mm256_loadu_pd(&data[start + 4]);
+
+  __m256d cmp0 = _mm256_cmp_pd(key4, v1, _CMP_EQ_OQ);
+  __m256d cmp1 = _mm256_cmp_pd(key4, v2, _CMP_EQ_OQ);
+
+  uint32_t res = (uint32_t)_mm256_movemask_pd(cmp0)
+                    | ((uint32_t)_mm256_movemask_pd(cmp1) << 4);
+  if (res)
+    return start + ctz(res);
+
+  /* the new key is > the last key in the page */
+  return -1;
+}
+
+// Selects the fastest kernel which is supported by the CPU; the default
+// for all other types is the scalar search
+template<typename T>
+inline SimdSearch<T>
+select_simd_search()
+{
+  SimdSearch<T> s = {linear_search<T>, 16};
+  return s;
+}
+
+template<>
+inline SimdSearch<uint16_t>
+select_simd_search<uint16_t>()
+{
+  SimdSearch<uint16_t> s = {linear_search_sse2, 16};
+  if (os_has_avx2())
+    s.function = linear_search_avx2;
+  return s;
+}
+
+template<>
+inline SimdSearch<uint32_t>
+select_simd_search<uint32_t>()
+{
+  SimdSearch<uint32_t> s = {linear_search_sse2, 16};
+  if (os_has_avx2())
+    s.function = linear_search_avx2;
+  return s;
+}
+
+template<>
+inline SimdSearch<float>
+select_simd_search<float>()
+{
+  SimdSearch<float> s = {linear_search_sse2, 16};
+  if (os_has_avx2())
+    s.function = linear_search_avx2;
+  return s;
+}
+
+template<>
+inline SimdSearch<uint64_t>
+select_simd_search<uint64_t>()
+{
+  SimdSearch<uint64_t> s = {linear_search<uint64_t>, 4};
+  if (os_has_avx2()) {
+    s.function = linear_search_avx2;
+    s.threshold = 8;
+  }
+  else if (os_has_sse41())
+    s.function = linear_search_sse41;
+  return s;
+}
+
+template<>
+inline SimdSearch<double>
+select_simd_search<double>()
+{
+  SimdSearch<double> s = {linear_search_sse2, 4};
+  if (os_has_avx2()) {
+    s.function = linear_search_avx2;
+    s.threshold = 8;
+  }
+  return s;
+}
+
+// Returns the linear search kernel for |T|; it is selected only once
+template<typename T>
+inline const SimdSearch<T> &
+simd_search()
+{
+  static const SimdSearch<T> s = select_simd_search<T>();
+  return s;
+}
+
+template<typename T>
+int
+find_simd(size_t node_count, T *data, const ups_key_t *hkey)
+{
+  assert(hkey->size == sizeof(T));
+  T key = *(T *)hkey->data;
+
+  const SimdSearch<T> &search = simd_search<T>();
+
+  // Run a binary search, but fall back to linear search as soon as
+  // the remaining range is too small
+  int threshold = search.threshold;
+  int i, l = 0, r = (int)node_count;
+  int last = (int)node_count + 1;
+
+  /* repeat till we found the key or the remaining range is so small that
+   * we rather perform a linear search (which is faster for small ranges) */
+  while (r - l > threshold) {
+    /* get the median item; if it's identical with the "last" item,
+     * we've found the slot */
+    i = (l + r) / 2;
+
+    if (i == last) {
+      assert(i >= 0);
+      assert(i < (int)node_count);
+      return -1;
+    }
+
+    /* found it? */
+    register T d = data[i];
+    /* if the key is < the current item: search "to the left" */
+    if (key < d) {
+      if (r == 0) {
+        assert(i == 0);
+        return -1;
+      }
+      r = i;
+    }
+    /* if the key is > the current item: search "to the right" */
+    else if (key > d) {
+      last = i;
+      l = i;
+    }
+    /* otherwise we found the key */
+    else
+      return i;
+  }
+
+  // still here? then perform a linear search for the remaining range
+  assert(r - l <= threshold);
+  if (r + threshold < (int)node_count)
+    return search.function(data, l, threshold, key);
+  return linear_search(data, l, r - l, key);
+}
 
 } // namespace upscaledb
 
@@ -0,0 +1,718 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * SIMD aggregation functions (SUM, MIN, MAX) over arrays of numeric
+ * values; used by the UQI plugins for block scans.
+ *
+ * The scalar kernels are always available. If the build targets SSE then
+ * the SSE2 kernels are used, or the SSE4.1/AVX2 kernels if the CPU
+ * supports them (selected at run time, see simd.h).
+ *
+ * Integer values are summed up as uint64_t, floating point values
+ * as double.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: yes
+ */
+
+#ifndef UPS_SIMD_AGGREGATE_H
+#define UPS_SIMD_AGGREGATE_H
+
+#include "0root/root.h"
+
+#include <functional>
+
+// Always verify that a file of level N does not include headers > N!
+#include "2simd/simd.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+// The type of a sum of |T| values
+template<typename T>
+struct AggregateSum {
+  typedef uint64_t type;
+};
+
+template<>
+struct AggregateSum<float> {
+  typedef double type;
+};
+
+template<>
+struct AggregateSum<double> {
+  typedef double type;
+};
+
+template<typename T>
+inline typename AggregateSum<T>::type
+scalar_sum(const T *data, size_t length)
+{
+  typename AggregateSum<T>::type sum = 0;
+  for (const T *end = data + length; data != end; data++)
+    sum += *data;
+  return sum;
+}
+
+// Returns the minimum (or maximum, if |IsMax| is true) of a non-empty array
+template<typename T, bool IsMax>
+inline T
+scalar_extreme(const T *data, size_t length)
+{
+  T value = data[0];
+  for (size_t i = 1; i < length; i++) {
+    if (IsMax ? data[i] > value : data[i] < value)
+      value = data[i];
+  }
+  return value;
+}
+
+// The aggregation kernels for a type |T|
+template<typename T>
+struct AggregateKernels
+{
+  typedef typename AggregateSum<T>::type (*SumFunction)(const T *data,
+                  size_t length);
+  typedef T (*ExtremeFunction)(const T *data, size_t length);
+
+  // calculates the sum
+  SumFunction sum;
+
+  // calculates the minimum
+  ExtremeFunction min;
+
+  // calculates the maximum
+  ExtremeFunction max;
+};
+
+// Returns the scalar kernels
+template<typename T>
+inline AggregateKernels<T>
+scalar_aggregate_kernels()
+{
+  AggregateKernels<T> k = {scalar_sum<T>, scalar_extreme<T, false>,
+                           scalar_extreme<T, true>};
+  return k;
+}
+
+// Returns the fastest kernels for |T|
+template<typename T>
+inline AggregateKernels<T>
+select_aggregate_kernels()
+{
+  return scalar_aggregate_kernels<T>();
+}
+
+#ifdef __SSE__
+
+//
+// Sums up the lanes of the accumulators and the remaining (unaligned)
+// values
+//
+template<typename T, typename Lane, size_t LaneCount>
+inline typename AggregateSum<T>::type
+finish_sum(const Lane *lanes, const T *tail, size_t tail_length)
+{
+  typename AggregateSum<T>::type sum = scalar_sum(tail, tail_length);
+  for (size_t i = 0; i < LaneCount; i++)
+    sum += lanes[i];
+  return sum;
+}
+
+template<typename T, bool IsMax, size_t LaneCount>
+inline T
+finish_extreme(T *lanes, const T *tail, size_t tail_length)
+{
+  T value = scalar_extreme<T, IsMax>(lanes, LaneCount);
+  if (tail_length > 0) {
+    T t = scalar_extreme<T, IsMax>(tail, tail_length);
+    if (IsMax ? t > value : t < value)
+      value = t;
+  }
+  return value;
+}
+
+//
+// SSE2 kernels
+//
+
+inline uint64_t
+sum_sse2(const uint8_t *data, size_t length)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  size_t i = 0;
+  // |sad| adds up 8 bytes into a 64bit lane
+  for (; i + 16 <= length; i += 16)
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(
+                    _mm_loadu_si128((const __m128i *)&data[i]), zero));
+
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_sum<uint8_t, uint64_t, 2>(lanes, data + i, length - i);
+}
+
+inline uint64_t
+sum_sse2(const uint16_t *data, size_t length)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+    __m128i s = _mm_add_epi32(_mm_unpacklo_epi16(v, zero),
+                    _mm_unpackhi_epi16(v, zero));
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(s, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(s, zero));
+  }
+
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_sum<uint16_t, uint64_t, 2>(lanes, data + i, length - i);
+}
+
+inline uint64_t
+sum_sse2(const uint32_t *data, size_t length)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+  }
+
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_sum<uint32_t, uint64_t, 2>(lanes, data + i, length - i);
+}
+
+inline uint64_t
+sum_sse2(const uint64_t *data, size_t length)
+{
+  __m128i acc = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 2 <= length; i += 2)
+    acc = _mm_add_epi64(acc, _mm_loadu_si128((const __m128i *)&data[i]));
+
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_sum<uint64_t, uint64_t, 2>(lanes, data + i, length - i);
+}
+
+inline double
+sum_sse2(const float *data, size_t length)
+{
+  __m128d acc = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    __m128 v = _mm_loadu_ps(&data[i]);
+    acc = _mm_add_pd(acc, _mm_cvtps_pd(v));
+    acc = _mm_add_pd(acc, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+
+  double lanes[2];
+  _mm_storeu_pd(lanes, acc);
+  return finish_sum<float, double, 2>(lanes, data + i, length - i);
+}
+
+inline double
+sum_sse2(const double *data, size_t length)
+{
+  __m128d acc = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 2 <= length; i += 2)
+    acc = _mm_add_pd(acc, _mm_loadu_pd(&data[i]));
+
+  double lanes[2];
+  _mm_storeu_pd(lanes, acc);
+  return finish_sum<double, double, 2>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+inline uint8_t
+extreme_sse2(const uint8_t *data, size_t length)
+{
+  if (length < 16)
+    return scalar_extreme<uint8_t, IsMax>(data, length);
+
+  __m128i acc = _mm_loadu_si128((const __m128i *)data);
+  size_t i = 16;
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+    acc = IsMax ? _mm_max_epu8(acc, v) : _mm_min_epu8(acc, v);
+  }
+
+  uint8_t lanes[16];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_extreme<uint8_t, IsMax, 16>(lanes, data + i, length - i);
+}
+
+// SSE2 only compares signed 16bit integers; the sign bit is flipped
+// to compare unsigned values
+template<bool IsMax>
+inline uint16_t
+extreme_sse2(const uint16_t *data, size_t length)
+{
+  if (length < 8)
+    return scalar_extreme<uint16_t, IsMax>(data, length);
+
+  __m128i bias = _mm_set1_epi16((short)0x8000);
+  __m128i acc = _mm_xor_si128(_mm_loadu_si128((const __m128i *)data), bias);
+  size_t i = 8;
+  for (; i + 8 <= length; i += 8) {
+    __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&data[i]),
+                    bias);
+    acc = IsMax ? _mm_max_epi16(acc, v) : _mm_min_epi16(acc, v);
+  }
+
+  uint16_t lanes[8];
+  _mm_storeu_si128((__m128i *)lanes, _mm_xor_si128(acc, bias));
+  return finish_extreme<uint16_t, IsMax, 8>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+inline float
+extreme_sse2(const float *data, size_t length)
+{
+  if (length < 4)
+    return scalar_extreme<float, IsMax>(data, length);
+
+  __m128 acc = _mm_loadu_ps(data);
+  size_t i = 4;
+  for (; i + 4 <= length; i += 4) {
+    __m128 v = _mm_loadu_ps(&data[i]);
+    acc = IsMax ? _mm_max_ps(acc, v) : _mm_min_ps(acc, v);
+  }
+
+  float lanes[4];
+  _mm_storeu_ps(lanes, acc);
+  return finish_extreme<float, IsMax, 4>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+inline double
+extreme_sse2(const double *data, size_t length)
+{
+  if (length < 2)
+    return scalar_extreme<double, IsMax>(data, length);
+
+  __m128d acc = _mm_loadu_pd(data);
+  size_t i = 2;
+  for (; i + 2 <= length; i += 2) {
+    __m128d v = _mm_loadu_pd(&data[i]);
+    acc = IsMax ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+  }
+
+  double lanes[2];
+  _mm_storeu_pd(lanes, acc);
+  return finish_extreme<double, IsMax, 2>(lanes, data + i, length - i);
+}
+
+//
+// SSE4.1 kernels
+//
+
+template<bool IsMax>
+UPS_TARGET_SSE41 inline uint32_t
+extreme_sse41(const uint32_t *data, size_t length)
+{
+  if (length < 4)
+    return scalar_extreme<uint32_t, IsMax>(data, length);
+
+  __m128i acc = _mm_loadu_si128((const __m128i *)data);
+  size_t i = 4;
+  for (; i + 4 <= length; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+    acc = IsMax ? _mm_max_epu32(acc, v) : _mm_min_epu32(acc, v);
+  }
+
+  uint32_t lanes[4];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish_extreme<uint32_t, IsMax, 4>(lanes, data + i, length - i);
+}
+
+//
+// AVX2 kernels
+//
+
+UPS_TARGET_AVX2 inline uint64_t
+sum_avx2(const uint8_t *data, size_t length)
+{
+  __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32)
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(
+                    _mm256_loadu_si256((const __m256i *)&data[i]), zero));
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_sum<uint8_t, uint64_t, 4>(lanes, data + i, length - i);
+}
+
+UPS_TARGET_AVX2 inline uint64_t
+sum_avx2(const uint16_t *data, size_t length)
+{
+  __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    __m256i s = _mm256_add_epi32(_mm256_unpacklo_epi16(v, zero),
+                    _mm256_unpackhi_epi16(v, zero));
+    acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(s, zero));
+    acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(s, zero));
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_sum<uint16_t, uint64_t, 4>(lanes, data + i, length - i);
+}
+
+UPS_TARGET_AVX2 inline uint64_t
+sum_avx2(const uint32_t *data, size_t length)
+{
+  __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(v, zero));
+    acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(v, zero));
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_sum<uint32_t, uint64_t, 4>(lanes, data + i, length - i);
+}
+
+UPS_TARGET_AVX2 inline uint64_t
+sum_avx2(const uint64_t *data, size_t length)
+{
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4)
+    acc = _mm256_add_epi64(acc,
+                    _mm256_loadu_si256((const __m256i *)&data[i]));
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_sum<uint64_t, uint64_t, 4>(lanes, data + i, length - i);
+}
+
+UPS_TARGET_AVX2 inline double
+sum_avx2(const float *data, size_t length)
+{
+  __m256d acc = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4)
+    acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm_loadu_ps(&data[i])));
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  return finish_sum<float, double, 4>(lanes, data + i, length - i);
+}
+
+UPS_TARGET_AVX2 inline double
+sum_avx2(const double *data, size_t length)
+{
+  __m256d acc = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4)
+    acc = _mm256_add_pd(acc, _mm256_loadu_pd(&data[i]));
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  return finish_sum<double, double, 4>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+UPS_TARGET_AVX2 inline uint8_t
+extreme_avx2(const uint8_t *data, size_t length)
+{
+  if (length < 32)
+    return scalar_extreme<uint8_t, IsMax>(data, length);
+
+  __m256i acc = _mm256_loadu_si256((const __m256i *)data);
+  size_t i = 32;
+  for (; i + 32 <= length; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    acc = IsMax ? _mm256_max_epu8(acc, v) : _mm256_min_epu8(acc, v);
+  }
+
+  uint8_t lanes[32];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_extreme<uint8_t, IsMax, 32>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+UPS_TARGET_AVX2 inline uint16_t
+extreme_avx2(const uint16_t *data, size_t length)
+{
+  if (length < 16)
+    return scalar_extreme<uint16_t, IsMax>(data, length);
+
+  __m256i acc = _mm256_loadu_si256((const __m256i *)data);
+  size_t i = 16;
+  for (; i + 16 <= length; i += 16) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    acc = IsMax ? _mm256_max_epu16(acc, v) : _mm256_min_epu16(acc, v);
+  }
+
+  uint16_t lanes[16];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_extreme<uint16_t, IsMax, 16>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+UPS_TARGET_AVX2 inline uint32_t
+extreme_avx2(const uint32_t *data, size_t length)
+{
+  if (length < 8)
+    return scalar_extreme<uint32_t, IsMax>(data, length);
+
+  __m256i acc = _mm256_loadu_si256((const __m256i *)data);
+  size_t i = 8;
+  for (; i + 8 <= length; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    acc = IsMax ? _mm256_max_epu32(acc, v) : _mm256_min_epu32(acc, v);
+  }
+
+  uint32_t lanes[8];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish_extreme<uint32_t, IsMax, 8>(lanes, data + i, length - i);
+}
+
+// AVX2 only compares signed 64bit integers; the sign bit is flipped
+// to compare unsigned values
+template<bool IsMax>
+UPS_TARGET_AVX2 inline uint64_t
+extreme_avx2(const uint64_t *data, size_t length)
+{
+  if (length < 4)
+    return scalar_extreme<uint64_t, IsMax>(data, length);
+
+  __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+  __m256i acc = _mm256_xor_si256(
+                  _mm256_loadu_si256((const __m256i *)data), bias);
+  size_t i = 4;
+  for (; i + 4 <= length; i += 4) {
+    __m256i v = _mm256_xor_si256(
+                    _mm256_loadu_si256((const __m256i *)&data[i]), bias);
+    __m256i gt = _mm256_cmpgt_epi64(v, acc);
+    acc = IsMax
+            ? _mm256_blendv_epi8(acc, v, gt)
+            : _mm256_blendv_epi8(v, acc, gt);
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, _mm256_xor_si256(acc, bias));
+  return finish_extreme<uint64_t, IsMax, 4>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+UPS_TARGET_AVX2 inline float
+extreme_avx2(const float *data, size_t length)
+{
+  if (length < 8)
+    return scalar_extreme<float, IsMax>(data, length);
+
+  __m256 acc = _mm256_loadu_ps(data);
+  size_t i = 8;
+  for (; i + 8 <= length; i += 8) {
+    __m256 v = _mm256_loadu_ps(&data[i]);
+    acc = IsMax ? _mm256_max_ps(acc, v) : _mm256_min_ps(acc, v);
+  }
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, acc);
+  return finish_extreme<float, IsMax, 8>(lanes, data + i, length - i);
+}
+
+template<bool IsMax>
+UPS_TARGET_AVX2 inline double
+extreme_avx2(const double *data, size_t length)
+{
+  if (length < 4)
+    return scalar_extreme<double, IsMax>(data, length);
+
+  __m256d acc = _mm256_loadu_pd(data);
+  size_t i = 4;
+  for (; i + 4 <= length; i += 4) {
+    __m256d v = _mm256_loadu_pd(&data[i]);
+    acc = IsMax ? _mm256_max_pd(acc, v) : _mm256_min_pd(acc, v);
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  return finish_extreme<double, IsMax, 4>(lanes, data + i, length - i);
+}
+
+//
+// Kernel selection
+//
+
+template<>
+inline AggregateKernels<uint8_t>
+select_aggregate_kernels<uint8_t>()
+{
+  AggregateKernels<uint8_t> k = {sum_sse2, extreme_sse2<false>,
+                                 extreme_sse2<true>};
+  if (os_has_avx2()) {
+    AggregateKernels<uint8_t> a = {sum_avx2, extreme_avx2<false>,
+                                   extreme_avx2<true>};
+    k = a;
+  }
+  return k;
+}
+
+template<>
+inline AggregateKernels<uint16_t>
+select_aggregate_kernels<uint16_t>()
+{
+  AggregateKernels<uint16_t> k = {sum_sse2, extreme_sse2<false>,
+                                  extreme_sse2<true>};
+  if (os_has_avx2()) {
+    AggregateKernels<uint16_t> a = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+    k = a;
+  }
+  return k;
+}
+
+template<>
+inline AggregateKernels<uint32_t>
+select_aggregate_kernels<uint32_t>()
+{
+  AggregateKernels<uint32_t> k = scalar_aggregate_kernels<uint32_t>();
+  k.sum = sum_sse2;
+  if (os_has_avx2()) {
+    AggregateKernels<uint32_t> a = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+    k = a;
+  }
+  else if (os_has_sse41()) {
+    k.min = extreme_sse41<false>;
+    k.max = extreme_sse41<true>;
+  }
+  return k;
+}
+
+template<>
+inline AggregateKernels<uint64_t>
+select_aggregate_kernels<uint64_t>()
+{
+  AggregateKernels<uint64_t> k = scalar_aggregate_kernels<uint64_t>();
+  k.sum = sum_sse2;
+  if (os_has_avx2()) {
+    AggregateKernels<uint64_t> a = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+    k = a;
+  }
+  return k;
+}
+
+template<>
+inline AggregateKernels<float>
+select_aggregate_kernels<float>()
+{
+  AggregateKernels<float> k = {sum_sse2, extreme_sse2<false>,
+                               extreme_sse2<true>};
+  if (os_has_avx2()) {
+    AggregateKernels<float> a = {sum_avx2, extreme_avx2<false>,
+                                 extreme_avx2<true>};
+    k = a;
+  }
+  return k;
+}
+
+template<>
+inline AggregateKernels<double>
+select_aggregate_kernels<double>()
+{
+  AggregateKernels<double> k = {sum_sse2, extreme_sse2<false>,
+                                extreme_sse2<true>};
+  if (os_has_avx2()) {
+    AggregateKernels<double> a = {sum_avx2, extreme_avx2<false>,
+                                  extreme_avx2<true>};
+    k = a;
+  }
+  return k;
+}
+
+#endif // __SSE__
+
+// Returns the kernels for |T|; they are selected on first use
+template<typename T>
+inline const AggregateKernels<T> &
+aggregate_kernels()
+{
+  static const AggregateKernels<T> k = select_aggregate_kernels<T>();
+  return k;
+}
+
+// Returns the sum of |length| values
+template<typename T>
+inline typename AggregateSum<T>::type
+simd_sum(const T *data, size_t length)
+{
+  return aggregate_kernels<T>().sum(data, length);
+}
+
+// Returns the minimum of |length| values; |length| must not be 0
+template<typename T>
+inline T
+simd_min(const T *data, size_t length)
+{
+  assert(length > 0);
+  return aggregate_kernels<T>().min(data, length);
+}
+
+// Returns the maximum of |length| values; |length| must not be 0
+template<typename T>
+inline T
+simd_max(const T *data, size_t length)
+{
+  assert(length > 0);
+  return aggregate_kernels<T>().max(data, length);
+}
+
+// Returns the minimum or the maximum, depending on the comparison
+// function of the caller
+template<typename T>
+inline T
+simd_extreme(const T *data, size_t length, std::less<T>)
+{
+  return simd_min(data, length);
+}
+
+template<typename T>
+inline T
+simd_extreme(const T *data, size_t length, std::greater<T>)
+{
+  return simd_max(data, length);
+}
+
+} // namespace upscaledb
+
+#endif /* UPS_SIMD_AGGREGATE_H */
@@ -64,6 +64,13 @@ struct WorkerPool {
     strand.post(f);
   }
 
+  // Add a new work item to the pool; unlike |enqueue()|, the items are
+  // not serialized but can run concurrently on all threads
+  template<typename F>
+  void post(F &f) {
+    service.post(f);
+  }
+
   // the destructor joins all threads
   ~WorkerPool() {
     service.stop();
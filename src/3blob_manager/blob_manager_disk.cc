@@ -415,12 +415,32 @@ DiskBlobManager::allocate(Context *context, ups_record_t *record,
   return blob_id;
 }
 
+// Releases the pages which were fetched while a blob was read. The
+// data was already copied (or is memory mapped), and keeping the pages
+// locked till the end of the operation could deadlock concurrent readers,
+// which lock the btree nodes in a different order.
+struct ReleaseBlobPages
+{
+  ReleaseBlobPages(Changeset *changeset_)
+    : changeset(changeset_), head(changeset_->collection.head()) {
+  }
+
+  ~ReleaseBlobPages() {
+    changeset->del_newer_than(head);
+  }
+
+  Changeset *changeset;
+  Page *head;
+};
+
 void
 DiskBlobManager::read(Context *context, uint64_t blob_id,
                 ups_record_t *record, uint32_t flags, ByteArray *arena)
 {
   metric_total_read++;
 
+  ReleaseBlobPages releaser(&context->changeset);
+
   // first step: read the blob header
   Page *page;
   PBlobHeader *blob_header = (PBlobHeader *)read_chunk(this, context, 0, &page,
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * btree bulk loading
+ *
+ * Builds the btree bottom-up from a sorted sequence of keys. The keys are
+ * appended to the right-most leaf; when the leaf is full then a new leaf
+ * is started, and the first key of the new leaf is appended to the
+ * right-most node of the parent level (which is started the same way
+ * when it overflows). There are no descents, and the leaves are filled
+ * up to the requested fill factor instead of 50%.
+ */
+
+#include "0root/root.h"
+
+#include <string.h>
+#include <vector>
+
+// Always verify that a file of level N does not include headers > N!
+#include "1base/error.h"
+#include "1base/dynamic_array.h"
+#include "2page/page.h"
+#include "3changeset/changeset.h"
+#include "3page_manager/page_manager.h"
+#include "3btree/btree_index.h"
+#include "3btree/btree_stats.h"
+#include "3btree/btree_node_proxy.h"
+#include "4context/context.h"
+#include "4db/db.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct BtreeBulkLoadAction
+{
+  BtreeBulkLoadAction(BtreeIndex *btree_, Context *context_,
+                  uint32_t fill_factor_)
+    : btree(btree_), context(context_),
+      page_manager(btree_->state.page_manager),
+      fill_factor(fill_factor_), leaf(0), count(0) {
+    last_key = ups_make_key(0, 0);
+  }
+
+  // This is the entry point for the actual bulk load operation
+  uint64_t run(BtreeBulkLoadSource &source) {
+    // the (empty) root page becomes the first leaf
+    leaf = page_manager->fetch(context, btree->root_address());
+
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    while (source.next(&key, &record)) {
+      append(&key, &record);
+      count++;
+    }
+
+    finalize();
+    return count;
+  }
+
+  // Appends a key/record pair to the right-most leaf
+  void append(ups_key_t *key, ups_record_t *record) {
+    BtreeNodeProxy *node = btree->get_node_from_page(leaf);
+
+    if (count > 0) {
+      int cmp = btree->compare_keys(key, &last_key);
+      if (unlikely(cmp < 0)) {
+        ups_trace(("keys are not sorted"));
+        throw Exception(UPS_INV_PARAMETER);
+      }
+      if (cmp == 0) {
+        append_duplicate(key, record);
+        return;
+      }
+    }
+
+    bool new_leaf = false;
+    PBtreeNode::InsertResult result = node->insert(context, key,
+                    PBtreeNode::kInsertAppend);
+    // the leaf is full: start a new one and try again
+    if (result.status == UPS_LIMITS_REACHED) {
+      start_leaf(split_position(node));
+      node = btree->get_node_from_page(leaf);
+      result = node->insert(context, key, PBtreeNode::kInsertAppend);
+      new_leaf = true;
+    }
+    if (unlikely(result.status != 0))
+      throw Exception(result.status);
+
+    uint32_t new_duplicate_id = 0;
+    node->set_record(context, result.slot, record, 0, 0, &new_duplicate_id);
+    leaf->set_dirty(true);
+
+    // a new leaf was started? then link it to the parent
+    if (new_leaf)
+      link_leaf(node);
+
+    // store a copy of the key for the next comparison
+    last_key_arena.copy((const uint8_t *)key->data, key->size);
+    last_key.data = last_key_arena.data();
+    last_key.size = key->size;
+  }
+
+  // Appends a duplicate record to the last key of the right-most leaf
+  void append_duplicate(ups_key_t *key, ups_record_t *record) {
+    if (unlikely(NOTSET(btree->db()->get_flags(),
+                        UPS_ENABLE_DUPLICATE_KEYS)))
+      throw Exception(UPS_DUPLICATE_KEY);
+
+    BtreeNodeProxy *node = btree->get_node_from_page(leaf);
+
+    // not enough space for the duplicate? then move the key to a new leaf
+    if (node->requires_split(context, key) && node->length() > 1) {
+      start_leaf(node->length() - 1);
+      node = btree->get_node_from_page(leaf);
+      link_leaf(node);
+    }
+
+    uint32_t new_duplicate_id = 0;
+    node->set_record(context, node->length() - 1, record, 0,
+                    UPS_DUPLICATE | UPS_DUPLICATE_INSERT_LAST,
+                    &new_duplicate_id);
+    leaf->set_dirty(true);
+  }
+
+  // Returns the number of keys which remain in a full leaf; all other keys
+  // are moved to the next leaf
+  int split_position(BtreeNodeProxy *node) const {
+    int length = (int)node->length();
+    if (fill_factor >= 100 || length < 2)
+      return length;
+    int pivot = (int)(length * (uint64_t)fill_factor / 100);
+    return pivot < 1 ? 1 : pivot;
+  }
+
+  // Allocates a new right-most leaf. Keys starting at |pivot| are moved
+  // from the current leaf to the new one.
+  void start_leaf(int pivot) {
+    BtreeNodeProxy *old_node = btree->get_node_from_page(leaf);
+
+    Page *new_page = page_manager->alloc(context, Page::kTypeBindex);
+    PBtreeNode::from_page(new_page)->set_flags(PBtreeNode::kLeafNode);
+    BtreeNodeProxy *new_node = btree->get_node_from_page(new_page);
+
+    if (pivot < (int)old_node->length())
+      old_node->split(context, new_node, pivot);
+
+    new_node->set_left_sibling(leaf->address());
+    old_node->set_right_sibling(new_page->address());
+    leaf->set_dirty(true);
+    new_page->set_dirty(true);
+    leaf = new_page;
+
+    release_pages();
+  }
+
+  // Appends the first key of a new leaf to the parent level
+  void link_leaf(BtreeNodeProxy *node) {
+    ups_key_t separator = {0};
+    node->key(context, 0, &separator_arena, &separator);
+    append_separator(0, &separator, node->left_sibling(),
+                    leaf->address());
+  }
+
+  // Appends |separator| (pointing to the page at |right|) to the
+  // right-most internal node of |level| (0 is the level above the leaves).
+  // If the level does not yet exist then it is created, and its left
+  // child pointer is set to |left|.
+  void append_separator(size_t level, ups_key_t *separator, uint64_t left,
+                  uint64_t right) {
+    if (level == internals.size()) {
+      Page *page = page_manager->alloc(context, Page::kTypeBindex);
+      btree->get_node_from_page(page)->set_left_child(left);
+      internals.push_back(page);
+    }
+
+    Page *page = internals[level];
+    BtreeNodeProxy *node = btree->get_node_from_page(page);
+    PBtreeNode::InsertResult result = node->insert(context, separator,
+                    PBtreeNode::kInsertAppend);
+
+    // the node is full: start a new one. The separator is not stored
+    // in the new node, but moves up to the next level.
+    if (result.status == UPS_LIMITS_REACHED) {
+      Page *new_page = page_manager->alloc(context, Page::kTypeBindex);
+      BtreeNodeProxy *new_node = btree->get_node_from_page(new_page);
+      new_node->set_left_child(right);
+      new_node->set_left_sibling(page->address());
+      node->set_right_sibling(new_page->address());
+      page->set_dirty(true);
+      internals[level] = new_page;
+
+      append_separator(level + 1, separator, page->address(),
+                      new_page->address());
+      return;
+    }
+    if (unlikely(result.status != 0))
+      throw Exception(result.status);
+
+    node->set_record_id(context, result.slot, right);
+    page->set_dirty(true);
+  }
+
+  // Releases all pages which are no longer modified, and gives the cache
+  // a chance to flush them
+  void release_pages() {
+    context->changeset.clear();
+    context->changeset.put(leaf);
+    for (std::vector<Page *>::iterator it = internals.begin();
+                    it != internals.end(); it++)
+      context->changeset.put(*it);
+
+    page_manager->purge_cache(context);
+  }
+
+  // Installs the top-most internal node as the new root
+  void finalize() {
+    BtreeStatistics *stats = btree->statistics();
+    stats->find_failed();
+    stats->insert_failed();
+    stats->erase_failed();
+
+    if (internals.empty())
+      return;
+
+    Page *old_root = page_manager->fetch(context, btree->root_address());
+    old_root->set_type(Page::kTypeBindex);
+    old_root->set_dirty(true);
+
+    Page *new_root = internals.back();
+    new_root->set_type(Page::kTypeBroot);
+    btree->set_root_address(new_root->address());
+    Page *header = page_manager->fetch(context, 0);
+    header->set_dirty(true);
+  }
+
+  // the current btree
+  BtreeIndex *btree;
+
+  // The caller's Context
+  Context *context;
+
+  // The Environment's page manager
+  PageManager *page_manager;
+
+  // The fill factor of the leaf nodes, in percent
+  uint32_t fill_factor;
+
+  // The right-most leaf
+  Page *leaf;
+
+  // The right-most internal node of each level, starting with the level
+  // above the leaves
+  std::vector<Page *> internals;
+
+  // The previous key
+  ups_key_t last_key;
+
+  // Storage for |last_key|
+  ByteArray last_key_arena;
+
+  // Storage for the separator key of a new leaf
+  ByteArray separator_arena;
+
+  // The number of key/record pairs that were loaded
+  uint64_t count;
+};
+
+uint64_t
+BtreeIndex::bulk_load(Context *context, BtreeBulkLoadSource &source,
+                uint32_t fill_factor)
+{
+  context->db = db();
+
+  Page *root = state.page_manager->fetch(context, root_address());
+  BtreeNodeProxy *node = get_node_from_page(root);
+  if (unlikely(!node->is_leaf() || node->length() != 0)) {
+    ups_trace(("bulk loading requires an empty database"));
+    throw Exception(UPS_INV_PARAMETER);
+  }
+
+  BtreeBulkLoadAction bla(this, context, fill_factor);
+  return bla.run(source);
+}
+
+} // namespace upscaledb
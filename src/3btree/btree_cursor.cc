@@ -22,6 +22,7 @@
 // Always verify that a file of level N does not include headers > N!
 #include "1base/error.h"
 #include "2page/page.h"
+#include "3changeset/changeset.h"
 #include "3page_manager/page_manager.h"
 #include "3btree/btree_index.h"
 #include "3btree/btree_cursor.h"
@@ -41,6 +42,9 @@ remove_cursor_from_page(BtreeCursor *cursor, Page *page)
   BtreeCursorState &st_ = cursor->st_;
   BtreeCursor *n, *p;
 
+  // concurrent readers can (un)couple their cursors to the same page
+  ScopedSpinlock lock(st_.m_btree->state.cursor_mutex);
+
   if (cursor == page->cursor_list()) {
     n = st_.m_next_in_page;
     if (n)
@@ -76,6 +80,7 @@ couple(BtreeCursor *cursor, Context *context)
    * the cursor's state, keep a backup and restore it afterwards.
    */
   int duplicate_index = st_.m_duplicate_index;
+  Readahead readahead = st_.m_readahead;
   ByteArray uncoupled_arena = st_.m_uncoupled_arena;
   ups_key_t uncoupled_key = st_.m_uncoupled_key;
   st_.m_uncoupled_arena = ByteArray();
@@ -83,14 +88,42 @@ couple(BtreeCursor *cursor, Context *context)
   cursor->find(context, &uncoupled_key, 0, 0, 0, 0);
 
   st_.m_duplicate_index = duplicate_index;
+  st_.m_readahead = readahead;
   st_.m_uncoupled_key = uncoupled_key;
   st_.m_uncoupled_arena = uncoupled_arena;
   uncoupled_arena.disown(); // do not free when going out of scope
 }
 
+// Locks the page which the cursor is coupled to. Concurrent readers must
+// not access a node (and its lazily populated caches) without holding
+// the page's lock.
+static inline void
+lock_coupled_page(BtreeCursor *cursor, Context *context)
+{
+  BtreeCursorState &st_ = cursor->st_;
+  if (st_.m_state == BtreeCursor::kStateCoupled) {
+    LocalEnvironment *env = st_.m_parent->ldb()->lenv();
+    env->page_manager()->fetch(context, st_.m_coupled_page->address(),
+                    PageManager::kReadOnly);
+  }
+}
+
+// Fetches the sibling of |page|. |page| is released before the sibling
+// is locked, otherwise readers moving in opposite directions could
+// deadlock.
+static inline Page *
+fetch_sibling(BtreeCursor *cursor, Context *context, LatchCoupling *latches,
+                Page *page, uint64_t sibling)
+{
+  LocalEnvironment *env = cursor->st_.m_parent->ldb()->lenv();
+  latches->release(page);
+  return env->page_manager()->fetch(context, sibling, PageManager::kReadOnly);
+}
+
 // move cursor to the very first key
 static inline ups_status_t
-move_first(BtreeCursor *cursor, Context *context, uint32_t flags)
+move_first(BtreeCursor *cursor, Context *context, LatchCoupling *latches,
+                uint32_t flags)
 {
   BtreeCursorState &st_ = cursor->st_;
   LocalDatabase *db = st_.m_parent->ldb();
@@ -98,6 +131,7 @@ move_first(BtreeCursor *cursor, Context *context, uint32_t flags)
 
   // get a NIL cursor
   cursor->set_to_nil();
+  st_.m_readahead.reset();
 
   // get the root page
   Page *page = env->page_manager()->fetch(context, st_.m_btree->root_address(),
@@ -106,8 +140,10 @@ move_first(BtreeCursor *cursor, Context *context, uint32_t flags)
 
   // traverse down to the leafs
   while (!node->is_leaf()) {
+    Page *parent = page;
     page = env->page_manager()->fetch(context, node->left_child(),
                     PageManager::kReadOnly);
+    latches->release(parent);
     node = st_.m_btree->get_node_from_page(page);
   }
 
@@ -115,8 +151,8 @@ move_first(BtreeCursor *cursor, Context *context, uint32_t flags)
   while (node->length() == 0) {
     if (unlikely(node->right_sibling() == 0))
       return UPS_KEY_NOT_FOUND;
-    page = env->page_manager()->fetch(context, node->right_sibling(),
-                    PageManager::kReadOnly);
+    page = fetch_sibling(cursor, context, latches, page,
+                    node->right_sibling());
     node = st_.m_btree->get_node_from_page(page);
   }
 
@@ -127,7 +163,8 @@ move_first(BtreeCursor *cursor, Context *context, uint32_t flags)
 
 // move cursor to the very last key
 static inline ups_status_t
-move_last(BtreeCursor *cursor, Context *context, uint32_t flags)
+move_last(BtreeCursor *cursor, Context *context, LatchCoupling *latches,
+                uint32_t flags)
 {
   BtreeCursorState &st_ = cursor->st_;
   LocalDatabase *db = st_.m_parent->ldb();
@@ -135,6 +172,7 @@ move_last(BtreeCursor *cursor, Context *context, uint32_t flags)
 
   // get a NIL cursor
   cursor->set_to_nil();
+  st_.m_readahead.reset();
 
   Page *page = env->page_manager()->fetch(context, st_.m_btree->root_address(),
                   PageManager::kReadOnly);
@@ -142,6 +180,7 @@ move_last(BtreeCursor *cursor, Context *context, uint32_t flags)
 
   // traverse down to the leafs
   while (!node->is_leaf()) {
+    Page *parent = page;
     if (unlikely(node->length() == 0))
       page = env->page_manager()->fetch(context, node->left_child(),
                     PageManager::kReadOnly);
@@ -149,6 +188,7 @@ move_last(BtreeCursor *cursor, Context *context, uint32_t flags)
       page = env->page_manager()->fetch(context,
                         node->record_id(context, node->length() - 1),
                         PageManager::kReadOnly);
+    latches->release(parent);
     node = st_.m_btree->get_node_from_page(page);
   }
 
@@ -156,8 +196,8 @@ move_last(BtreeCursor *cursor, Context *context, uint32_t flags)
   while (node->length() == 0) {
     if (unlikely(node->left_sibling() == 0))
       return UPS_KEY_NOT_FOUND;
-    page = env->page_manager()->fetch(context, node->left_sibling(),
-                        PageManager::kReadOnly);
+    page = fetch_sibling(cursor, context, latches, page,
+                    node->left_sibling());
     node = st_.m_btree->get_node_from_page(page);
   }
 
@@ -184,11 +224,10 @@ couple_or_throw(BtreeCursor *cursor, Context *context)
 
 // move cursor to the next key
 static inline ups_status_t
-move_next(BtreeCursor *cursor, Context *context, uint32_t flags)
+move_next(BtreeCursor *cursor, Context *context, LatchCoupling *latches,
+                uint32_t flags)
 {
   BtreeCursorState &st_ = cursor->st_;
-  LocalDatabase *db = st_.m_parent->ldb();
-  LocalEnvironment *env = db->lenv();
 
   // uncoupled cursor: couple it
   couple_or_throw(cursor, context);
@@ -219,8 +258,8 @@ move_next(BtreeCursor *cursor, Context *context, uint32_t flags)
   if (unlikely(!node->right_sibling()))
     return UPS_KEY_NOT_FOUND;
 
-  Page *page = env->page_manager()->fetch(context, node->right_sibling(),
-                    PageManager::kReadOnly);
+  Page *page = fetch_sibling(cursor, context, latches, st_.m_coupled_page,
+                    node->right_sibling());
   node = st_.m_btree->get_node_from_page(page);
 
   // if the right node is empty then continue searching for the next
@@ -228,11 +267,15 @@ move_next(BtreeCursor *cursor, Context *context, uint32_t flags)
   while (node->length() == 0) {
     if (unlikely(!node->right_sibling()))
       return UPS_KEY_NOT_FOUND;
-    page = env->page_manager()->fetch(context, node->right_sibling(),
-                    PageManager::kReadOnly);
+    page = fetch_sibling(cursor, context, latches, page,
+                    node->right_sibling());
     node = st_.m_btree->get_node_from_page(page);
   }
 
+  // read the following leaves ahead if the cursor traverses the leaves
+  // sequentially
+  st_.m_btree->read_ahead(st_.m_readahead, node);
+
   // couple this cursor to the smallest key in this page
   cursor->couple_to_page(page, 0, 0);
 
@@ -241,15 +284,17 @@ move_next(BtreeCursor *cursor, Context *context, uint32_t flags)
 
 // move cursor to the previous key
 static inline ups_status_t
-move_previous(BtreeCursor *cursor, Context *context, uint32_t flags)
+move_previous(BtreeCursor *cursor, Context *context, LatchCoupling *latches,
+                uint32_t flags)
 {
   BtreeCursorState &st_ = cursor->st_;
-  LocalDatabase *db = st_.m_parent->ldb();
-  LocalEnvironment *env = db->lenv();
 
   // uncoupled cursor: couple it
   couple_or_throw(cursor, context);
 
+  // moving backwards is not a sequential scan
+  st_.m_readahead.reset();
+
   BtreeNodeProxy *node = st_.m_btree->get_node_from_page(st_.m_coupled_page);
 
   // if this key has duplicates: get the previous duplicate; otherwise
@@ -272,8 +317,8 @@ move_previous(BtreeCursor *cursor, Context *context, uint32_t flags)
     if (unlikely(!node->left_sibling()))
       return UPS_KEY_NOT_FOUND;
 
-    Page *page = env->page_manager()->fetch(context, node->left_sibling(),
-                    PageManager::kReadOnly);
+    Page *page = fetch_sibling(cursor, context, latches, st_.m_coupled_page,
+                    node->left_sibling());
     node = st_.m_btree->get_node_from_page(page);
 
     // if the left node is empty then continue searching for the next
@@ -281,8 +326,8 @@ move_previous(BtreeCursor *cursor, Context *context, uint32_t flags)
     while (node->length() == 0) {
       if (unlikely(!node->left_sibling()))
         return UPS_KEY_NOT_FOUND;
-      page = env->page_manager()->fetch(context, node->left_sibling(),
-                    PageManager::kReadOnly);
+      page = fetch_sibling(cursor, context, latches, page,
+                    node->left_sibling());
       node = st_.m_btree->get_node_from_page(page);
     }
 
@@ -366,6 +411,7 @@ BtreeCursor::couple_to_page(Page *page, uint32_t index, int duplicate_index)
   st_.m_coupled_page = page;
 
   // add the cursor to the page
+  ScopedSpinlock lock(st_.m_btree->state.cursor_mutex);
   if (page->cursor_list()) {
     st_.m_next_in_page = page->cursor_list();
     st_.m_previous_in_page = 0;
@@ -418,14 +464,19 @@ BtreeCursor::move(Context *context, ups_key_t *key, ByteArray *key_arena,
 {
   ups_status_t st = 0;
 
+  // release pages which are no longer required
+  LatchCoupling latches(&context->changeset);
+  if (NOTSET(flags, UPS_CURSOR_FIRST | UPS_CURSOR_LAST))
+    lock_coupled_page(this, context);
+
   if (ISSET(flags, UPS_CURSOR_FIRST))
-    st = move_first(this, context, flags);
+    st = move_first(this, context, &latches, flags);
   else if (ISSET(flags, UPS_CURSOR_LAST))
-    st = move_last(this, context, flags);
+    st = move_last(this, context, &latches, flags);
   else if (ISSET(flags, UPS_CURSOR_NEXT))
-    st = move_next(this, context, flags);
+    st = move_next(this, context, &latches, flags);
   else if (ISSET(flags, UPS_CURSOR_PREVIOUS))
-    st = move_previous(this, context, flags);
+    st = move_previous(this, context, &latches, flags);
   // no move, but cursor is nil? return error
   else if (unlikely(st_.m_state == kStateNil)) {
     if (key || record)
@@ -460,6 +511,7 @@ BtreeCursor::find(Context *context, ups_key_t *key, ByteArray *key_arena,
                 ups_record_t *record, ByteArray *record_arena, uint32_t flags)
 {
   set_to_nil();
+  st_.m_readahead.reset();
 
   return st_.m_btree->find(context, st_.m_parent, key, key_arena, record,
                           record_arena, flags);
@@ -515,6 +567,8 @@ BtreeCursor::move_to_next_page(Context *context)
 
   Page *page = env->page_manager()->fetch(context, node->right_sibling(),
                         PageManager::kReadOnly);
+  node = st_.m_btree->get_node_from_page(page);
+  st_.m_btree->read_ahead(st_.m_readahead, node);
   couple_to_page(page, 0, 0);
   return 0;
 }
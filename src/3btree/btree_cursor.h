@@ -47,6 +47,7 @@
 // Always verify that a file of level N does not include headers > N!
 #include "1base/dynamic_array.h"
 #include "1base/error.h"
+#include "3page_manager/readahead.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -92,6 +93,9 @@ struct BtreeCursorState
 
   // Linked list of cursors which point to the same page
   BtreeCursor *m_next_in_page, *m_previous_in_page;
+
+  // Detects sequential moves to the right sibling
+  Readahead m_readahead;
 };
 
 
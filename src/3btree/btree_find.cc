@@ -22,6 +22,7 @@
 #include "0root/root.h"
 
 #include <string.h>
+#include <vector>
 
 // Always verify that a file of level N does not include headers > N!
 #include "1base/error.h"
@@ -31,6 +32,7 @@
 #include "3btree/btree_cursor.h"
 #include "3btree/btree_stats.h"
 #include "3btree/btree_node_proxy.h"
+#include "3changeset/changeset.h"
 #include "3page_manager/page_manager.h"
 #include "4cursor/cursor_local.h"
 
@@ -60,6 +62,9 @@ struct BtreeFindAction
     BtreeStatistics *stats = btree->statistics();
     BtreeStatistics::FindHints hints = stats->find_hints(flags);
 
+    // release pages which are no longer required
+    LatchCoupling latches(&context->changeset);
+
     if (hints.try_fast_track) {
       /*
        * see if we get a sure hit within this btree leaf; if not, revert to
@@ -95,6 +100,9 @@ struct BtreeFindAction
     uint32_t is_approx_match = 0;
 
     if (slot == -1) {
+      /* the fast-track page is no longer required */
+      latches.release(page);
+
       /* load the root page */
       page = env->page_manager()->fetch(context, btree->root_address(),
                       PageManager::kReadOnly);
@@ -102,13 +110,16 @@ struct BtreeFindAction
       /* now traverse the root to the leaf nodes till we find a leaf */
       node = btree->get_node_from_page(page);
       while (!node->is_leaf()) {
-        page = btree->find_lower_bound(context, page, key,
+        Page *parent = page;
+        page = btree->find_lower_bound(context, parent, key,
                               PageManager::kReadOnly, 0);
         if (unlikely(!page)) {
           stats->find_failed();
           return UPS_KEY_NOT_FOUND;
         }
 
+        /* the child is locked; now release the parent */
+        latches.release(parent);
         node = btree->get_node_from_page(page);
       }
 
@@ -131,7 +142,9 @@ struct BtreeFindAction
     if (unlikely(slot == -1)) {
       // find the left sibling
       if (node->left_sibling() > 0) {
-        page = env->page_manager()->fetch(context, node->left_sibling(),
+        uint64_t sibling = node->left_sibling();
+        latches.release(page);
+        page = env->page_manager()->fetch(context, sibling,
                         PageManager::kReadOnly);
         node = btree->get_node_from_page(page);
         slot = node->length() - 1;
@@ -141,7 +154,9 @@ struct BtreeFindAction
     else if (unlikely(slot >= (int)node->length())) {
       // find the right sibling
       if (node->right_sibling() > 0) {
-        page = env->page_manager()->fetch(context, node->right_sibling(),
+        uint64_t sibling = node->right_sibling();
+        latches.release(page);
+        page = env->page_manager()->fetch(context, sibling,
                         PageManager::kReadOnly);
         node = btree->get_node_from_page(page);
         slot = 0;
@@ -250,6 +265,171 @@ return_result:
   ByteArray *record_arena;
 };
 
+struct BtreeFindManyAction
+{
+  BtreeFindManyAction(BtreeIndex *btree_, Context *context_, uint32_t count_,
+                  const uint32_t *order_, ups_key_t *keys_,
+                  ups_record_t *records_, ups_status_t *results_,
+                  ByteArray *record_arena_)
+    : btree(btree_), context(context_),
+      page_manager(btree_->db()->lenv()->page_manager()), count(count_),
+      order(order_), keys(keys_), records(records_), results(results_),
+      record_arena(record_arena_), latches(&context_->changeset), leaf(0),
+      next(0) {
+  }
+
+  // This is the entry point for the actual lookup
+  void run() {
+    std::vector<size_t> offsets(count);
+    ByteArray batch;
+    ByteArray scratch;
+
+    // the keys are processed in sorted order; most of them are therefore
+    // found in the same leaf as their predecessor, or in its right sibling
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t index = order[i];
+      ups_record_t *record = &records[index];
+
+      int slot = locate(&keys[index]);
+      if (slot < 0) {
+        results[index] = UPS_KEY_NOT_FOUND;
+        continue;
+      }
+
+      // records which are not allocated by the caller are collected in a
+      // temporary buffer; their pointers are assigned when the buffer
+      // no longer grows
+      BtreeNodeProxy *node = btree->get_node_from_page(leaf);
+      node->record(context, slot, &scratch, record, 0);
+      if (NOTSET(record->flags, UPS_RECORD_USER_ALLOC))
+        offsets[index] = batch.append((uint8_t *)record->data, record->size);
+      results[index] = 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+      ups_record_t *record = &records[i];
+      if (results[i] == 0 && NOTSET(record->flags, UPS_RECORD_USER_ALLOC))
+        record->data = record->size ? batch.data() + offsets[i] : 0;
+    }
+    record_arena->assign(batch.data(), batch.size());
+    batch.disown();
+  }
+
+  // Moves to the leaf which would store |key|, and returns the slot of the
+  // key in that leaf, or -1 if the key does not exist. The current leaf
+  // (and its right sibling) are re-used if possible; otherwise the tree
+  // is traversed from the root.
+  int locate(ups_key_t *key) {
+    if (leaf) {
+      BtreeNodeProxy *node = btree->get_node_from_page(leaf);
+      int length = (int)node->length();
+      if (length > 0 && node->compare(context, key, 0) >= 0) {
+        if (node->compare(context, key, length - 1) <= 0)
+          return node->find(context, key);
+
+        // the key is larger than all keys of this leaf; if there is no
+        // sibling then the key does not exist
+        uint64_t sibling = node->right_sibling();
+        if (!sibling)
+          return -1;
+
+        if (!next || next->address() != sibling) {
+          latches.release(next);
+          next = page_manager->fetch(context, sibling,
+                          PageManager::kReadOnly);
+        }
+        node = btree->get_node_from_page(next);
+        length = (int)node->length();
+        if (length > 0) {
+          // the key is between the two leaves: it does not exist
+          if (node->compare(context, key, 0) < 0)
+            return -1;
+          if (node->compare(context, key, length - 1) <= 0) {
+            latches.release(leaf);
+            leaf = next;
+            next = 0;
+            prefetch_sibling();
+            return node->find(context, key);
+          }
+        }
+      }
+    }
+
+    // otherwise traverse the tree from the root to the leaf
+    latches.release(leaf);
+    latches.release(next);
+    next = 0;
+
+    leaf = page_manager->fetch(context, btree->root_address(),
+                    PageManager::kReadOnly);
+    BtreeNodeProxy *node = btree->get_node_from_page(leaf);
+    while (!node->is_leaf()) {
+      Page *parent = leaf;
+      leaf = btree->find_lower_bound(context, parent, key,
+                      PageManager::kReadOnly, 0);
+      latches.release(parent);
+      node = btree->get_node_from_page(leaf);
+    }
+
+    prefetch_sibling();
+    return node->find(context, key);
+  }
+
+  // Fetches the right sibling of the current leaf if it is cached, and
+  // prefetches the start of its payload (node header and key index)
+  // into the CPU cache; the next keys of the batch are likely stored
+  // in that page.
+  void prefetch_sibling() {
+    uint64_t sibling = btree->get_node_from_page(leaf)->right_sibling();
+    if (!sibling)
+      return;
+
+    next = page_manager->fetch(context, sibling,
+                    PageManager::kOnlyFromCache | PageManager::kReadOnly);
+    if (next) {
+      uint8_t *p = next->payload();
+      for (int i = 0; i < 4; i++)
+        UPS_PREFETCH(p + i * 64);
+    }
+  }
+
+  // the current btree
+  BtreeIndex *btree;
+
+  // The caller's Context
+  Context *context;
+
+  // The Environment's page manager
+  PageManager *page_manager;
+
+  // The number of keys
+  uint32_t count;
+
+  // The indices of the keys, in sorted order
+  const uint32_t *order;
+
+  // The keys that are looked up
+  ups_key_t *keys;
+
+  // The records that are retrieved
+  ups_record_t *records;
+
+  // The status of each lookup
+  ups_status_t *results;
+
+  // allocator for the record data
+  ByteArray *record_arena;
+
+  // releases pages which are no longer required
+  LatchCoupling latches;
+
+  // The current leaf
+  Page *leaf;
+
+  // The right sibling of the current leaf, if it was already fetched
+  Page *next;
+};
+
 ups_status_t
 BtreeIndex::find(Context *context, LocalCursor *cursor, ups_key_t *key,
               ByteArray *key_arena, ups_record_t *record,
@@ -261,5 +441,14 @@ BtreeIndex::find(Context *context, LocalCursor *cursor, ups_key_t *key,
   return bfa.run();
 }
 
-} // namespace upscaledb
+void
+BtreeIndex::find_many(Context *context, uint32_t count, const uint32_t *order,
+                ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+                ByteArray *record_arena)
+{
+  BtreeFindManyAction bfma(this, context, count, order, keys, records,
+                  results, record_arena);
+  bfma.run();
+}
 
+} // namespace upscaledb
@@ -396,6 +396,11 @@ class BaseNodeImpl
       records.fill_metrics(metrics, node_length);
     }
 
+    // Collects the ids of the blobs which store the records
+    void blob_ids(std::vector<uint64_t> &ids, size_t node_length) const {
+      records.blob_ids(ids, node_length);
+    }
+
     // Prints a slot to stdout (for debugging)
     void print(Context *context, int slot) {
       std::stringstream ss;
@@ -99,6 +99,14 @@ BtreeIndex::persist_configuration(Context *context, const DbConfig *dbconfig)
   state.btree_header->set_key_compression(dbconfig->key_compressor);
 }
 
+void
+BtreeIndex::read_ahead(Readahead &readahead, BtreeNodeProxy *node)
+{
+  size_t count = readahead.advance();
+  if (count > 0 && node->right_sibling() != 0)
+    state.page_manager->prefetch(state.db, node->right_sibling(), count);
+}
+
 Page *
 BtreeIndex::find_lower_bound(Context *context, Page *page, const ups_key_t *key,
                 uint32_t page_manager_flags, int *idxptr)
@@ -21,11 +21,13 @@
 #include "0root/root.h"
 
 #include <algorithm>
+#include <vector>
 
 // Always verify that a file of level N does not include headers > N!
 #include "1base/abi.h"
 #include "1base/dynamic_array.h"
 #include "1base/scoped_ptr.h"
+#include "1base/spinlock.h"
 #include "1globals/globals.h"
 #include "3btree/btree_cursor.h"
 #include "3btree/btree_stats.h"
@@ -114,6 +116,8 @@ class LocalDatabase;
 struct BtreeNodeProxy;
 struct PDupeEntry;
 struct BtreeVisitor;
+struct ScanVisitor;
+struct SelectStatement;
 
 //
 // Abstract base class, overwritten by a templated version
@@ -159,6 +163,23 @@ struct BtreeIndexState
 
   // the btree statistics
   BtreeStatistics statistics;
+
+  // protects the per-page lists of coupled cursors
+  Spinlock cursor_mutex;
+};
+
+//
+// A sorted sequence of key/record pairs; the input of
+// BtreeIndex::bulk_load()
+//
+struct BtreeBulkLoadSource
+{
+  // virtual destructor
+  virtual ~BtreeBulkLoadSource() { }
+
+  // Retrieves the next key/record pair. Returns false at the end of the
+  // sequence, throws an Exception on error.
+  virtual bool next(ups_key_t *key, ups_record_t *record) = 0;
 };
 
 //
@@ -223,6 +244,14 @@ struct BtreeIndex
                   ByteArray *key_arena, ups_record_t *record,
                   ByteArray *record_arena, uint32_t flags);
 
+  // Looks up a batch of |count| keys (ups_db_find_many). |order| contains
+  // the indices of the keys in sorted order. The status of each key is
+  // stored in |results|. Records which are not allocated by the caller
+  // are stored in |record_arena|.
+  void find_many(Context *context, uint32_t count, const uint32_t *order,
+                  ups_key_t *keys, ups_record_t *records,
+                  ups_status_t *results, ByteArray *record_arena);
+
   // Inserts (or updates) a key/record in the index (ups_db_insert)
   ups_status_t insert(Context *context, LocalCursor *cursor, ups_key_t *key,
                   ups_record_t *record, uint32_t flags);
@@ -233,10 +262,33 @@ struct BtreeIndex
   ups_status_t erase(Context *context, LocalCursor *cursor, ups_key_t *key,
                   int duplicate_index, uint32_t flags);
 
+  // Builds the btree bottom-up from the sorted key/record pairs of
+  // |source|; the btree must be empty. Leaf nodes are filled up to
+  // |fill_factor| percent. Returns the number of loaded pairs.
+  uint64_t bulk_load(Context *context, BtreeBulkLoadSource &source,
+                  uint32_t fill_factor);
+
   // Iterates over the whole index and calls |visitor| on every node
   void visit_nodes(Context *context, BtreeVisitor &visitor,
                   bool visit_internal_nodes);
 
+  // Splits the leaf level into (up to) |count| ranges of adjacent leaves
+  // which can be scanned independently. Stores the address of the first
+  // leaf of each range in |ranges|; each range ends where the next one
+  // starts.
+  void partition_leaves(Context *context, size_t count,
+                  std::vector<uint64_t> &ranges);
+
+  // Calls |visitor| on all keys of the leaves from |first| up to (but
+  // excluding) |last|; if |last| is 0 then the scan continues till the
+  // end of the leaf level. Used by concurrent readers.
+  void scan_leaves(Context *context, uint64_t first, uint64_t last,
+                  ScanVisitor *visitor, SelectStatement *statement);
+
+  // Reads the leaves following |node| ahead if |readahead| detects a
+  // sequential scan; called whenever a scan moves to the right sibling
+  void read_ahead(Readahead &readahead, BtreeNodeProxy *node);
+
   // Checks the integrity of the btree (ups_db_check_integrity)
   void check_integrity(Context *context, uint32_t flags);
 
@@ -21,12 +21,14 @@
 #include "0root/root.h"
 
 // Always verify that a file of level N does not include headers > N!
+#include "2compressor/compressor_factory.h"
 #include "3btree/btree_index.h"
 #include "3btree/btree_impl_default.h"
 #include "3btree/btree_impl_pax.h"
 #include "3btree/btree_keys_pod.h"
 #include "3btree/btree_keys_binary.h"
 #include "3btree/btree_keys_varlen.h"
+#include "3btree/btree_keys_prefix.h"
 #include "3btree/btree_zint32_groupvarint.h"
 #include "3btree/btree_zint32_maskedvbyte.h"
 #include "3btree/btree_zint32_simdcomp.h"
@@ -34,6 +36,7 @@
 #include "3btree/btree_zint32_simdfor.h"
 #include "3btree/btree_zint32_streamvbyte.h"
 #include "3btree/btree_zint32_varbyte.h"
+#include "3btree/btree_zint64.h"
 #include "3btree/btree_records_default.h"
 #include "3btree/btree_records_inline.h"
 #include "3btree/btree_records_internal.h"
@@ -192,6 +195,10 @@ struct BtreeIndexFactory
       case UPS_TYPE_UINT32:
         if (!is_leaf)
           PAX_INTERNAL_NUMERIC(uint32_t);
+        // the SIMD codecs are not supported by every CPU
+        if (key_compression != UPS_COMPRESSOR_NONE
+              && !CompressorFactory::is_available(key_compression))
+          throw Exception(UPS_INV_PARAMETER);
         switch (key_compression) {
           case UPS_COMPRESSOR_UINT32_VARBYTE:
             PAX_LEAF_NODE(Zint32::VarbyteKeyList, NumericCompare<uint32_t>);
@@ -231,7 +238,15 @@ struct BtreeIndexFactory
       case UPS_TYPE_UINT64:
         if (!is_leaf)
           PAX_INTERNAL_NUMERIC(uint64_t);
-        PAX_LEAF_NUMERIC(uint64_t);
+        switch (key_compression) {
+          case UPS_COMPRESSOR_UINT64_VARBYTE:
+            PAX_LEAF_NODE(Zint64::VarbyteKeyList, NumericCompare<uint64_t>);
+          case UPS_COMPRESSOR_UINT64_FOR:
+            PAX_LEAF_NODE(Zint64::ForKeyList, NumericCompare<uint64_t>);
+          default:
+            // no key compression
+            PAX_LEAF_NUMERIC(uint64_t);
+        }
       // 32bit float
       case UPS_TYPE_REAL32:
         if (!is_leaf)
@@ -268,6 +283,14 @@ struct BtreeIndexFactory
                     FixedSizeCompare);
         } // fixed keys
 
+        // variable length keys with prefix compression
+        if (key_compression == UPS_COMPRESSOR_PREFIX) {
+          if (!is_leaf)
+            DEF_INTERNAL_NODE(DefLayout::PrefixKeyList, VariableSizeCompare);
+          LEAF_NODE_IMPL(DefaultNodeImpl, DefLayout::PrefixKeyList,
+                    VariableSizeCompare);
+        }
+
         // variable length keys, with and without duplicates
         if (!is_leaf)
           DEF_INTERNAL_NODE(DefLayout::VariableLengthKeyList,
@@ -82,6 +82,11 @@ struct BtreeInsertAction : public BtreeUpdateAction
       if (unlikely(st == UPS_LIMITS_REACHED))
         st = insert();
     }
+    else if (hints.leaf_page_addr) {
+      st = insert_in_hinted_leaf();
+      if (unlikely(st == UPS_LIMITS_REACHED))
+        st = insert();
+    }
     else {
       st = insert();
     }
@@ -165,6 +170,31 @@ struct BtreeInsertAction : public BtreeUpdateAction
     return insert();
   }
 
+  // Inserts the key in the leaf of the previous insert operations if the
+  // key is between the smallest and the largest key of that leaf; then it
+  // cannot belong to any other leaf. This is the common case when sorted
+  // batches of keys are inserted (ups_db_insert_many).
+  ups_status_t insert_in_hinted_leaf() {
+    LocalEnvironment *env = btree->db()->lenv();
+
+    Page *page = env->page_manager()->fetch(context, hints.leaf_page_addr,
+                    PageManager::kOnlyFromCache);
+    /* if the page is not in cache: do a regular insert */
+    if (!page)
+      return insert();
+
+    BtreeNodeProxy *node = btree->get_node_from_page(page);
+    assert(node->is_leaf());
+
+    if (node->length() < 2
+            || node->requires_split(context, key)
+            || node->compare(context, key, 0) < 0
+            || node->compare(context, key, node->length() - 1) > 0)
+      return insert();
+
+    return insert_in_page(page, key, record, hints);
+  }
+
   ups_status_t insert() {
     // traverse the tree till a leaf is reached
     Page *parent;
@@ -112,7 +112,7 @@ class PodKeyList : public BaseKeyList
     template<typename Cmp>
     int find(Context *context, size_t node_count, const ups_key_t *key,
                     Cmp &comparator) {
-      return (find_simd_sse<T>(node_count, &m_data[0], key));
+      return (find_simd<T>(node_count, &m_data[0], key));
     }
 #else
     template<typename Cmp>
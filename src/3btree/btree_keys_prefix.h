@@ -0,0 +1,797 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * Prefix-compressed variable length KeyList (UPS_COMPRESSOR_PREFIX)
+ *
+ * Works like the VariableLengthKeyList, but the bytes which are shared by
+ * all keys of a node are stored only once, in a small header in front of
+ * the UpfrontIndex. The chunks only store the remaining suffixes.
+ *
+ * A key which is inserted, but does not start with the node's prefix, is
+ * stored in full and flagged with |kFullKey|. The prefix is recalculated
+ * whenever the node is rewritten (i.e. when it is split, merged or
+ * vacuumized).
+ *
+ * Lookups compare the search key against the prefix only once; afterwards
+ * the binary search compares the suffixes, without re-assembling the
+ * full keys.
+ *
+ * This KeyList relies on a lexicographical (memcmp-based) sort order and
+ * therefore is only used for UPS_TYPE_BINARY keys.
+ */
+
+#ifndef UPS_BTREE_KEYS_PREFIX_H
+#define UPS_BTREE_KEYS_PREFIX_H
+
+#include "0root/root.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <map>
+
+// Always verify that a file of level N does not include headers > N!
+#include "1globals/globals.h"
+#include "1base/dynamic_array.h"
+#include "1base/scoped_ptr.h"
+#include "2page/page.h"
+#include "3blob_manager/blob_manager.h"
+#include "3btree/btree_node.h"
+#include "3btree/btree_index.h"
+#include "3btree/upfront_index.h"
+#include "3btree/btree_keys_base.h"
+#include "4env/env_local.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+namespace DefLayout {
+
+//
+// Variable length keys with a per-node prefix
+//
+// The format of the range is:
+//   |PrefixSize|Prefix...|UpfrontIndex...|
+// where PrefixSize is 8 bit. The space for the prefix is reserved, even
+// if the prefix is shorter.
+//
+// The format of a single key is:
+//   |Flags|Suffix...|
+// where Flags are 8 bit. If |kFullKey| is set then the chunk stores the
+// full key, otherwise the full key is |Prefix + Suffix|. Extended keys are
+// always stored in full in their blob.
+//
+class PrefixKeyList : public BaseKeyList
+{
+    // for caching external keys
+    typedef std::map<uint64_t, ByteArray> ExtKeyCache;
+
+    // Describes a (full) key while the node is rewritten; the key data is
+    // stored in a separate buffer
+    struct Entry {
+      // the key flags (only |BtreeKey::kExtendedKey| is relevant)
+      uint8_t flags;
+
+      // offset of the data in the buffer
+      uint32_t offset;
+
+      // size of the data; for extended keys this is the size of the blob id
+      uint32_t size;
+    };
+
+  public:
+    enum {
+      // A flag whether this KeyList has sequential data
+      kHasSequentialData = 0,
+
+      // A flag whether this KeyList supports the scan() call
+      kSupportsBlockScans = 0,
+
+      // This KeyList can reduce its capacity in order to release storage
+      kCanReduceCapacity = 1,
+
+      // This KeyList has a custom find() implementation
+      kCustomFind = 1,
+
+      // This KeyList has a custom find_lower_bound() implementation
+      kCustomFindLowerBound = 1,
+
+      // Key flag: the chunk stores the full key, not just the suffix
+      kFullKey = 0x80
+    };
+
+    // Constructor
+    PrefixKeyList(LocalDatabase *db)
+      : m_db(db), m_index(db), m_data(0) {
+      size_t page_size = db->lenv()->config().page_size_bytes;
+      if (Globals::ms_extended_threshold)
+        m_extkey_threshold = Globals::ms_extended_threshold;
+      else {
+        if (page_size == 1024)
+          m_extkey_threshold = 64;
+        else if (page_size <= 1024 * 8)
+          m_extkey_threshold = 128;
+        else {
+          // UpfrontIndex's chunk size has 8 bit (max 255), and reserve
+          // a few bytes for metadata (flags)
+          m_extkey_threshold = 250;
+        }
+      }
+
+      // the prefix never exceeds half of the maximum inline key
+      m_max_prefix_size = std::min(m_extkey_threshold / 2, (size_t)255);
+      m_header_size = 1 + m_max_prefix_size;
+    }
+
+    // Creates a new KeyList starting at |ptr|, total size is
+    // |range_size| (in bytes)
+    void create(uint8_t *data, size_t range_size) {
+      m_data = data;
+      m_range_size = range_size;
+      m_data[0] = 0;
+      m_index.create(m_data + m_header_size, range_size - m_header_size,
+                      (range_size - m_header_size) / get_full_key_size());
+    }
+
+    // Opens an existing KeyList
+    void open(uint8_t *data, size_t range_size, size_t node_count) {
+      m_data = data;
+      m_range_size = range_size;
+      m_index.open(m_data + m_header_size, range_size - m_header_size);
+    }
+
+    // Calculates the required size for a range
+    size_t get_required_range_size(size_t node_count) const {
+      return (m_header_size + m_index.get_required_range_size(node_count));
+    }
+
+    // Returns the actual key size including overhead. This is an estimate
+    // since we don't know how large the keys will be
+    size_t get_full_key_size(const ups_key_t *key = 0) const {
+      if (!key)
+        return (24 + m_index.get_full_index_size() + 1);
+      // always make sure to have enough space for an extkey id
+      if (key->size < 8 || key->size > m_extkey_threshold)
+        return (sizeof(uint64_t) + m_index.get_full_index_size() + 1);
+      return (key->size + m_index.get_full_index_size() + 1);
+    }
+
+    // Copies a key into |dest|. Keys which are stored as suffixes are
+    // assembled in |arena|, even if |deep_copy| is false.
+    void get_key(Context *context, int slot, ByteArray *arena, ups_key_t *dest,
+                    bool deep_copy = true) {
+      uint8_t *p = get_chunk(slot);
+      ups_key_t tmp = {0};
+
+      if (unlikely(*p & BtreeKey::kExtendedKey)) {
+        get_extended_key(context, get_extended_blob_id(slot), &tmp);
+      }
+      else if ((*p & kFullKey) || get_prefix_size() == 0) {
+        tmp.size = get_key_size(slot);
+        tmp.data = p + 1;
+      }
+      else {
+        size_t prefix_size = get_prefix_size();
+        size_t suffix_size = get_key_size(slot);
+        dest->size = (uint16_t)(prefix_size + suffix_size);
+        if (!deep_copy || !(dest->flags & UPS_KEY_USER_ALLOC)) {
+          arena->resize(dest->size);
+          dest->data = arena->data();
+        }
+        ::memcpy(dest->data, get_prefix(), prefix_size);
+        ::memcpy((uint8_t *)dest->data + prefix_size, p + 1, suffix_size);
+        return;
+      }
+
+      dest->size = tmp.size;
+
+      if (likely(deep_copy == false)) {
+        dest->data = tmp.data;
+        return;
+      }
+
+      // allocate memory (if required)
+      if (!(dest->flags & UPS_KEY_USER_ALLOC)) {
+        arena->resize(tmp.size);
+        dest->data = arena->data();
+      }
+      ::memcpy(dest->data, tmp.data, tmp.size);
+    }
+
+    // Iterates all keys, calls the |visitor| on each. Not supported by
+    // this KeyList implementation (see VariableLengthKeyList).
+    ScanResult scan(ByteArray *arena, size_t node_count, uint32_t start) {
+      assert(!"shouldn't be here");
+      throw Exception(UPS_INTERNAL_ERROR);
+    }
+
+    // Performs a lower-bound search for a key. The search key is compared
+    // against the node's prefix only once; afterwards only the suffixes
+    // are compared.
+    template<typename Cmp>
+    int find_lower_bound(Context *context, size_t node_count,
+                    const ups_key_t *hkey, Cmp &comparator, int *pcmp) {
+      int prefix_cmp = compare_prefix(hkey);
+
+      int right = (int)node_count;
+      int left = 0;
+      int last = right + 1;
+
+      *pcmp = -1;
+
+      while (right - left > 0) {
+        // get the median item; if it's identical with the "last" item,
+        // we've found the slot
+        int middle = (left + right) / 2;
+
+        if (middle == last) {
+          *pcmp = 1;
+          return middle;
+        }
+
+        // compare it against the key
+        *pcmp = compare(context, hkey, prefix_cmp, middle, comparator);
+
+        // found it?
+        if (*pcmp == 0)
+          return middle;
+
+        // if the key is bigger than the item: search "to the left"
+        if (*pcmp < 0) {
+          if (right == 0) {
+            assert(middle == 0);
+            return -1;
+          }
+          right = middle;
+        }
+        // otherwise search "to the right"
+        else {
+          last = middle;
+          left = middle;
+        }
+      }
+
+      return -1;
+    }
+
+    // Finds a key
+    template<typename Cmp>
+    int find(Context *context, size_t node_count, const ups_key_t *hkey,
+                    Cmp &comparator) {
+      int cmp = 0;
+      int slot = find_lower_bound(context, node_count, hkey, comparator, &cmp);
+      if (slot == -1 || cmp != 0)
+        return -1;
+      return slot;
+    }
+
+    // Erases a key's payload. Does NOT remove the chunk from the UpfrontIndex
+    // (see |erase()|).
+    void erase_extended_key(Context *context, int slot) {
+      uint8_t flags = get_key_flags(slot);
+      if (flags & BtreeKey::kExtendedKey) {
+        // delete the extended key from the cache
+        erase_extended_key(context, get_extended_blob_id(slot));
+        // and transform into a key which is non-extended and occupies
+        // the same space as before, when it was extended
+        set_key_flags(slot, (flags & (~BtreeKey::kExtendedKey)) | kFullKey);
+        set_key_size(slot, sizeof(uint64_t));
+      }
+    }
+
+    // Erases a key, including extended blobs
+    void erase(Context *context, size_t node_count, int slot) {
+      erase_extended_key(context, slot);
+      m_index.erase(node_count, slot);
+    }
+
+    // Inserts the |key| at the position identified by |slot|.
+    // This method cannot fail; there MUST be sufficient free space in the
+    // node (otherwise the caller would have split the node).
+    template<typename Cmp>
+    PBtreeNode::InsertResult insert(Context *context, size_t node_count,
+                                const ups_key_t *key, uint32_t flags,
+                                Cmp &comparator, int slot) {
+      m_index.insert(node_count, slot);
+
+      // now there's one additional slot
+      node_count++;
+
+      if (key->size <= m_extkey_threshold) {
+        const uint8_t *data = (const uint8_t *)key->data;
+        size_t size = key->size;
+        uint8_t key_flags = 0;
+        if (shares_prefix(key)) {
+          data += get_prefix_size();
+          size -= get_prefix_size();
+        }
+        else
+          key_flags = kFullKey;
+
+        // When inserting the data: always add 1 byte for key flags
+        if (m_index.can_allocate_space(node_count, size + 1)) {
+          uint32_t offset = m_index.allocate_space(node_count, slot, size + 1);
+          uint8_t *p = m_index.get_chunk_data_by_offset(offset);
+          *p = key_flags;
+          ::memcpy(p + 1, data, size);
+
+          Globals::ms_bytes_before_compression += key->size;
+          Globals::ms_bytes_after_compression += size;
+          return (PBtreeNode::InsertResult(0, slot));
+        }
+      }
+
+      uint64_t blob_id = add_extended_key(context, key);
+      m_index.allocate_space(node_count, slot, 8 + 1);
+      set_extended_blob_id(slot, blob_id);
+      set_key_flags(slot, BtreeKey::kExtendedKey);
+
+      return (PBtreeNode::InsertResult(0, slot));
+    }
+
+    // Returns true if the |key| no longer fits into the node and a split
+    // is required. Makes sure that there is ALWAYS enough headroom
+    // for an extended key!
+    //
+    // If there's no key specified then always assume the worst case and
+    // pretend that the key has the maximum length
+    bool requires_split(size_t node_count, const ups_key_t *key) {
+      size_t required;
+      if (key) {
+        // add 1 byte for flags
+        required = key->size + 1;
+        if (shares_prefix(key))
+          required -= get_prefix_size();
+        if (key->size > m_extkey_threshold || required < 8 + 1)
+          required = 8 + 1;
+      }
+      else
+        required = m_extkey_threshold + 1;
+      return (m_index.requires_split(node_count, required));
+    }
+
+    // Copies |count| key from this[sstart] to dest[dstart]. The keys of
+    // |dest| are rewritten, and a new prefix is calculated.
+    void copy_to(int sstart, size_t node_count, PrefixKeyList &dest,
+                    size_t other_node_count, int dstart) {
+      assert(node_count - sstart > 0);
+      assert((size_t)dstart == other_node_count);
+
+      std::vector<Entry> entries;
+      ByteArray buffer;
+      dest.collect(0, other_node_count, entries, buffer);
+      collect(sstart, node_count, entries, buffer);
+
+      // make sure that the other node has sufficient capacity in its
+      // UpfrontIndex
+      size_t capacity = std::max(m_index.get_capacity(), entries.size());
+      dest.rewrite(entries, buffer, capacity, this);
+
+      // A lot of keys will be invalidated after copying, therefore make
+      // sure that the next_offset is recalculated when it's required
+      m_index.invalidate_next_offset();
+    }
+
+    // Checks the integrity of this node. Throws an exception if there is a
+    // violation.
+    void check_integrity(Context *context, size_t node_count) const {
+      ByteArray arena;
+
+      if (get_prefix_size() > m_max_prefix_size) {
+        ups_log(("prefix size %d exceeds the limit", (int)get_prefix_size()));
+        throw Exception(UPS_INTEGRITY_VIOLATED);
+      }
+
+      // verify that the offsets and sizes are not overlapping
+      m_index.check_integrity(node_count);
+
+      // make sure that extkeys are handled correctly
+      for (size_t i = 0; i < node_count; i++) {
+        if (get_key_size(i) > m_extkey_threshold
+            && !(get_key_flags(i) & BtreeKey::kExtendedKey)) {
+          ups_log(("key size %d, but key is not extended", get_key_size(i)));
+          throw Exception(UPS_INTEGRITY_VIOLATED);
+        }
+
+        if (get_key_flags(i) & BtreeKey::kExtendedKey) {
+          uint64_t blobid = get_extended_blob_id(i);
+          if (!blobid) {
+            ups_log(("integrity check failed: item %u "
+                    "is extended, but has no blob", i));
+            throw Exception(UPS_INTEGRITY_VIOLATED);
+          }
+
+          // make sure that the extended blob can be loaded
+          ups_record_t record = {0};
+          m_db->lenv()->blob_manager()->read(context, blobid,
+                          &record, 0, &arena);
+        }
+      }
+    }
+
+    // Rearranges the list. If |force| is true then the node is rewritten
+    // and the prefix is recalculated.
+    void vacuumize(size_t node_count, bool force) {
+      if (!force) {
+        m_index.maybe_vacuumize(node_count);
+        return;
+      }
+
+      std::vector<Entry> entries;
+      ByteArray buffer;
+      collect(0, node_count, entries, buffer);
+      rewrite(entries, buffer, m_index.get_capacity(), this);
+    }
+
+    // Change the range size; the capacity will be adjusted, the data is
+    // copied as necessary
+    void change_range_size(size_t node_count, uint8_t *new_data_ptr,
+            size_t new_range_size, size_t capacity_hint) {
+      if (!new_data_ptr)
+        new_data_ptr = m_data;
+      if (!new_range_size)
+        new_range_size = m_range_size;
+      size_t index_range_size = new_range_size - m_header_size;
+
+      // no capacity given? then try to find a good default one
+      if (capacity_hint == 0) {
+        capacity_hint = (index_range_size - m_index.get_next_offset(node_count)
+                - get_full_key_size()) / m_index.get_full_index_size();
+        if (capacity_hint <= node_count)
+          capacity_hint = node_count + 1;
+      }
+
+      // if there's not enough space for the new capacity then try to reduce
+      // the capacity
+      if (m_index.get_next_offset(node_count) + get_full_key_size(0)
+                      + capacity_hint * m_index.get_full_index_size()
+                      + UpfrontIndex::kPayloadOffset
+                > index_range_size)
+        capacity_hint = node_count + 1;
+
+      // the header is restored after the index was moved, because both
+      // ranges can overlap
+      ByteArray header;
+      header.copy(m_data, m_header_size);
+
+      m_index.change_range_size(node_count, new_data_ptr + m_header_size,
+                      index_range_size, capacity_hint);
+      ::memcpy(new_data_ptr, header.data(), m_header_size);
+      m_data = new_data_ptr;
+      m_range_size = new_range_size;
+    }
+
+    // Fills the btree_metrics structure
+    void fill_metrics(btree_metrics_t *metrics, size_t node_count) {
+      BaseKeyList::fill_metrics(metrics, node_count);
+      BtreeStatistics::update_min_max_avg(&metrics->keylist_index,
+              (uint32_t)(m_index.get_capacity()
+                    * m_index.get_full_index_size()));
+      BtreeStatistics::update_min_max_avg(&metrics->keylist_unused,
+              m_range_size - (uint32_t)get_required_range_size(node_count));
+    }
+
+    // Prints a slot to |out| (for debugging)
+    void print(Context *context, int slot, std::stringstream &out) {
+      ByteArray arena;
+      ups_key_t tmp = {0};
+      get_key(context, slot, &arena, &tmp, false);
+      out << std::string((const char *)tmp.data, tmp.size);
+    }
+
+    // Returns the pointer to a key's inline data (const flavour)
+    uint8_t *get_key_data(int slot) const {
+      return (get_chunk(slot) + 1);
+    }
+
+    // Returns the size of a key's inline data
+    size_t get_key_size(int slot) const {
+      return (m_index.get_chunk_size(slot) - 1);
+    }
+
+    // Returns the size of the node's prefix
+    size_t get_prefix_size() const {
+      return (m_data[0]);
+    }
+
+    // Returns a pointer to the node's prefix
+    const uint8_t *get_prefix() const {
+      return (m_data + 1);
+    }
+
+  private:
+    // Returns a pointer to the chunk of a key
+    uint8_t *get_chunk(int slot) const {
+      return (m_index.get_chunk_data_by_offset(m_index.get_chunk_offset(slot)));
+    }
+
+    // Returns true if |key| starts with the node's prefix
+    bool shares_prefix(const ups_key_t *key) const {
+      size_t prefix_size = get_prefix_size();
+      return (key->size >= prefix_size
+                && !::memcmp(key->data, get_prefix(), prefix_size));
+    }
+
+    // Compares the search key |hkey| against the node's prefix. Returns 0
+    // if |hkey| starts with the prefix. Otherwise the result is the result
+    // of comparing |hkey| with each key which shares the prefix.
+    int compare_prefix(const ups_key_t *hkey) const {
+      size_t prefix_size = get_prefix_size();
+      if (hkey->size >= prefix_size)
+        return (::memcmp(hkey->data, get_prefix(), prefix_size));
+      int m = ::memcmp(hkey->data, get_prefix(), hkey->size);
+      return (m ? m : -1);
+    }
+
+    // Compares the search key |hkey| with the key at |slot|; |prefix_cmp|
+    // is the result of |compare_prefix()|
+    template<typename Cmp>
+    int compare(Context *context, const ups_key_t *hkey, int prefix_cmp,
+                    int slot, Cmp &comparator) {
+      uint8_t *p = get_chunk(slot);
+
+      if (unlikely(*p & BtreeKey::kExtendedKey)) {
+        ups_key_t tmp = {0};
+        get_extended_key(context, get_extended_blob_id(slot), &tmp);
+        return (comparator(hkey->data, hkey->size, tmp.data, tmp.size));
+      }
+
+      if (unlikely(*p & kFullKey))
+        return (comparator(hkey->data, hkey->size, p + 1, get_key_size(slot)));
+
+      if (prefix_cmp != 0)
+        return (prefix_cmp);
+
+      size_t prefix_size = get_prefix_size();
+      return (comparator((const uint8_t *)hkey->data + prefix_size,
+                              hkey->size - prefix_size,
+                              p + 1, get_key_size(slot)));
+    }
+
+    // Appends the full keys of the slots [start, end) to |entries|;
+    // the key data is appended to |buffer|
+    void collect(size_t start, size_t end, std::vector<Entry> &entries,
+                    ByteArray &buffer) const {
+      for (size_t i = start; i < end; i++) {
+        uint8_t *p = get_chunk(i);
+        Entry e;
+        e.offset = buffer.size();
+        e.size = get_key_size(i);
+        if (*p & BtreeKey::kExtendedKey) {
+          e.flags = BtreeKey::kExtendedKey;
+          buffer.append(p + 1, e.size);
+        }
+        else {
+          e.flags = 0;
+          if (!(*p & kFullKey) && get_prefix_size() > 0) {
+            buffer.append(get_prefix(), get_prefix_size());
+            e.size += get_prefix_size();
+          }
+          buffer.append(p + 1, get_key_size(i));
+        }
+        entries.push_back(e);
+      }
+    }
+
+    // Returns the number of bytes which are required to store the
+    // inline keys of |entries| if |prefix| is the node's prefix
+    static size_t encoded_size(const std::vector<Entry> &entries,
+                    const uint8_t *buffer, const uint8_t *prefix,
+                    size_t prefix_size) {
+      size_t size = 0;
+      for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        size += e.size;
+        if (!(e.flags & BtreeKey::kExtendedKey)
+              && e.size >= prefix_size
+              && !::memcmp(buffer + e.offset, prefix, prefix_size))
+          size -= prefix_size;
+      }
+      return (size);
+    }
+
+    // Rewrites the whole node with the keys in |entries|. The new prefix
+    // is the longest prefix of all inline keys, unless the current prefix
+    // (of this node or of |other|) requires less space; a shorter prefix
+    // can increase the size of the keys, and then they might no longer fit.
+    void rewrite(const std::vector<Entry> &entries, ByteArray &buffer,
+                    size_t capacity, const PrefixKeyList *other) {
+      const uint8_t *data = buffer.data();
+
+      // calculate the longest common prefix of all inline keys
+      const uint8_t *lcp = 0;
+      size_t lcp_size = 0;
+      for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        if (e.flags & BtreeKey::kExtendedKey)
+          continue;
+        if (!lcp) {
+          lcp = data + e.offset;
+          lcp_size = std::min((size_t)e.size, m_max_prefix_size);
+          continue;
+        }
+        size_t j = 0;
+        size_t max = std::min(lcp_size, (size_t)e.size);
+        while (j < max && lcp[j] == data[e.offset + j])
+          j++;
+        lcp_size = j;
+      }
+
+      // then pick the candidate which requires the least space
+      ByteArray prefix;
+      prefix.copy(lcp, lcp_size);
+      size_t best = encoded_size(entries, data, prefix.data(), lcp_size);
+      const PrefixKeyList *candidates[] = {this, other};
+      for (int c = 0; c < 2; c++) {
+        const PrefixKeyList *list = candidates[c];
+        size_t size = encoded_size(entries, data, list->get_prefix(),
+                        list->get_prefix_size());
+        if (size < best) {
+          best = size;
+          prefix.copy(list->get_prefix(), list->get_prefix_size());
+        }
+      }
+      size_t prefix_size = prefix.size();
+
+      // store the prefix, then re-insert the keys
+      m_data[0] = (uint8_t)prefix_size;
+      if (prefix_size)
+        ::memcpy(m_data + 1, prefix.data(), prefix_size);
+      m_index.create(m_data + m_header_size, m_range_size - m_header_size,
+                      capacity);
+
+      for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        const uint8_t *p = data + e.offset;
+        size_t size = e.size;
+        uint8_t flags = e.flags;
+        if (!(flags & BtreeKey::kExtendedKey)) {
+          if (size >= prefix_size && !::memcmp(p, prefix.data(), prefix_size)) {
+            p += prefix_size;
+            size -= prefix_size;
+          }
+          else
+            flags |= kFullKey;
+        }
+
+        m_index.insert(i, i);
+        uint32_t offset = m_index.allocate_space(i + 1, i, size + 1);
+        uint8_t *chunk = m_index.get_chunk_data_by_offset(offset);
+        *chunk = flags;
+        ::memcpy(chunk + 1, p, size);
+      }
+    }
+
+    // Returns the flags of a key. Flags are defined in btree_flags.h
+    uint8_t get_key_flags(int slot) const {
+      return (*get_chunk(slot));
+    }
+
+    // Sets the flags of a key. Flags are defined in btree_flags.h
+    void set_key_flags(int slot, uint8_t flags) {
+      *get_chunk(slot) = flags;
+    }
+
+    // Sets the size of a key
+    void set_key_size(int slot, size_t size) {
+      assert(size + 1 <= m_index.get_chunk_size(slot));
+      m_index.set_chunk_size(slot, size + 1);
+    }
+
+    // Returns the record address of an extended key overflow area
+    uint64_t get_extended_blob_id(int slot) const {
+      return (*(uint64_t *)get_key_data(slot));
+    }
+
+    // Sets the record address of an extended key overflow area
+    void set_extended_blob_id(int slot, uint64_t blobid) {
+      *(uint64_t *)get_key_data(slot) = blobid;
+    }
+
+    // Erases an extended key from disk and from the cache
+    void erase_extended_key(Context *context, uint64_t blobid) {
+      m_db->lenv()->blob_manager()->erase(context, blobid);
+      if (m_extkey_cache) {
+        ExtKeyCache::iterator it = m_extkey_cache->find(blobid);
+        if (it != m_extkey_cache->end())
+          m_extkey_cache->erase(it);
+      }
+    }
+
+    // Retrieves the extended key at |blobid| and stores it in |key|; will
+    // use the cache.
+    void get_extended_key(Context *context, uint64_t blob_id, ups_key_t *key) {
+      if (!m_extkey_cache)
+        m_extkey_cache.reset(new ExtKeyCache());
+      else {
+        ExtKeyCache::iterator it = m_extkey_cache->find(blob_id);
+        if (it != m_extkey_cache->end()) {
+          key->size = it->second.size();
+          key->data = it->second.data();
+          return;
+        }
+      }
+
+      ByteArray arena;
+      ups_record_t record = {0};
+      m_db->lenv()->blob_manager()->read(context, blob_id, &record,
+                      UPS_FORCE_DEEP_COPY, &arena);
+      (*m_extkey_cache)[blob_id] = arena;
+      arena.disown();
+      key->data = record.data;
+      key->size = record.size;
+    }
+
+    // Allocates an extended key and stores it in the cache
+    uint64_t add_extended_key(Context *context, const ups_key_t *key) {
+      if (!m_extkey_cache)
+        m_extkey_cache.reset(new ExtKeyCache());
+
+      ups_record_t rec = {0};
+      rec.data = key->data;
+      rec.size = key->size;
+
+      uint64_t blob_id = m_db->lenv()->blob_manager()->allocate(
+                                        context, &rec, 0);
+      assert(blob_id != 0);
+      assert(m_extkey_cache->find(blob_id) == m_extkey_cache->end());
+
+      ByteArray arena;
+      arena.resize(key->size);
+      ::memcpy(arena.data(), key->data, key->size);
+      (*m_extkey_cache)[blob_id] = arena;
+      arena.disown();
+
+      // increment counter (for statistics)
+      Globals::ms_extended_keys++;
+
+      return (blob_id);
+    }
+
+    // The database
+    LocalDatabase *m_db;
+
+    // The index for managing the variable-length chunks
+    UpfrontIndex m_index;
+
+    // Pointer to the data of the node (starts with the prefix)
+    uint8_t *m_data;
+
+    // Cache for extended keys
+    ScopedPtr<ExtKeyCache> m_extkey_cache;
+
+    // Threshold for extended keys; if key size is > threshold then the
+    // key is moved to a blob
+    size_t m_extkey_threshold;
+
+    // The maximum size of the prefix
+    size_t m_max_prefix_size;
+
+    // The size of the header (prefix size and prefix) in front of the
+    // UpfrontIndex
+    size_t m_header_size;
+};
+
+} // namespace DefLayout
+
+} // namespace upscaledb
+
+#endif /* UPS_BTREE_KEYS_PREFIX_H */
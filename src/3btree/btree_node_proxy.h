@@ -21,6 +21,7 @@
 #include "0root/root.h"
 
 #include <set>
+#include <vector>
 #include <string.h>
 #include <iostream>
 #include <sstream>
@@ -234,6 +235,10 @@ struct BtreeNodeProxy
   // Fills the btree_metrics structure
   virtual void fill_metrics(btree_metrics_t *metrics) = 0;
 
+  // Appends the ids of the blobs which store the records of this node
+  // to |ids|; used for readahead
+  virtual void blob_ids(std::vector<uint64_t> &ids) const = 0;
+
   // Prints the node to stdout. Only for testing and debugging!
   virtual void print(Context *context, size_t length = 0) = 0;
 
@@ -565,6 +570,11 @@ struct BtreeNodeProxyImpl : public BtreeNodeProxy
     impl.fill_metrics(metrics, length());
   }
 
+  // Appends the ids of the blobs which store the records
+  virtual void blob_ids(std::vector<uint64_t> &ids) const {
+    impl.blob_ids(ids, length());
+  }
+
   // Prints the node to stdout (for debugging)
   virtual void print(Context *context, size_t length = 0) {
     std::cout << "page " << page->address() << ": " << this->length()
@@ -24,6 +24,8 @@
 
 #include "0root/root.h"
 
+#include <vector>
+
 // Always verify that a file of level N does not include headers > N!
 
 #ifndef UPS_ROOT_H
@@ -58,6 +60,11 @@ struct BaseRecordList
                         m_range_size);
   }
 
+  // Collects the ids of the blobs which store the records; used for
+  // readahead. Only required if records are stored in blobs
+  void blob_ids(std::vector<uint64_t> &ids, size_t node_count) const {
+  }
+
   // Returns the record id. Only required for internal nodes
   uint64_t record_id(int slot, int duplicate_index = 0) const {
     assert(!"shouldn't be here");
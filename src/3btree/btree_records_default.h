@@ -301,6 +301,14 @@ struct DefaultRecordList : public BaseRecordList
                         m_range_size - required_range_size(node_count));
   }
 
+  // Collects the ids of the blobs which store the records
+  void blob_ids(std::vector<uint64_t> &ids, size_t node_count) const {
+    for (size_t i = 0; i < node_count; i++) {
+      if (!is_record_inline(i) && record_id(i) != 0)
+        ids.push_back(record_id(i));
+    }
+  }
+
   // Prints a slot to |out| (for debugging)
   void print(Context *context, int slot, std::stringstream &out) const {
     out << "(" << record_size(context, slot) << " bytes)";
@@ -107,6 +107,17 @@ BtreeStatistics::erase_failed()
   state.last_leaf_count[kOperationErase] = 0;
 }
 
+void
+BtreeStatistics::page_released(uint64_t address)
+{
+  for (int i = 0; i < kOperationMax; i++) {
+    if (state.last_leaf_pages[i] == address) {
+      state.last_leaf_pages[i] = 0;
+      state.last_leaf_count[i] = 0;
+    }
+  }
+}
+
 BtreeStatistics::FindHints
 BtreeStatistics::find_hints(uint32_t flags)
 {
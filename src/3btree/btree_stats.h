@@ -112,6 +112,10 @@ struct BtreeStatistics
   // Reports that a ups_erase/ups_cursor_erase failed
   void erase_failed();
 
+  // Reports that a leaf page was merged into its sibling and released;
+  // it must no longer be used as a hint
+  void page_released(uint64_t address);
+
   // Keep track of the KeyList range size
   void set_keylist_range_size(bool leaf, size_t size) {
     state.keylist_range_size[(int)leaf] = size;
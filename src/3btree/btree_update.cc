@@ -124,6 +124,8 @@ merge_page(BtreeUpdateAction &state, Page *page, Page *sibling)
     p->set_dirty(true);
   }
 
+  if (sib_node->is_leaf())
+    state.btree->statistics()->page_released(sibling->address());
   env->page_manager()->del(state.context, sibling);
 
   Globals::ms_btree_smo_merge++;
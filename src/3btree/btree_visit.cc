@@ -22,10 +22,12 @@
 #include "0root/root.h"
 
 // Always verify that a file of level N does not include headers > N!
+#include "3changeset/changeset.h"
 #include "3page_manager/page_manager.h"
 #include "3btree/btree_index.h"
 #include "3btree/btree_node_proxy.h"
 #include "3btree/btree_visitor.h"
+#include "4uqi/statements.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -85,6 +87,7 @@ struct BtreeVisitAction
     assert(page != 0);
 
     // now visit all leaf nodes
+    Readahead readahead;
     while (page) {
       BtreeNodeProxy *node = btree->get_node_from_page(page);
       uint64_t right = node->right_sibling();
@@ -92,8 +95,10 @@ struct BtreeVisitAction
       visitor(context, node);
 
       /* follow the pointer to the right sibling */
-      if (likely(right))
+      if (likely(right)) {
         page = env->page_manager()->fetch(context, right, page_manager_flags);
+        btree->read_ahead(readahead, btree->get_node_from_page(page));
+      }
       else
         break;
     }
@@ -113,5 +118,78 @@ BtreeIndex::visit_nodes(Context *context, BtreeVisitor &visitor,
   bva.run();
 }
 
+void
+BtreeIndex::partition_leaves(Context *context, size_t count,
+              std::vector<uint64_t> &ranges)
+{
+  LocalEnvironment *env = db()->lenv();
+  LatchCoupling latches(&context->changeset);
+
+  // walk down level by level till a level has enough nodes (or the leaf
+  // level is reached). All nodes of a level are either leaves or
+  // internal nodes.
+  std::vector<uint64_t> level(1, root_address());
+  while (level.size() < count) {
+    std::vector<uint64_t> children;
+    for (size_t i = 0; i < level.size(); i++) {
+      Page *page = env->page_manager()->fetch(context, level[i],
+                      PageManager::kReadOnly);
+      BtreeNodeProxy *node = get_node_from_page(page);
+      if (node->is_leaf()) {
+        latches.release(page);
+        break;
+      }
+      children.push_back(node->left_child());
+      for (uint32_t j = 0; j < node->length(); j++)
+        children.push_back(node->record_id(context, j));
+      latches.release(page);
+    }
+    if (children.empty())
+      break;
+    level.swap(children);
+  }
+
+  // pick evenly distributed nodes and follow their leftmost path down to
+  // the leaf level
+  count = std::min(count, level.size());
+  for (size_t i = 0; i < count; i++) {
+    uint64_t address = level[i * level.size() / count];
+    while (true) {
+      Page *page = env->page_manager()->fetch(context, address,
+                      PageManager::kReadOnly);
+      BtreeNodeProxy *node = get_node_from_page(page);
+      if (node->is_leaf()) {
+        latches.release(page);
+        break;
+      }
+      address = node->left_child();
+      latches.release(page);
+    }
+    ranges.push_back(address);
+  }
+}
+
+void
+BtreeIndex::scan_leaves(Context *context, uint64_t first, uint64_t last,
+              ScanVisitor *visitor, SelectStatement *statement)
+{
+  LocalEnvironment *env = db()->lenv();
+  LatchCoupling latches(&context->changeset);
+
+  Readahead readahead;
+  uint64_t address = first;
+  while (address != 0 && address != last) {
+    Page *page = env->page_manager()->fetch(context, address,
+                    PageManager::kReadOnly);
+    BtreeNodeProxy *node = get_node_from_page(page);
+    if (address != first)
+      read_ahead(readahead, node);
+    if (node->length() > 0)
+      node->scan(context, visitor, statement, 0, statement->distinct);
+    address = node->right_sibling();
+    latches.release(page);
+  }
+}
+
 } // namespace upscaledb
 
@@ -60,21 +60,26 @@ sort_by_offset(const SortHelper &lhs, const SortHelper &rhs) {
 // The BlockCache is used to speed up multiple select() operations for
 // a single block. This is frequently used when iterating over a block
 // with a cursor.
+template<typename T>
 struct BlockCache {
   BlockCache()
     : is_active(false) {
   }
 
   bool is_active;
-  uint32_t index_value;
-  uint32_t data[256]; // TODO replace with kMaxKeysPerBlock
+  T index_value;
+  T data[256]; // TODO replace with kMaxKeysPerBlock
 };
 
 // This structure is an "index" entry which describes the location
 // of a variable-length block
 #include "1base/packstart.h"
-UPS_PACK_0 class UPS_PACK_1 IndexBase {
+template<typename T>
+UPS_PACK_0 class UPS_PACK_1 BasicIndex {
   public:
+    // the type of the keys
+    typedef T value_type;
+
     // initialize this block index
     void initialize(uint32_t offset, uint8_t *data, size_t data_size) {
       ::memset(this, 0, sizeof(*this));
@@ -92,22 +97,22 @@ UPS_PACK_0 class UPS_PACK_1 IndexBase {
     }
 
     // returns the initial value
-    uint32_t value() const {
+    T value() const {
       return (m_value);
     }
 
     // sets the initial value
-    void set_value(uint32_t value) {
+    void set_value(T value) {
       m_value = value;
     }
 
     // returns the highest value
-    uint32_t highest() const {
+    T highest() const {
       return (m_highest);
     }
 
     // sets the highest value
-    void set_highest(uint32_t highest) {
+    void set_highest(T highest) {
       m_highest = highest;
     }
 
@@ -117,17 +122,22 @@ UPS_PACK_0 class UPS_PACK_1 IndexBase {
     uint16_t m_offset;
 
     // the start value of this block
-    uint32_t m_value;
+    T m_value;
 
     // the highest value of this block
-    uint32_t m_highest;
+    T m_highest;
 } UPS_PACK_2;
 #include "1base/packstop.h"
 
+// The index of the blocks with 32bit keys
+typedef BasicIndex<uint32_t> IndexBase;
+
 // Base class for a BlockCodec
 template <typename Index>
 struct BlockCodecBase
 {
+  typedef typename Index::value_type Value;
+
   enum {
     kHasCompressApi = 0,
     kHasFindLowerBoundApi = 0,
@@ -138,32 +148,32 @@ struct BlockCodecBase
     kCompressInPlace = 0,
   };
 
-  static uint32_t compress_block(Index *index, const uint32_t *in,
+  static uint32_t compress_block(Index *index, const Value *in,
                   uint32_t *out) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
-  static uint32_t *uncompress_block(Index *index, const uint32_t *block_data,
-                  uint32_t *out) {
+  static Value *uncompress_block(Index *index, const uint32_t *block_data,
+                  Value *out) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
   static int find_lower_bound(Index *index, const uint32_t *block_data,
-                  uint32_t key, uint32_t *result) {
+                  Value key, Value *result) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
   static bool insert(Index *index, uint32_t *block_data,
-                  uint32_t key, int *pslot) {
+                  Value key, int *pslot) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
   static bool append(Index *index, uint32_t *block_data,
-                  uint32_t key, int *pslot) {
+                  Value key, int *pslot) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
@@ -175,7 +185,7 @@ struct BlockCodecBase
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
-  static uint32_t select(Index *index, uint32_t *block_data, int slot) {
+  static Value select(Index *index, uint32_t *block_data, int slot) {
     assert(!"shouldn't be here");
     throw Exception(UPS_INTERNAL_ERROR);
   }
@@ -186,9 +196,11 @@ struct Zint32Codec
 {
   typedef BlockIndex Index;
   typedef BlockCodec Codec;
+  typedef typename Index::value_type Value;
+  typedef upscaledb::Zint32::BlockCache<Value> BlockCache;
 
   static uint32_t compress_block(Index *index, BlockCache *block_cache,
-                    const uint32_t *in, uint32_t *out) {
+                    const Value *in, uint32_t *out) {
     block_cache->is_active = false;
 
     if (Codec::kHasCompressApi)
@@ -197,8 +209,8 @@ struct Zint32Codec
     throw Exception(UPS_INTERNAL_ERROR);
   }
 
-  static uint32_t *uncompress_block(Index *index, const uint32_t *block_data,
-                  uint32_t *out) {
+  static Value *uncompress_block(Index *index, const uint32_t *block_data,
+                  Value *out) {
     if (index->key_count() > 1)
       return (Codec::uncompress_block(index, block_data, out));
     else
@@ -206,40 +218,40 @@ struct Zint32Codec
   }
 
   static int find_lower_bound(Index *index, const uint32_t *block_data,
-                  uint32_t key, uint32_t *result) {
+                  Value key, Value *result) {
     if (Codec::kHasFindLowerBoundApi)
       return (Codec::find_lower_bound(index, block_data, key, result));
 
-    uint32_t tmp[Index::kMaxKeysPerBlock];
-    uint32_t *begin = uncompress_block(index, block_data, &tmp[0]);
-    uint32_t *end = begin + index->key_count() - 1;
-    uint32_t *it = std::lower_bound(begin, end, key);
+    Value tmp[Index::kMaxKeysPerBlock];
+    Value *begin = uncompress_block(index, block_data, &tmp[0]);
+    Value *end = begin + index->key_count() - 1;
+    Value *it = std::lower_bound(begin, end, key);
     *result = *it;
     return (it - begin);
   }
 
   static bool insert(Index *index, BlockCache *block_cache,
-                    uint32_t *block_data, uint32_t key, int *pslot) {
+                    uint32_t *block_data, Value key, int *pslot) {
     block_cache->is_active = false;
 
     if (Codec::kHasInsertApi)
       return (Codec::insert(index, block_data, key, pslot));
 
     // now decode the block
-    uint32_t datap[Index::kMaxKeysPerBlock];
-    uint32_t *data = uncompress_block(index, block_data, datap);
+    Value datap[Index::kMaxKeysPerBlock];
+    Value *data = uncompress_block(index, block_data, datap);
 
     // swap |key| and |index->value|
     if (key < index->value()) {
-      uint32_t tmp = index->value();
+      Value tmp = index->value();
       index->set_value(key);
       key = tmp;
     }
 
     // locate the position of the new key
-    uint32_t *it = data;
-    uint32_t *begin = &data[0];
-    uint32_t *end = &data[index->key_count() - 1];
+    Value *it = data;
+    Value *begin = &data[0];
+    Value *end = &data[index->key_count() - 1];
 
     if (index->key_count() > 1) {
       it = std::lower_bound(begin, end, key);
@@ -252,7 +264,7 @@ struct Zint32Codec
 
       // insert the new key
       if (it < end)
-        ::memmove(it + 1, it, (end - it) * sizeof(uint32_t));
+        ::memmove(it + 1, it, (end - it) * sizeof(Value));
     }
 
     *it = key;
@@ -266,18 +278,18 @@ struct Zint32Codec
   }
 
   static bool append(Index *index, BlockCache *block_cache,
-                    uint32_t *block_data, uint32_t key, int *pslot) {
+                    uint32_t *block_data, Value key, int *pslot) {
     block_cache->is_active = false;
 
     if (Codec::kHasAppendApi)
       return (Codec::append(index, block_data, key, pslot));
 
     // decode the block
-    uint32_t datap[Index::kMaxKeysPerBlock];
-    uint32_t *data = uncompress_block(index, block_data, datap);
+    Value datap[Index::kMaxKeysPerBlock];
+    Value *data = uncompress_block(index, block_data, datap);
 
     // append the new key
-    uint32_t *it = &data[index->key_count() - 1];
+    Value *it = &data[index->key_count() - 1];
     *it = key;
     *pslot = it - &data[0] + 1;
 
@@ -297,8 +309,8 @@ struct Zint32Codec
       return (Codec::del(index, block_data, slot, grow_handler));
 
     // uncompress the block and remove the key
-    uint32_t datap[Index::kMaxKeysPerBlock];
-    uint32_t *data = uncompress_block(index, block_data, datap);
+    Value datap[Index::kMaxKeysPerBlock];
+    Value *data = uncompress_block(index, block_data, datap);
 
     // delete the first value?
     if (slot == 0) {
@@ -308,7 +320,7 @@ struct Zint32Codec
 
     if (slot < (int)index->key_count() - 1) {
       ::memmove(&data[slot - 1], &data[slot],
-              sizeof(uint32_t) * (index->key_count() - slot - 1));
+              sizeof(Value) * (index->key_count() - slot - 1));
     }
 
     // adjust key count
@@ -330,7 +342,7 @@ struct Zint32Codec
       index->set_used_size(0);
   }
 
-  static uint32_t select(Index *index, BlockCache *block_cache,
+  static Value select(Index *index, BlockCache *block_cache,
                     uint32_t *block_data, int position_in_block) {
     if (position_in_block == 0)
       return (index->value());
@@ -342,7 +354,7 @@ struct Zint32Codec
 
     block_cache->is_active = true;
     block_cache->index_value = index->value();
-    uint32_t *data = uncompress_block(index, block_data, block_cache->data);
+    Value *data = uncompress_block(index, block_data, block_cache->data);
     return (data[position_in_block - 1]);
   }
 };
@@ -352,6 +364,7 @@ class BlockKeyList : public BaseKeyList
 {
   public:
     typedef typename Zint32Codec::Index Index;
+    typedef typename Zint32Codec::Value Value;
 
     enum {
       // A flag whether this KeyList has sequential data
@@ -475,8 +488,8 @@ class BlockKeyList : public BaseKeyList
         if (index->key_count() > 1) {
           assert(index->used_size() > 0);
 #if 0
-          uint32_t data[Index::kMaxKeysPerBlock];
-          uint32_t *pdata = uncompress_block(index, &data[0]);
+          Value data[Index::kMaxKeysPerBlock];
+          Value *pdata = uncompress_block(index, &data[0]);
           assert(pdata[0] > index->value());
           assert(highest <= index->value());
 
@@ -518,7 +531,7 @@ class BlockKeyList : public BaseKeyList
     // but never called
     size_t get_key_size(int slot) const {
       assert(!"shouldn't be here");
-      return (sizeof(uint32_t));
+      return (sizeof(Value));
     }
 
     // Returns a pointer to the key's data; only required to appease the
@@ -600,7 +613,7 @@ class BlockKeyList : public BaseKeyList
 
       *pcmp = 0;
 
-      uint32_t key = *(uint32_t *)hkey->data;
+      Value key = *(Value *)hkey->data;
       int slot = 0;
 
       // first perform a linear search through the index
@@ -617,7 +630,7 @@ class BlockKeyList : public BaseKeyList
         return (slot);
 
       // increment result by 1 because index 0 is index->value()
-      uint32_t result;
+      Value result;
       int s = Zint32Codec::find_lower_bound(index,
                       (uint32_t *)get_block_data(index), key, &result);
       if (result != key || s == (int)index->key_count())
@@ -631,9 +644,9 @@ class BlockKeyList : public BaseKeyList
                     const ups_key_t *hkey, uint32_t flags, Cmp &comparator,
                     int /* unused */ slot) {
       assert(check_integrity(0, node_count));
-      assert(hkey->size == sizeof(uint32_t));
+      assert(hkey->size == sizeof(Value));
 
-      uint32_t key = *(uint32_t *)hkey->data;
+      Value key = *(Value *)hkey->data;
 
       // if a split is required: vacuumize the node, then retry
       try {
@@ -716,7 +729,7 @@ class BlockKeyList : public BaseKeyList
                                 (uint32_t *)get_block_data(index),
                                 position_in_block);
 
-      dest->size = sizeof(uint32_t);
+      dest->size = sizeof(Value);
       if (deep_copy == false) {
         dest->data = (uint8_t *)&m_dummy;
         return;
@@ -728,7 +741,7 @@ class BlockKeyList : public BaseKeyList
         dest->data = arena->data();
       }
 
-      *(uint32_t *)dest->data = m_dummy;
+      *(Value *)dest->data = m_dummy;
     }
 
     // Prints a key to |out| (for debugging)
@@ -744,12 +757,13 @@ class BlockKeyList : public BaseKeyList
 
     // Scans all keys; used for the UQI APIs.
     ScanResult scan(ByteArray *arena, size_t node_count, uint32_t start) {
-      arena->resize((get_block_count() * (Index::kMaxKeysPerBlock + 1)) * 4);
+      arena->resize((get_block_count() * (Index::kMaxKeysPerBlock + 1))
+                      * sizeof(Value));
 
       Index *it = get_block_index(0);
       Index *end = get_block_index(get_block_count());
 
-      uint32_t *out = (uint32_t *)arena->data();
+      Value *out = (Value *)arena->data();
 
       for (; it < end; it++) {
         if (start > it->key_count()) {
@@ -762,7 +776,7 @@ class BlockKeyList : public BaseKeyList
         out += it->key_count();
       }
 
-      out = (uint32_t *)arena->data();
+      out = (Value *)arena->data();
       return std::make_pair(out + start, node_count - start);
     }
 
@@ -795,12 +809,12 @@ class BlockKeyList : public BaseKeyList
       // If start offset or destination offset > 0: uncompress both blocks,
       // merge them
       if (src_position_in_block > 0 || dst_position_in_block > 0) {
-        uint32_t sdata_buf[Index::kMaxKeysPerBlock];
-        uint32_t ddata_buf[Index::kMaxKeysPerBlock];
-        uint32_t *sdata = uncompress_block(srci, &sdata_buf[0]);
-        uint32_t *ddata = dest.uncompress_block(dsti, &ddata_buf[0]);
+        Value sdata_buf[Index::kMaxKeysPerBlock];
+        Value ddata_buf[Index::kMaxKeysPerBlock];
+        Value *sdata = uncompress_block(srci, &sdata_buf[0]);
+        Value *ddata = dest.uncompress_block(dsti, &ddata_buf[0]);
 
-        uint32_t *d = &ddata[srci->key_count()];
+        Value *d = &ddata[srci->key_count()];
 
         if (src_position_in_block == 0) {
           assert(dst_position_in_block != 0);
@@ -885,7 +899,8 @@ class BlockKeyList : public BaseKeyList
       set_used_size(kSizeofOverhead);
       add_block(0, Index::kInitialBlockSize);
       m_block_cache.is_active = false;
-      assert(sizeof(m_block_cache.data) >= 4 * (Index::kMaxKeysPerBlock - 1));
+      assert(sizeof(m_block_cache.data)
+                      >= sizeof(Value) * (Index::kMaxKeysPerBlock - 1));
     }
 
     // Calculates the used size and updates the stored value
@@ -903,7 +918,7 @@ class BlockKeyList : public BaseKeyList
 
     // Implementation for insert()
     virtual PBtreeNode::InsertResult insert_impl(size_t node_count,
-                    uint32_t key, uint32_t flags) {
+                    Value key, uint32_t flags) {
       int slot = 0;
 
       // perform a linear search through the index and get the block
@@ -925,8 +940,8 @@ class BlockKeyList : public BaseKeyList
         return (PBtreeNode::InsertResult(UPS_DUPLICATE_KEY,
                     slot + index->key_count() - 1));
 
-      uint32_t new_data[Index::kMaxKeysPerBlock];
-      uint32_t datap[Index::kMaxKeysPerBlock];
+      Value new_data[Index::kMaxKeysPerBlock];
+      Value datap[Index::kMaxKeysPerBlock];
 
       // A split is required if the block overflows
       bool requires_split = index->key_count() + 1 >= Index::kMaxKeysPerBlock;
@@ -972,11 +987,11 @@ class BlockKeyList : public BaseKeyList
         // to the new block.
         //
         // The pivot position is aligned to 4.
-        uint32_t *data = uncompress_block(index, datap);
+        Value *data = uncompress_block(index, datap);
         uint32_t to_copy = (index->key_count() / 2) & ~0x03;
         assert(to_copy > 0);
         uint32_t new_key_count = index->key_count() - to_copy - 1;
-        uint32_t new_value = data[to_copy];
+        Value new_value = data[to_copy];
 
         // once more check if the key already exists
         if (new_value == key)
@@ -984,7 +999,7 @@ class BlockKeyList : public BaseKeyList
 
         to_copy++;
         ::memmove(&new_data[0], &data[to_copy],
-                    sizeof(int32_t) * (index->key_count() - to_copy));
+                    sizeof(Value) * (index->key_count() - to_copy));
 
         // Now create a new block. This can throw, but so far we have not
         // modified existing data.
@@ -995,7 +1010,7 @@ class BlockKeyList : public BaseKeyList
 
         // add_block() can invalid the data pointer, therefore fetch it again
         if (Zint32Codec::Codec::kCompressInPlace)
-          data = (uint32_t *)get_block_data(index);
+          data = (Value *)get_block_data(index);
 
         // Adjust the size of the old block
         index->set_key_count(index->key_count() - new_key_count);
@@ -1018,7 +1033,7 @@ class BlockKeyList : public BaseKeyList
           // hack for BlockIndex: fetch data pointer once more because
           // it was invalidated when the new block was added
           if (Zint32Codec::Codec::kCompressInPlace)
-            data = (uint32_t *)get_block_data(index);
+            data = (Value *)get_block_data(index);
         }
 
         // the block was modified and needs to be compressed again, even if
@@ -1054,8 +1069,8 @@ class BlockKeyList : public BaseKeyList
     void print_block(Index *index) const {
       std::cout << "0: " << index->value() << std::endl;
 
-      uint32_t datap[Index::kMaxKeysPerBlock];
-      uint32_t *data = uncompress_block(index, datap);
+      Value datap[Index::kMaxKeysPerBlock];
+      Value *data = uncompress_block(index, datap);
 
       for (uint32_t i = 1; i < index->key_count(); i++)
         std::cout << i << ": " << data[i - 1] << std::endl;
@@ -1082,7 +1097,7 @@ class BlockKeyList : public BaseKeyList
 
     // Performs a linear search through the index; returns the index
     // and the slot of the first key in this block in |*pslot|.
-    Index *find_index(uint32_t key, int *pslot) {
+    Index *find_index(Value key, int *pslot) {
       Index *index = get_block_index(0);
       Index *iend = get_block_index(get_block_count());
 
@@ -1222,9 +1237,9 @@ class BlockKeyList : public BaseKeyList
     }
 
     // Performs a lower bound search
-    int lower_bound_search(uint32_t *begin, uint32_t *end, uint32_t key,
+    int lower_bound_search(Value *begin, Value *end, Value key,
                     int *pcmp) const {
-      uint32_t *it = std::lower_bound(begin, end, key);
+      Value *it = std::lower_bound(begin, end, key);
       if (it != end) {
         *pcmp = (*it == key) ? 0 : +1;
       }
@@ -1267,13 +1282,13 @@ class BlockKeyList : public BaseKeyList
     }
 
     // Compresses a block of data
-    uint32_t compress_block(Index *index, uint32_t *in) {
+    uint32_t compress_block(Index *index, Value *in) {
       return (Zint32Codec::compress_block(index, &m_block_cache,
                               in, (uint32_t *)get_block_data(index)));
     }
 
     // Uncompresses a block of data
-    uint32_t *uncompress_block(Index *index, uint32_t *out) const {
+    Value *uncompress_block(Index *index, Value *out) const {
       return (Zint32Codec::uncompress_block(index,
                               (uint32_t *)get_block_data(index), out));
     }
@@ -1285,10 +1300,10 @@ class BlockKeyList : public BaseKeyList
     size_t m_range_size;
 
     // helper variable to avoid returning pointers to local memory
-    uint32_t m_dummy;
+    Value m_dummy;
 
     // Cache for speeding up the select() operation
-    BlockCache m_block_cache;
+    typename Zint32Codec::BlockCache m_block_cache;
 
     // Cached pointer to the last index used in get_key()
     Index *m_cached_index;
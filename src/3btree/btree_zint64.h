@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * Compressed 64bit integer keys
+ *
+ * Uses the block-based KeyList of the 32bit integer compression
+ * (see btree_zint32_block.h). Two codecs are available:
+ *
+ * - Varbyte (UPS_COMPRESSOR_UINT64_VARBYTE) stores the delta of each key
+ *   to its predecessor as a variable-length integer (1 to 10 bytes).
+ *
+ * - FOR (UPS_COMPRESSOR_UINT64_FOR) stores the difference of each key
+ *   to the first key of the block ("Frame Of Reference"), bit-packed with
+ *   the bit width of the largest difference. Every key can be accessed
+ *   directly, which allows a binary search in the compressed block.
+ */
+
+#ifndef UPS_BTREE_ZINT64_H
+#define UPS_BTREE_ZINT64_H
+
+#include <sstream>
+#include <iostream>
+
+#include "0root/root.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "3btree/btree_zint32_block.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+//
+// The template classes in this file are wrapped in a separate namespace
+// to avoid naming clashes with other KeyLists
+//
+namespace Zint64 {
+
+// This structure is an "index" entry which describes the location
+// of a variable-length block
+#include "1base/packstart.h"
+template<int InitialBlockSize>
+UPS_PACK_0 class UPS_PACK_1 BlockIndex
+        : public Zint32::BasicIndex<uint64_t> {
+  public:
+    enum {
+      // Initial size of a new block
+      kInitialBlockSize = InitialBlockSize,
+
+      // Maximum keys per block; a 64bit delta requires up to 10 bytes,
+      // therefore the blocks are smaller than those of the 32bit codecs
+      kMaxKeysPerBlock = 128 + 1,
+    };
+
+    // initialize this block index
+    void initialize(uint32_t offset, uint8_t *block_data, size_t block_size) {
+      Zint32::BasicIndex<uint64_t>::initialize(offset, block_data,
+                      block_size);
+      m_block_size = block_size;
+      m_used_size = 0;
+      m_key_count = 0;
+    }
+
+    // returns the used size of the block
+    uint32_t used_size() const {
+      return (m_used_size);
+    }
+
+    // sets the used size of the block
+    void set_used_size(uint32_t size) {
+      m_used_size = size;
+    }
+
+    // returns the total block size
+    uint32_t block_size() const {
+      return (m_block_size);
+    }
+
+    // sets the total block size
+    void set_block_size(uint32_t size) {
+      m_block_size = size;
+    }
+
+    // returns the key count
+    uint32_t key_count() const {
+      return (m_key_count);
+    }
+
+    // sets the key count
+    void set_key_count(uint32_t key_count) {
+      m_key_count = key_count;
+    }
+
+    // copies this block to the |dest| block
+    void copy_to(const uint8_t *block_data, BlockIndex *dest,
+                    uint8_t *dest_data) {
+      dest->set_value(value());
+      dest->set_key_count(key_count());
+      dest->set_used_size(used_size());
+      dest->set_highest(highest());
+      ::memcpy(dest_data, block_data, block_size());
+    }
+
+  private:
+    // the total size of this block
+    unsigned int m_block_size : 11;
+
+    // used size of this block
+    unsigned int m_used_size : 11;
+
+    // the number of keys in this block; max 511 (kMaxKeysPerBlock)
+    unsigned int m_key_count : 9;
+} UPS_PACK_2;
+#include "1base/packstop.h"
+
+typedef BlockIndex<16> VarbyteIndex;
+
+struct VarbyteCodecImpl : public Zint32::BlockCodecBase<VarbyteIndex>
+{
+  enum {
+    kHasCompressApi = 1,
+    kHasFindLowerBoundApi = 1,
+    kHasAppendApi = 1,
+  };
+
+  static uint64_t *uncompress_block(VarbyteIndex *index,
+                  const uint32_t *block_data, uint64_t *out) {
+    const uint8_t *p = (const uint8_t *)block_data;
+    uint64_t delta, prev = index->value();
+    for (uint32_t i = 1; i < index->key_count(); i++) {
+      p += read_int(p, &delta);
+      prev += delta;
+      out[i - 1] = prev;
+    }
+    return (out);
+  }
+
+  static uint32_t compress_block(VarbyteIndex *index, const uint64_t *in,
+                  uint32_t *out32) {
+    uint8_t *out = (uint8_t *)out32;
+    uint8_t *p = out;
+    uint64_t prev = index->value();
+    for (uint32_t i = 1; i < index->key_count(); i++, in++) {
+      p += write_int(p, *in - prev);
+      prev = *in;
+    }
+    return (p - out);
+  }
+
+  static int find_lower_bound(VarbyteIndex *index, const uint32_t *block_data,
+                  uint64_t key, uint64_t *result) {
+    const uint8_t *p = (const uint8_t *)block_data;
+    uint64_t delta, prev = index->value();
+    *result = key + 1;
+    uint32_t s;
+    for (s = 1; s < index->key_count(); s++) {
+      p += read_int(p, &delta);
+      prev += delta;
+
+      if (prev >= key) {
+        *result = prev;
+        break;
+      }
+    }
+    return (s - 1);
+  }
+
+  static bool append(VarbyteIndex *index, uint32_t *block_data32,
+                  uint64_t key, int *pslot) {
+    uint8_t *p = (uint8_t *)block_data32 + index->used_size();
+    int space = write_int(p, key - index->highest());
+
+    index->set_key_count(index->key_count() + 1);
+    index->set_used_size(index->used_size() + space);
+    *pslot += index->key_count() - 1;
+    return (true);
+  }
+
+  static uint32_t estimate_required_size(VarbyteIndex *index,
+                        uint8_t *block_data, uint64_t key) {
+    return (index->used_size() + calculate_delta_size(key - index->value()));
+  }
+
+  // reads a value from |in|; returns the number of bytes that were read
+  static int read_int(const uint8_t *in, uint64_t *out) {
+    uint64_t value = in[0] & 0x7F;
+    int i = 0;
+    while (in[i] >= 128) {
+      i++;
+      value |= (uint64_t)(in[i] & 0x7F) << (7 * i);
+    }
+    *out = value;
+    return (i + 1);
+  }
+
+  // returns the compressed size of |value|
+  static int calculate_delta_size(uint64_t value) {
+    int size = 1;
+    while (value >= 128) {
+      value >>= 7;
+      size++;
+    }
+    return (size);
+  }
+
+  // writes |value| to |p|; returns the number of bytes that were written
+  static int write_int(uint8_t *p, uint64_t value) {
+    assert(value > 0);
+    int size = 1;
+    while (value >= 128) {
+      *p++ = static_cast<uint8_t>((value & 0x7F) | (1U << 7));
+      value >>= 7;
+      size++;
+    }
+    *p = static_cast<uint8_t>(value);
+    return (size);
+  }
+};
+
+typedef Zint32::Zint32Codec<VarbyteIndex, VarbyteCodecImpl> VarbyteCodec;
+
+class VarbyteKeyList : public Zint32::BlockKeyList<VarbyteCodec>
+{
+  public:
+    // Constructor
+    VarbyteKeyList(LocalDatabase *db)
+      : Zint32::BlockKeyList<VarbyteCodec>(db) {
+    }
+};
+
+//
+// The block layout of the FOR codec is
+//
+//   |bits (1 byte)|packed differences ...|
+//
+// The differences are relative to index->value(), therefore the block is
+// re-compressed whenever the first key of the block changes.
+//
+typedef BlockIndex<1 + 16> ForIndex;
+
+struct ForCodecImpl : public Zint32::BlockCodecBase<ForIndex>
+{
+  enum {
+    kHasCompressApi = 1,
+    kHasFindLowerBoundApi = 1,
+    kHasAppendApi = 1,
+  };
+
+  static uint64_t *uncompress_block(ForIndex *index,
+                  const uint32_t *block_data, uint64_t *out) {
+    const uint8_t *p = (const uint8_t *)block_data;
+    uint32_t b = p[0];
+    uint64_t base = index->value();
+    for (uint32_t i = 0; i < index->key_count() - 1; i++)
+      out[i] = base + read_bits(p + 1, i * b, b);
+    return (out);
+  }
+
+  static uint32_t compress_block(ForIndex *index, const uint64_t *in,
+                  uint32_t *out32) {
+    assert(index->key_count() > 1);
+    uint8_t *out = (uint8_t *)out32;
+    uint32_t count = index->key_count() - 1;
+    uint64_t base = index->value();
+    uint32_t b = bits(in[count - 1] - base);
+    out[0] = (uint8_t)b;
+    for (uint32_t i = 0; i < count; i++)
+      write_bits(out + 1, i * b, b, in[i] - base);
+    return (packed_size(count, b));
+  }
+
+  static int find_lower_bound(ForIndex *index, const uint32_t *block_data,
+                  uint64_t key, uint64_t *result) {
+    const uint8_t *p = (const uint8_t *)block_data;
+    uint32_t b = p[0];
+    uint64_t base = index->value();
+    uint64_t delta = key - base;
+
+    // binary search in the packed data
+    int count = (int)index->key_count() - 1;
+    int first = 0;
+    while (count > 0) {
+      int step = count / 2;
+      if (read_bits(p + 1, (first + step) * b, b) < delta) {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else
+        count = step;
+    }
+
+    if (first < (int)index->key_count() - 1)
+      *result = base + read_bits(p + 1, first * b, b);
+    else
+      *result = key + 1;
+    return (first);
+  }
+
+  static bool append(ForIndex *index, uint32_t *block_data32,
+                  uint64_t key, int *pslot) {
+    uint8_t *p = (uint8_t *)block_data32;
+    uint32_t count = index->key_count() - 1;
+    uint64_t delta = key - index->value();
+    uint32_t b = count > 0 ? p[0] : 0;
+
+    // the new key requires a wider bit width: uncompress the block,
+    // then compress it again
+    if (bits(delta) > b) {
+      uint64_t data[ForIndex::kMaxKeysPerBlock];
+      if (count > 0)
+        uncompress_block(index, block_data32, &data[0]);
+      data[count] = key;
+      index->set_key_count(index->key_count() + 1);
+      index->set_used_size(compress_block(index, &data[0], block_data32));
+    }
+    else {
+      write_bits(p + 1, count * b, b, delta);
+      index->set_key_count(index->key_count() + 1);
+      index->set_used_size(packed_size(count + 1, b));
+    }
+
+    *pslot += index->key_count() - 1;
+    return (true);
+  }
+
+  static uint32_t estimate_required_size(ForIndex *index, uint8_t *block_data,
+                        uint64_t key) {
+    uint64_t lowest = std::min(key, index->value());
+    uint64_t highest = std::max(key, index->highest());
+    return (packed_size(index->key_count(), bits(highest - lowest)));
+  }
+
+  // returns the size of |count| packed values with |b| bits each,
+  // including the header
+  static uint32_t packed_size(uint32_t count, uint32_t b) {
+    return (1 + (count * b + 7) / 8);
+  }
+
+  // reads a value with |b| bits, starting at bit position |bitpos|
+  static uint64_t read_bits(const uint8_t *p, uint32_t bitpos, uint32_t b) {
+    p += bitpos / 8;
+    uint32_t shift = bitpos % 8;
+    uint64_t value = 0;
+    uint32_t done = 0;
+    while (done < b) {
+      uint32_t n = std::min(8 - shift, b - done);
+      value |= (uint64_t)((*p >> shift) & ((1U << n) - 1)) << done;
+      done += n;
+      shift = 0;
+      p++;
+    }
+    return (value);
+  }
+
+  // writes the |b| lowest bits of |value|, starting at bit
+  // position |bitpos|
+  static void write_bits(uint8_t *p, uint32_t bitpos, uint32_t b,
+                  uint64_t value) {
+    p += bitpos / 8;
+    uint32_t shift = bitpos % 8;
+    while (b > 0) {
+      uint32_t n = std::min(8 - shift, b);
+      uint8_t mask = (uint8_t)(((1U << n) - 1) << shift);
+      *p = (uint8_t)((*p & ~mask) | (((uint32_t)value << shift) & mask));
+      value >>= n;
+      b -= n;
+      shift = 0;
+      p++;
+    }
+  }
+
+  // returns the integer logarithm of v (bit width)
+  static uint32_t bits(const uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long answer;
+    if (v == 0)
+      return 0;
+    _BitScanReverse64(&answer, v);
+    return answer + 1;
+#else
+    return v == 0 ? 0 : 64 - __builtin_clzll(v);
+#endif
+  }
+};
+
+typedef Zint32::Zint32Codec<ForIndex, ForCodecImpl> ForCodec;
+
+class ForKeyList : public Zint32::BlockKeyList<ForCodec>
+{
+  public:
+    // Constructor
+    ForKeyList(LocalDatabase *db)
+      : Zint32::BlockKeyList<ForCodec>(db) {
+    }
+};
+
+} // namespace Zint64
+
+} // namespace upscaledb
+
+#endif /* UPS_BTREE_ZINT64_H */
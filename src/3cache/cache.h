@@ -23,7 +23,17 @@
  * unused pages, because all pages are also stored in a (non-intrusive)
  * linked list, and whenever a page is accessed it is removed and re-inserted
  * at the head. The tail therefore points to the page which was not used
- * in a long time, and is the primary candidate for purging.
+ * in a long time.
+ *
+ * The order in which pages are purged is decided by the CachePolicy
+ * (see UPS_PARAM_CACHE_POLICY). The default policy (LRU) purges the pages
+ * at the tail of this list.
+ *
+ * The hash buckets are protected by a set of latches (each latch covers
+ * several buckets), the list and the CachePolicy by a separate latch.
+ * Concurrent readers therefore can look up pages in parallel. Recency
+ * updates are skipped if the list latch is contended, i.e. the LRU
+ * order is only approximated under concurrent access.
  *
  * @exception_safe: nothrow
  * @thread_safe: yes
@@ -43,6 +53,7 @@
 #include "2page/page_collection.h"
 #include "2config/env_config.h"
 #include "3cache/cache_state.h"
+#include "3changeset/changeset.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -57,6 +68,13 @@ calc_hash(uint64_t value)
 {
   return (size_t)(value % CacheState::kBucketSize);
 }
+
+// Returns the latch of a bucket
+static inline Spinlock &
+bucket_latch(CacheState *state, size_t hash)
+{
+  return state->bucket_latches[hash % CacheState::kLatchCount];
+}
 } // namespace Impl
 
 struct Cache
@@ -87,12 +105,18 @@ struct Cache
   void fill_metrics(ups_env_metrics_t *metrics) const {
     metrics->cache_hits = state.cache_hits;
     metrics->cache_misses = state.cache_misses;
+    metrics->cache_policy = state.policy->type();
+    state.policy->fill_metrics(metrics);
   }
 
   // Retrieves a page from the cache, also removes the page from the cache
   // and re-inserts it at the front. Returns null if the page was not cached.
+  //
+  // The returned page is not protected against eviction; the caller
+  // has to hold the PageManager's mutex.
   Page *get(uint64_t address) {
     size_t hash = Impl::calc_hash(address);
+    ScopedSpinlock lock(Impl::bucket_latch(&state, hash));
 
     Page *page = state.buckets[hash].get(address);
     if (!page) {
@@ -103,8 +127,54 @@ struct Cache
     // Now re-insert the page at the head of the "totallist", and
     // thus move far away from the tail. The pages at the tail are highest
     // candidates to be deleted when the cache is purged.
+    ScopedSpinlock list_lock(state.list_latch);
     state.totallist.del(page);
     state.totallist.put(page);
+    state.policy->hit(page);
+    state.cache_hits++;
+    return page;
+  }
+
+  // Returns a cached page without updating its recency or the statistics.
+  // Returns null if the page was not cached. Used for readahead.
+  //
+  // The returned page is not protected against eviction; the caller
+  // has to hold the PageManager's mutex.
+  Page *peek(uint64_t address) {
+    size_t hash = Impl::calc_hash(address);
+    ScopedSpinlock lock(Impl::bucket_latch(&state, hash));
+    return state.buckets[hash].get(address);
+  }
+
+  // Retrieves a page from the cache and adds it to the |changeset|, which
+  // locks the page (and protects it against eviction). Does not block
+  // if the page is locked by another thread; instead |*busy| is set to
+  // true and null is returned. Also returns null if the page is not
+  // cached. Cache misses are not counted; the caller will retry the
+  // lookup with |get(uint64_t)|.
+  Page *get(uint64_t address, Changeset *changeset, bool *busy) {
+    size_t hash = Impl::calc_hash(address);
+    Page *page;
+
+    {
+      ScopedSpinlock lock(Impl::bucket_latch(&state, hash));
+      page = state.buckets[hash].get(address);
+      if (!page)
+        return 0;
+      if (!changeset->try_put(page)) {
+        *busy = true;
+        return 0;
+      }
+    }
+
+    // The page is locked; it can no longer be purged. Update its recency,
+    // but skip this if another thread currently holds the list latch.
+    ScopedTryLock<Spinlock> list_lock(state.list_latch);
+    if (list_lock.is_locked()) {
+      state.totallist.del(page);
+      state.totallist.put(page);
+      state.policy->hit(page);
+    }
     state.cache_hits++;
     return page;
   }
@@ -112,16 +182,21 @@ struct Cache
   // Stores a page in the cache
   void put(Page *page) {
     size_t hash = Impl::calc_hash(page->address());
+    ScopedSpinlock lock(Impl::bucket_latch(&state, hash));
 
     /* First remove the page from the cache, if it's already cached
      *
      * Then re-insert the page at the head of the list. The tail will
      * point to the least recently used page.
      */
-    state.totallist.del(page);
-    state.totallist.put(page);
-    if (page->is_allocated())
-      state.alloc_elements++;
+    {
+      ScopedSpinlock list_lock(state.list_latch);
+      state.totallist.del(page);
+      state.totallist.put(page);
+      if (page->is_allocated())
+        state.alloc_elements++;
+      state.policy->put(page);
+    }
 
     state.buckets[hash].put(page);
   }
@@ -130,27 +205,39 @@ struct Cache
   void del(Page *page) {
     assert(page->address() != 0);
 
-    /* remove it from the list of all cached pages */
-    if (state.totallist.del(page) && page->is_allocated())
-      state.alloc_elements--;
+    size_t hash = Impl::calc_hash(page->address());
+    ScopedSpinlock lock(Impl::bucket_latch(&state, hash));
+
+    {
+      ScopedSpinlock list_lock(state.list_latch);
+
+      /* remove it from the list of all cached pages */
+      if (state.totallist.del(page) && page->is_allocated())
+        state.alloc_elements--;
+
+      /* and from the queues of the replacement policy */
+      state.policy->del(page);
+    }
 
     /* remove the page from the cache buckets */
-    size_t hash = Impl::calc_hash(page->address());
     state.buckets[hash].del(page);
   }
 
-  // Purges the cache. Implements a LRU eviction algorithm. Dirty pages are
-  // forwarded to the |processor()| for flushing.
+  // Purges the cache. The CachePolicy decides about the order in which
+  // the pages are evicted. Dirty pages are forwarded to the |processor()|
+  // for flushing.
   // The |ignore_page| is passed by the caller; this page will not be purged
   // under any circumstance. This is used by the PageManager to make sure
   // that the "last blob page" is not evicted by the cache.
   void purge_candidates(std::vector<uint64_t> &candidates,
                   std::vector<Page *> &garbage,
                   Page *ignore_page) {
+    ScopedSpinlock list_lock(state.list_latch);
+
     int limit = (int)(current_elements()
                       - (state.capacity_bytes / state.page_size_bytes));
 
-    Page *page = state.totallist.tail();
+    Page *page = state.policy->first_victim();
     for (int i = 0; i < limit && page != 0; i++) {
       if (page->mutex().try_lock()) {
         if (page->cursor_list() == 0 && page != ignore_page) {
@@ -162,19 +249,30 @@ struct Cache
         page->mutex().unlock();
       }
 
-      page = page->previous(Page::kListCache);
+      page = state.policy->next_victim(page);
     }
   }
 
   // Visits all pages in the "totallist". If |cb| returns true then the
   // page is removed and deleted. This is used by the Environment
   // to flush (and delete) pages.
+  // The list is not latched; the caller must have exclusive access.
   template<typename Purger>
   void purge_if(Purger &purger) {
     PurgeIfSelector<Purger> selector(this, purger);
     state.totallist.extract(selector);
   }
 
+  // Appends the addresses of (up to |limit|) cached pages to |addresses|,
+  // starting with the most recently used page
+  void hot_pages(std::vector<uint64_t> &addresses, size_t limit) {
+    ScopedSpinlock list_lock(state.list_latch);
+    for (Page *page = state.totallist.head();
+            page != 0 && addresses.size() < limit;
+            page = page->next(Page::kListCache))
+      addresses.push_back(page->address());
+  }
+
   // Returns true if the capacity limits are exceeded
   bool is_cache_full() const {
     return state.totallist.size() * state.page_size_bytes
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * The replacement policy of the Cache. A policy decides in which order
+ * cached pages are evicted when the cache is full.
+ *
+ * The Cache itself owns the hash buckets and the "totallist" with all
+ * cached pages; the policy only arranges the pages in its own queues and
+ * walks them in eviction order.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: no
+ */
+
+#ifndef UPS_CACHE_POLICY_H
+#define UPS_CACHE_POLICY_H
+
+#include "0root/root.h"
+
+#include "ups/upscaledb_int.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "2page/page.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct CachePolicy
+{
+  // Constructor; |capacity| is the number of pages that fit into the cache
+  CachePolicy(uint64_t capacity)
+    : capacity_pages(capacity) {
+  }
+
+  // virtual destructor
+  virtual ~CachePolicy() {
+  }
+
+  // Returns the policy type (UPS_CACHE_POLICY_*)
+  virtual int type() const = 0;
+
+  // A page was stored in the cache
+  virtual void put(Page *page) = 0;
+
+  // A cached page was accessed (a cache hit)
+  virtual void hit(Page *page) = 0;
+
+  // A page was removed from the cache
+  virtual void del(Page *page) = 0;
+
+  // Returns the best candidate for eviction; this starts a walk over
+  // all cached pages, followed by |next_victim()|
+  virtual Page *first_victim() = 0;
+
+  // Returns the next candidate for eviction after |page|, or null
+  virtual Page *next_victim(Page *page) = 0;
+
+  // Fills in the per-queue metrics
+  virtual void fill_metrics(ups_env_metrics_t *metrics) const = 0;
+
+  // The number of pages that fit into the cache
+  uint64_t capacity_pages;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_CACHE_POLICY_H */
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * A scan-resistant replacement policy, based on "2Q: A Low Overhead High
+ * Performance Buffer Management Replacement Algorithm" (Johnson, Shasha).
+ *
+ * New pages are stored in the "cold" FIFO queue (A1in). Accessing them
+ * again while they are in this queue does not change their position, since
+ * those accesses are usually correlated (i.e. several accesses of the same
+ * operation). When a page is evicted from the cold queue then its address
+ * is remembered in a "ghost" queue (A1out). If the page is then fetched
+ * again, it is stored in the "hot" LRU queue (Am).
+ *
+ * Pages are evicted from the cold queue as long as it exceeds 25% of the
+ * cache capacity. A large sequential scan therefore only cycles through the
+ * cold queue and does not push the hot pages (i.e. the btree root and
+ * internal nodes) out of the cache.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: no
+ */
+
+#ifndef UPS_CACHE_POLICY_2Q_H
+#define UPS_CACHE_POLICY_2Q_H
+
+#include "0root/root.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+
+// Always verify that a file of level N does not include headers > N!
+#include "2page/page_collection.h"
+#include "3cache/cache_policy.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct TwoQueueCachePolicy : public CachePolicy
+{
+  TwoQueueCachePolicy(uint64_t capacity)
+    : CachePolicy(capacity), cold_limit(std::max(capacity / 4, (uint64_t)1)),
+      ghost_limit(std::max(capacity / 2, (uint64_t)1)), cold_first(true),
+      cold_hits(0), hot_hits(0), ghost_hits(0) {
+  }
+
+  virtual int type() const {
+    return UPS_CACHE_POLICY_2Q;
+  }
+
+  virtual void put(Page *page) {
+    if (cold.has(page) || hot.has(page))
+      return;
+
+    // re-fetched after it was evicted from the cold queue? then the page
+    // is "hot"
+    std::set<uint64_t>::iterator it = ghosts.find(page->address());
+    if (it != ghosts.end()) {
+      ghosts.erase(it);
+      ghost_hits++;
+      hot.put(page);
+    }
+    else
+      cold.put(page);
+  }
+
+  virtual void hit(Page *page) {
+    if (hot.has(page)) {
+      hot.del(page);
+      hot.put(page);
+      hot_hits++;
+    }
+    else
+      cold_hits++;
+  }
+
+  virtual void del(Page *page) {
+    if (hot.del(page))
+      return;
+    if (!cold.del(page))
+      return;
+
+    ghosts.insert(page->address());
+    ghost_fifo.push_back(page->address());
+    if (ghost_fifo.size() > ghost_limit) {
+      ghosts.erase(ghost_fifo.front());
+      ghost_fifo.pop_front();
+    }
+  }
+
+  // Evicts from the cold queue first, unless it is below its limit
+  virtual Page *first_victim() {
+    cold_first = cold.size() > cold_limit || hot.is_empty();
+    if (cold_first)
+      return cold.is_empty() ? hot.tail() : cold.tail();
+    return hot.tail();
+  }
+
+  virtual Page *next_victim(Page *page) {
+    if (cold.has(page)) {
+      Page *p = page->previous(Page::kListCacheCold);
+      if (p)
+        return p;
+      return cold_first ? hot.tail() : 0;
+    }
+
+    Page *p = page->previous(Page::kListCacheHot);
+    if (p)
+      return p;
+    return cold_first ? 0 : cold.tail();
+  }
+
+  virtual void fill_metrics(ups_env_metrics_t *metrics) const {
+    metrics->cache_hits_cold = cold_hits;
+    metrics->cache_hits_hot = hot_hits;
+    metrics->cache_misses_ghost = ghost_hits;
+    metrics->cache_pages_cold = cold.size();
+    metrics->cache_pages_hot = hot.size();
+  }
+
+  // max. number of pages in the cold queue before it is purged first
+  uint64_t cold_limit;
+
+  // max. number of addresses in the ghost queue
+  uint64_t ghost_limit;
+
+  // the current eviction order; set in |first_victim()|
+  bool cold_first;
+
+  // the cold queue (A1in) - FIFO
+  PageCollection<Page::kListCacheCold> cold;
+
+  // the hot queue (Am) - LRU
+  PageCollection<Page::kListCacheHot> hot;
+
+  // addresses of pages recently evicted from the cold queue (A1out)
+  std::set<uint64_t> ghosts;
+
+  // the same addresses, in eviction order
+  std::deque<uint64_t> ghost_fifo;
+
+  // counts the cache hits in the cold queue
+  uint64_t cold_hits;
+
+  // counts the cache hits in the hot queue
+  uint64_t hot_hits;
+
+  // counts the misses of pages that were found in the ghost queue
+  uint64_t ghost_hits;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_CACHE_POLICY_2Q_H */
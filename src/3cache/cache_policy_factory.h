@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * A factory for CachePolicy objects
+ *
+ * @exception_safe: strong
+ * @thread_safe: yes
+ */
+
+#ifndef UPS_CACHE_POLICY_FACTORY_H
+#define UPS_CACHE_POLICY_FACTORY_H
+
+#include "0root/root.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "3cache/cache_policy_2q.h"
+#include "3cache/cache_policy_lru.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct CachePolicyFactory {
+  // creates a new CachePolicy instance depending on the |policy|
+  // (UPS_CACHE_POLICY_*)
+  static CachePolicy *create(int policy, uint64_t capacity,
+                  PageCollection<Page::kListCache> &totallist) {
+    switch (policy) {
+      case UPS_CACHE_POLICY_2Q:
+        return new TwoQueueCachePolicy(capacity);
+      default:
+        return new LruCachePolicy(capacity, totallist);
+    }
+  }
+
+  // Returns true if the |policy| is valid
+  static bool is_available(uint64_t policy) {
+    return policy == UPS_CACHE_POLICY_LRU || policy == UPS_CACHE_POLICY_2Q;
+  }
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_CACHE_POLICY_FACTORY_H */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * The default replacement policy: least recently used. Walks the Cache's
+ * "totallist" from the tail; the Cache moves each accessed page to the
+ * head of this list.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: no
+ */
+
+#ifndef UPS_CACHE_POLICY_LRU_H
+#define UPS_CACHE_POLICY_LRU_H
+
+#include "0root/root.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "2page/page_collection.h"
+#include "3cache/cache_policy.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct LruCachePolicy : public CachePolicy
+{
+  typedef PageCollection<Page::kListCache> TotalList;
+
+  LruCachePolicy(uint64_t capacity, TotalList &totallist_)
+    : CachePolicy(capacity), totallist(totallist_), hits(0) {
+  }
+
+  virtual int type() const {
+    return UPS_CACHE_POLICY_LRU;
+  }
+
+  // The Cache already moved the page to the head of the totallist
+  virtual void put(Page *) {
+  }
+
+  virtual void hit(Page *) {
+    hits++;
+  }
+
+  virtual void del(Page *) {
+  }
+
+  virtual Page *first_victim() {
+    return totallist.tail();
+  }
+
+  virtual Page *next_victim(Page *page) {
+    return page->previous(Page::kListCache);
+  }
+
+  virtual void fill_metrics(ups_env_metrics_t *metrics) const {
+    metrics->cache_hits_cold = hits;
+    metrics->cache_pages_cold = totallist.size();
+  }
+
+  // The Cache's list of all pages, ordered by recency
+  TotalList &totallist;
+
+  // counts the cache hits
+  uint64_t hits;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_CACHE_POLICY_LRU_H */
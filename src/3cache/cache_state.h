@@ -21,13 +21,17 @@
 #include "0root/root.h"
 
 #include <vector>
+#include <boost/atomic.hpp>
 
 #include "ups/types.h"
 
 // Always verify that a file of level N does not include headers > N!
+#include "1base/scoped_ptr.h"
+#include "1base/spinlock.h"
 #include "2page/page.h"
 #include "2page/page_collection.h"
 #include "2config/env_config.h"
+#include "3cache/cache_policy_factory.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -43,6 +47,10 @@ struct CacheState
     // The number of buckets should be a prime number or similar, as it
     // is used in a MODULO hash scheme
     kBucketSize = 10317,
+
+    // The number of latches protecting the buckets; bucket |i| is
+    // protected by latch |i % kLatchCount|
+    kLatchCount = 64
   };
 
   CacheState(const EnvConfig &config)
@@ -52,6 +60,8 @@ struct CacheState
       page_size_bytes(config.page_size_bytes), alloc_elements(0),
       buckets(kBucketSize), cache_hits(0), cache_misses(0) {
     assert(capacity_bytes > 0);
+    policy.reset(CachePolicyFactory::create(config.cache_policy,
+                            capacity_bytes / page_size_bytes, totallist));
   }
 
   // the capacity (in bytes)
@@ -70,11 +80,20 @@ struct CacheState
   // The hash table buckets - each is a linked list of Page pointers
   std::vector<CacheLine> buckets;
 
+  // The latches of the buckets
+  Spinlock bucket_latches[kLatchCount];
+
+  // Protects the |totallist|, |alloc_elements| and the |policy|
+  Spinlock list_latch;
+
   // counts the cache hits
-  uint64_t cache_hits;
+  boost::atomic<uint64_t> cache_hits;
 
   // counts the cache misses
-  uint64_t cache_misses;
+  boost::atomic<uint64_t> cache_misses;
+
+  // the replacement policy; decides which pages are purged
+  ScopedPtr<CachePolicy> policy;
 };
 
 } // namespace upscaledb
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * The compressed cache tier
+ *
+ * Keeps compressed copies of clean pages which were evicted from the Cache.
+ * A page which is not cached is first looked up in this tier before it
+ * is read from disk (see UPS_PARAM_COMPRESSED_CACHE_SIZE).
+ *
+ * The tier is exclusive: a page is removed as soon as it is loaded into
+ * the Cache again. Therefore the compressed copy is always identical to
+ * the page on disk; pages are only modified (and flushed) while they
+ * are in the Cache.
+ *
+ * If the size limit is exceeded then the least recently stored pages
+ * are discarded.
+ *
+ * @exception_safe: strong
+ * @thread_safe: no; the caller has to hold the PageManager's mutex
+ */
+
+#ifndef UPS_COMPRESSED_CACHE_H
+#define UPS_COMPRESSED_CACHE_H
+
+#include "0root/root.h"
+
+#include <map>
+#include <list>
+
+#include "ups/upscaledb_int.h"
+
+// Always verify that a file of level N does not include headers > N!
+#include "1base/error.h"
+#include "1base/scoped_ptr.h"
+#include "1mem/mem.h"
+#include "2config/env_config.h"
+#include "2compressor/compressor_factory.h"
+#include "2page/page.h"
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+struct CompressedCache
+{
+  // A compressed page
+  struct Entry {
+    // the compressed data
+    uint8_t *data;
+
+    // the size of the compressed data
+    uint32_t size;
+
+    // the position in the |lru| list
+    std::list<uint64_t>::iterator lru;
+  };
+
+  typedef std::map<uint64_t, Entry> EntryMap;
+
+  // Constructor
+  CompressedCache(const EnvConfig &config)
+    : capacity_bytes(config.compressed_cache_size_bytes),
+      page_size_bytes(config.page_size_bytes), current_bytes(0),
+      hits(0), misses(0) {
+    if (capacity_bytes > 0)
+      compressor.reset(CompressorFactory::create(
+                              config.compressed_cache_compressor));
+  }
+
+  // Destructor; releases all pages
+  ~CompressedCache() {
+    clear();
+  }
+
+  // Returns true if the tier is enabled
+  bool is_enabled() const {
+    return capacity_bytes > 0;
+  }
+
+  // Fills in the current metrics
+  void fill_metrics(ups_env_metrics_t *metrics) const {
+    metrics->compressed_cache_hits = hits;
+    metrics->compressed_cache_misses = misses;
+    metrics->compressed_cache_pages = entries.size();
+    metrics->compressed_cache_bytes = current_bytes;
+  }
+
+  // Stores a compressed copy of a (clean) page. The page is skipped if
+  // it does not compress well. Discards the oldest pages if the size limit
+  // is exceeded.
+  void put(Page *page) {
+    uint64_t address = page->address();
+    del(address);
+
+    uint32_t size = compressor->compress((uint8_t *)page->data(),
+                            page_size_bytes);
+    // not worth the effort if less than 1/8th of the page is saved
+    if (size > page_size_bytes - page_size_bytes / 8)
+      return;
+
+    uint8_t *data = Memory::allocate<uint8_t>(size);
+    ::memcpy(data, compressor->arena.data(), size);
+
+    lru.push_front(address);
+    Entry entry = {data, size, lru.begin()};
+    entries[address] = entry;
+    current_bytes += size;
+
+    while (current_bytes > capacity_bytes && !lru.empty())
+      del(lru.back());
+  }
+
+  // Loads the page at |address| from the tier and removes it. Returns false
+  // if the page is not stored.
+  bool get(uint64_t address, Page *page) {
+    EntryMap::iterator it = entries.find(address);
+    if (it == entries.end()) {
+      misses++;
+      return false;
+    }
+
+    uint8_t *buffer = Memory::allocate<uint8_t>(page_size_bytes);
+    try {
+      compressor->decompress(it->second.data, it->second.size,
+                      page_size_bytes, buffer);
+    }
+    catch (Exception &) {
+      Memory::release(buffer);
+      del(it);
+      misses++;
+      return false;
+    }
+
+    page->assign_allocated_buffer(buffer, address);
+    del(it);
+    hits++;
+    return true;
+  }
+
+  // Returns true if the page at |address| is stored
+  bool has(uint64_t address) const {
+    return entries.find(address) != entries.end();
+  }
+
+  // Removes the page at |address|, if it is stored
+  void del(uint64_t address) {
+    EntryMap::iterator it = entries.find(address);
+    if (it != entries.end())
+      del(it);
+  }
+
+  // Removes all pages at or above |address|; used when the file
+  // is truncated
+  void del_from(uint64_t address) {
+    EntryMap::iterator it = entries.lower_bound(address);
+    while (it != entries.end())
+      del(it++);
+  }
+
+  // Removes all pages
+  void clear() {
+    while (!entries.empty())
+      del(entries.begin());
+  }
+
+  // Removes a page
+  void del(EntryMap::iterator it) {
+    Memory::release(it->second.data);
+    current_bytes -= it->second.size;
+    lru.erase(it->second.lru);
+    entries.erase(it);
+  }
+
+  // The compressed pages, sorted by address
+  EntryMap entries;
+
+  // The addresses of the pages; the most recently stored page is at
+  // the front
+  std::list<uint64_t> lru;
+
+  // The size limit (in bytes); 0 if the tier is disabled
+  uint64_t capacity_bytes;
+
+  // The page size
+  uint32_t page_size_bytes;
+
+  // The number of compressed bytes currently stored
+  uint64_t current_bytes;
+
+  // Compresses and decompresses the pages
+  ScopedPtr<Compressor> compressor;
+
+  // The number of pages which were found
+  uint64_t hits;
+
+  // The number of pages which were not found
+  uint64_t misses;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_COMPRESSED_CACHE_H */
@@ -38,22 +38,12 @@ namespace upscaledb {
 /* a unittest hook for Changeset::flush() */
 void (*g_CHANGESET_POST_LOG_HOOK)(void);
 
-struct UnlockPage
-{
-  bool operator()(Page *page) {
-#ifdef UPS_ENABLE_HELGRIND
-    page->mutex().try_lock();
-#endif
-    page->mutex().unlock();
-    return true;
-  }
-};
-
 struct FlushChangesetVisitor
 {
   bool operator()(Page *page) {
     assert(page->mutex().try_lock() == false);
 
+    page->set_changeset(0);
     if (page->is_dirty())
       list.push_back(page);
     else
@@ -67,8 +57,12 @@ struct FlushChangesetVisitor
 static void
 async_flush_changeset(std::vector<Page *> list, Device *device,
                 Journal *journal, uint64_t lsn,
-                bool enable_fsync, int fd_index)
+                bool enable_fsync, int fd_index, uint64_t journal_ticket)
 {
+  /* make sure that the log is durable before the pages are written */
+  if (enable_fsync)
+    journal->sync(journal_ticket);
+
   std::vector<Page *>::iterator it = list.begin();
   for (; it != list.end(); it++) {
     Page *page = *it;
@@ -100,13 +94,20 @@ async_flush_changeset(std::vector<Page *> list, Device *device,
 void
 Changeset::clear()
 {
-  UnlockPage unlocker;
-  collection.for_each(unlocker);
-  collection.clear();
+  // remove the page from the collection BEFORE it is unlocked; as soon as
+  // it's unlocked it can be added to a changeset of another thread
+  while (Page *page = collection.head()) {
+    collection.del(page);
+    page->set_changeset(0);
+#ifdef UPS_ENABLE_HELGRIND
+    page->mutex().try_lock();
+#endif
+    page->mutex().unlock();
+  }
 }
 
 void
-Changeset::flush(uint64_t lsn)
+Changeset::flush(uint64_t lsn, bool durable)
 {
   // now flush all modified pages to disk
   if (collection.is_empty())
@@ -125,7 +126,8 @@ Changeset::flush(uint64_t lsn)
    * "write-ahead logs" all changes. */
   int fd_index = env->journal()->append_changeset(visitor.list,
                                       env->page_manager()->last_blob_page_id(),
-                                      lsn);
+                                      lsn, durable);
+  uint64_t journal_ticket = durable ? 0 : env->journal()->sync_ticket();
 
   UPS_INDUCE_ERROR(ErrorInducer::kChangesetFlush);
 
@@ -138,7 +140,7 @@ Changeset::flush(uint64_t lsn)
   env->page_manager()->run_async(boost::bind(&async_flush_changeset,
                           visitor.list, env->device(), env->journal(), lsn,
                           ISSET(env->config().flags, UPS_ENABLE_FSYNC),
-                          fd_index));
+                          fd_index, journal_ticket));
 }
 
 } // namespace upscaledb
@@ -62,12 +62,44 @@ struct Changeset
     if (!has(page))
       page->mutex().lock();
     collection.put(page);
+    page->set_changeset(this);
+  }
+
+  /*
+   * Appends a page to the changeset, but only if its lock can be acquired
+   * without blocking. Returns false if the page is locked by a different
+   * thread.
+   *
+   * Unlike |put()| this does not rely on |has()|, which is not reliable
+   * if other threads (i.e. concurrent readers) maintain their own
+   * changesets.
+   */
+  bool try_put(Page *page) {
+    if (page->mutex().try_lock()) {
+      collection.put(page);
+      page->set_changeset(this);
+      return true;
+    }
+    // the page is already locked - either by this changeset, or by
+    // somebody else
+    return page->changeset() == this;
   }
 
   /* Removes a page from the changeset. The page is unlocked. */
   void del(Page *page) {
-    page->mutex().unlock();
     collection.del(page);
+    page->set_changeset(0);
+    page->mutex().unlock();
+  }
+
+  /*
+   * Removes all pages which were added after |head| was the head of the
+   * changeset. The pages are unlocked; |head| itself is not removed.
+   */
+  void del_newer_than(Page *head) {
+    Page *page;
+    while ((page = collection.head()) != 0 && page != head)
+      del(page);
   }
 
   /* Check if the page is already part of the changeset */
@@ -86,9 +118,11 @@ struct Changeset
   /*
    * Flush all pages in the changeset - first write them to the log, then
    * write them to the disk.
+   * If |durable| is false then the log is not synced immediately, but
+   * right before the pages are written (by the worker thread).
    * On success: will clear the changeset and the journal
    */
-  void flush(uint64_t lsn);
+  void flush(uint64_t lsn, bool durable = true);
 
   /* The Environment */
   LocalEnvironment *env;
@@ -97,6 +131,35 @@ struct Changeset
   PageCollection<Page::kListChangeset> collection;
 };
 
+/*
+ * Releases the pages of a read-only btree traversal as soon as they are
+ * no longer required ("latch coupling"), so that concurrent readers
+ * never wait for a page lock while holding another one which they no
+ * longer need.
+ *
+ * This is only enabled if the changeset was empty when the traversal
+ * started; otherwise the changeset might contain pages of a pending
+ * write operation, which must not be released.
+ */
+struct LatchCoupling
+{
+  LatchCoupling(Changeset *changeset_)
+    : changeset(changeset_), enabled(changeset_->is_empty()) {
+  }
+
+  /* Removes |page| from the changeset (and unlocks it) */
+  void release(Page *page) {
+    if (enabled && page)
+      changeset->del(page);
+  }
+
+  /* The Changeset of the current operation */
+  Changeset *changeset;
+
+  /* True if pages can be released */
+  bool enabled;
+};
+
 } // namespace upscaledb
 
 #endif /* UPS_CHANGESET_H */
@@ -18,10 +18,17 @@
 #include "0root/root.h"
 
 #include <string.h>
+#include <time.h>
+#include <map>
+#include <deque>
+#include <algorithm>
 #ifndef WIN32
 #  include <libgen.h>
 #endif
 
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
 #include "1base/error.h"
 #include "1errorinducer/errorinducer.h"
 #include "1os/os.h"
@@ -48,6 +55,68 @@ enum {
 
   // flush buffers if this limit is exceeded
   kBufferLimit = 1024 * 1024, // 1 mb
+
+  // recovery reads the journal files in chunks of this size
+  kRecoveryReadSize = 4 * 1024 * 1024, // 4 mb
+
+  // recovered changeset pages are written in batches of this size
+  kRecoveryBatchSize = 32 * 1024 * 1024, // 32 mb
+
+  // max. number of entries which are read ahead of the logical replay
+  kRecoveryQueueSize = 1024
+};
+
+//
+// Reads a journal file sequentially with large buffered reads; used
+// during recovery
+//
+struct JournalReader
+{
+  JournalReader()
+    : file(0), file_size(0), buffer_offset(0) {
+  }
+
+  // Attaches the reader to |f|
+  void attach(File *f) {
+    file = f;
+    file_size = f->file_size();
+    buffer.clear();
+    buffer_offset = 0;
+  }
+
+  // Reads |len| bytes at |offset|
+  void read(uint64_t offset, void *ptr, size_t len) {
+    if (offset + len > file_size)
+      throw Exception(UPS_IO_ERROR);
+
+    if (len >= kRecoveryReadSize) {
+      file->pread(offset, ptr, len);
+      return;
+    }
+
+    if (offset < buffer_offset
+            || offset + len > buffer_offset + buffer.size()) {
+      size_t size = (size_t)std::min<uint64_t>(kRecoveryReadSize,
+                            file_size - offset);
+      buffer.resize(size);
+      file->pread(offset, buffer.data(), size);
+      buffer_offset = offset;
+    }
+
+    ::memcpy(ptr, buffer.data() + (offset - buffer_offset), len);
+  }
+
+  // The journal file
+  File *file;
+
+  // The size of the file; the file does not grow during recovery
+  uint64_t file_size;
+
+  // The buffered data
+  ByteArray buffer;
+
+  // The file offset of |buffer|
+  uint64_t buffer_offset;
 };
 
 static inline void
@@ -66,8 +135,10 @@ clear_file(JournalState &state, int idx)
   state.open_txn[idx] = 0;
   state.closed_txn[idx] = 0;
 
-  // also clear the buffer with the outstanding data
+  // also clear the buffer with the outstanding data; these entries are
+  // obsolete because their Transactions were flushed to the database
   state.buffer[idx].clear();
+  state.buffer_lsn[idx] = 0;
 }
 
 static inline std::string
@@ -101,6 +172,99 @@ log_file_path(JournalState &state, int i)
   return (path);
 }
 
+// Makes sure that all data up to |ticket| (a |written_seq| value) is
+// durable ("group commit"). If another thread is already running an fsync
+// then this thread waits for the next one, which then covers all writes
+// that arrived in the meantime. If |collect| is true then the leader of a
+// group can wait up to |group_commit_delay_usec| for more commits to
+// arrive. Callers which hold the Environment lock or page locks must not
+// wait, otherwise they would block the very commits they are waiting for.
+//
+// Can be called with or without holding the Environment lock; the
+// fsync itself never requires the lock.
+static inline void
+sync_files(JournalState &state, uint64_t ticket, bool collect)
+{
+  ScopedLock lock(state.sync_mutex);
+
+  state.sync_waiters++;
+  if (!collect)
+    state.sync_urgent++;
+  state.sync_cond.notify_all(); // wake up a leader which collects commits
+
+  while (state.synced_seq < ticket) {
+    if (state.sync_in_progress) {
+      state.sync_cond.wait(lock);
+      continue;
+    }
+
+    // this thread is the leader of the next group
+    state.sync_in_progress = true;
+
+    if (collect && state.group_commit_delay_usec > 0) {
+      boost::system_time deadline = boost::get_system_time()
+              + boost::posix_time::microseconds(state.group_commit_delay_usec);
+      while (state.sync_urgent == 0
+              && (state.group_commit_size == 0
+                  || state.sync_waiters < state.group_commit_size)) {
+        if (!state.sync_cond.timed_wait(lock, deadline))
+          break;
+      }
+    }
+
+    uint64_t target = state.written_seq;
+    uint64_t target_lsn = state.written_lsn;
+    bool files[2] = {state.unsynced[0], state.unsynced[1]};
+    state.unsynced[0] = state.unsynced[1] = false;
+
+    lock.unlock();
+    try {
+      for (int i = 0; i < 2; i++) {
+        if (files[i]) {
+          state.files[i].flush();
+          state.count_fsyncs++;
+        }
+      }
+    }
+    catch (Exception &) {
+      lock.lock();
+      state.unsynced[0] |= files[0];
+      state.unsynced[1] |= files[1];
+      state.sync_in_progress = false;
+      state.sync_waiters--;
+      if (!collect)
+        state.sync_urgent--;
+      state.sync_cond.notify_all();
+      throw;
+    }
+    lock.lock();
+
+    if (target > state.synced_seq)
+      state.synced_seq = target;
+    if (target_lsn > state.durable_lsn)
+      state.durable_lsn = target_lsn;
+    state.sync_in_progress = false;
+    state.sync_cond.notify_all();
+  }
+
+  state.sync_waiters--;
+  if (!collect)
+    state.sync_urgent--;
+}
+
+// Returns the lsn up to which all entries were written to the files, i.e.
+// the lsn preceding the oldest entry which is still buffered
+static inline uint64_t
+written_lsn_bound(JournalState &state)
+{
+  uint64_t lsn = state.last_lsn;
+  for (int i = 0; i < 2; i++) {
+    if (state.buffer_lsn[i] != 0 && state.buffer_lsn[i] - 1 < lsn)
+      lsn = state.buffer_lsn[i] - 1;
+  }
+  return lsn;
+}
+
 static inline void
 flush_buffer(JournalState &state, int idx, bool fsync = false)
 {
@@ -108,10 +272,22 @@ flush_buffer(JournalState &state, int idx, bool fsync = false)
     state.files[idx].write(state.buffer[idx].data(),
                     state.buffer[idx].size());
     state.count_bytes_flushed += state.buffer[idx].size();
+    state.checkpoint_bytes += state.buffer[idx].size();
 
     state.buffer[idx].clear();
+    state.buffer_lsn[idx] = 0;
+
+    uint64_t ticket;
+    {
+      ScopedLock lock(state.sync_mutex);
+      ticket = ++state.written_seq;
+      state.unsynced[idx] = true;
+      uint64_t lsn = written_lsn_bound(state);
+      if (lsn > state.written_lsn)
+        state.written_lsn = lsn;
+    }
     if (fsync)
-      state.files[idx].flush();
+      sync_files(state, ticket, false);
   }
 }
 
@@ -122,17 +298,211 @@ maybe_flush_buffer(JournalState &state, int idx)
     flush_buffer(state, idx);
 }
 
+// Acquires the Environment lock for the background thread. Returns false
+// if the thread has to terminate. Journal::close() holds the Environment
+// lock while it stops the thread, therefore the thread must not block
+// on that lock.
+static inline bool
+lock_environment(JournalState &state)
+{
+  SharedMutex &mutex = state.env->mutex();
+  while (!mutex.timed_lock(boost::posix_time::milliseconds(10))) {
+    if (state.flusher_stop)
+      return false;
+  }
+  return true;
+}
+
+// Writes and fsyncs all buffered entries; called by the background
+// flusher
+static inline void
+flush_async_commits(JournalState &state)
+{
+  SharedMutex &mutex = state.env->mutex();
+  if (!lock_environment(state))
+    return;
+
+  uint64_t ticket;
+  try {
+    flush_buffer(state, 0);
+    flush_buffer(state, 1);
+    state.async_pending = false;
+    state.async_bytes = 0;
+
+    ScopedLock lock(state.sync_mutex);
+    ticket = state.written_seq;
+  }
+  catch (Exception &) {
+    mutex.unlock();
+    throw;
+  }
+  mutex.unlock();
+
+  sync_files(state, ticket, false);
+  state.count_background_flushes++;
+}
+
+// Returns true if a checkpoint is required (see
+// UPS_PARAM_JOURNAL_CHECKPOINT_SIZE, UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL)
+static inline bool
+checkpoint_due(JournalState &state)
+{
+  if (state.checkpoint_bytes == 0)
+    return false;
+  if (state.checkpoint_size > 0
+          && state.checkpoint_bytes >= state.checkpoint_size)
+    return true;
+  return state.checkpoint_interval_sec > 0
+          && (uint64_t)::time(0) - state.checkpoint_time
+                >= state.checkpoint_interval_sec;
+}
+
+// Performs a checkpoint on the background thread
+static inline void
+background_checkpoint(JournalState &state)
+{
+  SharedMutex &mutex = state.env->mutex();
+  if (!lock_environment(state))
+    return;
+
+  try {
+    if (checkpoint_due(state))
+      state.env->journal()->checkpoint();
+  }
+  catch (Exception &) {
+    mutex.unlock();
+    throw;
+  }
+  mutex.unlock();
+}
+
+// Returns the time (in milliseconds) till the background thread wakes
+// up again; 0 if it only wakes up when it is notified
+static inline uint32_t
+flusher_timeout_msec(JournalState *state)
+{
+  uint32_t msec = state->flush_interval_msec;
+  // the age of the journal is checked every second
+  if (state->checkpoint_interval_sec > 0 && (msec == 0 || msec > 1000))
+    msec = 1000;
+  return msec;
+}
+
+// The background flusher; flushes the asynchronous commits periodically
+// (see UPS_PARAM_JOURNAL_FLUSH_INTERVAL) or when it is woken up, and
+// performs the checkpoints
+static void
+run_flusher(JournalState *state)
+{
+  ScopedLock lock(state->flusher_mutex);
+  while (!state->flusher_stop) {
+    if (!state->flusher_wakeup) {
+      uint32_t msec = flusher_timeout_msec(state);
+      if (msec > 0)
+        state->flusher_cond.timed_wait(lock,
+                boost::posix_time::milliseconds(msec));
+      else
+        state->flusher_cond.wait(lock);
+    }
+    state->flusher_wakeup = false;
+    if (state->flusher_stop)
+      continue;
+
+    bool flush = state->async_pending;
+    bool checkpoint = checkpoint_due(*state);
+    if (!flush && !checkpoint)
+      continue;
+
+    lock.unlock();
+    try {
+      if (flush)
+        flush_async_commits(*state);
+      if (checkpoint)
+        background_checkpoint(*state);
+    }
+    catch (Exception &ex) {
+      ups_log(("background flush of the journal failed with error %d (%s)",
+                              ex.code, ups_strerror(ex.code)));
+    }
+    lock.lock();
+  }
+}
+
+// Starts the background flusher (if necessary), and wakes it up if the
+// size limit of the asynchronous commits or of the checkpoints is exceeded
+static inline void
+notify_flusher(JournalState &state)
+{
+  bool async = state.async_pending
+          && (state.flush_interval_msec > 0 || state.flush_size > 0);
+  bool checkpoints = state.checkpoint_size > 0
+          || state.checkpoint_interval_sec > 0;
+  if (!async && !checkpoints)
+    return;
+
+  if (!state.flusher.get()) {
+    state.flusher_stop = false;
+    state.flusher.reset(new Thread(run_flusher, &state));
+  }
+
+  if ((async && state.flush_size > 0 && state.async_bytes >= state.flush_size)
+        || (state.checkpoint_size > 0
+            && state.checkpoint_bytes >= state.checkpoint_size)) {
+    ScopedLock lock(state.flusher_mutex);
+    state.flusher_wakeup = true;
+    state.flusher_cond.notify_one();
+  }
+}
+
+// Stops the background flusher
+static inline void
+stop_flusher(JournalState &state)
+{
+  if (!state.flusher.get())
+    return;
+
+  {
+    ScopedLock lock(state.flusher_mutex);
+    state.flusher_stop = true;
+    state.flusher_cond.notify_one();
+  }
+  state.flusher->join();
+  state.flusher.reset(0);
+}
+
+// Returns the size of journal file |idx|
+static inline uint64_t
+journal_file_size(JournalState &state, JournalReader *readers, int idx)
+{
+  if (readers)
+    return readers[idx].file_size;
+  return state.files[idx].file_size();
+}
+
+// Reads from journal file |idx|; uses the buffered |readers|, if available
+static inline void
+journal_pread(JournalState &state, JournalReader *readers, int idx,
+                uint64_t offset, void *ptr, size_t len)
+{
+  if (readers)
+    readers[idx].read(offset, ptr, len);
+  else
+    state.files[idx].pread(offset, ptr, len);
+}
+
 // Sequentially returns the next journal entry, starting with
 // the oldest entry.
 //
 // |iter| must be initialized with zeroes for the first call.
 // |auxbuffer| returns the auxiliary data of the entry and is either
 // a structure of type PJournalEntryInsert or PJournalEntryErase.
+// If |readers| are specified then the files are read through their
+// buffers.
 //
 // Returns an empty entry (lsn is zero) after the last element.
 static inline void
 read_entry(JournalState &state, Journal::Iterator *iter, PJournalEntry *entry,
-                ByteArray *auxbuffer)
+                ByteArray *auxbuffer, JournalReader *readers = 0)
 {
   auxbuffer->clear();
 
@@ -149,14 +519,14 @@ read_entry(JournalState &state, Journal::Iterator *iter, PJournalEntry *entry,
   }
 
   // get the size of the journal file
-  uint64_t filesize = state.files[iter->fdidx].file_size();
+  uint64_t filesize = journal_file_size(state, readers, iter->fdidx);
 
   // reached EOF? then either skip to the next file or we're done
   if (filesize == iter->offset) {
     if (iter->fdstart == iter->fdidx) {
       iter->fdidx = iter->fdidx == 1 ? 0 : 1;
       iter->offset = 0;
-      filesize = state.files[iter->fdidx].file_size();
+      filesize = journal_file_size(state, readers, iter->fdidx);
     }
     else {
       entry->lsn = 0;
@@ -172,7 +542,8 @@ read_entry(JournalState &state, Journal::Iterator *iter, PJournalEntry *entry,
 
   // now try to read the next entry
   try {
-    state.files[iter->fdidx].pread(iter->offset, entry, sizeof(*entry));
+    journal_pread(state, readers, iter->fdidx, iter->offset, entry,
+                    sizeof(*entry));
 
     iter->offset += sizeof(*entry);
 
@@ -180,8 +551,8 @@ read_entry(JournalState &state, Journal::Iterator *iter, PJournalEntry *entry,
     if (entry->followup_size) {
       auxbuffer->resize((uint32_t)entry->followup_size);
 
-      state.files[iter->fdidx].pread(iter->offset, auxbuffer->data(),
-                      (size_t)entry->followup_size);
+      journal_pread(state, readers, iter->fdidx, iter->offset,
+                      auxbuffer->data(), (size_t)entry->followup_size);
       iter->offset += entry->followup_size;
     }
   }
@@ -211,6 +582,19 @@ append_entry(JournalState &state, int idx,
     state.buffer[idx].append(ptr4, ptr4_size);
   if (ptr5_size)
     state.buffer[idx].append(ptr5, ptr5_size);
+
+  state.async_bytes += ptr1_size + ptr2_size + ptr3_size + ptr4_size
+          + ptr5_size;
+}
+
+// Remembers the |lsn| of an entry which was appended to buffer |idx|
+static inline void
+append_lsn(JournalState &state, int idx, uint64_t lsn)
+{
+  if (state.buffer_lsn[idx] == 0 || lsn < state.buffer_lsn[idx])
+    state.buffer_lsn[idx] = lsn;
+  if (lsn > state.last_lsn)
+    state.last_lsn = lsn;
 }
 
 // Switches the log file if necessary; returns the new log descriptor in the
@@ -333,18 +717,15 @@ append_changeset_page(JournalState &state, Page *page, uint32_t page_size)
 // Scans a file for the oldest changeset. Returns the lsn of this
 // changeset.
 static inline uint64_t
-scan_for_oldest_changeset(JournalState &state, File *file)
+scan_for_oldest_changeset(JournalReader *reader)
 {
   Journal::Iterator it;
   PJournalEntry entry;
-  ByteArray buffer;
 
   // get the next entry
   try {
-    uint64_t filesize = file->file_size();
-
-    while (it.offset < filesize) {
-      file->pread(it.offset, &entry, sizeof(entry));
+    while (it.offset < reader->file_size) {
+      reader->read(it.offset, &entry, sizeof(entry));
 
       if (entry.lsn == 0)
         break;
@@ -364,22 +745,175 @@ scan_for_oldest_changeset(JournalState &state, File *file)
   return 0;
 }
 
-// Redo all Changesets of a log file, in chronological order
+// Scans a file for the newest checkpoint. Returns the lsn of this
+// checkpoint, or 0.
+static inline uint64_t
+scan_for_newest_checkpoint(JournalReader *reader)
+{
+  Journal::Iterator it;
+  PJournalEntry entry;
+  uint64_t lsn = 0;
+
+  try {
+    while (it.offset < reader->file_size) {
+      reader->read(it.offset, &entry, sizeof(entry));
+
+      if (entry.lsn == 0)
+        break;
+
+      if (entry.type == Journal::kEntryTypeCheckpoint && entry.lsn > lsn)
+        lsn = entry.lsn;
+
+      it.offset += sizeof(entry) + entry.followup_size;
+    }
+  }
+  catch (Exception &ex) {
+    ups_log(("exception (error %d) while reading journal", ex.code));
+  }
+
+  return lsn;
+}
+
+// Writes a range of recovered pages; runs on a separate thread
+static void
+write_recovered_range(std::vector<Page *> *pages, ups_status_t *status)
+{
+  try {
+    Page::flush(*pages);
+  }
+  catch (Exception &ex) {
+    *status = ex.code;
+  }
+}
+
+//
+// Collects the newest image of each page which is restored from the
+// changesets. The pages are not read from disk, they are completely
+// overwritten. If a batch is full then its pages are written in file
+// order; with several recovery threads, ranges of the batch are written
+// concurrently.
+//
+struct RecoveredPages
+{
+  typedef std::map<uint64_t, uint8_t *> PageMap;
+
+  RecoveredPages(JournalState &state_, uint32_t threads_)
+    : state(state_), threads(threads_),
+      page_size(state_.env->config().page_size_bytes) {
+  }
+
+  ~RecoveredPages() {
+    for (PageMap::iterator it = pages.begin(); it != pages.end(); it++)
+      Memory::release(it->second);
+  }
+
+  // Stores the image of the page at |address|; an older image of the
+  // same page is replaced. Writes the batch if it is full.
+  void put(uint64_t address, const uint8_t *data) {
+    uint8_t *&buffer = pages[address];
+    if (!buffer)
+      buffer = Memory::allocate<uint8_t>(page_size);
+    ::memcpy(buffer, data, page_size);
+
+    if (pages.size() * page_size >= kRecoveryBatchSize)
+      flush();
+  }
+
+  // Writes all collected pages to disk
+  void flush() {
+    if (pages.empty())
+      return;
+
+    state.count_recovered_pages += pages.size();
+
+    // the header page is cached by the Environment and updated in memory
+    PageMap::iterator it = pages.find(0);
+    if (it != pages.end()) {
+      Page *header = state.env->header()->header_page();
+      ::memcpy(header->data(), it->second, page_size);
+      header->set_dirty(true);
+      header->flush();
+      Memory::release(it->second);
+      pages.erase(it);
+      if (pages.empty())
+        return;
+    }
+
+    // grow the file, if necessary
+    Device *device = state.env->device();
+    uint64_t end = pages.rbegin()->first + page_size;
+    if (end > device->file_size())
+      device->truncate(end);
+
+    // the Page objects take ownership of the buffers
+    std::vector<Page *> list;
+    list.reserve(pages.size());
+    for (it = pages.begin(); it != pages.end(); it++) {
+      Page *page = new Page(device);
+      page->assign_allocated_buffer(it->second, it->first);
+      page->set_dirty(true);
+      list.push_back(page);
+    }
+    pages.clear();
+
+    size_t count = std::max<size_t>(1, std::min<size_t>(threads, list.size()));
+    std::vector<std::vector<Page *> > ranges(count);
+    std::vector<ups_status_t> results(count, 0);
+    size_t per_range = (list.size() + count - 1) / count;
+    for (size_t i = 0; i < list.size(); i++)
+      ranges[i / per_range].push_back(list[i]);
+
+    if (count == 1) {
+      write_recovered_range(&ranges[0], &results[0]);
+    }
+    else {
+      boost::thread_group group;
+      for (size_t i = 0; i < count; i++)
+        group.create_thread(boost::bind(&write_recovered_range, &ranges[i],
+                                &results[i]));
+      group.join_all();
+    }
+
+    for (size_t i = 0; i < list.size(); i++)
+      delete list[i];
+
+    for (size_t i = 0; i < count; i++)
+      if (results[i])
+        throw Exception(results[i]);
+  }
+
+  // The journal state
+  JournalState &state;
+
+  // The number of threads for writing the pages
+  uint32_t threads;
+
+  // The page size
+  uint32_t page_size;
+
+  // The page images, sorted by address
+  PageMap pages;
+};
+
+// Redo all Changesets of a log file, in chronological order; changesets
+// older than |checkpoint_lsn| were already written to the database file
+// and are skipped.
 // Returns the highest lsn of the last changeset applied
 static inline uint64_t
-redo_all_changesets(JournalState &state, int fdidx)
+redo_all_changesets(JournalState &state, JournalReader *reader,
+                RecoveredPages &recovered, uint64_t checkpoint_lsn)
 {
   Journal::Iterator it;
   PJournalEntry entry;
-  ByteArray buffer;
   uint64_t max_lsn = 0;
+  uint32_t page_size = state.env->config().page_size_bytes;
+  ByteArray arena(page_size);
+  ByteArray tmp;
 
   // for each entry...
   try {
-    uint64_t log_file_size = state.files[fdidx].file_size();
-
-    while (it.offset < log_file_size) {
-      state.files[fdidx].pread(it.offset, &entry, sizeof(entry));
+    while (it.offset < reader->file_size) {
+      reader->read(it.offset, &entry, sizeof(entry));
 
       // Skip all log entries which are NOT from a changeset
       if (entry.type != Journal::kEntryTypeChangeset) {
@@ -389,74 +923,39 @@ redo_all_changesets(JournalState &state, int fdidx)
 
       max_lsn = entry.lsn;
 
+      if (entry.lsn < checkpoint_lsn) {
+        it.offset += sizeof(entry) + entry.followup_size;
+        continue;
+      }
+
       it.offset += sizeof(entry);
 
       // Read the Changeset header
       PJournalEntryChangeset changeset;
-      state.files[fdidx].pread(it.offset, &changeset, sizeof(changeset));
+      reader->read(it.offset, &changeset, sizeof(changeset));
       it.offset += sizeof(changeset);
 
-      uint32_t page_size = state.env->config().page_size_bytes;
-      ByteArray arena(page_size);
-      ByteArray tmp;
-
-      uint64_t file_size = state.env->device()->file_size();
-
       state.env->page_manager()->set_last_blob_page_id(changeset.last_blob_page);
 
       // for each page in this changeset...
       for (uint32_t i = 0; i < changeset.num_pages; i++) {
         PJournalEntryPageHeader page_header;
-        state.files[fdidx].pread(it.offset, &page_header,
-                        sizeof(page_header));
+        reader->read(it.offset, &page_header, sizeof(page_header));
         it.offset += sizeof(page_header);
         if (page_header.compressed_size > 0) {
           tmp.resize(page_size);
-          state.files[fdidx].pread(it.offset, tmp.data(),
-                        page_header.compressed_size);
+          reader->read(it.offset, tmp.data(), page_header.compressed_size);
           it.offset += page_header.compressed_size;
           state.compressor->decompress(tmp.data(),
                         page_header.compressed_size, page_size, &arena);
         }
         else {
-          state.files[fdidx].pread(it.offset, arena.data(), page_size);
+          reader->read(it.offset, arena.data(), page_size);
           it.offset += page_size;
         }
 
-        Page *page;
-
-        // now write the page to disk
-        if (page_header.address == file_size) {
-          file_size += page_size;
-
-          page = new Page(state.env->device());
-          page->alloc(0);
-        }
-        else if (page_header.address > file_size) {
-          file_size = (size_t)page_header.address + page_size;
-          state.env->device()->truncate(file_size);
-
-          page = new Page(state.env->device());
-          page->fetch(page_header.address);
-        }
-        else {
-          if (page_header.address == 0)
-            page = state.env->header()->header_page();
-          else
-            page = new Page(state.env->device());
-          page->fetch(page_header.address);
-        }
-        assert(page->address() == page_header.address);
-
-        // overwrite the page data
-        ::memcpy(page->data(), arena.data(), page_size);
-
-        // flush the modified page to disk
-        page->set_dirty(true);
-        page->flush();
-
-        if (page_header.address != 0)
-          delete page;
+        // the page is written when the batch is full
+        recovered.put(page_header.address, arena.data());
       }
     }
   }
@@ -472,34 +971,251 @@ redo_all_changesets(JournalState &state, int fdidx)
 // Recovers (re-applies) the physical changelog; returns the lsn of the
 // Changelog
 static inline uint64_t
-recover_changeset(JournalState &state)
+recover_changeset(JournalState &state, uint32_t threads)
 {
+  JournalReader readers[2];
+  readers[0].attach(&state.files[0]);
+  readers[1].attach(&state.files[1]);
+
   // scan through both files, look for the file with the oldest changeset.
-  uint64_t lsn1 = scan_for_oldest_changeset(state, &state.files[0]);
-  uint64_t lsn2 = scan_for_oldest_changeset(state, &state.files[1]);
+  uint64_t lsn1 = scan_for_oldest_changeset(&readers[0]);
+  uint64_t lsn2 = scan_for_oldest_changeset(&readers[1]);
 
   // both files are empty or do not contain a changeset?
   if (lsn1 == 0 && lsn2 == 0)
     return 0;
 
+  // changesets which precede the newest checkpoint are skipped
+  uint64_t checkpoint_lsn = std::max(scan_for_newest_checkpoint(&readers[0]),
+                          scan_for_newest_checkpoint(&readers[1]));
+
   // now redo all changesets chronologically
   state.current_fd = lsn1 < lsn2 ? 0 : 1;
 
-  uint64_t max_lsn1 = redo_all_changesets(state, state.current_fd);
-  uint64_t max_lsn2 = redo_all_changesets(state, state.current_fd == 0 ? 1 : 0);
+  RecoveredPages recovered(state, threads);
+  uint64_t max_lsn1 = redo_all_changesets(state, &readers[state.current_fd],
+                          recovered, checkpoint_lsn);
+  uint64_t max_lsn2 = redo_all_changesets(state,
+                          &readers[state.current_fd == 0 ? 1 : 0], recovered,
+                          checkpoint_lsn);
+  recovered.flush();
 
   // return the lsn of the newest changeset
   return std::max(max_lsn1, max_lsn2);
 }
 
+//
+// A journal entry which was read and decoded for the logical recovery;
+// the key and the record are already decompressed
+//
+struct RecoveryEntry
+{
+  RecoveryEntry() {
+    ::memset(&key, 0, sizeof(key));
+    ::memset(&record, 0, sizeof(record));
+  }
+
+  // The entry header
+  PJournalEntry entry;
+
+  // The auxiliary data (the transaction name, PJournalEntryInsert or
+  // PJournalEntryErase)
+  ByteArray aux;
+
+  // The key and the record of an insert or erase operation
+  ups_key_t key;
+  ups_record_t record;
+
+  // Storage for the decompressed key and record
+  ByteArray key_arena;
+  ByteArray record_arena;
+};
+
+//
+// Reads the journal entries for the logical recovery. With a separate
+// thread, the entries are read and decompressed ahead while the
+// operations are re-applied.
+//
+struct RecoveryReader
+{
+  RecoveryReader(JournalState &state_, uint64_t start_lsn_, bool threaded)
+    : state(state_), start_lsn(start_lsn_), status(0), done(false),
+      stop(false) {
+    readers[0].attach(&state.files[0]);
+    readers[1].attach(&state.files[1]);
+    if (threaded)
+      thread.reset(new Thread(boost::bind(&RecoveryReader::run, this)));
+  }
+
+  ~RecoveryReader() {
+    if (thread) {
+      {
+        ScopedLock lock(mutex);
+        stop = true;
+        cond.notify_all();
+      }
+      thread->join();
+    }
+    while (!queue.empty()) {
+      delete queue.front();
+      queue.pop_front();
+    }
+  }
+
+  // Returns the next entry, or null after the last entry. The caller
+  // deletes the entry. Throws if the entry cannot be decoded.
+  RecoveryEntry *next() {
+    if (!thread) {
+      RecoveryEntry *e = read();
+      if (!e && status)
+        throw Exception(status);
+      return e;
+    }
+
+    ScopedLock lock(mutex);
+    while (queue.empty() && !done)
+      cond.wait(lock);
+    if (queue.empty()) {
+      if (status)
+        throw Exception(status);
+      return 0;
+    }
+    RecoveryEntry *e = queue.front();
+    queue.pop_front();
+    cond.notify_all();
+    return e;
+  }
+
+  // The thread function; fills the queue
+  void run() {
+    while (true) {
+      RecoveryEntry *e = read();
+
+      ScopedLock lock(mutex);
+      while (queue.size() >= kRecoveryQueueSize && !stop)
+        cond.wait(lock);
+      if (!e || stop) {
+        delete e;
+        done = true;
+        cond.notify_all();
+        return;
+      }
+      queue.push_back(e);
+      cond.notify_all();
+    }
+  }
+
+  // Reads and decodes the next entry; returns null after the last entry
+  // or if an error occurred
+  RecoveryEntry *read() {
+    RecoveryEntry *e = new RecoveryEntry;
+    try {
+      read_entry(state, &it, &e->entry, &e->aux, readers);
+      if (e->entry.lsn == 0) {
+        delete e;
+        return 0;
+      }
+      decode(e);
+    }
+    catch (Exception &ex) {
+      status = ex.code;
+      delete e;
+      return 0;
+    }
+    return e;
+  }
+
+  // Decompresses the key and the record of an insert or erase operation.
+  // Operations which were already flushed with a changeset are skipped.
+  void decode(RecoveryEntry *e) {
+    if (e->entry.lsn <= start_lsn || !e->aux.data())
+      return;
+
+    if (e->entry.type == Journal::kEntryTypeInsert) {
+      PJournalEntryInsert *ins = (PJournalEntryInsert *)e->aux.data();
+      uint8_t *payload = ins->key_data();
+
+      // extract the key - it can be compressed or uncompressed
+      if (ins->compressed_key_size != 0) {
+        state.compressor->decompress(payload, ins->compressed_key_size,
+                        ins->key_size);
+        e->key_arena.append(state.compressor->arena.data(), ins->key_size);
+        e->key.data = e->key_arena.data();
+        payload += ins->compressed_key_size;
+      }
+      else {
+        e->key.data = payload;
+        payload += ins->key_size;
+      }
+      e->key.size = ins->key_size;
+
+      // extract the record - it can be compressed or uncompressed
+      if (ins->compressed_record_size != 0) {
+        state.compressor->decompress(payload, ins->compressed_record_size,
+                        ins->record_size);
+        e->record_arena.append(state.compressor->arena.data(),
+                        ins->record_size);
+        e->record.data = e->record_arena.data();
+      }
+      else
+        e->record.data = payload;
+      e->record.size = ins->record_size;
+    }
+    else if (e->entry.type == Journal::kEntryTypeErase) {
+      PJournalEntryErase *er = (PJournalEntryErase *)e->aux.data();
+      if (er->compressed_key_size != 0) {
+        state.compressor->decompress(er->key_data(), er->compressed_key_size,
+                        er->key_size);
+        e->key_arena.append(state.compressor->arena.data(), er->key_size);
+        e->key.data = e->key_arena.data();
+      }
+      else
+        e->key.data = er->key_data();
+      e->key.size = er->key_size;
+    }
+  }
+
+  // The journal state
+  JournalState &state;
+
+  // Operations up to this lsn were already flushed
+  uint64_t start_lsn;
+
+  // Buffered readers for both files
+  JournalReader readers[2];
+
+  // The current position in the journal
+  Journal::Iterator it;
+
+  // The error status, if decoding failed
+  ups_status_t status;
+
+  // The decoded entries; protected by |mutex|
+  std::deque<RecoveryEntry *> queue;
+
+  // True if the thread has read the last entry
+  bool done;
+
+  // True if the thread has to terminate
+  bool stop;
+
+  // Protects the queue and the flags
+  Mutex mutex;
+
+  // Signals changes of the queue
+  Condition cond;
+
+  // The thread; null if the entries are read on demand
+  ScopedPtr<Thread> thread;
+};
+
 // Recovers the logical journal
 static inline void
 recover_journal(JournalState &state, Context *context,
-                LocalTransactionManager *txn_manager, uint64_t start_lsn)
+                LocalTransactionManager *txn_manager, uint64_t start_lsn,
+                uint32_t threads)
 {
   ups_status_t st = 0;
-  Journal::Iterator it;
-  ByteArray buffer;
 
   /* recovering the journal is rather simple - we iterate over the
    * files and re-apply EVERY operation (incl. txn_begin and txn_abort),
@@ -510,6 +1226,10 @@ recover_journal(JournalState &state, Context *context,
    *
    * When done then auto-abort all transactions that were not yet
    * committed.
+   *
+   * The operations are re-applied in their original order (the
+   * transaction layer is not thread-safe), but with more than one
+   * recovery thread the entries are read and decompressed ahead.
    */
 
   // make sure that there are no pending transactions - start with
@@ -520,139 +1240,105 @@ recover_journal(JournalState &state, Context *context,
   // do not append to the journal during recovery
   state.disable_logging = true;
 
-  do {
-    PJournalEntry entry;
-
-    // get the next entry
-    read_entry(state, &it, &entry, &buffer);
-
-    // reached end of logfile?
-    if (!entry.lsn)
-      break;
-
-    // re-apply this operation
-    switch (entry.type) {
-      case Journal::kEntryTypeTxnBegin: {
-        Transaction *txn = 0;
-        st = ups_txn_begin((ups_txn_t **)&txn, (ups_env_t *)state.env, 
-                (const char *)buffer.data(), 0, UPS_DONT_LOCK);
-        // on success: patch the txn ID
-        if (st == 0) {
-          txn->set_id(entry.txn_id);
-          txn_manager->set_txn_id(entry.txn_id);
-        }
-        break;
-      }
-      case Journal::kEntryTypeTxnAbort: {
-        Transaction *txn = get_txn(state, txn_manager, entry.txn_id);
-        st = ups_txn_abort((ups_txn_t *)txn, UPS_DONT_LOCK);
-        break;
-      }
-      case Journal::kEntryTypeTxnCommit: {
-        Transaction *txn = get_txn(state, txn_manager, entry.txn_id);
-        st = ups_txn_commit((ups_txn_t *)txn, UPS_DONT_LOCK);
-        break;
-      }
-      case Journal::kEntryTypeInsert: {
-        PJournalEntryInsert *ins = (PJournalEntryInsert *)buffer.data();
-        Transaction *txn = 0;
-        Database *db;
-        ups_key_t key = {0};
-        ups_record_t record = {0};
-        if (!ins) {
-          st = UPS_IO_ERROR;
-          goto bail;
-        }
+  try {
+    RecoveryReader reader(state, start_lsn, threads > 1);
 
-        // do not insert if the key was already flushed to disk
-        if (entry.lsn <= start_lsn)
-          continue;
+    do {
+      // get the next entry
+      ScopedPtr<RecoveryEntry> e(reader.next());
 
-        uint8_t *payload = ins->key_data();
+      // reached end of logfile?
+      if (!e)
+        break;
 
-        // extract the key - it can be compressed or uncompressed
-        ByteArray keyarena;
-        if (ins->compressed_key_size != 0) {
-          state.compressor->decompress(payload, ins->compressed_key_size,
-                          ins->key_size);
-          keyarena.append(state.compressor->arena.data(), ins->key_size);
-          key.data = keyarena.data();
-          payload += ins->compressed_key_size;
+      PJournalEntry &entry = e->entry;
+
+      // re-apply this operation
+      switch (entry.type) {
+        case Journal::kEntryTypeTxnBegin: {
+          Transaction *txn = 0;
+          st = ups_txn_begin((ups_txn_t **)&txn, (ups_env_t *)state.env, 
+                  (const char *)e->aux.data(), 0, UPS_DONT_LOCK);
+          // on success: patch the txn ID
+          if (st == 0) {
+            txn->set_id(entry.txn_id);
+            txn_manager->set_txn_id(entry.txn_id);
+          }
+          break;
         }
-        else {
-          key.data = payload;
-          payload += ins->key_size;
+        case Journal::kEntryTypeTxnAbort: {
+          Transaction *txn = get_txn(state, txn_manager, entry.txn_id);
+          st = ups_txn_abort((ups_txn_t *)txn, UPS_DONT_LOCK);
+          break;
         }
-        key.size = ins->key_size;
-        // extract the record - it can be compressed or uncompressed
-        ByteArray recarena;
-        if (ins->compressed_record_size != 0) {
-          state.compressor->decompress(payload, ins->compressed_record_size,
-                          ins->record_size);
-          recarena.append(state.compressor->arena.data(), ins->record_size);
-          record.data = recarena.data();
-          payload += ins->compressed_record_size;
+        case Journal::kEntryTypeTxnCommit: {
+          Transaction *txn = get_txn(state, txn_manager, entry.txn_id);
+          st = ups_txn_commit((ups_txn_t *)txn, UPS_DONT_LOCK);
+          break;
         }
-        else {
-          record.data = payload;
-          payload += ins->record_size;
+        case Journal::kEntryTypeInsert: {
+          PJournalEntryInsert *ins = (PJournalEntryInsert *)e->aux.data();
+          Transaction *txn = 0;
+          Database *db;
+          if (!ins) {
+            st = UPS_IO_ERROR;
+            break;
+          }
+
+          // do not insert if the key was already flushed to disk
+          if (entry.lsn <= start_lsn)
+            continue;
+
+          if (entry.txn_id)
+            txn = get_txn(state, txn_manager, entry.txn_id);
+          db = get_db(state, entry.dbname);
+          st = ups_db_insert((ups_db_t *)db, (ups_txn_t *)txn, &e->key,
+                          &e->record, ins->insert_flags | UPS_DONT_LOCK);
+          break;
         }
-        record.size = ins->record_size;
-        if (entry.txn_id)
-          txn = get_txn(state, txn_manager, entry.txn_id);
-        db = get_db(state, entry.dbname);
-        st = ups_db_insert((ups_db_t *)db, (ups_txn_t *)txn, &key, &record,
-                        ins->insert_flags | UPS_DONT_LOCK);
-        break;
-      }
-      case Journal::kEntryTypeErase: {
-        PJournalEntryErase *e = (PJournalEntryErase *)buffer.data();
-        Transaction *txn = 0;
-        Database *db;
-        ups_key_t key = {0};
-        if (!e) {
-          st = UPS_IO_ERROR;
-          goto bail;
+        case Journal::kEntryTypeErase: {
+          PJournalEntryErase *er = (PJournalEntryErase *)e->aux.data();
+          Transaction *txn = 0;
+          Database *db;
+          if (!er) {
+            st = UPS_IO_ERROR;
+            break;
+          }
+
+          // do not erase if the key was already erased from disk
+          if (entry.lsn <= start_lsn)
+            continue;
+
+          if (entry.txn_id)
+            txn = get_txn(state, txn_manager, entry.txn_id);
+          db = get_db(state, entry.dbname);
+          st = ups_db_erase((ups_db_t *)db, (ups_txn_t *)txn, &e->key,
+                          er->erase_flags | UPS_DONT_LOCK);
+          // key might have already been erased when the changeset
+          // was flushed
+          if (st == UPS_KEY_NOT_FOUND)
+            st = 0;
+          break;
         }
-
-        // do not erase if the key was already erased from disk
-        if (entry.lsn <= start_lsn)
-          continue;
-
-        if (entry.txn_id)
-          txn = get_txn(state, txn_manager, entry.txn_id);
-        db = get_db(state, entry.dbname);
-        key.data = e->key_data();
-        if (e->compressed_key_size != 0) {
-          state.compressor->decompress(e->key_data(), e->compressed_key_size,
-                          e->key_size);
-          key.data = state.compressor->arena.data();
+        case Journal::kEntryTypeChangeset:
+        case Journal::kEntryTypeCheckpoint: {
+          // skip this; the changeset was already applied
+          break;
         }
-        else
-          key.data = e->key_data();
-        key.size = e->key_size;
-        st = ups_db_erase((ups_db_t *)db, (ups_txn_t *)txn, &key,
-                        e->erase_flags | UPS_DONT_LOCK);
-        // key might have already been erased when the changeset
-        // was flushed
-        if (st == UPS_KEY_NOT_FOUND)
-          st = 0;
-        break;
-      }
-      case Journal::kEntryTypeChangeset: {
-        // skip this; the changeset was already applied
-        break;
-      }
-      default:
-        ups_log(("invalid journal entry type or journal is corrupt"));
-        st = UPS_IO_ERROR;
+        default:
+          ups_log(("invalid journal entry type or journal is corrupt"));
+          st = UPS_IO_ERROR;
       }
 
       if (st)
-        goto bail;
-  } while (1);
+        break;
+      state.count_recovered_operations++;
+    } while (1);
+  }
+  catch (Exception &ex) {
+    st = ex.code;
+  }
 
-bail:
   // all transactions which are not yet committed will be aborted
   abort_uncommitted_txns(state, txn_manager);
 
@@ -675,11 +1361,35 @@ JournalState::JournalState(LocalEnvironment *env_)
   : env(env_), current_fd(0),
     threshold(env_->config().journal_switch_threshold),
     disable_logging(false), count_bytes_flushed(0),
-    count_bytes_before_compression(0), count_bytes_after_compression(0)
+    count_bytes_before_compression(0), count_bytes_after_compression(0),
+    count_commits(0), count_fsyncs(0), written_seq(0), synced_seq(0),
+    sync_in_progress(false), sync_waiters(0), sync_urgent(0),
+    commit_ticket(0),
+    group_commit_delay_usec(env_->config().group_commit_delay_usec),
+    group_commit_size(env_->config().group_commit_size),
+    last_lsn(0), commit_lsn(0), written_lsn(0), durable_lsn(0),
+    async_pending(false), async_bytes(0), flusher_wakeup(false),
+    flusher_stop(false),
+    flush_interval_msec(env_->config().journal_flush_interval_msec),
+    flush_size(env_->config().journal_flush_size), count_async_commits(0),
+    count_background_flushes(0),
+    recovery_threads(env_->config().recovery_threads),
+    count_recovered_pages(0), count_recovered_operations(0),
+    recovery_time_usec(0),
+    checkpoint_size(env_->config().journal_checkpoint_size),
+    checkpoint_interval_sec(env_->config().journal_checkpoint_interval_sec),
+    checkpoint_bytes(0), checkpoint_time((uint64_t)::time(0)),
+    count_checkpoints(0)
 {
   if (threshold == 0)
     threshold = kSwitchTxnThreshold;
 
+  unsynced[0] = false;
+  unsynced[1] = false;
+
+  buffer_lsn[0] = 0;
+  buffer_lsn[1] = 0;
+
   open_txn[0] = 0;
   open_txn[1] = 0;
   closed_txn[0] = 0;
@@ -694,6 +1404,11 @@ Journal::Journal(LocalEnvironment *env)
     state.compressor.reset(CompressorFactory::create(algo));
 }
 
+Journal::~Journal()
+{
+  stop_flusher(state);
+}
+
 void
 Journal::create()
 {
@@ -746,6 +1461,7 @@ Journal::append_txn_begin(LocalTransaction *txn, const char *name, uint64_t lsn)
                 (uint32_t)txn->get_name().size() + 1);
   else
     append_entry(state, cur, (uint8_t *)&entry, (uint32_t)sizeof(entry));
+  append_lsn(state, cur, lsn);
   maybe_flush_buffer(state, cur);
 
   state.open_txn[cur]++;
@@ -776,12 +1492,13 @@ Journal::append_txn_abort(LocalTransaction *txn, uint64_t lsn)
   state.closed_txn[idx]++;
 
   append_entry(state, idx, (uint8_t *)&entry, sizeof(entry));
+  append_lsn(state, idx, lsn);
   maybe_flush_buffer(state, idx);
   // no need for fsync - incomplete transactions will be aborted anyway
 }
 
 void
-Journal::append_txn_commit(LocalTransaction *txn, uint64_t lsn)
+Journal::append_txn_commit(LocalTransaction *txn, uint64_t lsn, bool async)
 {
   if (unlikely(state.disable_logging))
     return;
@@ -799,9 +1516,37 @@ Journal::append_txn_commit(LocalTransaction *txn, uint64_t lsn)
   int idx = txn->get_log_desc();
 
   append_entry(state, idx, (uint8_t *)&entry, sizeof(entry));
+  append_lsn(state, idx, lsn);
+  state.commit_lsn = lsn;
+  state.count_commits++;
+
+  // an asynchronous commit stays in the buffer; it is written and synced
+  // by the background flusher, or by the next synchronous commit
+  if (async) {
+    state.count_async_commits++;
+    state.async_pending = true;
+    maybe_flush_buffer(state, idx);
+    notify_flusher(state);
+    return;
+  }
 
-  // and flush the file
-  flush_buffer(state, idx, ISSET(state.env->get_flags(), UPS_ENABLE_FSYNC));
+  // a synchronous commit also writes the pending asynchronous commits of
+  // the other file, otherwise it could become durable before a commit
+  // it depends on
+  if (state.async_pending) {
+    flush_buffer(state, idx == 0 ? 1 : 0);
+    state.async_pending = false;
+  }
+
+  // and write the file; the fsync is performed by the caller after the
+  // Environment lock was released (see take_commit_ticket()), therefore
+  // commits of concurrent threads share a single fsync
+  flush_buffer(state, idx);
+
+  if (ISSET(state.env->get_flags(), UPS_ENABLE_FSYNC))
+    state.commit_ticket = state.written_seq;
+
+  notify_flusher(state);
 }
 
 void
@@ -885,6 +1630,7 @@ Journal::append_insert(Database *db, LocalTransaction *txn,
   state.buffer[idx].overwrite(entry_position + sizeof(entry),
                   (uint8_t *)&insert, sizeof(PJournalEntryInsert) - 1);
 
+  append_lsn(state, idx, lsn);
   maybe_flush_buffer(state, idx);
 }
 
@@ -936,12 +1682,13 @@ Journal::append_erase(Database *db, LocalTransaction *txn, ups_key_t *key,
   append_entry(state, idx, (uint8_t *)&entry, sizeof(entry),
                 (uint8_t *)&erase, sizeof(PJournalEntryErase) - 1,
                 (uint8_t *)payload_data, payload_size);
+  append_lsn(state, idx, lsn);
   maybe_flush_buffer(state, idx);
 }
 
 int
 Journal::append_changeset(std::vector<Page *> &pages,
-                uint64_t last_blob_page, uint64_t lsn)
+                uint64_t last_blob_page, uint64_t lsn, bool durable)
 {
   assert(pages.size() > 0);
 
@@ -983,12 +1730,13 @@ Journal::append_changeset(std::vector<Page *> &pages,
   // and patch in the followup-size
   state.buffer[state.current_fd].overwrite(entry_position,
           (uint8_t *)&entry, sizeof(entry));
+  append_lsn(state, state.current_fd, lsn);
 
   UPS_INDUCE_ERROR(ErrorInducer::kChangesetFlush);
 
   // and flush the file
   flush_buffer(state, state.current_fd,
-                  ISSET(state.env->get_flags(), UPS_ENABLE_FSYNC));
+                  durable && ISSET(state.env->get_flags(), UPS_ENABLE_FSYNC));
 
   UPS_INDUCE_ERROR(ErrorInducer::kChangesetFlush);
 
@@ -997,9 +1745,63 @@ Journal::append_changeset(std::vector<Page *> &pages,
   // counter for "opened transactions" is incremented. It will be decremented
   // by the worker thread as soon as the dirty pages are flushed to disk.
   state.open_txn[state.current_fd]++;
+
+  notify_flusher(state);
   return state.current_fd;
 }
 
+void
+Journal::sync(uint64_t ticket, bool collect)
+{
+  if (ticket != 0)
+    sync_files(state, ticket, collect);
+}
+
+uint64_t
+Journal::take_commit_ticket()
+{
+  uint64_t ticket = state.commit_ticket;
+  state.commit_ticket = 0;
+  return ticket;
+}
+
+uint64_t
+Journal::sync_ticket()
+{
+  ScopedLock lock(state.sync_mutex);
+  return state.written_seq;
+}
+
+uint64_t
+Journal::durable_lsn()
+{
+  ScopedLock lock(state.sync_mutex);
+  return state.durable_lsn;
+}
+
+uint64_t
+Journal::durable_ticket(uint64_t lsn)
+{
+  if (lsn == 0)
+    lsn = state.commit_lsn;
+  // an lsn of a previous session is already durable
+  if (lsn > state.last_lsn)
+    lsn = state.last_lsn;
+
+  ScopedLock lock(state.sync_mutex);
+  if (lsn <= state.durable_lsn)
+    return 0;
+
+  if (lsn > state.written_lsn) {
+    lock.unlock();
+    flush_buffer(state, 0);
+    flush_buffer(state, 1);
+    state.async_pending = false;
+    lock.lock();
+  }
+  return state.written_seq;
+}
+
 void
 Journal::changeset_flushed(int fd_index)
 {
@@ -1019,9 +1821,78 @@ Journal::transaction_flushed(LocalTransaction *txn)
   state.closed_txn[idx]++;
 }
 
+void
+Journal::checkpoint()
+{
+  LocalEnvironment *env = state.env;
+  LocalTransactionManager *txn_manager
+          = (LocalTransactionManager *)env->txn_manager();
+  Context context(env, 0, 0);
+
+  // write the committed Transactions and the dirty pages to the database
+  // file; the journal entries are only discarded when the file is durable
+  if (txn_manager)
+    txn_manager->flush_committed_txns(&context);
+  env->page_manager()->flush_all_pages();
+  env->device()->flush();
+
+  // make the remaining entries durable, otherwise the durable lsn would
+  // no longer reflect the asynchronous commits of a truncated file
+  flush_buffer(state, 0);
+  flush_buffer(state, 1);
+  state.async_pending = false;
+  state.async_bytes = 0;
+  uint64_t ticket;
+  {
+    ScopedLock lock(state.sync_mutex);
+    ticket = state.written_seq;
+  }
+  sync_files(state, ticket, false);
+
+  // the entries of Transactions which are not yet flushed are still
+  // required for recovery; all other files are truncated
+  uint32_t live[2] = {0, 0};
+  if (txn_manager) {
+    Transaction *txn = txn_manager->get_oldest_txn();
+    for (; txn != 0; txn = txn->get_next()) {
+      if (NOTSET(txn->get_flags(), UPS_TXN_TEMPORARY))
+        live[((LocalTransaction *)txn)->get_log_desc()]++;
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    if (live[i] == 0)
+      clear_file(state, i);
+    else
+      state.open_txn[i] = live[i];
+  }
+
+  // recovery does not re-apply the changesets which precede this record
+  PJournalEntry entry;
+  entry.lsn = env->next_lsn();
+  entry.type = Journal::kEntryTypeCheckpoint;
+  append_entry(state, state.current_fd, (uint8_t *)&entry, sizeof(entry));
+  append_lsn(state, state.current_fd, entry.lsn);
+  flush_buffer(state, state.current_fd,
+                  ISSET(env->get_flags(), UPS_ENABLE_FSYNC));
+
+  state.checkpoint_bytes = 0;
+  state.checkpoint_time = (uint64_t)::time(0);
+  state.count_checkpoints++;
+}
+
 void
 Journal::close(bool noclear)
 {
+  // the background flusher must not touch the files anymore
+  stop_flusher(state);
+
+  // wait till a concurrent fsync is completed
+  {
+    ScopedLock lock(state.sync_mutex);
+    while (state.sync_in_progress)
+      state.sync_cond.wait(lock);
+  }
+
   // the noclear flag is set during testing, for checking whether the files
   // contain the correct data. Flush the buffers, otherwise the tests will
   // fail because data is missing
@@ -1043,9 +1914,11 @@ void
 Journal::recover(LocalTransactionManager *txn_manager)
 {
   Context context(state.env, 0, 0);
+  boost::posix_time::ptime start
+          = boost::posix_time::microsec_clock::universal_time();
 
   // first redo the changesets
-  uint64_t start_lsn = recover_changeset(state);
+  uint64_t start_lsn = recover_changeset(state, state.recovery_threads);
 
   // load the state of the PageManager; the PageManager state is loaded AFTER
   // physical recovery because its page might have been restored in
@@ -1056,10 +1929,14 @@ Journal::recover(LocalTransactionManager *txn_manager)
 
   // then start the normal recovery
   if (ISSET(state.env->get_flags(), UPS_ENABLE_TRANSACTIONS))
-    recover_journal(state, &context, txn_manager, start_lsn);
+    recover_journal(state, &context, txn_manager, start_lsn,
+                    state.recovery_threads);
 
   // clear the journal files
   clear();
+
+  state.recovery_time_usec = (boost::posix_time::microsec_clock::universal_time()
+                  - start).total_microseconds();
 }
 
 void
@@ -36,6 +36,20 @@
  * was written. In case of a commit or a changeset there will also be an
  * fsync, if UPS_ENABLE_FSYNC is enabled.
  *
+ * Asynchronous commits (UPS_TXN_ASYNC_COMMIT) are not flushed immediately.
+ * A background thread writes and fsyncs the buffers periodically; the
+ * lsn up to which all entries are durable is tracked, and callers can wait
+ * till their commit is durable (ups_env_wait_durable_lsn).
+ *
+ * A checkpoint flushes all committed Transactions and all dirty pages
+ * to the database file, truncates the journal files which no longer
+ * contain entries of open Transactions and appends a checkpoint record.
+ * Checkpoints are performed by the background thread when the journal
+ * grew by UPS_PARAM_JOURNAL_CHECKPOINT_SIZE bytes or after
+ * UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL seconds; this bounds the size of
+ * the journal and the duration of the recovery. Changesets older than the
+ * newest checkpoint are not re-applied during recovery.
+ *
  * The physical information is a collection of pages which are modified in
  * one or more database operations (i.e. ups_db_erase). This collection is
  * called a "changeset" and implemented in changeset.h/.cc. As soon as the
@@ -127,7 +141,11 @@ struct Journal
     kEntryTypeErase      = 5,
 
     // marks a whole changeset operation (writes modified pages)
-    kEntryTypeChangeset  = 6
+    kEntryTypeChangeset  = 6,
+
+    // marks a checkpoint; all older changesets were written to the
+    // database file
+    kEntryTypeCheckpoint = 7
   };
 
   //
@@ -151,6 +169,9 @@ struct Journal
   // Constructor
   Journal(LocalEnvironment *env);
 
+  // Destructor; stops the background flusher
+  ~Journal();
+
   // Creates a new journal
   void create();
 
@@ -178,8 +199,11 @@ struct Journal
   // Appends a journal entry for ups_txn_abort/kEntryTypeTxnAbort
   void append_txn_abort(LocalTransaction *txn, uint64_t lsn);
 
-  // Appends a journal entry for ups_txn_commit/kEntryTypeTxnCommit
-  void append_txn_commit(LocalTransaction *txn, uint64_t lsn);
+  // Appends a journal entry for ups_txn_commit/kEntryTypeTxnCommit.
+  // If |async| is true then the entry stays in the buffer; it is
+  // flushed by a background thread (UPS_TXN_ASYNC_COMMIT)
+  void append_txn_commit(LocalTransaction *txn, uint64_t lsn,
+                  bool async = false);
 
   // Appends a journal entry for ups_insert/kEntryTypeInsert
   void append_insert(Database *db, LocalTransaction *txn,
@@ -193,9 +217,33 @@ struct Journal
 
   // Appends a journal entry for a whole changeset/kEntryTypeChangeset
   // Returns the current file descriptor, which is the parameter for
-  // on_changeset_flush()
+  // on_changeset_flush(). If |durable| is false then the fsync is
+  // skipped; the caller then has to call |sync()| before the pages are
+  // written
   int append_changeset(std::vector<Page *> &pages, uint64_t last_blob_page,
-                  uint64_t lsn);
+                  uint64_t lsn, bool durable = true);
+
+  // Returns the ticket of the most recent commit and resets it; the
+  // caller then waits with |sync()| till the commit is durable.
+  // Returns 0 if the commit does not require an fsync
+  uint64_t take_commit_ticket();
+
+  // Returns a ticket for all data that was written so far
+  uint64_t sync_ticket();
+
+  // Returns the lsn up to which all entries are durable
+  uint64_t durable_lsn();
+
+  // Writes all entries up to |lsn| (or up to the most recent commit, if
+  // |lsn| is 0) and returns a ticket for |sync()|. Returns 0 if these
+  // entries are already durable
+  uint64_t durable_ticket(uint64_t lsn);
+
+  // Waits till all data of |ticket| is durable (group commit); does not
+  // require the Environment lock. If |collect| is true then the fsync
+  // can be delayed to collect more commits (see
+  // UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY).
+  void sync(uint64_t ticket, bool collect = false);
 
   // Called by the worker thread as soon as a changeset was flushed
   void changeset_flushed(int fd_index);
@@ -203,6 +251,11 @@ struct Journal
   // Adjusts the transaction counters; called whenever |txn| is flushed.
   void transaction_flushed(LocalTransaction *txn);
 
+  // Performs a checkpoint: flushes all committed Transactions and dirty
+  // pages, truncates the journal files which are no longer required and
+  // appends a checkpoint record. The caller holds the Environment lock.
+  void checkpoint();
+
   // Empties the journal, removes all entries
   void clear();
 
@@ -220,6 +273,14 @@ struct Journal
             = state.count_bytes_before_compression;
     metrics->journal_bytes_after_compression
             = state.count_bytes_after_compression;
+    metrics->journal_commits = state.count_commits;
+    metrics->journal_fsyncs = state.count_fsyncs;
+    metrics->journal_async_commits = state.count_async_commits;
+    metrics->journal_background_flushes = state.count_background_flushes;
+    metrics->journal_recovery_time_usec = state.recovery_time_usec;
+    metrics->journal_recovered_pages = state.count_recovered_pages;
+    metrics->journal_recovered_operations = state.count_recovered_operations;
+    metrics->journal_checkpoints = state.count_checkpoints;
   }
 
   // Flushes all buffers to disk. Used for testing.
@@ -26,6 +26,7 @@
 #include "ups/types.h" // for metrics
 
 #include "1base/dynamic_array.h"
+#include "1base/mutex.h"
 #include "1base/scoped_ptr.h"
 #include "1os/file.h"
 #include "2page/page_collection.h"
@@ -84,6 +85,129 @@ struct JournalState
   // Counting the bytes after compression (for ups_env_get_metrics)
   uint64_t count_bytes_after_compression;
 
+  // Counting the committed Transactions (for ups_env_get_metrics)
+  uint64_t count_commits;
+
+  // Counting the fsync calls (for ups_env_get_metrics)
+  boost::atomic<uint64_t> count_fsyncs;
+
+  // Protects the group commit state (|written_seq| ... |sync_waiters|);
+  // the files are synced without holding the Environment lock
+  Mutex sync_mutex;
+
+  // Signals that an fsync was completed, or that a new thread is waiting
+  Condition sync_cond;
+
+  // Incremented whenever a buffer was written to a file
+  uint64_t written_seq;
+
+  // The |written_seq| which is guaranteed to be durable
+  uint64_t synced_seq;
+
+  // True if the file has data which is not yet durable
+  bool unsynced[2];
+
+  // True while a thread performs the fsync for a whole group
+  bool sync_in_progress;
+
+  // The number of threads waiting for an fsync
+  uint32_t sync_waiters;
+
+  // The number of waiting threads which must not be delayed because they
+  // hold locks (i.e. the worker thread, which holds the page locks of
+  // a changeset); a collecting leader stops waiting for more commits
+  uint32_t sync_urgent;
+
+  // The |written_seq| of the most recent commit, or 0; see
+  // |Journal::take_commit_ticket()|
+  uint64_t commit_ticket;
+
+  // Group commit: max. time (in microseconds) for collecting commits
+  // before an fsync is started
+  uint32_t group_commit_delay_usec;
+
+  // Group commit: stop collecting if this number of commits is waiting
+  uint32_t group_commit_size;
+
+  // The lsn of the first entry in each buffer; 0 if the buffer is empty
+  uint64_t buffer_lsn[2];
+
+  // The lsn of the most recent entry
+  uint64_t last_lsn;
+
+  // The lsn of the most recent commit
+  uint64_t commit_lsn;
+
+  // All entries up to this lsn were written to the files; protected
+  // by |sync_mutex|
+  uint64_t written_lsn;
+
+  // All entries up to this lsn are durable; protected by |sync_mutex|
+  uint64_t durable_lsn;
+
+  // True if the buffers contain asynchronous commits; read by the
+  // background flusher without holding the Environment lock
+  boost::atomic<bool> async_pending;
+
+  // The number of bytes appended since the previous background flush
+  uint64_t async_bytes;
+
+  // The background thread for asynchronous commits and checkpoints;
+  // started with the first commit which requires it
+  ScopedPtr<Thread> flusher;
+
+  // Protects |flusher_wakeup|; the flusher waits on |flusher_cond|
+  Mutex flusher_mutex;
+
+  // Wakes up the flusher
+  Condition flusher_cond;
+
+  // True if the flusher has to flush immediately
+  bool flusher_wakeup;
+
+  // True if the flusher has to terminate
+  boost::atomic<bool> flusher_stop;
+
+  // The interval (in milliseconds) of the background flush; 0 if disabled
+  uint32_t flush_interval_msec;
+
+  // Wake up the flusher if |async_bytes| exceeds this limit; 0 if disabled
+  uint64_t flush_size;
+
+  // Counting the asynchronous commits (for ups_env_get_metrics)
+  uint64_t count_async_commits;
+
+  // Counting the background flushes (for ups_env_get_metrics)
+  boost::atomic<uint64_t> count_background_flushes;
+
+  // Perform a checkpoint if this number of bytes was written since the
+  // previous checkpoint; 0 if disabled
+  uint64_t checkpoint_size;
+
+  // Perform a checkpoint after this number of seconds; 0 if disabled
+  uint32_t checkpoint_interval_sec;
+
+  // The number of bytes written since the previous checkpoint
+  boost::atomic<uint64_t> checkpoint_bytes;
+
+  // The time of the previous checkpoint (or of the first write)
+  boost::atomic<uint64_t> checkpoint_time;
+
+  // Counting the checkpoints (for ups_env_get_metrics)
+  uint64_t count_checkpoints;
+
+  // The number of threads used for recovery (see UPS_PARAM_RECOVERY_THREADS)
+  uint32_t recovery_threads;
+
+  // Counting the pages restored from changesets (for ups_env_get_metrics)
+  uint64_t count_recovered_pages;
+
+  // Counting the re-applied operations (for ups_env_get_metrics)
+  uint64_t count_recovered_operations;
+
+  // The duration of the last recovery, in microseconds
+  uint64_t recovery_time_usec;
+
   // A map of all opened Databases
   typedef std::map<uint16_t, Database *> DatabaseMap;
   DatabaseMap database_map;
@@ -20,11 +20,16 @@
 #include "0root/root.h"
 
 #include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <limits>
+#include <boost/function.hpp>
 
 #include "3rdparty/murmurhash3/MurmurHash3.h"
 // Always verify that a file of level N does not include headers > N!
 #include "1base/signal.h"
 #include "1base/dynamic_array.h"
+#include "1os/file.h"
 #include "2page/page.h"
 #include "2device/device.h"
 #include "3page_manager/page_manager.h"
@@ -45,6 +50,28 @@ static inline Page *
 fetch_unlocked(PageManagerState *state, Context *context,
                 uint64_t address, uint32_t flags);
 
+#include "1base/packstart.h"
+
+// The header of the file with the addresses of the cached pages; the
+// addresses follow the header
+UPS_PACK_0 struct UPS_PACK_1 PWarmupHeader
+{
+  enum {
+    kMagic = ('U' << 24) | ('P' << 16) | ('S' << 8) | 'W'
+  };
+
+  // the magic
+  uint32_t magic;
+
+  // the page size of the Environment
+  uint32_t page_size;
+
+  // the number of addresses
+  uint64_t count;
+} UPS_PACK_2;
+
+#include "1base/packstop.h"
+
 template <typename T>
 struct Deleter
 {
@@ -68,9 +95,92 @@ struct AsyncFlushMessage
   std::vector<uint64_t> page_ids;
 };
 
+// Writes a batch of locked pages, then unlocks them
+static void
+flush_and_unlock(std::vector<Page *> &batch)
+{
+  try {
+    Page::flush(batch);
+  }
+  catch (Exception &) {
+    // ignore the pages, fall through
+  }
+  for (std::vector<Page *>::iterator it = batch.begin();
+                  it != batch.end();
+                  it++)
+    (*it)->mutex().unlock();
+  batch.clear();
+}
+
+// Counts the batches which are flushed by the flush threads
+struct FlushLatch
+{
+  FlushLatch()
+    : pending(0) {
+  }
+
+  // Adds a batch
+  void add() {
+    ScopedLock lock(mutex);
+    pending++;
+  }
+
+  // Called when a batch was flushed
+  void done() {
+    ScopedLock lock(mutex);
+    if (--pending == 0)
+      cond.notify_all();
+  }
+
+  // Waits till all batches were flushed
+  void wait() {
+    ScopedLock lock(mutex);
+    while (pending > 0)
+      cond.wait(lock);
+  }
+
+  size_t pending;
+  Mutex mutex;
+  Condition cond;
+};
+
+// Flushes a batch of locked pages on one of the flush threads
+static void
+async_flush_batch(std::vector<Page *> *batch, RateLimiter *rate_limiter,
+                uint32_t page_size, FlushLatch *latch)
+{
+  if (rate_limiter)
+    rate_limiter->acquire((uint64_t)batch->size() * page_size);
+  flush_and_unlock(*batch);
+  delete batch;
+  latch->done();
+}
+
+// Flushes the dirty pages of |message|. The pages are written in file order,
+// therefore adjacent pages are coalesced by the Device. If flush threads are
+// configured then the batches are written concurrently.
+//
+// Background flushes (of |purge_cache()|) are rate limited, but not the
+// flushes which a caller waits for.
 static void
 async_flush_pages(AsyncFlushMessage *message)
 {
+  // the dirty pages are written in batches; the batch size limits the
+  // time a page stays locked
+  const size_t kBatchSize = 64;
+  PageManagerState *state = message->page_manager->state.get();
+  WorkerPool *flush_workers = state->flush_workers.get();
+  RateLimiter *rate_limiter = 0;
+  if (!message->signal && state->flush_rate_limiter.is_enabled())
+    rate_limiter = &state->flush_rate_limiter;
+  uint32_t page_size = state->config.page_size_bytes;
+  FlushLatch latch;
+
+  std::vector<Page *> *batch = new std::vector<Page *>();
+  batch->reserve(kBatchSize);
+
+  std::sort(message->page_ids.begin(), message->page_ids.end());
+
   for (std::vector<uint64_t>::iterator it = message->page_ids.begin();
                   it != message->page_ids.end();
                   it++) {
@@ -81,16 +191,34 @@ async_flush_pages(AsyncFlushMessage *message)
     assert(page->mutex().try_lock() == false);
 
     // flush page if it's dirty
-    if (page->is_dirty()) {
-      try {
-        page->flush();
-      }
-      catch (Exception &) {
-        // ignore page, fall through
+    if (!page->is_dirty()) {
+      page->mutex().unlock();
+      continue;
+    }
+
+    batch->push_back(page);
+    if (batch->size() == kBatchSize) {
+      latch.add();
+      if (flush_workers) {
+        boost::function<void ()> job = boost::bind(&async_flush_batch, batch,
+                                rate_limiter, page_size, &latch);
+        flush_workers->post(job);
       }
+      else
+        async_flush_batch(batch, rate_limiter, page_size, &latch);
+      batch = new std::vector<Page *>();
+      batch->reserve(kBatchSize);
     }
-    page->mutex().unlock();
   }
+  if (!batch->empty()) {
+    latch.add();
+    async_flush_batch(batch, rate_limiter, page_size, &latch);
+  }
+  else
+    delete batch;
+
+  latch.wait();
+
   if (message->in_progress)
     message->in_progress = false;
   if (message->signal)
@@ -111,6 +239,318 @@ verify_crc32(Page *page)
   }
 }
 
+// Reads a page from the compressed cache tier or, if it is not stored
+// there, from disk. The caller has to hold the mutex.
+static inline void
+read_page(PageManagerState *state, Page *page, uint64_t address)
+{
+  if (!state->compressed_cache.is_enabled()
+        || !state->compressed_cache.get(address, page))
+    page->fetch(address);
+}
+
+// Reads a page ahead, unless it is already cached or the cache is full.
+// Memory mapped pages are skipped unless |include_mapped| is true; then
+// they are faulted in. The page is not yet visible to other threads; the
+// eviction epoch is stored in |epoch|. Returns null if the page was not read.
+static Page *
+read_page_ahead(PageManagerState *state, LocalDatabase *db, uint64_t address,
+                uint64_t *epoch, bool include_mapped = false)
+{
+  uint32_t page_size = state->config.page_size_bytes;
+
+  // otherwise mapped pages are left to the readahead of the operating system
+  if (!include_mapped && state->device->is_mapped(address, page_size))
+    return 0;
+
+  {
+    ScopedSpinlock lock(state->mutex);
+    // pages in the compressed cache tier are not read from disk
+    if (state->cache.is_cache_full() || state->cache.peek(address)
+          || state->compressed_cache.has(address))
+      return 0;
+    *epoch = state->eviction_epoch;
+  }
+
+  // the I/O is performed without holding the mutex
+  Page *page = new Page(state->device, db);
+  try {
+    page->fetch(address);
+    if (ISSET(state->config.flags, UPS_ENABLE_CRC32))
+      verify_crc32(page);
+  }
+  catch (Exception &) {
+    // ignore the page; the error is reported when it is fetched
+    delete page;
+    return 0;
+  }
+
+  if (!page->is_allocated()) {
+    volatile uint8_t touched = 0;
+    for (uint32_t i = 0; i < page_size; i += 4096)
+      touched += ((uint8_t *)page->data())[i];
+  }
+  return page;
+}
+
+// Stores a page which was read ahead in the cache. The page is discarded
+// if it was loaded in the meantime, or if pages were evicted (and
+// therefore maybe modified and flushed) since it was read. Returns true
+// if the page was stored.
+static bool
+store_page_ahead(PageManagerState *state, Page *page, uint64_t epoch)
+{
+  ScopedSpinlock lock(state->mutex);
+  if (epoch != state->eviction_epoch || state->cache.peek(page->address())) {
+    delete page;
+    return false;
+  }
+  state->compressed_cache.del(page->address());
+  state->cache.put(page);
+  return true;
+}
+
+// Returns the right sibling of a leaf and appends the ids of its blobs
+// to |blob_ids|. Returns 0 if |page| is not a leaf.
+static uint64_t
+inspect_leaf(LocalDatabase *db, Page *page, std::vector<uint64_t> &blob_ids)
+{
+  if (page->type() != Page::kTypeBroot && page->type() != Page::kTypeBindex)
+    return 0;
+  if (!PBtreeNode::from_page(page)->is_leaf())
+    return 0;
+
+  // a page which was preloaded by the cache warm-up is claimed
+  if (page->db() == 0)
+    page->set_db(db);
+  else if (page->db() != db)
+    return 0;
+
+  BtreeNodeProxy *node = db->btree_index()->get_node_from_page(page);
+  node->blob_ids(blob_ids);
+  return node->right_sibling();
+}
+
+// Reads up to |count| leaves ahead, starting at |address|, and follows the
+// right siblings. Also reads the first page of each blob of these leaves.
+static void
+async_prefetch_pages(PageManager *page_manager, LocalDatabase *db,
+                uint64_t address, size_t count)
+{
+  PageManagerState *state = page_manager->state.get();
+  uint32_t page_size = state->config.page_size_bytes;
+  std::vector<uint64_t> blob_ids;
+  uint64_t epoch;
+
+  for (size_t i = 0; i < count && address != 0; i++) {
+    uint64_t right = 0;
+    blob_ids.clear();
+
+    Page *page = read_page_ahead(state, db, address, &epoch);
+    if (page) {
+      right = inspect_leaf(db, page, blob_ids);
+      if (store_page_ahead(state, page, epoch))
+        state->page_count_prefetched++;
+    }
+    else {
+      // the page is cached (or cannot be read ahead); its sibling is only
+      // available if the page is not in use
+      ScopedSpinlock lock(state->mutex);
+      page = state->cache.peek(address);
+      if (!page || !page->mutex().try_lock())
+        return;
+      right = inspect_leaf(db, page, blob_ids);
+      page->mutex().unlock();
+    }
+
+    uint64_t last = 0;
+    for (std::vector<uint64_t>::iterator it = blob_ids.begin();
+                    it != blob_ids.end();
+                    it++) {
+      uint64_t blob_page = *it - (*it % page_size);
+      if (blob_page == last)
+        continue;
+      last = blob_page;
+      page = read_page_ahead(state, db, blob_page, &epoch);
+      if (page && store_page_ahead(state, page, epoch))
+        state->page_count_prefetched++;
+    }
+
+    address = right;
+  }
+}
+
+// Returns the path of the file with the addresses of the cached pages
+static inline std::string
+warmup_path(PageManagerState *state)
+{
+  return state->config.filename + ".warmup";
+}
+
+// Returns the addresses of the cached pages, and of the pages of closed
+// Databases. The caller has to hold the mutex.
+static void
+collect_hot_pages(PageManagerState *state, std::vector<uint64_t> &addresses)
+{
+  // do not store more pages than the cache can hold
+  size_t limit = (size_t)std::min(state->cache.capacity()
+                          / state->config.page_size_bytes,
+                      (uint64_t)std::numeric_limits<size_t>::max());
+
+  addresses = state->hot_pages;
+  if (addresses.size() > limit)
+    addresses.resize(limit);
+  state->cache.hot_pages(addresses, limit);
+}
+
+// Remembers the addresses of the pages of a closed Database. The caller
+// has to hold the mutex.
+static void
+remember_hot_pages(PageManagerState *state,
+                const std::vector<uint64_t> &addresses)
+{
+  std::vector<uint64_t> &hot_pages = state->hot_pages;
+  hot_pages.insert(hot_pages.end(), addresses.begin(), addresses.end());
+  std::sort(hot_pages.begin(), hot_pages.end());
+  hot_pages.erase(std::unique(hot_pages.begin(), hot_pages.end()),
+                  hot_pages.end());
+
+  uint64_t limit = state->cache.capacity() / state->config.page_size_bytes;
+  if (hot_pages.size() > limit)
+    hot_pages.resize((size_t)limit);
+}
+
+// Writes the addresses of the cached pages to the warm-up file; the
+// addresses are sorted, therefore the pages are later read in file order
+static void
+store_hot_pages(std::string path, uint32_t page_size, int file_mode,
+                std::vector<uint64_t> addresses)
+{
+  std::sort(addresses.begin(), addresses.end());
+  addresses.erase(std::unique(addresses.begin(), addresses.end()),
+                  addresses.end());
+
+  PWarmupHeader header;
+  header.magic = PWarmupHeader::kMagic;
+  header.page_size = page_size;
+  header.count = addresses.size();
+
+  try {
+    File file;
+    file.create(path.c_str(), file_mode);
+    file.write(&header, sizeof(header));
+    if (!addresses.empty())
+      file.write(&addresses[0], addresses.size() * sizeof(uint64_t));
+  }
+  catch (Exception &) {
+    // the warm-up is only an optimization; ignore the error
+  }
+}
+
+// Reads the addresses from the warm-up file. Returns false if the file does
+// not exist or is invalid.
+static bool
+load_hot_pages(PageManagerState *state, std::vector<uint64_t> &addresses)
+{
+  try {
+    File file;
+    file.open(warmup_path(state).c_str(), true);
+
+    PWarmupHeader header;
+    uint64_t file_size = file.file_size();
+    if (file_size < sizeof(header))
+      return false;
+    file.pread(0, &header, sizeof(header));
+    if (header.magic != PWarmupHeader::kMagic
+          || header.page_size != state->config.page_size_bytes
+          || file_size != sizeof(header) + header.count * sizeof(uint64_t))
+      return false;
+
+    addresses.resize((size_t)header.count);
+    if (!addresses.empty())
+      file.pread(sizeof(header), &addresses[0],
+                      addresses.size() * sizeof(uint64_t));
+    return true;
+  }
+  catch (Exception &) {
+    return false;
+  }
+}
+
+// Preloads the pages of the warm-up file in address order. The pages are
+// not yet assigned to a Database; they are claimed by the first Database
+// which fetches them. Stops if the cache is full.
+//
+// The pages are processed in small batches; afterwards the job is
+// re-scheduled, therefore other messages of the worker (i.e. readahead
+// requests or flushes) are not delayed.
+static void
+async_warm_up(PageManager *page_manager)
+{
+  const size_t kBatchSize = 64;
+  PageManagerState *state = page_manager->state.get();
+  std::vector<uint64_t> &addresses = state->warmup_addresses;
+
+  // first run: load the addresses
+  if (state->warmup_pages_total == 0) {
+    if (!load_hot_pages(state, addresses) || addresses.empty())
+      return;
+    std::sort(addresses.begin(), addresses.end());
+    state->warmup_pages_total = addresses.size();
+  }
+
+  uint32_t page_size = state->config.page_size_bytes;
+  uint64_t file_size = state->device->file_size();
+  uint64_t epoch;
+  bool cache_full = false;
+
+  for (size_t i = 0;
+          i < kBatchSize && state->warmup_pages_processed < addresses.size();
+          i++) {
+    uint64_t address = addresses[(size_t)state->warmup_pages_processed];
+
+    // skip invalid addresses and the header page
+    if (address != 0 && address % page_size == 0
+          && address + page_size <= file_size) {
+      Page *page = read_page_ahead(state, 0, address, &epoch, true);
+      if (page)
+        store_page_ahead(state, page, epoch);
+      else if (state->cache.is_cache_full()) {
+        cache_full = true;
+        break;
+      }
+    }
+    state->warmup_pages_processed++;
+  }
+
+  // pages which do not fit into the cache are skipped
+  if (cache_full || state->warmup_cancelled)
+    state->warmup_pages_processed = state->warmup_pages_total;
+
+  if (state->warmup_pages_processed < state->warmup_pages_total)
+    page_manager->run_async(boost::bind(&async_warm_up, page_manager));
+  else
+    std::vector<uint64_t>().swap(addresses);
+}
+
+static void
+notify_signal(Signal *signal)
+{
+  signal->notify();
+}
+
+// Waits till the worker thread processed all pending messages (i.e.
+// pending readahead requests)
+static void
+wait_for_worker(PageManager *page_manager)
+{
+  if (!page_manager->state->worker.get())
+    return;
+  Signal signal;
+  page_manager->run_async(boost::bind(&notify_signal, &signal));
+  signal.wait();
+}
+
 static inline Page *
 add_to_changeset(Changeset *changeset, Page *page)
 {
@@ -235,8 +675,13 @@ fetch_unlocked(PageManagerState *state, Context *context, uint64_t address,
     page = state->header->header_page();
   else if (state->state_page && address == state->state_page->address())
     page = state->state_page;
-  else
+  else {
     page = state->cache.get(address);
+    // a page which was preloaded by the cache warm-up is claimed by
+    // the first Database which fetches it
+    if (page && page->db() == 0)
+      page->set_db(context->db);
+  }
 
   if (page) {
     page->set_without_header(ISSET(flags, PageManager::kNoHeader));
@@ -249,7 +694,7 @@ fetch_unlocked(PageManagerState *state, Context *context, uint64_t address,
 
   page = new Page(state->device, context->db);
   try {
-    page->fetch(address);
+    read_page(state, page, address);
   }
   catch (Exception &ex) {
     delete page;
@@ -258,6 +703,10 @@ fetch_unlocked(PageManagerState *state, Context *context, uint64_t address,
 
   assert(page->data());
 
+  /* lock the page BEFORE it's stored in the cache; afterwards it is visible
+   * to other threads */
+  add_to_changeset(&context->changeset, page);
+
   /* store the page in the list */
   state->cache.put(page);
 
@@ -273,7 +722,7 @@ fetch_unlocked(PageManagerState *state, Context *context, uint64_t address,
     verify_crc32(page);
 
   state->page_count_fetched++;
-  return add_to_changeset(&context->changeset, page);
+  return page;
 }
 
 static inline Page *
@@ -299,7 +748,7 @@ alloc_unlocked(PageManagerState *state, Context *context, uint32_t page_type,
         goto done;
       /* otherwise fetch the page from disk */
       page = new Page(state->device, context->db);
-      page->fetch(address);
+      read_page(state, page, address);
       goto done;
     }
   }
@@ -335,7 +784,9 @@ done:
     page->set_node_proxy(0);
   }
 
-  /* store the page in the cache and the Changeset */
+  /* store the page in the cache and the Changeset; a stale copy in the
+   * compressed cache tier is discarded */
+  state->compressed_cache.del(page->address());
   state->cache.put(page);
   add_to_changeset(&context->changeset, page);
 
@@ -368,12 +819,18 @@ done:
 PageManagerState::PageManagerState(LocalEnvironment *_env)
   : env(_env), config(_env->config()), header(_env->header()),
     device(_env->device()), lsn_manager(_env->lsn_manager()),
-    cache(_env->config()), freelist(config), needs_flush(false),
+    cache(_env->config()), compressed_cache(_env->config()),
+    freelist(config), needs_flush(false),
     state_page(0), last_blob_page(0), last_blob_page_id(0),
-    page_count_fetched(0), page_count_index(0), page_count_blob(0),
+    page_count_fetched(0), page_count_prefetched(0), eviction_epoch(0),
+    warmup_pages_total(0), warmup_pages_processed(0), warmup_cancelled(false),
+    store_hot_pages_on_close(true), last_warmup_time(::time(0)),
+    page_count_index(0), page_count_blob(0),
     page_count_page_manager(0), cache_hits(0), cache_misses(0), message(0),
-    worker(new WorkerPool(1))
+    flush_rate_limiter(config.flush_rate_limit), worker(new WorkerPool(1))
 {
+  if (config.flush_threads > 0)
+    flush_workers.reset(new WorkerPool(config.flush_threads));
 }
 
 PageManagerState::~PageManagerState()
@@ -429,8 +886,40 @@ PageManager::initialize(uint64_t pageid)
 Page *
 PageManager::fetch(Context *context, uint64_t address, uint32_t flags)
 {
-  ScopedSpinlock lock(state->mutex);
-  return fetch_unlocked(state.get(), context, address, flags);
+  // Cached pages are looked up without locking the PageManager, and this
+  // thread never waits for a page lock while it holds the PageManager's
+  // mutex or a latch of the Cache. Otherwise concurrent readers (see
+  // Database::supports_concurrent_reads()) could deadlock.
+  for (int k = 0; ; k++) {
+    bool busy = false;
+    Page *page = 0;
+
+    // fast path: the page is cached
+    if (address != 0)
+      page = state->cache.get(address, &context->changeset, &busy);
+
+    if (!page && !busy) {
+      ScopedSpinlock lock(state->mutex);
+
+      // check again - the page might have been loaded by another thread
+      if (address != 0)
+        page = state->cache.get(address, &context->changeset, &busy);
+      if (!page && !busy)
+        return fetch_unlocked(state.get(), context, address, flags);
+    }
+
+    if (page) {
+      // a page which was preloaded by the cache warm-up is claimed by
+      // the first Database which fetches it
+      if (unlikely(page->db() == 0))
+        page->set_db(context->db);
+      page->set_without_header(ISSET(flags, kNoHeader));
+      return page;
+    }
+
+    // the page is locked by another thread; try again
+    boost::this_thread::yield();
+  }
 }
 
 Page *
@@ -495,6 +984,9 @@ void
 PageManager::fill_metrics(ups_env_metrics_t *metrics) const
 {
   metrics->page_count_fetched = state->page_count_fetched;
+  metrics->page_count_prefetched = state->page_count_prefetched;
+  metrics->cache_warmup_pages_total = state->warmup_pages_total;
+  metrics->cache_warmup_pages_processed = state->warmup_pages_processed;
   metrics->page_count_flushed = Page::ms_page_count_flushed;
   metrics->page_count_type_index = state->page_count_index;
   metrics->page_count_type_blob = state->page_count_blob;
@@ -502,6 +994,7 @@ PageManager::fill_metrics(ups_env_metrics_t *metrics) const
   metrics->freelist_hits = state->freelist.freelist_hits;
   metrics->freelist_misses = state->freelist.freelist_misses;
   state->cache.fill_metrics(metrics);
+  state->compressed_cache.fill_metrics(metrics);
 }
 
 struct FlushAllPagesVisitor
@@ -553,6 +1046,22 @@ PageManager::purge_cache(Context *context)
 {
   ScopedSpinlock lock(state->mutex);
 
+  // periodically persist the addresses of the cached pages
+  if (state->config.cache_warmup_interval_sec > 0
+        && state->config.cache_warmup
+        && NOTSET(state->config.flags, UPS_IN_MEMORY | UPS_READ_ONLY)) {
+    time_t now = ::time(0);
+    if (now - state->last_warmup_time
+            >= (time_t)state->config.cache_warmup_interval_sec) {
+      state->last_warmup_time = now;
+      std::vector<uint64_t> addresses;
+      collect_hot_pages(state.get(), addresses);
+      run_async(boost::bind(&store_hot_pages, warmup_path(state.get()),
+                              state->config.page_size_bytes,
+                              state->config.file_mode, addresses));
+    }
+  }
+
   // do NOT purge the cache iff
   //   1. this is an in-memory Environment
   //   2. there's still a "purge cache" operation pending
@@ -582,10 +1091,19 @@ PageManager::purge_cache(Context *context)
                   it++) {
     Page *page = *it;
     if (likely(page->mutex().try_lock())) {
-      assert(page->cursor_list() == 0);
+      // a concurrent reader might have coupled a cursor in the meantime
+      if (page->cursor_list() != 0) {
+        page->mutex().unlock();
+        continue;
+      }
       state->cache.del(page);
       page->mutex().unlock();
+      // mapped pages are not stored in the compressed cache tier; they
+      // are cached by the operating system
+      if (state->compressed_cache.is_enabled() && page->is_allocated())
+        state->compressed_cache.put(page);
       delete page;
+      state->eviction_epoch++;
     }
   }
 }
@@ -614,6 +1132,7 @@ PageManager::reclaim_space(Context *context)
       if (page) {
         state->cache.del(page);
         delete page;
+        state->eviction_epoch++;
       }
     }
 
@@ -623,6 +1142,7 @@ PageManager::reclaim_space(Context *context)
 
   if (do_truncate) {
     state->needs_flush = true;
+    state->compressed_cache.del_from(file_size);
     state->device->truncate(file_size);
     maybe_store_state(state.get(), context, true);
   }
@@ -650,6 +1170,9 @@ struct CloseDatabaseVisitor
 void
 PageManager::close_database(Context *context, LocalDatabase *db)
 {
+  // pending readahead requests must not load pages of this database
+  wait_for_worker(this);
+
   Signal signal;
   AsyncFlushMessage *message = new AsyncFlushMessage(this, state->device,
                                     &signal);
@@ -667,6 +1190,11 @@ PageManager::close_database(Context *context, LocalDatabase *db)
     context->changeset.clear();
     state->cache.purge_if(visitor);
 
+    // the pages are persisted for the cache warm-up when the Environment
+    // is closed
+    if (state->config.cache_warmup)
+      remember_hot_pages(state.get(), message->page_ids);
+
     if (state->header->header_page()->is_dirty())
       message->page_ids.push_back(0);
   }
@@ -679,6 +1207,7 @@ PageManager::close_database(Context *context, LocalDatabase *db)
   delete message;
 
   ScopedSpinlock lock(state->mutex);
+  state->eviction_epoch++;
   // now delete the pages
   for (std::vector<Page *>::iterator it = visitor.pages.begin();
           it != visitor.pages.end();
@@ -692,6 +1221,23 @@ PageManager::close_database(Context *context, LocalDatabase *db)
   }
 }
 
+void
+PageManager::warm_up()
+{
+  if (!state->config.cache_warmup
+        || ISSET(state->config.flags, UPS_IN_MEMORY))
+    return;
+  run_async(boost::bind(&async_warm_up, this));
+}
+
+void
+PageManager::prefetch(LocalDatabase *db, uint64_t address, size_t count)
+{
+  if (ISSET(state->config.flags, UPS_IN_MEMORY) || address == 0)
+    return;
+  run_async(boost::bind(&async_prefetch_pages, this, db, address, count));
+}
+
 void
 PageManager::del(Context *context, Page *page, size_t page_count)
 {
@@ -725,11 +1271,32 @@ PageManager::del(Context *context, Page *page, size_t page_count)
   // relevant for logging.
 }
 
+struct UnclaimedPagesVisitor
+{
+  UnclaimedPagesVisitor(Page *last_blob_page_)
+    : last_blob_page(last_blob_page_) {
+  }
+
+  bool operator()(Page *page) {
+    if (page->db() == 0 && page != last_blob_page && !page->is_dirty())
+      pages.push_back(page);
+    return false;
+  }
+
+  Page *last_blob_page;
+  std::vector<Page *> pages;
+};
+
 void
 PageManager::close(Context *context)
 {
   // no need to lock the mutex; this method is called during shutdown
 
+  // stop the cache warm-up, then wait till pending readahead requests
+  // are completed
+  state->warmup_cancelled = true;
+  wait_for_worker(this);
+
   // cut off unused space at the end of the file; this space is managed
   // by the device
   state->device->reclaim_space();
@@ -760,13 +1327,36 @@ PageManager::close(Context *context)
   // flush all dirty pages to disk, then delete them
   flush_all_pages();
 
+  // persist the addresses of the cached pages for the cache warm-up
+  if (state->config.cache_warmup
+        && state->store_hot_pages_on_close
+        && NOTSET(state->config.flags, UPS_IN_MEMORY | UPS_READ_ONLY)) {
+    std::vector<uint64_t> addresses;
+    collect_hot_pages(state.get(), addresses);
+    store_hot_pages(warmup_path(state.get()), state->config.page_size_bytes,
+                    state->config.file_mode, addresses);
+  }
+
+  // delete the preloaded pages which were not claimed by a Database
+  UnclaimedPagesVisitor visitor(state->last_blob_page);
+  state->cache.purge_if(visitor);
+  for (std::vector<Page *>::iterator it = visitor.pages.begin();
+          it != visitor.pages.end();
+          it++) {
+    state->cache.del(*it);
+    delete *it;
+  }
+
   // join the worker thread
   state->worker.reset(0);
+  state->flush_workers.reset(0);
 }
 
 void
 PageManager::reset(Context *context)
 {
+  // the cache only contains the pages of the recovery
+  state->store_hot_pages_on_close = false;
   close(context);
   state.reset(new PageManagerState(state->env));
 }
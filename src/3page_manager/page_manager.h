@@ -111,6 +111,17 @@ struct PageManager
   // Flushes and closes all pages of a database
   void close_database(Context *context, LocalDatabase *db);
 
+  // Asks the worker thread to preload the pages which were cached when
+  // the Environment was closed the last time (if the cache warm-up is
+  // enabled). Does not block.
+  void warm_up();
+
+  // Asks the worker thread to read up to |count| leaf pages of |db| ahead,
+  // starting at |address| and following the right siblings. The first
+  // pages of the leaves' blobs are also read. Pages are only stored in the
+  // cache if it is not yet full.
+  void prefetch(LocalDatabase *db, uint64_t address, size_t count);
+
   // Schedules one (or many sequential) pages for deletion and adds them
   // to the Freelist
   void del(Context *context, Page *page, size_t page_count = 1);
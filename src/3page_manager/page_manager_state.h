@@ -29,12 +29,16 @@
 
 #include "0root/root.h"
 
+#include <time.h>
+#include <vector>
 #include <boost/atomic.hpp>
 
 // Always verify that a file of level N does not include headers > N!
+#include "1base/rate_limiter.h"
 #include "1base/spinlock.h"
 #include "2config/env_config.h"
 #include "3cache/cache.h"
+#include "3cache/compressed_cache.h"
 #include "3page_manager/freelist.h"
 
 #ifndef UPS_ROOT_H
@@ -83,6 +87,10 @@ struct PageManagerState
   // The cache
   Cache cache;
 
+  // The compressed cache tier; stores pages which were evicted from
+  // the |cache|
+  CompressedCache compressed_cache;
+
   // The freelist
   Freelist freelist;
 
@@ -102,6 +110,37 @@ struct PageManagerState
   // tracks number of fetched pages
   uint64_t page_count_fetched;
 
+  // tracks number of pages which were read ahead
+  uint64_t page_count_prefetched;
+
+  // Incremented whenever pages are evicted from the cache; a page which
+  // is read ahead is discarded if pages were evicted in the meantime,
+  // because then its file image might be outdated
+  uint64_t eviction_epoch;
+
+  // number of pages which are preloaded by the cache warm-up
+  uint64_t warmup_pages_total;
+
+  // number of these pages which were already processed
+  uint64_t warmup_pages_processed;
+
+  // the addresses of the pages which are preloaded
+  std::vector<uint64_t> warmup_addresses;
+
+  // set when the PageManager is closed; stops the cache warm-up
+  boost::atomic<bool> warmup_cancelled;
+
+  // false if the addresses of the cached pages must not be persisted
+  // when the PageManager is closed (i.e. after recovery)
+  bool store_hot_pages_on_close;
+
+  // the time when the addresses of the cached pages were persisted
+  time_t last_warmup_time;
+
+  // the addresses of the pages of closed Databases; persisted for the
+  // cache warm-up
+  std::vector<uint64_t> hot_pages;
+
   // tracks number of index pages
   uint64_t page_count_index;
 
@@ -124,6 +163,13 @@ struct PageManagerState
   // For collecting unused pages; cached to avoid memory allocations
   std::vector<Page *> garbage;
 
+  // The threads which write dirty pages to disk; null if the pages are
+  // written by the |worker|
+  ScopedPtr<WorkerPool> flush_workers;
+
+  // Limits the throughput of background flushes
+  RateLimiter flush_rate_limiter;
+
   // The worker thread which flushes dirty pages
   ScopedPtr<WorkerPool> worker;
 };
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+/*
+ * Detects sequential scans over the leaf level of a btree and decides
+ * how many pages are read ahead.
+ *
+ * @exception_safe: nothrow
+ * @thread_safe: no
+ */
+
+#ifndef UPS_READAHEAD_H
+#define UPS_READAHEAD_H
+
+#include "0root/root.h"
+
+#include <algorithm>
+
+// Always verify that a file of level N does not include headers > N!
+
+#ifndef UPS_ROOT_H
+#  error "root.h was not included"
+#endif
+
+namespace upscaledb {
+
+//
+// The readahead window starts small and is doubled whenever the scan
+// consumed half of the pages which were read ahead; a fast scan therefore
+// quickly requests larger batches. Non-sequential moves reset the window.
+//
+struct Readahead
+{
+  enum {
+    // number of consecutive moves to the right sibling before pages
+    // are read ahead
+    kThreshold = 2,
+
+    // the initial size of the window (in pages)
+    kMinWindow = 4,
+
+    // the maximum size of the window (in pages)
+    kMaxWindow = 64
+  };
+
+  // Constructor
+  Readahead() {
+    reset();
+  }
+
+  // Resets the state; called when the scan is not sequential
+  void reset() {
+    sequential = 0;
+    window = kMinWindow;
+    ahead = 0;
+  }
+
+  // Called whenever the scan moves to the right sibling. Returns the number
+  // of pages which should be read ahead (starting at the new sibling's
+  // right neighbour), or 0 if no pages should be read.
+  size_t advance() {
+    if (ahead > 0)
+      ahead--;
+    if (++sequential < kThreshold)
+      return 0;
+
+    // enough pages were already requested?
+    if (ahead > window / 2)
+      return 0;
+
+    // the scan keeps going; request a larger batch
+    if (sequential > kThreshold)
+      window = std::min(window * 2, (size_t)kMaxWindow);
+    ahead = window;
+    return window;
+  }
+
+  // Number of consecutive moves to the right sibling
+  size_t sequential;
+
+  // The current size of the window
+  size_t window;
+
+  // Number of pages which were requested but not yet visited
+  size_t ahead;
+};
+
+} // namespace upscaledb
+
+#endif /* UPS_READAHEAD_H */
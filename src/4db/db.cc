@@ -32,6 +32,38 @@ Database::Database(Environment *env, DbConfig &config)
 {
 }
 
+Database::~Database()
+{
+  for (ThreadArenaMap::iterator it = m_thread_arenas.begin();
+          it != m_thread_arenas.end();
+          it++)
+    delete it->second;
+}
+
+Database::ThreadArenas *
+Database::thread_arenas()
+{
+  ScopedSpinlock lock(m_thread_arenas_mutex);
+
+  ThreadArenas *&arenas = m_thread_arenas[boost::this_thread::get_id()];
+  if (!arenas)
+    arenas = new ThreadArenas;
+  return (arenas);
+}
+
+void
+Database::release_thread_arenas()
+{
+  ScopedSpinlock lock(m_thread_arenas_mutex);
+
+  ThreadArenaMap::iterator it
+          = m_thread_arenas.find(boost::this_thread::get_id());
+  if (it != m_thread_arenas.end()) {
+    delete it->second;
+    m_thread_arenas.erase(it);
+  }
+}
+
 ups_status_t
 Database::cursor_create(Cursor **pcursor, Transaction *txn, uint32_t flags)
 {
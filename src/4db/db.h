@@ -25,11 +25,14 @@
 
 #include "0root/root.h"
 
+#include <map>
+
 #include "ups/upscaledb_int.h"
 #include "ups/upscaledb_uqi.h"
 
 // Always verify that a file of level N does not include headers > N!
 #include "1base/dynamic_array.h"
+#include "1base/spinlock.h"
 #include "2config/db_config.h"
 #include "4env/env.h"
 
@@ -59,8 +62,7 @@ class Database
     // Constructor
     Database(Environment *env, DbConfig &config);
 
-    virtual ~Database() {
-    }
+    virtual ~Database();
 
     // Returns the Environment pointer
     Environment *get_env() {
@@ -109,6 +111,11 @@ class Database
     virtual ups_status_t insert(Cursor *cursor, Transaction *txn,
                     ups_key_t *key, ups_record_t *record, uint32_t flags) = 0;
 
+    // Loads a sorted sequence of key/value pairs into an empty database
+    // (ups_db_bulk_load)
+    virtual ups_status_t bulk_load(ups_bulk_load_func_t func, void *context,
+                    uint32_t fill_factor) = 0;
+
     // Erase a key/value pair (ups_db_erase, ups_cursor_erase)
     virtual ups_status_t erase(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     uint32_t flags) = 0;
@@ -117,6 +124,16 @@ class Database
     virtual ups_status_t find(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     ups_record_t *record, uint32_t flags) = 0;
 
+    // Lookup of a batch of keys (ups_db_find_many)
+    virtual ups_status_t find_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags) = 0;
+
+    // Inserts a batch of key/value pairs (ups_db_insert_many)
+    virtual ups_status_t insert_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags) = 0;
+
     // Creates a cursor (ups_cursor_create)
     virtual ups_status_t cursor_create(Cursor **pcursor, Transaction *txn,
                     uint32_t flags);
@@ -131,6 +148,13 @@ class Database
     // Closes a cursor (ups_cursor_close)
     ups_status_t cursor_close(Cursor *cursor);
 
+    // Returns true if ups_db_find, ups_cursor_find and ups_cursor_move
+    // can run concurrently, with the Environment's mutex locked in shared
+    // mode
+    virtual bool supports_concurrent_reads() {
+      return (false);
+    }
+
     // Closes the Database (ups_db_close)
     ups_status_t close(uint32_t flags);
 
@@ -150,22 +174,43 @@ class Database
     }
 
     // Returns the memory buffer for the key data: the per-database buffer
-    // if |txn| is null or temporary, otherwise the buffer from the |txn|
+    // if |txn| is null or temporary, otherwise the buffer from the |txn|.
+    // If concurrent reads are supported then each thread has its own buffer.
     ByteArray &key_arena(Transaction *txn) {
-      return ((txn == 0 || (txn->get_flags() & UPS_TXN_TEMPORARY))
-                 ? m_key_arena
-                 : txn->key_arena());
+      if (txn == 0 || (txn->get_flags() & UPS_TXN_TEMPORARY))
+        return (supports_concurrent_reads()
+                    ? thread_arenas()->key_arena
+                    : m_key_arena);
+      return (txn->key_arena());
     }
 
     // Returns the memory buffer for the record data: the per-database buffer
-    // if |txn| is null or temporary, otherwise the buffer from the |txn|
+    // if |txn| is null or temporary, otherwise the buffer from the |txn|.
+    // If concurrent reads are supported then each thread has its own buffer.
     ByteArray &record_arena(Transaction *txn) {
-      return ((txn == 0 || (txn->get_flags() & UPS_TXN_TEMPORARY))
-                 ? m_record_arena
-                 : txn->record_arena());
+      if (txn == 0 || (txn->get_flags() & UPS_TXN_TEMPORARY))
+        return (supports_concurrent_reads()
+                    ? thread_arenas()->record_arena
+                    : m_record_arena);
+      return (txn->record_arena());
     }
 
+    // Releases the buffers of the current thread; called by short-lived
+    // threads (i.e. of a parallel UQI scan) before they terminate
+    void release_thread_arenas();
+
   protected:
+    // The key and record buffers of a single thread
+    struct ThreadArenas {
+      ByteArray key_arena;
+      ByteArray record_arena;
+    };
+
+    typedef std::map<boost::thread::id, ThreadArenas *> ThreadArenaMap;
+
+    // Returns the buffers of the current thread; they are created on demand
+    ThreadArenas *thread_arenas();
+
     // Creates a cursor; this is the actual implementation
     virtual Cursor *cursor_create_impl(Transaction *txn) = 0;
 
@@ -194,6 +239,13 @@ class Database
     // This is where record->data points to when returning a
     // record to the user; used if Transactions are disabled
     ByteArray m_record_arena;
+
+    // The per-thread buffers for key and record data; used instead of
+    // |m_key_arena| and |m_record_arena| if concurrent reads are supported
+    ThreadArenaMap m_thread_arenas;
+
+    // Protects |m_thread_arenas|
+    Spinlock m_thread_arenas_mutex;
 };
 
 } // namespace upscaledb
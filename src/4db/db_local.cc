@@ -17,8 +17,12 @@
 
 #include "0root/root.h"
 
+#include <vector>
+#include <algorithm>
+
 // Always verify that a file of level N does not include headers > N!
 #include "1globals/callbacks.h"
+#include "2device/device.h"
 #include "3page_manager/page_manager.h"
 #include "3journal/journal.h"
 #include "3blob_manager/blob_manager.h"
@@ -30,6 +34,7 @@
 #include "4txn/txn_local.h"
 #include "4txn/txn_cursor.h"
 #include "4uqi/statements.h"
+#include "4uqi/scanvisitor.h"
 #include "4uqi/scanvisitorfactory.h"
 #include "4uqi/result.h"
 
@@ -179,7 +184,7 @@ LocalDatabase::insert_txn(Context *context, ups_key_t *key,
   /* get (or create) the node for this key */
   TransactionNode *node = m_txn_index->get(key, 0);
   if (!node) {
-    node = new TransactionNode(this, key);
+    node = m_txn_index->create_node(key);
     node_created = true;
     // TODO only store when the operation is successful?
     m_txn_index->store(node);
@@ -194,7 +199,7 @@ LocalDatabase::insert_txn(Context *context, ups_key_t *key,
   if (st) {
     if (node_created) {
       m_txn_index->remove(node);
-      delete node;
+      m_txn_index->destroy_node(node);
     }
     return (st);
   }
@@ -551,7 +556,7 @@ LocalDatabase::erase_txn(Context *context, ups_key_t *key, uint32_t flags,
   /* get (or create) the node for this key */
   TransactionNode *node = m_txn_index->get(key, 0);
   if (!node) {
-    node = new TransactionNode(this, key);
+    node = m_txn_index->create_node(key);
     node_created = true;
     // TODO only store when the operation is successful?
     m_txn_index->store(node);
@@ -564,7 +569,7 @@ LocalDatabase::erase_txn(Context *context, ups_key_t *key, uint32_t flags,
     if (st) {
       if (node_created) {
         m_txn_index->remove(node);
-        delete node;
+        m_txn_index->destroy_node(node);
       }
       return (st);
     }
@@ -1139,6 +1144,97 @@ LocalDatabase::insert(Cursor *hcursor, Transaction *txn, ups_key_t *key,
   }
 }
 
+// Retrieves the key/record pairs of ups_db_bulk_load() from the user's
+// callback function, and verifies them
+struct BulkLoadCallbackSource : public BtreeBulkLoadSource
+{
+  BulkLoadCallbackSource(LocalDatabase *db_, ups_bulk_load_func_t func_,
+                  void *context_)
+    : db(db_), func(func_), context(context_), last_recno(0) {
+  }
+
+  virtual bool next(ups_key_t *key, ups_record_t *record) {
+    *key = ups_make_key(0, 0);
+    *record = ups_make_record(0, 0);
+
+    ups_status_t st = func((ups_db_t *)db, key, record, context);
+    if (st == UPS_KEY_NOT_FOUND)
+      return false;
+    if (st)
+      throw Exception(st);
+
+    const DbConfig &config = db->config();
+    if (config.key_size != UPS_KEY_SIZE_UNLIMITED
+        && key->size != config.key_size) {
+      ups_trace(("invalid key size (%u instead of %u)",
+            key->size, config.key_size));
+      throw Exception(UPS_INV_KEY_SIZE);
+    }
+    if (config.record_size != UPS_RECORD_SIZE_UNLIMITED
+        && record->size != config.record_size) {
+      ups_trace(("invalid record size (%u instead of %u)",
+            record->size, config.record_size));
+      throw Exception(UPS_INV_RECORD_SIZE);
+    }
+
+    if (ISSET(config.flags, UPS_RECORD_NUMBER32))
+      last_recno = *(uint32_t *)key->data;
+    else if (ISSET(config.flags, UPS_RECORD_NUMBER64))
+      last_recno = *(uint64_t *)key->data;
+    return true;
+  }
+
+  LocalDatabase *db;
+  ups_bulk_load_func_t func;
+  void *context;
+  uint64_t last_recno;
+};
+
+ups_status_t
+LocalDatabase::bulk_load(ups_bulk_load_func_t func, void *data,
+                uint32_t fill_factor)
+{
+  LocalEnvironment *env = lenv();
+  Context context(env, 0, this);
+
+  try {
+    // The loaded pages are not logged. Therefore all committed
+    // transactions are applied to the btree, and the journal is cleared;
+    // otherwise recovery could overwrite the new pages with stale images
+    // of pages that were freed and are now re-used.
+    if (env->txn_manager()) {
+      env->txn_manager()->flush_committed_txns(&context);
+      if (env->txn_manager()->get_oldest_txn() != 0) {
+        ups_trace(("bulk loading requires that all transactions are "
+                    "committed or aborted"));
+        return (UPS_TXN_STILL_OPEN);
+      }
+    }
+    if (env->journal()) {
+      env->page_manager()->flush_all_pages();
+      env->device()->flush();
+      env->journal()->clear();
+    }
+
+    BulkLoadCallbackSource source(this, func, data);
+    m_btree_index->bulk_load(&context, source, fill_factor);
+    context.changeset.clear();
+
+    if (ISSETANY(get_flags(), UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64))
+      m_recno = source.last_recno;
+
+    // make the loaded pages durable
+    if (NOTSET(get_flags(), UPS_IN_MEMORY)) {
+      env->page_manager()->flush_all_pages();
+      env->device()->flush();
+    }
+    return (0);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
 ups_status_t
 LocalDatabase::erase(Cursor *hcursor, Transaction *txn, ups_key_t *key,
                 uint32_t flags)
@@ -1256,6 +1352,154 @@ LocalDatabase::find(Cursor *hcursor, Transaction *txn, ups_key_t *key,
   }
 }
 
+// Sorts the indices of a batch of keys (ups_db_find_many,
+// ups_db_insert_many) by the keys they refer to
+struct BatchKeyComparator
+{
+  BatchKeyComparator(BtreeIndex *btree_, ups_key_t *keys_)
+    : btree(btree_), keys(keys_) {
+  }
+
+  bool operator()(uint32_t lhs, uint32_t rhs) const {
+    return (btree->compare_keys(&keys[lhs], &keys[rhs]) < 0);
+  }
+
+  BtreeIndex *btree;
+  ups_key_t *keys;
+};
+
+// Returns true if |st| is the status of a single key of a batch, and the
+// remaining keys can still be processed
+static inline bool
+is_batch_key_status(ups_status_t st)
+{
+  return (st == UPS_KEY_NOT_FOUND
+          || st == UPS_DUPLICATE_KEY
+          || st == UPS_INV_KEY_SIZE
+          || st == UPS_INV_RECORD_SIZE);
+}
+
+ups_status_t
+LocalDatabase::find_many(Transaction *txn, uint32_t count, ups_key_t *keys,
+            ups_record_t *records, ups_status_t *results, uint32_t flags)
+{
+  std::vector<uint32_t> order(count);
+  for (uint32_t i = 0; i < count; i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                  BatchKeyComparator(m_btree_index.get(), keys));
+
+  try {
+    /* pending Transactions and duplicate keys require a cursor; then the
+     * keys are looked up one by one (but still in sorted order) */
+    if (ISSET(get_flags(), UPS_ENABLE_DUPLICATE_KEYS)
+          || (m_txn_index.get() && m_txn_index->get_first() != 0)) {
+      std::vector<size_t> offsets(count);
+      ByteArray batch;
+
+      for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = order[i];
+        ups_record_t *record = &records[index];
+        ups_status_t st = find(0, txn, &keys[index], record, flags);
+        results[index] = st;
+        if (st == 0 && NOTSET(record->flags, UPS_RECORD_USER_ALLOC))
+          offsets[index] = batch.append((uint8_t *)record->data,
+                          record->size);
+        else if (st && !is_batch_key_status(st))
+          return (st);
+      }
+
+      for (uint32_t i = 0; i < count; i++) {
+        ups_record_t *record = &records[i];
+        if (results[i] == 0 && NOTSET(record->flags, UPS_RECORD_USER_ALLOC))
+          record->data = record->size ? batch.data() + offsets[i] : 0;
+      }
+      record_arena(txn).assign(batch.data(), batch.size());
+      batch.disown();
+      return (0);
+    }
+
+    /* otherwise the btree looks up the whole batch, and re-uses the
+     * leaf pages of the previous keys */
+    std::vector<uint32_t> valid;
+    valid.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t index = order[i];
+      if (m_config.key_size != UPS_KEY_SIZE_UNLIMITED
+          && keys[index].size != m_config.key_size)
+        results[index] = UPS_INV_KEY_SIZE;
+      else
+        valid.push_back(index);
+    }
+
+    Context context(lenv(), (LocalTransaction *)txn, this);
+
+    /* purge cache if necessary */
+    lenv()->page_manager()->purge_cache(&context);
+
+    if (!valid.empty())
+      m_btree_index->find_many(&context, (uint32_t)valid.size(), &valid[0],
+                      keys, records, results, &record_arena(txn));
+    return (0);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
+ups_status_t
+LocalDatabase::insert_many(Transaction *txn, uint32_t count, ups_key_t *keys,
+            ups_record_t *records, ups_status_t *results, uint32_t flags)
+{
+  bool is_recno = ISSETANY(get_flags(),
+                  UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64);
+
+  /* record numbers are assigned in the order of the batch; all other
+   * keys are inserted in sorted order, which allows the btree to re-use
+   * the leaf of the previous insert operation */
+  std::vector<uint32_t> order(count);
+  for (uint32_t i = 0; i < count; i++)
+    order[i] = i;
+  if (!is_recno)
+    std::stable_sort(order.begin(), order.end(),
+                  BatchKeyComparator(m_btree_index.get(), keys));
+
+  /* generated record number keys are collected in a temporary buffer */
+  std::vector<size_t> offsets(count);
+  std::vector<bool> generated(count);
+  ByteArray batch;
+  ups_status_t st = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t index = order[i];
+    ups_key_t *key = &keys[index];
+    bool allocate = is_recno && key->data == 0;
+
+    results[index] = insert(0, txn, key, &records[index], flags);
+    if (allocate && results[index] == 0) {
+      offsets[index] = batch.append((uint8_t *)key->data, key->size);
+      generated[index] = true;
+    }
+    else if (allocate)
+      key->data = 0;
+
+    if (results[index] && !is_batch_key_status(results[index])) {
+      st = results[index];
+      break;
+    }
+  }
+
+  if (!batch.is_empty()) {
+    for (uint32_t i = 0; i < count; i++) {
+      if (generated[i])
+        keys[i].data = batch.data() + offsets[i];
+    }
+    key_arena(txn).assign(batch.data(), batch.size());
+    batch.disown();
+  }
+  return (st);
+}
+
 Cursor *
 LocalDatabase::cursor_create_impl(Transaction *txn)
 {
@@ -1524,6 +1768,104 @@ are_cursors_identical(LocalCursor *c1, LocalCursor *c2)
   return (k1 == k2);
 }
 
+// A partial scan of a parallel query; visits a range of leaves with its
+// own ScanVisitor
+struct PartialScan
+{
+  PartialScan(LocalDatabase *db_, SelectStatement *stmt_,
+                  ScanVisitor *visitor_, uint64_t first_, uint64_t last_)
+    : db(db_), stmt(stmt_), visitor(visitor_), first(first_), last(last_),
+      status(0) {
+  }
+
+  // Scans the range in the current thread
+  void run() {
+    try {
+      Context context(db->lenv(), 0, db);
+      db->btree_index()->scan_leaves(&context, first, last, visitor, stmt);
+    }
+    catch (Exception &ex) {
+      status = ex.code;
+    }
+  }
+
+  // Thread entry point
+  void operator()() {
+    run();
+    db->release_thread_arenas();
+  }
+
+  LocalDatabase *db;
+  SelectStatement *stmt;
+  ScanVisitor *visitor;
+  uint64_t first;
+  uint64_t last;
+  ups_status_t status;
+};
+
+ups_status_t
+LocalDatabase::select_range_parallel(SelectStatement *stmt,
+                ScanVisitor *visitor, uint32_t threads, Result **presult)
+{
+  std::vector<uint64_t> ranges;
+
+  try {
+    Context context(lenv(), 0, this);
+
+    /* purge cache if necessary */
+    lenv()->page_manager()->purge_cache(&context);
+
+    /* split the leaf level in (up to) |threads| ranges */
+    m_btree_index->partition_leaves(&context, threads, ranges);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+
+  /* each range gets its own visitor; the first range is scanned by the
+   * current thread with the original visitor */
+  std::vector<PartialScan> scans;
+  scans.reserve(ranges.size());
+  for (size_t i = 0; i < ranges.size(); i++) {
+    ScanVisitor *v = visitor;
+    if (i > 0)
+      v = ScanVisitorFactory::from_select(stmt, this);
+    assert(v != 0);
+    scans.push_back(PartialScan(this, stmt, v, ranges[i],
+                            i + 1 < ranges.size() ? ranges[i + 1] : 0));
+  }
+
+  std::vector<Thread *> workers;
+  for (size_t i = 1; i < scans.size(); i++)
+    workers.push_back(new Thread(boost::ref(scans[i])));
+
+  scans[0].run();
+
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i]->join();
+    delete workers[i];
+  }
+
+  /* merge the partial results in key order */
+  ups_status_t st = 0;
+  for (size_t i = 0; i < scans.size(); i++) {
+    if (st == 0)
+      st = scans[i].status;
+    if (i > 0) {
+      if (st == 0)
+        visitor->merge(scans[i].visitor);
+      delete scans[i].visitor;
+    }
+  }
+  if (st)
+    return (st);
+
+  Result *result = new Result;
+  visitor->assign_result((uqi_result_t *)result);
+  *presult = result;
+  return (0);
+}
+
 ups_status_t
 LocalDatabase::select_range(SelectStatement *stmt, LocalCursor *begin,
                 LocalCursor *end, Result **presult)
@@ -1546,6 +1888,16 @@ LocalDatabase::select_range(SelectStatement *stmt, LocalCursor *begin,
   if (!visitor.get())
     return (UPS_PARSER_ERROR);
 
+  /* scan the Database with multiple threads? Requires that the visitor
+   * can merge partial results, and that the btree can be read
+   * concurrently */
+  uint32_t threads = stmt->parallel > 0
+                        ? (uint32_t)stmt->parallel
+                        : lenv()->config().query_threads;
+  if (threads > 1 && !begin && !end && visitor->supports_merge()
+          && supports_concurrent_reads())
+    return (select_range_parallel(stmt, visitor.get(), threads, presult));
+
   Context context(lenv(), 0, this);
 
   Result *result = new Result;
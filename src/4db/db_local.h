@@ -50,6 +50,7 @@ class TransactionOperation;
 class LocalEnvironment;
 class LocalTransaction;
 struct SelectStatement;
+struct ScanVisitor;
 struct Result;
 
 template<typename T>
@@ -115,6 +116,11 @@ class LocalDatabase : public Database {
     virtual ups_status_t insert(Cursor *cursor, Transaction *txn,
                     ups_key_t *key, ups_record_t *record, uint32_t flags);
 
+    // Loads a sorted sequence of key/value pairs into an empty database
+    // (ups_db_bulk_load)
+    virtual ups_status_t bulk_load(ups_bulk_load_func_t func, void *context,
+                    uint32_t fill_factor);
+
     // Erase a key/value pair (ups_db_erase, ups_cursor_erase)
     virtual ups_status_t erase(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     uint32_t flags);
@@ -123,10 +129,31 @@ class LocalDatabase : public Database {
     virtual ups_status_t find(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     ups_record_t *record, uint32_t flags);
 
+    // Lookup of a batch of keys (ups_db_find_many)
+    virtual ups_status_t find_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags);
+
+    // Inserts a batch of key/value pairs (ups_db_insert_many)
+    virtual ups_status_t insert_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags);
+
     // Moves a cursor, returns key and/or record (ups_cursor_move)
     virtual ups_status_t cursor_move(Cursor *cursor, ups_key_t *key,
                     ups_record_t *record, uint32_t flags);
 
+    // Returns true if read-only operations can run concurrently. This is
+    // not supported if Transactions or duplicate keys are enabled, or if
+    // the keys or records are compressed (because the compressors are
+    // shared)
+    virtual bool supports_concurrent_reads() {
+      return (NOTSET(get_flags(), UPS_ENABLE_TRANSACTIONS)
+              && NOTSET(get_flags(), UPS_ENABLE_DUPLICATE_KEYS)
+              && m_config.key_compressor == UPS_COMPRESSOR_NONE
+              && m_record_compressor.get() == 0);
+    }
+
     // Inserts a key/record pair in a txn node; if cursor is not NULL it will
     // be attached to the new txn_op structure
     // TODO this should be private
@@ -207,6 +234,12 @@ class LocalDatabase : public Database {
     // Returns true if a (btree) key was erased in a Transaction
     bool is_key_erased(Context *context, ups_key_t *key);
 
+    // Implementation of select_range() for parallel scans: splits the leaf
+    // level into ranges, scans them with |threads| threads and merges the
+    // partial results into |visitor|
+    ups_status_t select_range_parallel(SelectStatement *stmt,
+                    ScanVisitor *visitor, uint32_t threads, Result **result);
+
     // Erases a key/record pair from a txn; on success, cursor will be set to
     // nil
     ups_status_t erase_txn(Context *context, ups_key_t *key, uint32_t flags,
@@ -384,6 +384,167 @@ RemoteDatabase::find(Cursor *hcursor, Transaction *htxn, ups_key_t *key,
   }
 }
 
+ups_status_t
+RemoteDatabase::find_many(Transaction *htxn, uint32_t count, ups_key_t *keys,
+            ups_record_t *records, ups_status_t *results, uint32_t flags)
+{
+  try {
+    RemoteEnvironment *env = renv();
+    RemoteTransaction *txn = dynamic_cast<RemoteTransaction *>(htxn);
+
+    /* pack all keys into a single buffer */
+    size_t size = 0;
+    for (uint32_t i = 0; i < count; i++)
+      size += SerializedBatch::get_size(keys[i].size);
+    ByteArray buffer(size);
+    uint8_t *ptr = buffer.data();
+    for (uint32_t i = 0; i < count; i++)
+      ptr = SerializedBatch::append(ptr, keys[i].data, keys[i].size);
+
+    SerializedWrapper request;
+    request.id = kDbFindManyRequest;
+    request.db_find_many_request.db_handle = m_remote_handle;
+    request.db_find_many_request.txn_handle = txn
+              ? txn->get_remote_handle()
+              : 0;
+    request.db_find_many_request.flags = flags;
+    request.db_find_many_request.count = count;
+    request.db_find_many_request.keys.value = buffer.data();
+    request.db_find_many_request.keys.size = (uint32_t)size;
+
+    SerializedWrapper reply;
+    env->perform_request(&request, &reply);
+    assert(reply.id == kDbFindManyReply);
+
+    ups_status_t st = reply.db_find_many_reply.status;
+    if (st)
+      return (st);
+
+    if (reply.db_find_many_reply.results.size != count * sizeof(int32_t))
+      throw Exception(UPS_INTERNAL_ERROR);
+
+    /* the records are unpacked from a copy of the reply */
+    ByteArray *rec_arena = &record_arena(txn);
+    rec_arena->copy(reply.db_find_many_reply.records.value,
+                    reply.db_find_many_reply.records.size);
+    ptr = rec_arena->data();
+    uint8_t *end = ptr + reply.db_find_many_reply.records.size;
+    int32_t *status = (int32_t *)reply.db_find_many_reply.results.value;
+
+    for (uint32_t i = 0; i < count; i++) {
+      void *data;
+      uint32_t data_size;
+      ptr = SerializedBatch::next(ptr, end, &data, &data_size);
+      if (!ptr)
+        throw Exception(UPS_INTERNAL_ERROR);
+
+      results[i] = status[i];
+      if (results[i] != 0)
+        continue;
+
+      ups_record_t *record = &records[i];
+      record->size = data_size;
+      if (record->flags & UPS_RECORD_USER_ALLOC)
+        ::memcpy(record->data, data, data_size);
+      else
+        record->data = data;
+    }
+    return (0);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
+ups_status_t
+RemoteDatabase::insert_many(Transaction *htxn, uint32_t count,
+            ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+            uint32_t flags)
+{
+  try {
+    RemoteEnvironment *env = renv();
+    RemoteTransaction *txn = dynamic_cast<RemoteTransaction *>(htxn);
+
+    /* recno: do not send the keys, unless they are overwritten */
+    bool send_keys = NOTSET(get_flags(),
+                    UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64)
+            || ISSET(flags, UPS_OVERWRITE);
+
+    /* pack all keys and records into two buffers */
+    size_t key_size = 0;
+    size_t record_size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      key_size += SerializedBatch::get_size(send_keys ? keys[i].size : 0);
+      record_size += SerializedBatch::get_size(records[i].size);
+    }
+    ByteArray key_buffer(key_size);
+    ByteArray record_buffer(record_size);
+    uint8_t *kptr = key_buffer.data();
+    uint8_t *rptr = record_buffer.data();
+    for (uint32_t i = 0; i < count; i++) {
+      if (send_keys)
+        kptr = SerializedBatch::append(kptr, keys[i].data, keys[i].size);
+      else
+        kptr = SerializedBatch::append(kptr, 0, 0);
+      rptr = SerializedBatch::append(rptr, records[i].data, records[i].size);
+    }
+
+    SerializedWrapper request;
+    request.id = kDbInsertManyRequest;
+    request.db_insert_many_request.db_handle = m_remote_handle;
+    request.db_insert_many_request.txn_handle = txn
+              ? txn->get_remote_handle()
+              : 0;
+    request.db_insert_many_request.flags = flags;
+    request.db_insert_many_request.count = count;
+    request.db_insert_many_request.keys.value = key_buffer.data();
+    request.db_insert_many_request.keys.size = (uint32_t)key_size;
+    request.db_insert_many_request.records.value = record_buffer.data();
+    request.db_insert_many_request.records.size = (uint32_t)record_size;
+
+    SerializedWrapper reply;
+    env->perform_request(&request, &reply);
+    assert(reply.id == kDbInsertManyReply);
+
+    if (reply.db_insert_many_reply.results.size == count * sizeof(int32_t)) {
+      int32_t *status = (int32_t *)reply.db_insert_many_reply.results.value;
+      for (uint32_t i = 0; i < count; i++)
+        results[i] = status[i];
+    }
+
+    /* recno: copy the generated keys */
+    if (reply.db_insert_many_reply.has_keys) {
+      ByteArray *arena = &key_arena(txn);
+      arena->copy(reply.db_insert_many_reply.keys.value,
+                      reply.db_insert_many_reply.keys.size);
+      uint8_t *ptr = arena->data();
+      uint8_t *end = ptr + reply.db_insert_many_reply.keys.size;
+
+      for (uint32_t i = 0; i < count; i++) {
+        void *data;
+        uint32_t data_size;
+        ptr = SerializedBatch::next(ptr, end, &data, &data_size);
+        if (!ptr)
+          throw Exception(UPS_INTERNAL_ERROR);
+        if (results[i] != 0)
+          continue;
+
+        ups_key_t *key = &keys[i];
+        if (key->data)
+          ::memcpy(key->data, data, data_size);
+        else
+          key->data = data;
+        key->size = (uint16_t)data_size;
+      }
+    }
+
+    return (reply.db_insert_many_reply.status);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
 Cursor *
 RemoteDatabase::cursor_create_impl(Transaction *htxn)
 {
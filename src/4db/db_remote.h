@@ -74,6 +74,12 @@ class RemoteDatabase : public Database
     virtual ups_status_t insert(Cursor *cursor, Transaction *txn,
                     ups_key_t *key, ups_record_t *record, uint32_t flags);
 
+    // Loads a sorted sequence of key/value pairs into an empty database
+    virtual ups_status_t bulk_load(ups_bulk_load_func_t func, void *context,
+                    uint32_t fill_factor) {
+      return (UPS_NOT_IMPLEMENTED);
+    }
+
     // Erase a key/value pair (ups_db_erase, ups_cursor_erase)
     virtual ups_status_t erase(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     uint32_t flags);
@@ -82,6 +88,16 @@ class RemoteDatabase : public Database
     virtual ups_status_t find(Cursor *cursor, Transaction *txn, ups_key_t *key,
                     ups_record_t *record, uint32_t flags);
 
+    // Lookup of a batch of keys (ups_db_find_many)
+    virtual ups_status_t find_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags);
+
+    // Inserts a batch of key/value pairs (ups_db_insert_many)
+    virtual ups_status_t insert_many(Transaction *txn, uint32_t count,
+                    ups_key_t *keys, ups_record_t *records,
+                    ups_status_t *results, uint32_t flags);
+
     // Moves a cursor, returns key and/or record (ups_cursor_move)
     virtual ups_status_t cursor_move(Cursor *cursor, ups_key_t *key,
                     ups_record_t *record, uint32_t flags);
@@ -55,7 +55,7 @@ ups_status_t
 Environment::get_database_names(uint16_t *names, uint32_t *count)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_get_database_names(names, count));
   }
   catch (Exception &ex) {
@@ -67,7 +67,7 @@ ups_status_t
 Environment::get_parameters(ups_parameter_t *param)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_get_parameters(param));
   }
   catch (Exception &ex) {
@@ -79,7 +79,7 @@ ups_status_t
 Environment::flush(uint32_t flags)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_flush(flags));
   }
   catch (Exception &ex) {
@@ -92,7 +92,7 @@ Environment::create_db(Database **pdb, DbConfig &config,
                     const ups_parameter_t *param)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
 
     ups_status_t st = do_create_db(pdb, config, param);
 
@@ -121,7 +121,7 @@ Environment::open_db(Database **pdb, DbConfig &config,
                     const ups_parameter_t *param)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
 
     /* make sure that this database is not yet open */
     if (m_database_map.find(config.db_name) != m_database_map.end())
@@ -148,7 +148,7 @@ ups_status_t
 Environment::rename_db(uint16_t oldname, uint16_t newname, uint32_t flags)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_rename_db(oldname, newname, flags));
   }
   catch (Exception &ex) {
@@ -160,7 +160,7 @@ ups_status_t
 Environment::erase_db(uint16_t dbname, uint32_t flags)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_erase_db(dbname, flags));
   }
   catch (Exception &ex) {
@@ -174,9 +174,9 @@ Environment::close_db(Database *db, uint32_t flags)
   ups_status_t st = 0;
 
   try {
-    ScopedLock lock;
+    ScopedExclusiveLock lock;
     if (!(flags & UPS_DONT_LOCK))
-      lock = ScopedLock(m_mutex);
+      lock = ScopedExclusiveLock(m_mutex);
 
     uint16_t dbname = db->name();
 
@@ -207,9 +207,9 @@ ups_status_t
 Environment::txn_begin(Transaction **ptxn, const char *name, uint32_t flags)
 {
   try {
-    ScopedLock lock;
+    ScopedExclusiveLock lock;
     if (!(flags & UPS_DONT_LOCK))
-      lock = ScopedLock(m_mutex);
+      lock = ScopedExclusiveLock(m_mutex);
 
     if (!(m_config.flags & UPS_ENABLE_TRANSACTIONS)) {
       ups_trace(("transactions are disabled (see UPS_ENABLE_TRANSACTIONS)"));
@@ -229,7 +229,7 @@ std::string
 Environment::txn_get_name(Transaction *txn)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (txn->get_name());
   }
   catch (Exception &) {
@@ -241,8 +241,17 @@ ups_status_t
 Environment::txn_commit(Transaction *txn, uint32_t flags)
 {
   try {
-    ScopedLock lock(m_mutex);
-    return (do_txn_commit(txn, flags));
+    uint64_t ticket;
+    {
+      ScopedExclusiveLock lock(m_mutex);
+      ups_status_t st = do_txn_commit(txn, flags);
+      ticket = do_txn_commit_ticket();
+      if (st)
+        return (st);
+    }
+    if (ticket)
+      do_txn_commit_wait(ticket);
+    return (0);
   }
   catch (Exception &ex) {
     return (ex.code);
@@ -253,7 +262,7 @@ ups_status_t
 Environment::txn_abort(Transaction *txn, uint32_t flags)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     return (do_txn_abort(txn, flags));
   }
   catch (Exception &ex) {
@@ -261,13 +270,45 @@ Environment::txn_abort(Transaction *txn, uint32_t flags)
   }
 }
 
+ups_status_t
+Environment::get_durable_lsn(uint64_t *durable_lsn, uint64_t *commit_lsn)
+{
+  try {
+    ScopedExclusiveLock lock(m_mutex);
+    return (do_get_durable_lsn(durable_lsn, commit_lsn));
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
+ups_status_t
+Environment::wait_durable_lsn(uint64_t lsn)
+{
+  try {
+    uint64_t ticket = 0;
+    {
+      ScopedExclusiveLock lock(m_mutex);
+      ups_status_t st = do_durable_lsn_ticket(lsn, &ticket);
+      if (st)
+        return (st);
+    }
+    if (ticket)
+      do_txn_commit_wait(ticket);
+    return (0);
+  }
+  catch (Exception &ex) {
+    return (ex.code);
+  }
+}
+
 ups_status_t
 Environment::close(uint32_t flags)
 {
   ups_status_t st = 0;
 
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
 
     /* auto-abort (or commit) all pending transactions */
     if (m_txn_manager.get()) {
@@ -316,7 +357,7 @@ ups_status_t
 Environment::fill_metrics(ups_env_metrics_t *metrics)
 {
   try {
-    ScopedLock lock(m_mutex);
+    ScopedExclusiveLock lock(m_mutex);
     do_fill_metrics(metrics);
     return (0);
   }
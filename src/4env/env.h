@@ -86,8 +86,9 @@ class Environment
       return (m_config);
     }
 
-    // Returns this Environment's mutex
-    Mutex &mutex() {
+    // Returns this Environment's mutex; read-only operations can lock it
+    // in shared mode (see Database::supports_concurrent_reads())
+    SharedMutex &mutex() {
       return (m_mutex);
     }
 
@@ -137,6 +138,14 @@ class Environment
     // Commits a transaction (ups_txn_abort)
     ups_status_t txn_abort(Transaction *txn, uint32_t flags);
 
+    // Returns the durable lsn and the lsn of the most recent commit
+    // (ups_env_get_durable_lsn); |commit_lsn| can be null
+    ups_status_t get_durable_lsn(uint64_t *durable_lsn, uint64_t *commit_lsn);
+
+    // Waits till the journal is durable up to |lsn|
+    // (ups_env_wait_durable_lsn)
+    ups_status_t wait_durable_lsn(uint64_t lsn);
+
     // Closes the Environment (ups_env_close)
     ups_status_t close(uint32_t flags);
 
@@ -190,6 +199,34 @@ class Environment
     // Commits a transaction (ups_txn_commit)
     virtual ups_status_t do_txn_commit(Transaction *txn, uint32_t flags) = 0;
 
+    // Returns a ticket for the durability of the most recent commit, or 0
+    // if the commit is already durable; called while the Environment is
+    // locked
+    virtual uint64_t do_txn_commit_ticket() {
+      return (0);
+    }
+
+    // Waits till the commit with |ticket| is durable; called after the
+    // Environment lock was released, therefore concurrent commits can
+    // share an fsync
+    virtual void do_txn_commit_wait(uint64_t ticket) {
+    }
+
+    // Returns the durable lsn and the lsn of the most recent commit
+    // (ups_env_get_durable_lsn)
+    virtual ups_status_t do_get_durable_lsn(uint64_t *durable_lsn,
+                    uint64_t *commit_lsn) {
+      return (UPS_NOT_IMPLEMENTED);
+    }
+
+    // Writes the journal up to |lsn| and returns a ticket for
+    // |do_txn_commit_wait()|, or 0 if the lsn is already durable; called
+    // while the Environment is locked (ups_env_wait_durable_lsn)
+    virtual ups_status_t do_durable_lsn_ticket(uint64_t lsn,
+                    uint64_t *ticket) {
+      return (UPS_NOT_IMPLEMENTED);
+    }
+
     // Commits a transaction (ups_txn_abort)
     virtual ups_status_t do_txn_abort(Transaction *txn, uint32_t flags) = 0;
 
@@ -201,7 +238,7 @@ class Environment
 
   protected:
     // A mutex to serialize access to this Environment
-    Mutex m_mutex;
+    SharedMutex m_mutex;
 
     // The Environment's configuration
     EnvConfig m_config;
@@ -360,6 +360,9 @@ fail_with_fake_cleansing:
   if (m_header->page_manager_blobid() != 0)
     m_page_manager->initialize(m_header->page_manager_blobid());
 
+  /* preload the pages which were cached when the Environment was closed */
+  m_page_manager->warm_up();
+
   return (0);
 }
 
@@ -433,6 +436,54 @@ LocalEnvironment::do_get_parameters(ups_parameter_t *param)
       case UPS_PARAM_POSIX_FADVISE:
         p->value = m_config.posix_advice;
         break;
+      case UPS_PARAM_CACHE_POLICY:
+        p->value = m_config.cache_policy;
+        break;
+      case UPS_PARAM_IO_QUEUE_DEPTH:
+        p->value = m_config.io_queue_depth;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY:
+        p->value = m_config.group_commit_delay_usec;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE:
+        p->value = m_config.group_commit_size;
+        break;
+      case UPS_PARAM_QUERY_THREADS:
+        p->value = m_config.query_threads;
+        break;
+      case UPS_PARAM_CACHE_WARMUP:
+        p->value = m_config.cache_warmup ? 1 : 0;
+        break;
+      case UPS_PARAM_CACHE_WARMUP_INTERVAL:
+        p->value = m_config.cache_warmup_interval_sec;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_SIZE:
+        p->value = m_config.compressed_cache_size_bytes;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR:
+        p->value = m_config.compressed_cache_compressor;
+        break;
+      case UPS_PARAM_FLUSH_THREADS:
+        p->value = m_config.flush_threads;
+        break;
+      case UPS_PARAM_FLUSH_RATE_LIMIT:
+        p->value = m_config.flush_rate_limit;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_INTERVAL:
+        p->value = m_config.journal_flush_interval_msec;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_SIZE:
+        p->value = m_config.journal_flush_size;
+        break;
+      case UPS_PARAM_RECOVERY_THREADS:
+        p->value = m_config.recovery_threads;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_SIZE:
+        p->value = m_config.journal_checkpoint_size;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL:
+        p->value = m_config.journal_checkpoint_interval_sec;
+        break;
       default:
         ups_trace(("unknown parameter %d", (int)p->name));
         return (UPS_INV_PARAMETER);
@@ -484,7 +535,8 @@ LocalEnvironment::do_create_db(Database **pdb, DbConfig &config,
           config.record_compressor = (int)param->value;
           break;
         case UPS_PARAM_KEY_COMPRESSION:
-          if (!CompressorFactory::is_available(param->value)) {
+          if (param->value != UPS_COMPRESSOR_PREFIX
+                && !CompressorFactory::is_available(param->value)) {
             ups_trace(("unknown algorithm for key compression"));
             return (UPS_INV_PARAMETER);
           }
@@ -585,11 +637,26 @@ LocalEnvironment::do_create_db(Database **pdb, DbConfig &config,
     }
   }
 
-  // all heavy-weight compressors are only allowed for
-  // variable-length binary keys
+  // uint64 compression is only allowed for uint64-keys
+  if (config.key_compressor == UPS_COMPRESSOR_UINT64_VARBYTE
+      || config.key_compressor == UPS_COMPRESSOR_UINT64_FOR) {
+    if (config.key_type != UPS_TYPE_UINT64) {
+      ups_trace(("Uint64 compression only allowed for uint64 keys "
+                 "(UPS_TYPE_UINT64)"));
+      return (UPS_INV_PARAMETER);
+    }
+    if (m_config.page_size_bytes != 16 * 1024) {
+      ups_trace(("Uint64 compression only allowed for page size of 16k"));
+      return (UPS_INV_PARAMETER);
+    }
+  }
+
+  // all heavy-weight compressors (and the prefix compression) are only
+  // allowed for variable-length binary keys
   if (config.key_compressor == UPS_COMPRESSOR_LZF
         || config.key_compressor == UPS_COMPRESSOR_SNAPPY
-        || config.key_compressor == UPS_COMPRESSOR_ZLIB) {
+        || config.key_compressor == UPS_COMPRESSOR_ZLIB
+        || config.key_compressor == UPS_COMPRESSOR_PREFIX) {
     if (config.key_type != UPS_TYPE_BINARY
           || config.key_size != UPS_KEY_SIZE_UNLIMITED) {
       ups_trace(("Key compression only allowed for unlimited binary keys "
@@ -836,6 +903,45 @@ LocalEnvironment::do_txn_commit(Transaction *txn, uint32_t flags)
   return (m_txn_manager->commit(txn, flags));
 }
 
+uint64_t
+LocalEnvironment::do_txn_commit_ticket()
+{
+  return (m_journal.get() ? m_journal->take_commit_ticket() : 0);
+}
+
+void
+LocalEnvironment::do_txn_commit_wait(uint64_t ticket)
+{
+  m_journal->sync(ticket, true);
+}
+
+ups_status_t
+LocalEnvironment::do_get_durable_lsn(uint64_t *durable_lsn,
+                uint64_t *commit_lsn)
+{
+  if (!m_journal.get()) {
+    ups_trace(("Environment does not have a journal"));
+    return (UPS_INV_PARAMETER);
+  }
+
+  *durable_lsn = m_journal->durable_lsn();
+  if (commit_lsn)
+    *commit_lsn = m_journal->state.commit_lsn;
+  return (0);
+}
+
+ups_status_t
+LocalEnvironment::do_durable_lsn_ticket(uint64_t lsn, uint64_t *ticket)
+{
+  if (!m_journal.get()) {
+    ups_trace(("Environment does not have a journal"));
+    return (UPS_INV_PARAMETER);
+  }
+
+  *ticket = m_journal->durable_ticket(lsn);
+  return (0);
+}
+
 ups_status_t
 LocalEnvironment::do_txn_abort(Transaction *txn, uint32_t flags)
 {
@@ -895,6 +1001,16 @@ LocalEnvironment::do_fill_metrics(ups_env_metrics_t *metrics) const
     LocalDatabase *db = (LocalDatabase *)m_database_map.begin()->second;
     db->fill_metrics(metrics);
   }
+  // the memory of the Transactions
+  if (m_txn_manager) {
+    ((LocalTransactionManager *)m_txn_manager.get())->fill_metrics(metrics);
+    for (DatabaseMap::const_iterator it = m_database_map.begin();
+            it != m_database_map.end(); it++) {
+      LocalDatabase *db = (LocalDatabase *)it->second;
+      if (db->txn_index())
+        db->txn_index()->fill_metrics(metrics);
+    }
+  }
   // and of the btrees
   BtreeIndex::fill_metrics(metrics);
   // SIMD support enabled?
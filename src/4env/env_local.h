@@ -145,6 +145,21 @@ class LocalEnvironment : public Environment
     // Commits a transaction (ups_txn_commit)
     virtual ups_status_t do_txn_commit(Transaction *txn, uint32_t flags);
 
+    // Returns the journal's ticket for the most recent commit
+    virtual uint64_t do_txn_commit_ticket();
+
+    // Waits till the journal is synced (group commit)
+    virtual void do_txn_commit_wait(uint64_t ticket);
+
+    // Returns the durable lsn and the lsn of the most recent commit
+    virtual ups_status_t do_get_durable_lsn(uint64_t *durable_lsn,
+                    uint64_t *commit_lsn);
+
+    // Writes the journal up to |lsn| and returns a ticket for
+    // |do_txn_commit_wait()|
+    virtual ups_status_t do_durable_lsn_ticket(uint64_t lsn,
+                    uint64_t *ticket);
+
     // Commits a transaction (ups_txn_abort)
     virtual ups_status_t do_txn_abort(Transaction *txn, uint32_t flags);
 
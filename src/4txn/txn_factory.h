@@ -30,8 +30,7 @@
 #include "ups/types.h"
 
 // Always verify that a file of level N does not include headers > N!
-#include "1mem/mem.h"
-#include "4txn/txn.h"
+#include "4txn/txn_local.h"
 
 #ifndef UPS_ROOT_H
 #  error "root.h was not included"
@@ -41,19 +40,21 @@ namespace upscaledb {
 
 struct TransactionFactory
 {
-  // Creates a new TransactionOperation
+  // Creates a new TransactionOperation; the operation (and the copies
+  // of |key| and |record|) are allocated from the Arena of |txn|
   static TransactionOperation *create_operation(LocalTransaction *txn,
             TransactionNode *node, uint32_t flags, uint32_t orig_flags,
             uint64_t lsn, ups_key_t *key, ups_record_t *record) {
     TransactionOperation *op;
-    op = Memory::allocate<TransactionOperation>(sizeof(*op)
+    op = (TransactionOperation *)txn->arena().allocate(sizeof(*op)
                                             + (record ? record->size : 0)
                                             + (key ? key->size : 0));
     op->initialize(txn, node, flags, orig_flags, lsn, key, record);
     return (op);
   }
 
-  // Destroys a TransactionOperation
+  // Destroys a TransactionOperation; its memory is released when the
+  // Arena of the Transaction is cleared
   static void destroy_operation(TransactionOperation *op) {
     op->destroy();
   }
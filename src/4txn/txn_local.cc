@@ -128,9 +128,7 @@ TransactionOperation::destroy()
     prev->set_next_in_txn(next);
 
   if (delete_node)
-    delete node;
-
-  Memory::release(this);
+    node->get_db()->txn_index()->destroy_node(node);
 }
 
 TransactionNode *
@@ -220,7 +218,8 @@ LocalTransactionManager::LocalTransactionManager(Environment *env)
 LocalTransaction::LocalTransaction(LocalEnvironment *env, const char *name,
         uint32_t flags)
   : Transaction(env, name, flags), m_log_desc(0), m_oldest_op(0),
-    m_newest_op(0), m_op_counter(0), m_accum_data_size(0)
+    m_newest_op(0), m_op_counter(0), m_accum_data_size(0),
+    m_arena(&((LocalTransactionManager *)env->txn_manager())->arena_pool())
 {
   LocalTransactionManager *ltm = 
         (LocalTransactionManager *)env->txn_manager();
@@ -281,10 +280,13 @@ LocalTransaction::free_operations()
 
   set_oldest_op(0);
   set_newest_op(0);
+
+  // now release the memory of all operations at once
+  m_arena.clear();
 }
 
 TransactionIndex::TransactionIndex(LocalDatabase *db)
-  : m_db(db)
+  : m_db(db), m_free_nodes(0), m_free_node_count(0)
 {
   rbt_new(this);
 }
@@ -295,13 +297,44 @@ TransactionIndex::~TransactionIndex()
 
   while ((node = rbt_last(this))) {
     remove(node);
-    delete node;
+    destroy_node(node);
   }
 
   // re-initialize the tree
   rbt_new(this);
 }
 
+TransactionNode *
+TransactionIndex::create_node(ups_key_t *key)
+{
+  void *p;
+  if (m_free_nodes) {
+    p = m_free_nodes;
+    m_free_nodes = *(TransactionNode **)p;
+    m_free_node_count--;
+  }
+  else
+    p = m_node_arena.allocate(sizeof(TransactionNode));
+  return (new (p) TransactionNode(m_db, key));
+}
+
+void
+TransactionIndex::destroy_node(TransactionNode *node)
+{
+  node->~TransactionNode();
+  *(TransactionNode **)node = m_free_nodes;
+  m_free_nodes = node;
+  m_free_node_count++;
+}
+
+void
+TransactionIndex::fill_metrics(ups_env_metrics_t *metrics) const
+{
+  metrics->txn_arena_size += m_node_arena.size();
+  metrics->txn_arena_usage += m_node_arena.usage()
+                    - m_free_node_count * sizeof(TransactionNode);
+}
+
 TransactionNode *
 TransactionIndex::get(ups_key_t *key, uint32_t flags)
 {
@@ -486,7 +519,8 @@ LocalTransactionManager::commit(Transaction *htxn, uint32_t flags)
 
     /* append journal entry */
     if (lenv()->journal() && !(txn->get_flags() & UPS_TXN_TEMPORARY))
-      lenv()->journal()->append_txn_commit(txn, lenv()->next_lsn());
+      lenv()->journal()->append_txn_commit(txn, lenv()->next_lsn(),
+                      ISSET(flags, UPS_TXN_ASYNC_COMMIT));
 
     /* flush committed transactions */
     maybe_flush_committed_txns(&context);
@@ -544,6 +578,7 @@ LocalTransactionManager::flush_committed_txns_impl(Context *context)
   LocalTransaction *oldest;
   Journal *journal = lenv()->journal();
   uint64_t highest_lsn = 0;
+  bool durable = false;
 
   assert(context->changeset.is_empty());
 
@@ -558,6 +593,12 @@ LocalTransactionManager::flush_committed_txns_impl(Context *context)
       /* this transaction was flushed! */
       if (journal && (oldest->get_flags() & UPS_TXN_TEMPORARY) == 0)
         journal->transaction_flushed(oldest);
+
+      /* explicit commits wait for their own fsync (group commit, see
+       * Environment::txn_commit), but temporary transactions are only
+       * durable if the changeset is synced immediately */
+      if (oldest->get_flags() & UPS_TXN_TEMPORARY)
+        durable = true;
     }
     else if (oldest->is_aborted()) {
       ; /* nop */
@@ -574,7 +615,7 @@ LocalTransactionManager::flush_committed_txns_impl(Context *context)
 
   /* now flush the changeset and write the modified pages to disk */
   if (highest_lsn && context->env->journal())
-    context->changeset.flush(highest_lsn);
+    context->changeset.flush(highest_lsn, durable);
   else
     context->changeset.clear();
   assert(context->changeset.is_empty());
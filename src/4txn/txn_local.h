@@ -26,6 +26,7 @@
 #include "0root/root.h"
 
 // Always verify that a file of level N does not include headers > N!
+#include "1mem/arena.h"
 #include "1rb/rb.h"
 #include "4txn/txn.h"
 
@@ -369,6 +370,17 @@ class TransactionIndex
     // Returns the key count of this index
     uint64_t count(Context *context, LocalTransaction *txn, bool distinct);
 
+    // Creates a new TransactionNode for |key|; the node is not yet stored
+    // in the tree
+    TransactionNode *create_node(ups_key_t *key);
+
+    // Releases a TransactionNode which was created with |create_node()|;
+    // the node must no longer be stored in the tree
+    void destroy_node(TransactionNode *node);
+
+    // Adds the memory usage of the nodes to |metrics|
+    void fill_metrics(ups_env_metrics_t *metrics) const;
+
  // private: //TODO re-enable this; currently disabled because rb.h needs it
     // the Database for all operations in this tree
     LocalDatabase *m_db;
@@ -376,6 +388,16 @@ class TransactionIndex
     // stuff for rb.h
     TransactionNode *rbt_root;
     TransactionNode rbt_nil;
+
+  private:
+    // the memory of the nodes; released when the index is destroyed
+    Arena m_node_arena;
+
+    // released nodes, which are re-used by |create_node()|
+    TransactionNode *m_free_nodes;
+
+    // the number of nodes in |m_free_nodes|
+    size_t m_free_node_count;
 };
 
 
@@ -436,6 +458,12 @@ class LocalTransaction : public Transaction
       return (m_accum_data_size);
     }
 
+    // Returns the Arena which stores the operations of this Transaction,
+    // including their keys and records
+    Arena &arena() {
+      return (m_arena);
+    }
+
   private:
     friend struct Journal;
     friend struct TxnFixture;
@@ -471,6 +499,9 @@ class LocalTransaction : public Transaction
     // The approximate accumulated memory consumed by this Transaction
     // (sums up key->size and record->size over all operations)
     int m_accum_data_size;
+
+    // The memory of the operations; released in bulk in |free_operations()|
+    Arena m_arena;
 };
 
 
@@ -513,6 +544,18 @@ class LocalTransactionManager : public TransactionManager
       m_txn_id = id;
     }
 
+    // Returns the pool which provides the memory of the Transactions'
+    // Arenas
+    ArenaPool &arena_pool() {
+      return (m_arena_pool);
+    }
+
+    // Fills the metrics of the Transaction Arenas
+    void fill_metrics(ups_env_metrics_t *metrics) const {
+      metrics->txn_arena_size += m_arena_pool.size;
+      metrics->txn_arena_usage += m_arena_pool.usage;
+    }
+
   private:
     void flush_committed_txns_impl(Context *context);
 
@@ -531,6 +574,9 @@ class LocalTransactionManager : public TransactionManager
 
     // The current transaction ID
     uint64_t m_txn_id;
+
+    // Provides (and recycles) the memory chunks of the Transactions
+    ArenaPool m_arena_pool;
 };
 
 } // namespace upscaledb
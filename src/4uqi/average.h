@@ -19,6 +19,7 @@
 
 #include "1base/error.h"
 #include "2config/db_config.h"
+#include "2simd/simd_aggregate.h"
 #include "4uqi/scanvisitor.h"
 #include "4uqi/plugin_wrapper.h"
 #include "4uqi/result.h"
@@ -62,18 +63,10 @@ struct AverageScanVisitor : public NumericalScanVisitor {
   // Operates on an array of keys
   virtual void operator()(const void *key_data, const void *record_data,
                   size_t length) {
-    if (ISSET(statement->function.flags, UQI_STREAM_KEY)) {
-      Sequence<Key> keys(key_data, length);
-      for (typename Sequence<Key>::iterator it = keys.begin();
-                      it != keys.end(); it++)
-        sum += it->value;
-    }
-    else {
-      Sequence<Record> records(record_data, length);
-      for (typename Sequence<Record>::iterator it = records.begin();
-                      it != records.end(); it++)
-        sum += it->value;
-    }
+    if (ISSET(statement->function.flags, UQI_STREAM_KEY))
+      sum += simd_sum((const typename Key::type *)key_data, length);
+    else
+      sum += simd_sum((const typename Record::type *)record_data, length);
 
     count += length;
   }
@@ -86,6 +79,18 @@ struct AverageScanVisitor : public NumericalScanVisitor {
     uqi_result_add_row(result, "AVERAGE", 8, &avg, sizeof(avg));
   }
 
+  // Partial sums and counters can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial sum and counter of |other|
+  virtual void merge(ScanVisitor *other) {
+    AverageScanVisitor *o = (AverageScanVisitor *)other;
+    sum += o->sum;
+    count += o->count;
+  }
+
   // The aggregated sum
   double sum;
 
@@ -161,6 +166,18 @@ struct AverageIfScanVisitor : public NumericalScanVisitor {
     uqi_result_add_row(result, "AVERAGE", 8, &avg, sizeof(avg));
   }
 
+  // Partial sums and counters can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial sum and counter of |other|
+  virtual void merge(ScanVisitor *other) {
+    AverageIfScanVisitor *o = (AverageIfScanVisitor *)other;
+    sum += o->sum;
+    count += o->count;
+  }
+
   // The aggreated sum
   double sum;
 
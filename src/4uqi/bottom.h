@@ -100,6 +100,31 @@ struct BottomScanVisitorBase : public NumericalScanVisitor {
     }
   }
 
+  // Partial results can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Merges the smallest values of |other|
+  virtual void merge(ScanVisitor *other) {
+    BottomScanVisitorBase *o = (BottomScanVisitorBase *)other;
+
+    if (ISSET(statement->function.flags, UQI_STREAM_KEY)) {
+      for (typename KeyMap::iterator it = o->stored_keys.begin();
+                      it != o->stored_keys.end(); it++)
+        max_key = store_max_value(it->first, max_key,
+                        it->second.data(), it->second.size(),
+                        stored_keys, statement->limit);
+    }
+    else {
+      for (typename RecordMap::iterator it = o->stored_records.begin();
+                      it != o->stored_records.end(); it++)
+        max_record = store_max_value(it->first, max_record,
+                        it->second.data(), it->second.size(),
+                        stored_records, statement->limit);
+    }
+  }
+
   // The maximum value currently stored in |keys|
   Key max_key;
 
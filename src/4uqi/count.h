@@ -58,6 +58,16 @@ struct CountScanVisitor : public ScanVisitor {
     uqi_result_add_row(result, "COUNT", 6, &count, sizeof(count));
   }
 
+  // Partial counters can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial counter of |other|
+  virtual void merge(ScanVisitor *other) {
+    count += ((CountScanVisitor *)other)->count;
+  }
+
   // The counter
   uint64_t count;
 };
@@ -117,6 +127,16 @@ struct CountIfScanVisitor : public ScanVisitor {
     uqi_result_add_row(result, "COUNT", 6, &count, sizeof(count));
   }
 
+  // Partial counters can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial counter of |other|
+  virtual void merge(ScanVisitor *other) {
+    count += ((CountIfScanVisitor *)other)->count;
+  }
+
   // The counter
   uint64_t count;
 
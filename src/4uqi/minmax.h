@@ -17,10 +17,12 @@
 
 #include "0root/root.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "1base/error.h"
 #include "2config/db_config.h"
+#include "2simd/simd_aggregate.h"
 #include "4uqi/plugin_wrapper.h"
 #include "4uqi/statements.h"
 #include "4uqi/scanvisitor.h"
@@ -58,6 +60,26 @@ struct MinMaxScanVisitorBase : public NumericalScanVisitor {
     other.copy((const uint8_t *)data, size);
   }
 
+  // Merges the partial result of |o|; |Compare| decides whether its
+  // minimum/maximum replaces the current one
+  template<template<typename T> class Compare>
+  void merge_values(MinMaxScanVisitorBase *o) {
+    if (ISSET(statement->function.flags, UQI_STREAM_KEY)) {
+      Compare<typename Key::type> cmp;
+      if (cmp(o->key.value, key.value)) {
+        key = o->key;
+        copy_value(o->other.data(), o->other.size());
+      }
+    }
+    else {
+      Compare<typename Record::type> cmp;
+      if (cmp(o->record.value, record.value)) {
+        record = o->record;
+        copy_value(o->other.data(), o->other.size());
+      }
+    }
+  }
+
   // The current minimum/maximum key
   Key key;
 
@@ -104,33 +126,49 @@ struct MinMaxScanVisitor : public MinMaxScanVisitorBase<Key, Record> {
     }
   }
 
-  // Operates on an array of keys
+  // Operates on an array of keys. The minimum/maximum of the array is
+  // calculated first; the other stream is only accessed if it replaces
+  // the current one.
   virtual void operator()(const void *key_data, const void *record_data,
                   size_t length) {
+    if (length == 0)
+      return;
+
     Sequence<Key> keys(key_data, length);
     Sequence<Record> records(record_data, length);
-    typename Sequence<Key>::iterator kit = keys.begin();
-    typename Sequence<Record>::iterator rit = records.begin();
 
     if (ISSET(P::statement->function.flags, UQI_STREAM_KEY)) {
       Compare<typename Key::type> cmp;
-      for (; kit != keys.end(); kit++, rit++) {
-        if (cmp(kit->value, P::key.value)) {
-          P::key = kit->value;
-          P::copy_value(&rit->value, rit->size());
-        }
+      const typename Key::type *data = (const typename Key::type *)key_data;
+      typename Key::type value = simd_extreme(data, length, cmp);
+      if (cmp(value, P::key.value)) {
+        size_t i = std::find(data, data + length, value) - data;
+        P::key = value;
+        P::copy_value(&records.begin()[i].value, records.begin()[i].size());
       }
     }
     else {
       Compare<typename Record::type> cmp;
-      for (; kit != keys.end(); kit++, rit++) {
-        if (cmp(rit->value, P::record.value)) {
-          P::record = rit->value;
-          P::copy_value(&kit->value, kit->size());
-        }
+      const typename Record::type *data
+              = (const typename Record::type *)record_data;
+      typename Record::type value = simd_extreme(data, length, cmp);
+      if (cmp(value, P::record.value)) {
+        size_t i = std::find(data, data + length, value) - data;
+        P::record = value;
+        P::copy_value(&keys.begin()[i].value, keys.begin()[i].size());
       }
     }
   }
+
+  // Partial minimums/maximums can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Merges the minimum/maximum of |other|
+  virtual void merge(ScanVisitor *other) {
+    P::template merge_values<Compare>((P *)other);
+  }
 };
 
 template<typename Key, typename Record>
@@ -234,6 +272,16 @@ struct MinMaxIfScanVisitor : public MinMaxScanVisitorBase<Key, Record> {
     }
   }
 
+  // Partial minimums/maximums can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Merges the minimum/maximum of |other|
+  virtual void merge(ScanVisitor *other) {
+    P::template merge_values<Compare>((P *)other);
+  }
+
   PredicatePluginWrapper plugin;
 };
 
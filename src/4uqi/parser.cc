@@ -44,6 +44,7 @@ static qi::rule<const char *, std::string(), ascii::space_type> unquoted_string;
 static qi::rule<const char *, std::string(), ascii::space_type> plugin_name;
 static qi::rule<const char *, std::string(), ascii::space_type> where_clause;
 static qi::rule<const char *, int(), ascii::space_type> limit_clause;
+static qi::rule<const char *, int(), ascii::space_type> parallel_clause;
 static qi::rule<const char *, short(), ascii::space_type> from_clause;
 static qi::rule<const char *, short(), ascii::space_type> number;
 static qi::rule<const char *, int(), ascii::space_type> input_clause;
@@ -65,6 +66,7 @@ initialize_parsers()
   plugin_name %= unquoted_string | quoted_string;
   where_clause = no_case[lit("where")] >> plugin_name;
   limit_clause = no_case[lit("limit")] >> int_;
+  parallel_clause = no_case[lit("parallel")] >> int_;
   from_clause = no_case[lit("from")] >> no_case[lit("database")]
                     >> number;
   number = (no_case[lit("0x")] >> boost::spirit::hex)
@@ -114,6 +116,7 @@ Parser::parse_select(const char *query, SelectStatement &stmt)
       >> -(where_clause[boost::phoenix::ref(stmt.predicate.name) = _1]
         >> '(' >> input_clause [ref(stmt.predicate.flags) = _1] >> ')')
       >> -limit_clause [ref(stmt.limit) = _1]
+      >> -parallel_clause [ref(stmt.parallel) = _1]
       >> -char_(';')
       ;
 
@@ -166,6 +169,11 @@ Parser::parse_select(const char *query, SelectStatement &stmt)
     }
   }
 
+  if (stmt.parallel < 0) {
+    ups_trace(("'parallel' requires a positive number of threads"));
+    return (UPS_PARSER_ERROR);
+  }
+
   return (0);
 }
 
@@ -62,6 +62,19 @@ struct ScanVisitor {
   // Assigns the internal result to |result|
   virtual void assign_result(uqi_result_t *result) = 0;
 
+  // Returns true if this visitor implements |merge()|. Only then the
+  // scan can be split into partial scans which run in parallel.
+  virtual bool supports_merge() const {
+    return (false);
+  }
+
+  // Merges the partial result of |other| into this visitor. |other| was
+  // created for the same statement, and it visited keys which are
+  // greater than those visited by this visitor.
+  virtual void merge(ScanVisitor *other) {
+    assert(!"shouldn't be here");
+  }
+
   // The select statement
   SelectStatement *statement;
 };
@@ -52,14 +52,14 @@ struct FunctionDesc {
 struct SelectStatement {
   // constructor
   SelectStatement()
-    : dbid(0), distinct(false), limit(0), function_plg(0), predicate_plg(0),
-      requires_keys(true), requires_records(true) {
+    : dbid(0), distinct(false), limit(0), parallel(0), function_plg(0),
+      predicate_plg(0), requires_keys(true), requires_records(true) {
   }
 
   // constructor - required by the parser
   SelectStatement(const std::string &foo)
-    : dbid(0), distinct(false), limit(0), function_plg(0), predicate_plg(0),
-      requires_keys(true), requires_records(true) {
+    : dbid(0), distinct(false), limit(0), parallel(0), function_plg(0),
+      predicate_plg(0), requires_keys(true), requires_records(true) {
   }
 
   // the database id
@@ -71,6 +71,10 @@ struct SelectStatement {
   // the limit - if 0 then unlimited
   int limit;
 
+  // the number of threads scanning the database - if 0 then the
+  // Environment's default is used
+  int parallel;
+
   // the actual query function (an aggregation plugin)
   FunctionDesc function;
 
@@ -19,6 +19,7 @@
 
 #include "1base/error.h"
 #include "2config/db_config.h"
+#include "2simd/simd_aggregate.h"
 #include "4uqi/plugin_wrapper.h"
 #include "4uqi/type_wrapper.h"
 #include "4uqi/statements.h"
@@ -61,18 +62,10 @@ struct SumScanVisitor : public NumericalScanVisitor {
   // Operates on an array of keys
   virtual void operator()(const void *key_data, const void *record_data,
                   size_t length) {
-    if (ISSET(statement->function.flags, UQI_STREAM_KEY)) {
-      typename Key::type *it = (typename Key::type *)key_data;
-      typename Key::type *end = it + length;
-      for (; it != end; it++)
-        sum += *it;
-    }
-    else {
-      typename Record::type *it = (typename Record::type *)record_data;
-      typename Record::type *end = it + length;
-      for (; it != end; it++)
-        sum += *it;
-    }
+    if (ISSET(statement->function.flags, UQI_STREAM_KEY))
+      sum += simd_sum((const typename Key::type *)key_data, length);
+    else
+      sum += simd_sum((const typename Record::type *)record_data, length);
   }
 
   // Assigns the result to |result|
@@ -81,6 +74,16 @@ struct SumScanVisitor : public NumericalScanVisitor {
     uqi_result_add_row(result, "SUM", 4, &sum, sizeof(sum));
   }
 
+  // Partial sums can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial sum of |other|
+  virtual void merge(ScanVisitor *other) {
+    sum += ((SumScanVisitor *)other)->sum;
+  }
+
   // The aggregated sum
   ResultType sum;
 };
@@ -189,6 +192,16 @@ struct SumIfScanVisitor : public NumericalScanVisitor {
     uqi_result_add_row(result, "SUM", 4, &sum, sizeof(sum));
   }
 
+  // Partial sums can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Adds the partial sum of |other|
+  virtual void merge(ScanVisitor *other) {
+    sum += ((SumIfScanVisitor *)other)->sum;
+  }
+
   // The aggreated sum
   ResultType sum;
 
@@ -100,6 +100,31 @@ struct TopScanVisitorBase : public NumericalScanVisitor {
     }
   }
 
+  // Partial results can be merged
+  virtual bool supports_merge() const {
+    return (true);
+  }
+
+  // Merges the largest values of |other|
+  virtual void merge(ScanVisitor *other) {
+    TopScanVisitorBase *o = (TopScanVisitorBase *)other;
+
+    if (ISSET(statement->function.flags, UQI_STREAM_KEY)) {
+      for (typename KeyMap::iterator it = o->stored_keys.begin();
+                      it != o->stored_keys.end(); it++)
+        min_key = store_min_value(it->first, min_key,
+                        it->second.data(), it->second.size(),
+                        stored_keys, statement->limit);
+    }
+    else {
+      for (typename RecordMap::iterator it = o->stored_records.begin();
+                      it != o->stored_records.end(); it++)
+        min_record = store_min_value(it->first, min_record,
+                        it->second.data(), it->second.size(),
+                        stored_records, statement->limit);
+    }
+  }
+
   // The minimum value currently stored in |keys|
   Key min_key;
 
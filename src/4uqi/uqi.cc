@@ -137,7 +137,7 @@ uqi_select_range(ups_env_t *henv, const char *query, ups_cursor_t *begin,
   }
 
   Environment *env = (Environment *)henv;
-  ScopedLock lock(env->mutex());
+  ScopedExclusiveLock lock(env->mutex());
 
   return (env->select_range(query,
                         (upscaledb::Cursor *)begin,
@@ -16,10 +16,13 @@
  */
 
 #include <string.h>
+#include <vector>
 
 // winsock2.h is required for libuv
 #ifdef WIN32
 #  include <winsock2.h>
+#else
+#  include <unistd.h>
 #endif
 
 // include this BEFORE os.h!
@@ -41,6 +44,12 @@
 #  error "root.h was not included"
 #endif
 
+// Connections are handed over to the other event loops as (duplicated)
+// sockets; otherwise there is only a single event loop
+#if !defined(WIN32) && UV_VERSION_MAJOR >= 1
+#  define UPS_SRV_MULTIPLE_LOOPS 1
+#endif
+
 namespace upscaledb {
 
 static void
@@ -50,11 +59,14 @@ on_write_cb(uv_write_t *req, int status)
   delete req;
 };
 
+// Stores a serialized reply of the current request; the replies are
+// sent by the client's event loop (see flush_replies())
 static void
-on_write_cb2(uv_write_t *req, int status)
+send_reply(uv_stream_t *tcp, uint8_t *data, uint32_t size)
 {
-  delete req;
-};
+  ClientContext *client = (ClientContext *)tcp->data;
+  client->replies.push_back(Message(0, data, size));
+}
 
 static void
 send_wrapper(ServerContext *srv, uv_stream_t *tcp, Protocol *reply)
@@ -65,13 +77,7 @@ send_wrapper(ServerContext *srv, uv_stream_t *tcp, Protocol *reply)
   if (!reply->pack(&data, &data_size))
     return;
 
-  // |req| needs to exist till the request was finished asynchronously;
-  // therefore it must be allocated on the heap
-  uv_write_t *req = new uv_write_t();
-  uv_buf_t buf = uv_buf_init((char *)data, data_size);
-  req->data = data;
-  // |req| and |data| are freed in on_write_cb()
-  uv_write(req, (uv_stream_t *)tcp, &buf, 1, on_write_cb);
+  send_reply(tcp, data, data_size);
 }
 
 static void
@@ -81,27 +87,39 @@ send_wrapper(ServerContext *srv, uv_stream_t *tcp, SerializedWrapper *reply)
   int reply_size = size_left;
   reply->magic = UPS_TRANSFER_MAGIC_V2;
   reply->size = size_left;
-  srv->buffer.resize(size_left);
-  uint8_t *ptr = srv->buffer.data();
+
+  // the reply is sent asynchronously, therefore each reply needs its
+  // own buffer
+  uint8_t *data = Memory::allocate<uint8_t>(reply_size);
+  uint8_t *ptr = data;
 
   reply->serialize(&ptr, &size_left);
   assert(size_left == 0);
 
-  // |req| needs to exist till the request was finished asynchronously;
-  // therefore it must be allocated on the heap
-  uv_write_t *req = new uv_write_t();
-  uv_buf_t buf = uv_buf_init((char *)srv->buffer.data(), reply_size);
-  req->data = srv->buffer.data();
+  send_reply(tcp, data, reply_size);
+}
 
-  // |req| is freed in on_write_cb()
-  uv_write(req, (uv_stream_t *)tcp, &buf, 1, on_write_cb2);
+// Locks the arena of |db| till the reply was serialized; see
+// ServerContext::arena_mutex
+static void
+lock_arena(ServerContext *srv, Database *db, ScopedReadLock &lock)
+{
+  if (db)
+    lock.lock(srv->arena_mutex, db->supports_concurrent_reads());
 }
 
 static void
 handle_connect(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
 {
   assert(request != 0);
-  Environment *env = srv->open_envs[request->connect_request().path()];
+  Environment *env = 0;
+  {
+    ScopedLock lock(srv->open_envs_mutex);
+    EnvironmentMap::iterator it
+            = srv->open_envs.find(request->connect_request().path());
+    if (it != srv->open_envs.end())
+      env = it->second;
+  }
 
   if (ErrorInducer::is_active()) {
     if (ErrorInducer::induce(ErrorInducer::kServerConnect)) {
@@ -358,6 +376,7 @@ handle_env_open_db(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
   }
 
   /* check if the database is already open */
+  ScopedLock lock(srv->open_db_mutex);
   Handle<Database> handle = srv->get_db_by_name(dbname);
   db = (ups_db_t *)handle.object;
   db_handle = handle.index;
@@ -604,6 +623,7 @@ static void
 handle_db_insert(ServerContext *srv, uv_stream_t *tcp,
                 Protocol *request)
 {
+  ScopedReadLock arena_lock;
   ups_status_t st = 0;
   bool send_key = false;
   ups_key_t key = {0};
@@ -641,6 +661,7 @@ handle_db_insert(ServerContext *srv, uv_stream_t *tcp,
         rec.flags = request->db_insert_request().record().flags()
                     & (~UPS_RECORD_USER_ALLOC);
       }
+      lock_arena(srv, db, arena_lock);
       st = ups_db_insert((ups_db_t *)db, (ups_txn_t *)txn, &key, &rec,
                     request->db_insert_request().flags());
 
@@ -665,6 +686,7 @@ static void
 handle_db_insert(ServerContext *srv, uv_stream_t *tcp,
                 SerializedWrapper *request)
 {
+  ScopedReadLock arena_lock;
   ups_status_t st = 0;
   bool send_key = false;
   ups_key_t key = {0};
@@ -699,6 +721,7 @@ handle_db_insert(ServerContext *srv, uv_stream_t *tcp,
         rec.flags = request->db_insert_request.record.flags
                         & (~UPS_RECORD_USER_ALLOC);
       }
+      lock_arena(srv, db, arena_lock);
       st = ups_db_insert((ups_db_t *)db, (ups_txn_t *)txn, &key, &rec,
                     request->db_insert_request.flags);
 
@@ -730,6 +753,7 @@ static void
 handle_db_find(ServerContext *srv, uv_stream_t *tcp,
                 Protocol *request)
 {
+  ScopedReadLock arena_lock;
   ups_status_t st = 0;
   ups_key_t key = {0};
   ups_record_t rec = {0};
@@ -773,6 +797,7 @@ handle_db_find(ServerContext *srv, uv_stream_t *tcp,
                   & (~UPS_RECORD_USER_ALLOC);
     }
 
+    lock_arena(srv, cursor ? cursor->db() : db, arena_lock);
     if (cursor)
       st = ups_cursor_find((ups_cursor_t *)cursor, &key,
                       request->db_find_request().has_record()
@@ -803,6 +828,7 @@ static void
 handle_db_find(ServerContext *srv, uv_stream_t *tcp,
                 SerializedWrapper *request)
 {
+  ScopedReadLock arena_lock;
   ups_status_t st = 0;
   ups_key_t key = {0};
   ups_record_t rec = {0};
@@ -843,6 +869,7 @@ handle_db_find(ServerContext *srv, uv_stream_t *tcp,
                     & (~UPS_RECORD_USER_ALLOC);
     }
 
+    lock_arena(srv, cursor ? cursor->db() : db, arena_lock);
     if (cursor)
       st = ups_cursor_find((ups_cursor_t *)cursor, &key,
                     request->db_find_request.has_record
@@ -879,6 +906,167 @@ handle_db_find(ServerContext *srv, uv_stream_t *tcp,
   send_wrapper(srv, tcp, &reply);
 }
 
+static void
+handle_db_find_many(ServerContext *srv, uv_stream_t *tcp,
+                SerializedWrapper *request)
+{
+  ScopedReadLock arena_lock;
+  ups_status_t st = 0;
+  uint32_t count = request->db_find_many_request.count;
+  std::vector<ups_key_t> keys(count);
+  std::vector<ups_record_t> records(count);
+  std::vector<int32_t> results(count);
+  ByteArray buffer;
+
+  Transaction *txn = 0;
+  Database *db = 0;
+
+  if (request->db_find_many_request.txn_handle) {
+    txn = srv->get_txn(request->db_find_many_request.txn_handle);
+    if (!txn)
+      st = UPS_INV_PARAMETER;
+  }
+
+  if (st == 0) {
+    db = srv->get_db(request->db_find_many_request.db_handle);
+    if (!db)
+      st = UPS_INV_PARAMETER;
+  }
+
+  if (st == 0) {
+    uint8_t *ptr = request->db_find_many_request.keys.value;
+    uint8_t *end = ptr + request->db_find_many_request.keys.size;
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t size;
+      ptr = SerializedBatch::next(ptr, end, &keys[i].data, &size);
+      if (!ptr) {
+        st = UPS_INV_PARAMETER;
+        break;
+      }
+      keys[i].size = (uint16_t)size;
+    }
+  }
+
+  if (st == 0 && count > 0) {
+    lock_arena(srv, db, arena_lock);
+    st = ups_db_find_many((ups_db_t *)db, (ups_txn_t *)txn, count, &keys[0],
+                    &records[0], &results[0],
+                    request->db_find_many_request.flags);
+  }
+
+  /* pack the records; keys which were not found get an empty record */
+  if (st == 0) {
+    size_t size = 0;
+    for (uint32_t i = 0; i < count; i++)
+      size += SerializedBatch::get_size(results[i] ? 0 : records[i].size);
+    buffer.resize(size);
+    uint8_t *ptr = buffer.data();
+    for (uint32_t i = 0; i < count; i++) {
+      if (results[i])
+        ptr = SerializedBatch::append(ptr, 0, 0);
+      else
+        ptr = SerializedBatch::append(ptr, records[i].data, records[i].size);
+    }
+  }
+
+  SerializedWrapper reply;
+  reply.id = kDbFindManyReply;
+  reply.db_find_many_reply.status = st;
+  if (st == 0) {
+    reply.db_find_many_reply.results.value = (uint8_t *)&results[0];
+    reply.db_find_many_reply.results.size = count * sizeof(int32_t);
+    reply.db_find_many_reply.records.value = buffer.data();
+    reply.db_find_many_reply.records.size = (uint32_t)buffer.size();
+  }
+
+  send_wrapper(srv, tcp, &reply);
+}
+
+static void
+handle_db_insert_many(ServerContext *srv, uv_stream_t *tcp,
+                SerializedWrapper *request)
+{
+  ScopedReadLock arena_lock;
+  ups_status_t st = 0;
+  bool send_keys = false;
+  uint32_t count = request->db_insert_many_request.count;
+  std::vector<ups_key_t> keys(count);
+  std::vector<ups_record_t> records(count);
+  std::vector<int32_t> results(count, UPS_INTERNAL_ERROR);
+  ByteArray buffer;
+
+  Transaction *txn = 0;
+  Database *db = 0;
+
+  if (request->db_insert_many_request.txn_handle) {
+    txn = srv->get_txn(request->db_insert_many_request.txn_handle);
+    if (!txn)
+      st = UPS_INV_PARAMETER;
+  }
+
+  if (st == 0) {
+    db = srv->get_db(request->db_insert_many_request.db_handle);
+    if (!db)
+      st = UPS_INV_PARAMETER;
+  }
+
+  if (st == 0) {
+    uint8_t *kptr = request->db_insert_many_request.keys.value;
+    uint8_t *kend = kptr + request->db_insert_many_request.keys.size;
+    uint8_t *rptr = request->db_insert_many_request.records.value;
+    uint8_t *rend = rptr + request->db_insert_many_request.records.size;
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t size;
+      kptr = SerializedBatch::next(kptr, kend, &keys[i].data, &size);
+      keys[i].size = (uint16_t)size;
+      rptr = SerializedBatch::next(rptr, rend, &records[i].data, &size);
+      records[i].size = size;
+      if (!kptr || !rptr) {
+        st = UPS_INV_PARAMETER;
+        break;
+      }
+    }
+  }
+
+  if (st == 0 && count > 0) {
+    lock_arena(srv, db, arena_lock);
+    st = ups_db_insert_many((ups_db_t *)db, (ups_txn_t *)txn, count,
+                    &keys[0], &records[0], &results[0],
+                    request->db_insert_many_request.flags);
+
+    /* recno: return the generated keys */
+    if (db->get_flags() & (UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64)) {
+      size_t size = 0;
+      for (uint32_t i = 0; i < count; i++)
+        size += SerializedBatch::get_size(results[i] ? 0 : keys[i].size);
+      buffer.resize(size);
+      uint8_t *ptr = buffer.data();
+      for (uint32_t i = 0; i < count; i++) {
+        if (results[i])
+          ptr = SerializedBatch::append(ptr, 0, 0);
+        else
+          ptr = SerializedBatch::append(ptr, keys[i].data, keys[i].size);
+      }
+      send_keys = true;
+    }
+  }
+
+  SerializedWrapper reply;
+  reply.id = kDbInsertManyReply;
+  reply.db_insert_many_reply.status = st;
+  if (count > 0) {
+    reply.db_insert_many_reply.results.value = (uint8_t *)&results[0];
+    reply.db_insert_many_reply.results.size = count * sizeof(int32_t);
+  }
+  if (send_keys) {
+    reply.db_insert_many_reply.has_keys = true;
+    reply.db_insert_many_reply.keys.value = buffer.data();
+    reply.db_insert_many_reply.keys.size = (uint32_t)buffer.size();
+  }
+
+  send_wrapper(srv, tcp, &reply);
+}
+
 static void
 handle_db_erase(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
 {
@@ -1258,6 +1446,7 @@ handle_cursor_clone(ServerContext *srv, uv_stream_t *tcp,
 static void
 handle_cursor_insert(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
 {
+  ScopedReadLock arena_lock;
   ups_key_t key = {0};
   ups_record_t rec = {0};
   ups_status_t st = 0;
@@ -1290,6 +1479,7 @@ handle_cursor_insert(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
 
   send_key = request->cursor_insert_request().send_key();
 
+  lock_arena(srv, cursor->db(), arena_lock);
   st = ups_cursor_insert((ups_cursor_t *)cursor, &key, &rec,
             request->cursor_insert_request().flags());
 
@@ -1306,6 +1496,7 @@ static void
 handle_cursor_insert(ServerContext *srv, uv_stream_t *tcp,
                 SerializedWrapper *request)
 {
+  ScopedReadLock arena_lock;
   ups_key_t key = {0};
   ups_record_t rec = {0};
   ups_status_t st = 0;
@@ -1333,6 +1524,7 @@ handle_cursor_insert(ServerContext *srv, uv_stream_t *tcp,
                 & (~UPS_RECORD_USER_ALLOC);
   }
 
+  lock_arena(srv, cursor->db(), arena_lock);
   st = ups_cursor_insert((ups_cursor_t *)cursor, &key, &rec,
             request->cursor_insert_request.flags);
 
@@ -1592,6 +1784,7 @@ bail:
 static void
 handle_cursor_move(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
 {
+  ScopedReadLock arena_lock;
   ups_key_t key = {0};
   ups_record_t rec = {0};
   ups_status_t st = 0;
@@ -1625,6 +1818,7 @@ handle_cursor_move(ServerContext *srv, uv_stream_t *tcp, Protocol *request)
                 & (~UPS_RECORD_USER_ALLOC);
   }
 
+  lock_arena(srv, cursor->db(), arena_lock);
   st = ups_cursor_move((ups_cursor_t *)cursor,
                         send_key ? &key : 0,
                         send_rec ? &rec : 0,
@@ -1764,6 +1958,12 @@ dispatch(ServerContext *srv, uv_stream_t *tcp, uint32_t magic,
       case kDbFindRequest:
         handle_db_find(srv, tcp, &request);
         break;
+      case kDbFindManyRequest:
+        handle_db_find_many(srv, tcp, &request);
+        break;
+      case kDbInsertManyRequest:
+        handle_db_insert_many(srv, tcp, &request);
+        break;
       case kDbGetKeyCountRequest:
         handle_db_count(srv, tcp, &request);
         break;
@@ -1918,13 +2118,137 @@ dispatch(ServerContext *srv, uv_stream_t *tcp, uint32_t magic,
   return (true);
 }
 
+// Releases a client after its socket was closed and no worker thread
+// executes one of its requests
 static void
-on_close_connection(uv_handle_t *handle)
+free_client(ClientContext *client)
+{
+  for (MessageQueue::iterator it = client->requests.begin();
+          it != client->requests.end(); it++)
+    Memory::release(it->data);
+  for (MessageQueue::iterator it = client->replies.begin();
+          it != client->replies.end(); it++)
+    Memory::release(it->data);
+  Memory::release(client->tcp);
+  delete client;
+}
+
+static void
+on_close_handle(uv_handle_t *handle)
 {
-  delete (ClientContext *)handle->data;
   Memory::release(handle);
 }
 
+static void
+on_close_connection(uv_handle_t *handle)
+{
+  ClientContext *client = (ClientContext *)handle->data;
+  client->is_closed = true;
+  // if a worker still executes a request of this client then the client
+  // is released when the request is finished
+  if (!client->is_busy)
+    free_client(client);
+}
+
+static void
+close_client(ClientContext *client)
+{
+  if (!client->is_closing) {
+    client->is_closing = true;
+    uv_close((uv_handle_t *)client->tcp, on_close_connection);
+  }
+}
+
+// Sends the replies of the current request; called by the client's
+// event loop
+static void
+flush_replies(ClientContext *client)
+{
+  for (MessageQueue::iterator it = client->replies.begin();
+          it != client->replies.end(); it++) {
+    if (client->is_closing) {
+      Memory::release(it->data);
+      continue;
+    }
+
+    // |req| needs to exist till the request was finished asynchronously;
+    // therefore it must be allocated on the heap
+    uv_write_t *req = new uv_write_t();
+    uv_buf_t buf = uv_buf_init((char *)it->data, it->size);
+    req->data = it->data;
+    // |req| and |data| are freed in on_write_cb()
+    uv_write(req, (uv_stream_t *)client->tcp, &buf, 1, on_write_cb);
+  }
+  client->replies.clear();
+}
+
+// A request which is executed by the worker pool
+struct RequestJob {
+  RequestJob(ClientContext *_client, const Message &_request)
+    : client(_client), request(_request) {
+  }
+
+  void operator()() {
+    if (!dispatch(client->srv, (uv_stream_t *)client->tcp, request.magic,
+                request.data, request.size))
+      client->failed = true;
+    Memory::release(request.data);
+
+    // hand the client back to its event loop, which sends the replies
+    // and starts the next request
+    EventLoop *loop = client->loop;
+    {
+      ScopedLock lock(loop->mutex);
+      loop->finished.push_back(client);
+    }
+    uv_async_send(&loop->async);
+  }
+
+  ClientContext *client;
+  Message request;
+};
+
+// Passes the next queued request of |client| to the worker pool. Only one
+// request per client is executed at a time, therefore the requests are
+// processed in the order in which they were received.
+static void
+start_next_request(ClientContext *client)
+{
+  assert(!client->is_busy);
+  if (client->requests.empty() || client->is_closing)
+    return;
+
+  RequestJob job(client, client->requests.front());
+  client->requests.pop_front();
+  client->is_busy = true;
+  client->srv->workers->post(job);
+}
+
+// Processes a request; without a worker pool the request is executed
+// immediately, otherwise it is queued. Returns false if the client
+// should be closed.
+static bool
+process_request(ClientContext *client, uint32_t magic, uint8_t *data,
+                uint32_t size)
+{
+  if (!client->srv->workers) {
+    bool ok = dispatch(client->srv, (uv_stream_t *)client->tcp, magic,
+                    data, size);
+    flush_replies(client);
+    return (ok);
+  }
+
+  // |data| belongs to the network buffer and is released when this
+  // function returns; the worker needs its own copy
+  uint8_t *copy = Memory::allocate<uint8_t>(size);
+  ::memcpy(copy, data, size);
+  client->requests.push_back(Message(magic, copy, size));
+
+  if (!client->is_busy)
+    start_next_request(client);
+  return (true);
+}
+
 #if UV_VERSION_MINOR >= 11
 static void
 on_alloc_buffer(uv_handle_t *handle, size_t size, uv_buf_t *buf)
@@ -1978,7 +2302,9 @@ on_read_data(uv_stream_t *tcp, ssize_t nread, uv_buf_t buf_struct)
         if (buffer->size() < size)
           goto bail;
         // otherwise dispatch the message
-        close_client = !dispatch(context->srv, tcp, magic, p, size);
+        close_client = !process_request(context, magic, p, size);
+        if (close_client)
+          goto bail;
         // and move the remaining data to "the left"
         if (buffer->size() == size) {
           buffer->clear();
@@ -2003,7 +2329,7 @@ on_read_data(uv_stream_t *tcp, ssize_t nread, uv_buf_t buf_struct)
       if (magic == UPS_TRANSFER_MAGIC_V1)
         size += 8;
       if (size <= (uint32_t)nread) {
-        close_client = !dispatch(context->srv, tcp, magic, p, size);
+        close_client = !process_request(context, magic, p, size);
         if (close_client)
           goto bail;
         nread -= size;
@@ -2021,11 +2347,33 @@ on_read_data(uv_stream_t *tcp, ssize_t nread, uv_buf_t buf_struct)
 
 bail:
   if (close_client || nread < 0)
-    uv_close((uv_handle_t *)tcp, on_close_connection);
+    upscaledb::close_client(context);
   Memory::release(buf->base);
   //buf->base = 0;
 }
 
+// Starts reading from a new connection of |loop|
+static void
+start_connection(EventLoop *loop, uv_tcp_t *tcp)
+{
+  tcp->data = new ClientContext(loop->srv, loop, tcp);
+  uv_read_start((uv_stream_t *)tcp, on_alloc_buffer, on_read_data);
+}
+
+// Opens a socket which was handed over by the first event loop
+static void
+open_connection(EventLoop *loop, int fd)
+{
+  uv_tcp_t *tcp = Memory::allocate<uv_tcp_t>(sizeof(uv_tcp_t));
+  uv_tcp_init(loop->loop, tcp);
+  if (uv_tcp_open(tcp, fd) != 0) {
+    ::close(fd);
+    uv_close((uv_handle_t *)tcp, on_close_handle);
+    return;
+  }
+  start_connection(loop, tcp);
+}
+
 static void
 on_new_connection(uv_stream_t *server, int status)
 {
@@ -2033,19 +2381,39 @@ on_new_connection(uv_stream_t *server, int status)
     return;
 
   ServerContext *srv = (ServerContext *)server->data;
+  EventLoop *first = srv->loops[0];
 
   uv_tcp_t *client = Memory::allocate<uv_tcp_t>(sizeof(uv_tcp_t));
-  client->data = new ClientContext(srv);
+  uv_tcp_init(first->loop, client);
+  if (uv_accept(server, (uv_stream_t *)client) != 0) {
+    uv_close((uv_handle_t *)client, on_close_handle);
+    return;
+  }
 
-#if UV_VERSION_MINOR >= 11
-  uv_tcp_init(&srv->loop, client);
-#else
-  uv_tcp_init(srv->loop, client);
+  // distribute the connections round-robin
+  EventLoop *loop = srv->loops[srv->next_loop++ % srv->loops.size()];
+  if (loop == first) {
+    start_connection(loop, client);
+    return;
+  }
+
+#ifdef UPS_SRV_MULTIPLE_LOOPS
+  // a libuv handle cannot move to another loop; hand over a duplicate
+  // of the socket and close the original handle
+  uv_os_fd_t fd;
+  int newfd = -1;
+  if (uv_fileno((uv_handle_t *)client, &fd) == 0)
+    newfd = ::dup(fd);
+  uv_close((uv_handle_t *)client, on_close_handle);
+  if (newfd < 0)
+    return;
+
+  {
+    ScopedLock lock(loop->mutex);
+    loop->new_sockets.push_back(newfd);
+  }
+  uv_async_send(&loop->async);
 #endif
-  if (uv_accept(server, (uv_stream_t *)client) == 0)
-    uv_read_start((uv_stream_t *)client, on_alloc_buffer, on_read_data);
-  else
-    uv_close((uv_handle_t *)client, on_close_connection);
 }
 
 static void
@@ -2061,15 +2429,66 @@ on_async_cb(uv_async_t *handle, int status)
 on_async_cb(uv_async_t *handle)
 #endif
 {
-  ServerContext *srv = (ServerContext *)handle->data;
+  EventLoop *loop = (EventLoop *)handle->data;
+  std::vector<int> new_sockets;
+  std::vector<ClientContext *> finished;
+  bool shutdown;
 
-  // simply copy the Environments in the queue to the map of opened
-  // Environments
-  ScopedLock lock(srv->open_queue_mutex);
-  for (EnvironmentMap::iterator it = srv->open_queue.begin();
-          it != srv->open_queue.end(); it++) {
-    srv->open_envs[it->first] = it->second;
+  {
+    ScopedLock lock(loop->mutex);
+    new_sockets.swap(loop->new_sockets);
+    finished.swap(loop->finished);
+    shutdown = loop->shutdown;
+  }
+
+  for (std::vector<int>::iterator it = new_sockets.begin();
+          it != new_sockets.end(); it++)
+    open_connection(loop, *it);
+
+  for (std::vector<ClientContext *>::iterator it = finished.begin();
+          it != finished.end(); it++) {
+    ClientContext *client = *it;
+    client->is_busy = false;
+    if (client->is_closed) {
+      free_client(client);
+      continue;
+    }
+
+    flush_replies(client);
+    if (client->failed)
+      close_client(client);
+    else
+      start_next_request(client);
   }
+
+  if (shutdown)
+    uv_stop(loop->loop);
+}
+
+static void
+init_loop(EventLoop *loop)
+{
+#if UV_VERSION_MINOR >= 11
+  loop->loop = Memory::allocate<uv_loop_t>(sizeof(uv_loop_t));
+  uv_loop_init(loop->loop);
+#else
+  loop->loop = uv_loop_new();
+#endif
+  loop->async.data = loop;
+  uv_async_init(loop->loop, &loop->async, on_async_cb);
+}
+
+static void
+close_loop(EventLoop *loop)
+{
+  uv_close((uv_handle_t *)&loop->async, 0);
+
+#if UV_VERSION_MINOR >= 11
+  uv_loop_close(loop->loop);
+  Memory::release(loop->loop);
+#else
+  uv_loop_delete(loop->loop);
+#endif
 }
 
 } // namespace upscaledb
@@ -2082,14 +2501,23 @@ ups_srv_init(ups_srv_config_t *config, ups_srv_t **psrv)
   ServerContext *srv = new ServerContext();
   struct sockaddr_in bind_addr;
 
+  size_t io_threads = config->io_threads > 0 ? config->io_threads : 1;
+#ifndef UPS_SRV_MULTIPLE_LOOPS
+  io_threads = 1;
+#endif
+
+  for (size_t i = 0; i < io_threads; i++) {
+    EventLoop *loop = new EventLoop(srv);
+    init_loop(loop);
+    srv->loops.push_back(loop);
+  }
+
+  uv_loop_t *first = srv->loops[0]->loop;
+  uv_tcp_init(first, &srv->server);
 #if UV_VERSION_MINOR >= 11
-  uv_loop_init(&srv->loop);
-  uv_tcp_init(&srv->loop, &srv->server);
   uv_ip4_addr("0.0.0.0", config->port, &bind_addr);
   uv_tcp_bind(&srv->server, (sockaddr *)&bind_addr, 0);
 #else
-  srv->loop = uv_loop_new();
-  uv_tcp_init(srv->loop, &srv->server);
   bind_addr = uv_ip4_addr("0.0.0.0", config->port);
   uv_tcp_bind(&srv->server, bind_addr);
 #endif
@@ -2102,14 +2530,12 @@ ups_srv_init(ups_srv_config_t *config, ups_srv_t **psrv)
     return (UPS_IO_ERROR);
   }
 
-  srv->async.data = srv;
-#if UV_VERSION_MINOR >= 11
-  uv_async_init(&srv->loop, &srv->async, on_async_cb);
-  uv_thread_create(&srv->thread_id, on_run_thread, &srv->loop);
-#else
-  uv_async_init(srv->loop, &srv->async, on_async_cb);
-  uv_thread_create(&srv->thread_id, on_run_thread, srv->loop);
-#endif
+  if (config->worker_threads > 0)
+    srv->workers.reset(new WorkerPool(config->worker_threads));
+
+  for (size_t i = 0; i < srv->loops.size(); i++)
+    uv_thread_create(&srv->loops[i]->thread_id, on_run_thread,
+                    srv->loops[i]->loop);
 
   *psrv = (ups_srv_t *)srv;
   return (UPS_SUCCESS);
@@ -2124,12 +2550,8 @@ ups_srv_add_env(ups_srv_t *hsrv, ups_env_t *env, const char *urlname)
     return (UPS_INV_PARAMETER);
   }
 
-  {
-    ScopedLock lock(srv->open_queue_mutex);
-    srv->open_queue[urlname] = (Environment *)env;
-  }
-
-  uv_async_send(&srv->async);
+  ScopedLock lock(srv->open_envs_mutex);
+  srv->open_envs[urlname] = (Environment *)env;
   return (UPS_SUCCESS);
 }
 
@@ -2140,36 +2562,34 @@ ups_srv_close(ups_srv_t *hsrv)
   if (!srv)
     return;
 
-  uv_unref((uv_handle_t *)&srv->server);
-  uv_unref((uv_handle_t *)&srv->async);
-
   // TODO clean up all allocated objects and handles
 
-  /* stop the event loop */
-#if UV_VERSION_MINOR >= 11
-  uv_stop(&srv->loop);
-#else
-  uv_stop(srv->loop);
-#endif
-  uv_async_send(&srv->async);
+  /* stop the workers; they might still wake up the event loops */
+  srv->workers.reset();
 
-  /* join the libuv thread */
-  (void)uv_thread_join(&srv->thread_id);
+  /* stop the event loops and join their threads */
+  for (size_t i = 0; i < srv->loops.size(); i++) {
+    EventLoop *loop = srv->loops[i];
+    {
+      ScopedLock lock(loop->mutex);
+      loop->shutdown = true;
+    }
+    uv_stop(loop->loop);
+    uv_async_send(&loop->async);
+    (void)uv_thread_join(&loop->thread_id);
+  }
 
-  /* close the async handle and the server socket */
-  uv_close((uv_handle_t *)&srv->async, 0);
+  /* close the server socket */
   uv_close((uv_handle_t *)&srv->server, 0);
 
   /* clean up libuv */
-#if UV_VERSION_MINOR >= 11
-  uv_loop_close(&srv->loop);
-#else
-  uv_loop_delete(srv->loop);
-#endif
+  for (size_t i = 0; i < srv->loops.size(); i++) {
+    close_loop(srv->loops[i]);
+    delete srv->loops[i];
+  }
 
   delete srv;
 
   /* free libprotocol static data */
   Protocol::shutdown();
 }
-
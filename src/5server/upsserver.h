@@ -26,6 +26,7 @@
 #include "0root/root.h"
 
 #include <vector>
+#include <deque>
 
 #include <uv.h>
 
@@ -34,6 +35,8 @@
 #include "ups/upscaledb_srv.h"
 
 #include "1base/mutex.h"
+#include "1base/scoped_ptr.h"
+#include "2worker/worker.h"
 #include "4db/db.h"
 #include "4cursor/cursor.h"
 
@@ -63,18 +66,62 @@ typedef std::vector< Handle<Cursor> > CursorVector;
 typedef std::vector< Handle<Transaction> > TransactionVector;
 typedef std::map<std::string, Environment *> EnvironmentMap;
 
+class ServerContext;
+struct ClientContext;
+
+// A serialized request or reply; |data| is allocated with Memory::allocate
+struct Message {
+  Message(uint32_t _magic = 0, uint8_t *_data = 0, uint32_t _size = 0)
+    : magic(_magic), data(_data), size(_size) {
+  }
+
+  uint32_t magic;
+  uint8_t *data;
+  uint32_t size;
+};
+
+typedef std::deque<Message> MessageQueue;
+
+// An event loop with its own thread. Each loop performs the network I/O
+// of the connections which were assigned to it.
+struct EventLoop {
+  EventLoop(ServerContext *_srv)
+    : srv(_srv), loop(0), thread_id(0), shutdown(false) {
+    memset(&async, 0, sizeof(async));
+  }
+
+  ServerContext *srv;
+  uv_loop_t *loop;
+  uv_thread_t thread_id;
+
+  // wakes up the loop if one of the queues below was modified
+  uv_async_t async;
+
+  // protects the members below
+  Mutex mutex;
+
+  // sockets of accepted connections which were handed over to this loop
+  std::vector<int> new_sockets;
+
+  // clients whose current request was executed by a worker thread
+  std::vector<ClientContext *> finished;
+
+  // true if the loop should terminate
+  bool shutdown;
+};
+
 class ServerContext {
   public:
     ServerContext()
-      : thread_id(0), m_handle_counter(1) {
+      : next_loop(0), m_handle_counter(1) {
       memset(&server, 0, sizeof(server));
-      memset(&async, 0, sizeof(async));
     }
 
     // allocates a new handle
     // TODO the allocate_handle methods have lots of duplicate code;
     // try to find a generic solution!
     uint64_t allocate_handle(Environment *env) {
+      ScopedLock lock(m_mutex);
       uint64_t c = 0;
       for (EnvironmentVector::iterator it = m_environments.begin();
               it != m_environments.end(); it++, c++) {
@@ -94,6 +141,7 @@ class ServerContext {
     }
 
     uint64_t allocate_handle(Database *db) {
+      ScopedLock lock(m_mutex);
       uint64_t c = 0;
       for (DatabaseVector::iterator it = m_databases.begin();
               it != m_databases.end(); it++, c++) {
@@ -113,6 +161,7 @@ class ServerContext {
     }
 
     uint64_t allocate_handle(Transaction *txn) {
+      ScopedLock lock(m_mutex);
       uint64_t c = 0;
       for (TransactionVector::iterator it = m_transactions.begin();
               it != m_transactions.end(); it++, c++) {
@@ -132,6 +181,7 @@ class ServerContext {
     }
 
     uint64_t allocate_handle(Cursor *cursor) {
+      ScopedLock lock(m_mutex);
       uint64_t c = 0;
       for (CursorVector::iterator it = m_cursors.begin();
               it != m_cursors.end(); it++, c++) {
@@ -151,6 +201,7 @@ class ServerContext {
     }
 
     void remove_env_handle(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       //assert(index < m_environments.size());
       if (index >= m_environments.size())
@@ -164,6 +215,7 @@ class ServerContext {
     }
 
     void remove_db_handle(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_databases.size());
       if (index >= m_databases.size())
@@ -177,6 +229,7 @@ class ServerContext {
     }
 
     void remove_txn_handle(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_transactions.size());
       if (index >= m_transactions.size())
@@ -190,6 +243,7 @@ class ServerContext {
     }
 
     void remove_cursor_handle(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_cursors.size());
       if (index >= m_cursors.size())
@@ -203,6 +257,7 @@ class ServerContext {
     }
 
     Environment *get_env(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_environments.size());
       if (index >= m_environments.size())
@@ -215,6 +270,7 @@ class ServerContext {
     }
 
     Database *get_db(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_databases.size());
       if (index >= m_databases.size())
@@ -227,6 +283,7 @@ class ServerContext {
     }
 
     Transaction *get_txn(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_transactions.size());
       if (index >= m_transactions.size())
@@ -239,6 +296,7 @@ class ServerContext {
     }
 
     Cursor *get_cursor(uint64_t handle) {
+      ScopedLock lock(m_mutex);
       uint32_t index = handle & 0xffffffff;
       assert(index < m_cursors.size());
       if (index >= m_cursors.size())
@@ -251,6 +309,7 @@ class ServerContext {
     }
 
     Handle<Database> get_db_by_name(uint16_t dbname) {
+      ScopedLock lock(m_mutex);
       for (size_t i = 0; i < m_databases.size(); i++) {
         Database *db = m_databases[i].object;
         if (db && db->name() == dbname)
@@ -259,19 +318,29 @@ class ServerContext {
       return (Handle<Database>(0, 0));
     }
 
+    // the listening socket; owned by the first event loop
     uv_tcp_t server;
-    uv_thread_t thread_id;
-    uv_async_t async;
-#if UV_VERSION_MINOR >= 11
-	uv_loop_t loop;
-#else
-	uv_loop_t *loop;
-#endif
-    EnvironmentMap open_envs;
 
-    Mutex open_queue_mutex;
-    EnvironmentMap open_queue;
-    ByteArray buffer;
+    // the event loops; connections are assigned round-robin
+    std::vector<EventLoop *> loops;
+    size_t next_loop;
+
+    // executes the requests; if null then the requests are executed
+    // by the event loops
+    ScopedPtr<WorkerPool> workers;
+
+    // Keys and records which are returned without a Transaction are
+    // stored in the arena of the Database, which is shared by all threads
+    // unless the Database supports concurrent reads. Handlers returning
+    // such data hold this lock till their reply was serialized.
+    SharedMutex arena_mutex;
+
+    // serializes ups_env_open_db, which fails if a Database is opened twice
+    Mutex open_db_mutex;
+
+    // the Environments served by this server
+    Mutex open_envs_mutex;
+    EnvironmentMap open_envs;
 
   private:
     EnvironmentVector m_environments;
@@ -279,16 +348,42 @@ class ServerContext {
     CursorVector m_cursors;
     TransactionVector m_transactions;
     uint64_t m_handle_counter;
+
+    // protects the handles; the requests are executed by multiple threads
+    Mutex m_mutex;
 };
 
 struct ClientContext {
-  ClientContext(ServerContext *_srv)
-    : buffer(0), srv(_srv) {
+  ClientContext(ServerContext *_srv, EventLoop *_loop, uv_tcp_t *_tcp)
+    : buffer(0), srv(_srv), loop(_loop), tcp(_tcp), is_busy(false),
+      is_closing(false), is_closed(false), failed(false) {
     assert(srv != 0);
   }
 
+  // buffers incomplete requests
   ByteArray buffer;
   ServerContext *srv;
+
+  // the event loop which owns this connection
+  EventLoop *loop;
+  uv_tcp_t *tcp;
+
+  // requests which wait for the current request; they are executed in
+  // the order in which they were received
+  MessageQueue requests;
+
+  // replies of the current request; sent by the event loop
+  MessageQueue replies;
+
+  // true if a worker thread executes a request of this client
+  bool is_busy;
+
+  // true if the socket is closing, or was closed
+  bool is_closing;
+  bool is_closed;
+
+  // true if a request could not be unpacked; the connection is closed
+  bool failed;
 };
 
 } // namespace upscaledb
@@ -27,6 +27,7 @@
 #include "1base/dynamic_array.h"
 #include "1globals/callbacks.h"
 #include "1mem/mem.h"
+#include "1os/io_uring.h"
 #include "2config/db_config.h"
 #include "2config/env_config.h"
 #include "2page/page.h"
@@ -36,6 +37,7 @@
 #include "2compressor/compressor_factory.h"
 #include "2device/device.h"
 #include "3btree/btree_stats.h"
+#include "3cache/cache_policy_factory.h"
 #include "3blob_manager/blob_manager.h"
 #include "3btree/btree_index.h"
 #include "3btree/btree_cursor.h"
@@ -364,6 +366,74 @@ ups_env_create(ups_env_t **henv, const char *filename,
       case UPS_PARAM_POSIX_FADVISE:
         config.posix_advice = (int)param->value;
         break;
+      case UPS_PARAM_CACHE_POLICY:
+        if (!CachePolicyFactory::is_available(param->value)) {
+          ups_trace(("unknown cache policy"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.cache_policy = (int)param->value;
+        break;
+      case UPS_PARAM_IO_QUEUE_DEPTH:
+        if (param->value > IoUring::kMaxQueueDepth) {
+          ups_trace(("invalid io queue depth"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.io_queue_depth = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY:
+        config.group_commit_delay_usec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE:
+        config.group_commit_size = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_QUERY_THREADS:
+        config.query_threads = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_CACHE_WARMUP:
+        config.cache_warmup = param->value != 0;
+        break;
+      case UPS_PARAM_CACHE_WARMUP_INTERVAL:
+        config.cache_warmup_interval_sec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_SIZE:
+        if (ISSET(flags, UPS_IN_MEMORY) && param->value != 0) {
+          ups_trace(("combination of UPS_IN_MEMORY and compressed cache "
+                "size != 0 not allowed"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.compressed_cache_size_bytes = param->value;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR:
+        if (param->value != UPS_COMPRESSOR_LZF
+              && param->value != UPS_COMPRESSOR_SNAPPY
+              && param->value != UPS_COMPRESSOR_ZLIB) {
+          ups_trace(("unsupported algorithm for the compressed cache"));
+          return (UPS_INV_PARAMETER);
+        }
+        if (!CompressorFactory::is_available(param->value)) {
+          ups_trace(("unknown algorithm for the compressed cache"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.compressed_cache_compressor = (int)param->value;
+        break;
+      case UPS_PARAM_FLUSH_THREADS:
+        config.flush_threads = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_FLUSH_RATE_LIMIT:
+        config.flush_rate_limit = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_INTERVAL:
+        config.journal_flush_interval_msec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_SIZE:
+        config.journal_flush_size = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_SIZE:
+        config.journal_checkpoint_size = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL:
+        config.journal_checkpoint_interval_sec = (uint32_t)param->value;
+        break;
       default:
         ups_trace(("unknown parameter %d", (int)param->name));
         return (UPS_INV_PARAMETER);
@@ -562,6 +632,77 @@ ups_env_open(ups_env_t **henv, const char *filename, uint32_t flags,
       case UPS_PARAM_POSIX_FADVISE:
         config.posix_advice = (int)param->value;
         break;
+      case UPS_PARAM_CACHE_POLICY:
+        if (!CachePolicyFactory::is_available(param->value)) {
+          ups_trace(("unknown cache policy"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.cache_policy = (int)param->value;
+        break;
+      case UPS_PARAM_IO_QUEUE_DEPTH:
+        if (param->value > IoUring::kMaxQueueDepth) {
+          ups_trace(("invalid io queue depth"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.io_queue_depth = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY:
+        config.group_commit_delay_usec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE:
+        config.group_commit_size = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_QUERY_THREADS:
+        config.query_threads = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_CACHE_WARMUP:
+        config.cache_warmup = param->value != 0;
+        break;
+      case UPS_PARAM_CACHE_WARMUP_INTERVAL:
+        config.cache_warmup_interval_sec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_SIZE:
+        if (ISSET(flags, UPS_IN_MEMORY) && param->value != 0) {
+          ups_trace(("combination of UPS_IN_MEMORY and compressed cache "
+                "size != 0 not allowed"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.compressed_cache_size_bytes = param->value;
+        break;
+      case UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR:
+        if (param->value != UPS_COMPRESSOR_LZF
+              && param->value != UPS_COMPRESSOR_SNAPPY
+              && param->value != UPS_COMPRESSOR_ZLIB) {
+          ups_trace(("unsupported algorithm for the compressed cache"));
+          return (UPS_INV_PARAMETER);
+        }
+        if (!CompressorFactory::is_available(param->value)) {
+          ups_trace(("unknown algorithm for the compressed cache"));
+          return (UPS_INV_PARAMETER);
+        }
+        config.compressed_cache_compressor = (int)param->value;
+        break;
+      case UPS_PARAM_FLUSH_THREADS:
+        config.flush_threads = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_FLUSH_RATE_LIMIT:
+        config.flush_rate_limit = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_INTERVAL:
+        config.journal_flush_interval_msec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_JOURNAL_FLUSH_SIZE:
+        config.journal_flush_size = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_SIZE:
+        config.journal_checkpoint_size = param->value;
+        break;
+      case UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL:
+        config.journal_checkpoint_interval_sec = (uint32_t)param->value;
+        break;
+      case UPS_PARAM_RECOVERY_THREADS:
+        config.recovery_threads = (uint32_t)param->value;
+        break;
       default:
         ups_trace(("unknown parameter %d", (int)param->name));
         return (UPS_INV_PARAMETER);
@@ -687,6 +828,35 @@ ups_env_get_parameters(ups_env_t *henv, ups_parameter_t *param)
   return (env->get_parameters(param));
 }
 
+ups_status_t UPS_CALLCONV
+ups_env_get_durable_lsn(ups_env_t *henv, uint64_t *durable_lsn,
+                uint64_t *commit_lsn)
+{
+  Environment *env = (Environment *)henv;
+  if (unlikely(!env)) {
+    ups_trace(("parameter 'env' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(!durable_lsn)) {
+    ups_trace(("parameter 'durable_lsn' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+
+  return (env->get_durable_lsn(durable_lsn, commit_lsn));
+}
+
+ups_status_t UPS_CALLCONV
+ups_env_wait_durable_lsn(ups_env_t *henv, uint64_t lsn)
+{
+  Environment *env = (Environment *)henv;
+  if (unlikely(!env)) {
+    ups_trace(("parameter 'env' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+
+  return (env->wait_durable_lsn(lsn));
+}
+
 ups_status_t UPS_CALLCONV
 ups_env_flush(ups_env_t *henv, uint32_t flags)
 {
@@ -744,7 +914,7 @@ ups_db_get_parameters(ups_db_t *hdb, ups_parameter_t *param)
     return UPS_INV_PARAMETER;
   }
 
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   /* get the parameters */
   return (db->get_parameters(param));
@@ -777,7 +947,7 @@ ups_db_set_compare_func(ups_db_t *hdb, ups_compare_func_t foo)
     return (UPS_INV_PARAMETER); 
   }
 
-  ScopedLock lock(ldb->get_env()->mutex());
+  ScopedExclusiveLock lock(ldb->get_env()->mutex());
 
   /* set the compare functions */
   return (ldb->set_compare_func(foo));
@@ -806,7 +976,7 @@ ups_db_find(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key,
     return (UPS_INV_PARAMETER);
 
   Environment *env = db->get_env();
-  ScopedLock lock(env->mutex());
+  ScopedReadLock lock(env->mutex(), db->supports_concurrent_reads());
 
   if (unlikely(ISSETANY(db->get_flags(),
         (UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64)))
@@ -818,6 +988,44 @@ ups_db_find(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key,
   return (db->find(0, txn, key, record, flags));
 }
 
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_find_many(ups_db_t *hdb, ups_txn_t *htxn, uint32_t count,
+                ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+                uint32_t flags)
+{
+  Database *db = (Database *)hdb;
+  Transaction *txn = (Transaction *)htxn;
+
+  if (unlikely(!db)) {
+    ups_trace(("parameter 'db' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(!keys || !records || !results)) {
+    ups_trace(("parameters 'keys', 'records' and 'results' must not "
+               "be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(flags != 0)) {
+    ups_trace(("parameter 'flags' must be 0"));
+    return (UPS_INV_PARAMETER);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (unlikely(!prepare_key(&keys[i]) || !prepare_record(&records[i])))
+      return (UPS_INV_PARAMETER);
+    if (unlikely(!keys[i].data
+          && ISSETANY(db->get_flags(),
+                  (UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64)))) {
+      ups_trace(("key->data must not be NULL"));
+      return (UPS_INV_PARAMETER);
+    }
+  }
+
+  Environment *env = db->get_env();
+  ScopedReadLock lock(env->mutex(), db->supports_concurrent_reads());
+
+  return (db->find_many(txn, count, keys, records, results, flags));
+}
+
 UPS_EXPORT int UPS_CALLCONV
 ups_key_get_approximate_match_type(ups_key_t *key)
 {
@@ -874,9 +1082,9 @@ ups_db_insert(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key,
     return (UPS_INV_PARAMETER);
 
   Environment *env = db->get_env();
-  ScopedLock lock;
+  ScopedExclusiveLock lock;
   if (!(flags & UPS_DONT_LOCK))
-    lock = ScopedLock(env->mutex());
+    lock = ScopedExclusiveLock(env->mutex());
 
   if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
     ups_trace(("cannot insert in a read-only database"));
@@ -898,6 +1106,103 @@ ups_db_insert(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key,
   return (db->insert(0, txn, key, record, flags));
 }
 
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_insert_many(ups_db_t *hdb, ups_txn_t *htxn, uint32_t count,
+                ups_key_t *keys, ups_record_t *records, ups_status_t *results,
+                uint32_t flags)
+{
+  Database *db = (Database *)hdb;
+  Transaction *txn = (Transaction *)htxn;
+
+  if (unlikely(!db)) {
+    ups_trace(("parameter 'db' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(!keys || !records || !results)) {
+    ups_trace(("parameters 'keys', 'records' and 'results' must not "
+               "be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(ISSETANY(flags, UPS_HINT_APPEND | UPS_HINT_PREPEND))) {
+    ups_trace(("flags UPS_HINT_APPEND and UPS_HINT_PREPEND are only "
+          "allowed in ups_cursor_insert"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(ISSET(flags, UPS_OVERWRITE) && ISSET(flags, UPS_DUPLICATE))) {
+    ups_trace(("cannot combine UPS_OVERWRITE and UPS_DUPLICATE"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(ISSETANY(flags, UPS_DUPLICATE_INSERT_AFTER
+                                | UPS_DUPLICATE_INSERT_BEFORE
+                                | UPS_DUPLICATE_INSERT_LAST
+                                | UPS_DUPLICATE_INSERT_FIRST))) {
+    ups_trace(("function does not support flags UPS_DUPLICATE_INSERT_*; "
+          "see ups_cursor_insert"));
+    return (UPS_INV_PARAMETER);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (unlikely(!prepare_key(&keys[i]) || !prepare_record(&records[i])))
+      return (UPS_INV_PARAMETER);
+  }
+
+  Environment *env = db->get_env();
+  ScopedExclusiveLock lock;
+  if (!(flags & UPS_DONT_LOCK))
+    lock = ScopedExclusiveLock(env->mutex());
+
+  if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
+    ups_trace(("cannot insert in a read-only database"));
+    return (UPS_WRITE_PROTECTED);
+  }
+  if (unlikely(ISSET(flags, UPS_DUPLICATE)
+      && NOTSET(db->get_flags(), UPS_ENABLE_DUPLICATE_KEYS))) {
+    ups_trace(("database does not support duplicate keys "
+          "(see UPS_ENABLE_DUPLICATE_KEYS)"));
+    return (UPS_INV_PARAMETER);
+  }
+
+  if (ISSETANY(db->get_flags(), UPS_RECORD_NUMBER32 | UPS_RECORD_NUMBER64)) {
+    for (uint32_t i = 0; i < count; i++) {
+      ups_status_t st = check_recno_key(&keys[i], flags);
+      if (st)
+        return (st);
+    }
+  }
+
+  return (db->insert_many(txn, count, keys, records, results, flags));
+}
+
+UPS_EXPORT ups_status_t UPS_CALLCONV
+ups_db_bulk_load(ups_db_t *hdb, ups_bulk_load_func_t func, void *context,
+                uint32_t fill_factor, uint32_t flags)
+{
+  Database *db = (Database *)hdb;
+
+  if (unlikely(!db)) {
+    ups_trace(("parameter 'db' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(!func)) {
+    ups_trace(("parameter 'func' must not be NULL"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (unlikely(fill_factor > 100)) {
+    ups_trace(("parameter 'fill_factor' must not be greater than 100"));
+    return (UPS_INV_PARAMETER);
+  }
+  if (fill_factor == 0)
+    fill_factor = 100;
+
+  ScopedExclusiveLock lock(db->get_env()->mutex());
+
+  if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
+    ups_trace(("cannot load into a read-only database"));
+    return (UPS_WRITE_PROTECTED);
+  }
+
+  return (db->bulk_load(func, context, fill_factor));
+}
+
 UPS_EXPORT ups_status_t UPS_CALLCONV
 ups_db_erase(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key, uint32_t flags)
 {
@@ -916,9 +1221,9 @@ ups_db_erase(ups_db_t *hdb, ups_txn_t *htxn, ups_key_t *key, uint32_t flags)
     return (UPS_INV_PARAMETER);
 
   Environment *env = db->get_env();
-  ScopedLock lock;
+  ScopedExclusiveLock lock;
   if (!(flags & UPS_DONT_LOCK))
-    lock = ScopedLock(env->mutex());
+    lock = ScopedExclusiveLock(env->mutex());
 
   if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
     ups_trace(("cannot erase from a read-only database"));
@@ -942,7 +1247,7 @@ ups_db_check_integrity(ups_db_t *hdb, uint32_t flags)
     return (UPS_INV_PARAMETER);
   }
 
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
   return (db->check_integrity(flags));
 }
 
@@ -991,9 +1296,9 @@ ups_cursor_create(ups_cursor_t **hcursor, ups_db_t *hdb, ups_txn_t *htxn,
   }
 
   Environment *env = db->get_env();
-  ScopedLock lock;
+  ScopedExclusiveLock lock;
   if (!(flags & UPS_DONT_LOCK))
-    lock = ScopedLock(env->mutex());
+    lock = ScopedExclusiveLock(env->mutex());
 
   return (db->cursor_create(cursor, txn, flags));
 }
@@ -1014,7 +1319,7 @@ ups_cursor_clone(ups_cursor_t *hsrc, ups_cursor_t **hdest)
   }
 
   Database *db = src->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
   return (db->cursor_clone(dest, src));
 }
 
@@ -1041,7 +1346,7 @@ ups_cursor_overwrite(ups_cursor_t *hcursor, ups_record_t *record,
     return (UPS_INV_PARAMETER);
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
     ups_trace(("cannot overwrite in a read-only database"));
@@ -1074,7 +1379,7 @@ ups_cursor_move(ups_cursor_t *hcursor, ups_key_t *key,
 
   Database *db = cursor->db();
   Environment *env = db->get_env();
-  ScopedLock lock(env->mutex());
+  ScopedReadLock lock(env->mutex(), db->supports_concurrent_reads());
 
   return (db->cursor_move(cursor, key, record, flags));
 }
@@ -1100,9 +1405,9 @@ ups_cursor_find(ups_cursor_t *hcursor, ups_key_t *key, ups_record_t *record,
 
   Database *db = cursor->db();
   Environment *env = db->get_env();
-  ScopedLock lock;
+  ScopedReadLock lock;
   if (!(flags & UPS_DONT_LOCK))
-    lock = ScopedLock(env->mutex());
+    lock.lock(env->mutex(), db->supports_concurrent_reads());
 
   return (db->find(cursor, cursor->get_txn(), key, record, flags));
 }
@@ -1138,7 +1443,7 @@ ups_cursor_insert(ups_cursor_t *hcursor, ups_key_t *key, ups_record_t *record,
     return (UPS_INV_PARAMETER);
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   if (unlikely(ISSET(db->get_flags(), UPS_READ_ONLY))) {
     ups_trace(("cannot insert to a read-only database"));
@@ -1181,7 +1486,7 @@ ups_cursor_erase(ups_cursor_t *hcursor, uint32_t flags)
   }
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   if (ISSET(db->get_flags(), UPS_READ_ONLY)) {
     ups_trace(("cannot erase from a read-only database"));
@@ -1207,7 +1512,7 @@ ups_cursor_get_duplicate_count(ups_cursor_t *hcursor, uint32_t *count,
   }
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   return (cursor->get_duplicate_count(flags, count));
 }
@@ -1227,7 +1532,7 @@ ups_cursor_get_duplicate_position(ups_cursor_t *hcursor, uint32_t *position)
   }
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   return (cursor->get_duplicate_position(position));
 }
@@ -1247,7 +1552,7 @@ ups_cursor_get_record_size(ups_cursor_t *hcursor, uint32_t *size)
   }
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   return (cursor->get_record_size(size));
 }
@@ -1263,7 +1568,7 @@ ups_cursor_close(ups_cursor_t *hcursor)
   }
 
   Database *db = cursor->db();
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   return (db->cursor_close(cursor));
 }
@@ -1275,7 +1580,7 @@ ups_set_context_data(ups_db_t *hdb, void *data)
   if (unlikely(!db))
     return;
 
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
   db->set_context_data(data);
 }
 
@@ -1289,7 +1594,7 @@ ups_get_context_data(ups_db_t *hdb, ups_bool_t dont_lock)
   if (dont_lock)
     return (db->get_context_data());
 
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
   return (db->get_context_data());
 }
 
@@ -1329,7 +1634,7 @@ ups_db_count(ups_db_t *hdb, ups_txn_t *htxn, uint32_t flags,
     return (UPS_INV_PARAMETER);
   }
 
-  ScopedLock lock(db->get_env()->mutex());
+  ScopedExclusiveLock lock(db->get_env()->mutex());
 
   return (db->count(txn, (flags & UPS_SKIP_DUPLICATES) != 0, count));
 }
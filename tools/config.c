@@ -73,6 +73,14 @@ __parser_cb(void *ctx, int type, const struct JSON_value_struct *value) {
           p->globals.port = value->vu.integer_value;
           break;
         }
+        if (!strcmp("io-threads", p->key)) {
+          p->globals.io_threads = value->vu.integer_value;
+          break;
+        }
+        if (!strcmp("worker-threads", p->key)) {
+          p->globals.worker_threads = value->vu.integer_value;
+          break;
+        }
       }
       if (type == JSON_T_STRING) {
         if (!strcmp("error-log", p->key)) {
@@ -33,6 +33,8 @@ typedef struct config_table_t
 
   struct config_global_t {
     unsigned int port;
+    unsigned int io_threads;
+    unsigned int worker_threads;
     unsigned int enable_error_log;
     char *error_log;
     unsigned int enable_access_log;
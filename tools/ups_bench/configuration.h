@@ -51,7 +51,8 @@ struct Configuration
     kDistributionAscending,
     kDistributionDescending,
     kDistributionZipfian,
-    kDistributionClustered
+    kDistributionClustered,
+    kDistributionLatest
   };
 
   enum {
@@ -69,7 +70,9 @@ struct Configuration
 
   enum {
     kDefaultKeysize = 16,
-    kDefaultRecsize = 1024
+    kDefaultRecsize = 1024,
+    kDefaultRecordCount = 100000,
+    kDefaultScanLength = 100
   };
 
   Configuration()
@@ -92,7 +95,12 @@ struct Configuration
       journal_compression(0), record_compression(0), key_compression(0),
       read_only(false), enable_crc32(false), record_number32(false),
       record_number64(false), posix_fadvice(UPS_POSIX_FADVICE_NORMAL),
-      simulate_crashes(false) {
+      simulate_crashes(false), cache_policy(UPS_CACHE_POLICY_LRU),
+      io_queue_depth(0), group_commit_delay(0), group_commit_size(0),
+      workload(0), record_count(kDefaultRecordCount),
+      scan_length(kDefaultScanLength), compressed_cache_size(0),
+      flush_threads(0), flush_rate_limit(0), async_commit(false),
+      journal_flush_interval(0) {
   }
 
   const char *
@@ -214,6 +222,25 @@ struct Configuration
                 << " ";
     if (simulate_crashes)
       std::cout << "--simulate-crashes ";
+    if (cache_policy == UPS_CACHE_POLICY_2Q)
+      std::cout << "--cache-policy=2q ";
+    if (io_queue_depth)
+      std::cout << "--io-queue-depth=" << io_queue_depth << " ";
+    if (group_commit_delay)
+      std::cout << "--group-commit-delay=" << group_commit_delay << " ";
+    if (group_commit_size)
+      std::cout << "--group-commit-size=" << group_commit_size << " ";
+    if (compressed_cache_size)
+      std::cout << "--compressed-cache=" << compressed_cache_size << " ";
+    if (flush_threads)
+      std::cout << "--flush-threads=" << flush_threads << " ";
+    if (flush_rate_limit)
+      std::cout << "--flush-rate-limit=" << flush_rate_limit << " ";
+    if (async_commit)
+      std::cout << "--async-commit ";
+    if (journal_flush_interval)
+      std::cout << "--journal-flush-interval=" << journal_flush_interval
+              << " ";
     if (!filename.empty())
       std::cout << filename;
     else {
@@ -239,6 +266,16 @@ struct Configuration
         std::cout << "--distribution=descending ";
       if (distribution == kDistributionZipfian)
         std::cout << "--distribution=zipfian ";
+      if (distribution == kDistributionClustered)
+        std::cout << "--distribution=clustered ";
+      if (distribution == kDistributionLatest)
+        std::cout << "--distribution=latest ";
+      if (workload) {
+        std::cout << "--workload=" << workload << " ";
+        std::cout << "--record-count=" << record_count << " ";
+        if (scan_length != kDefaultScanLength)
+          std::cout << "--scan-length=" << scan_length << " ";
+      }
       if (limit_ops)
         std::cout << "--stop-ops=" << limit_ops << " ";
       if (limit_seconds)
@@ -313,6 +350,18 @@ struct Configuration
   bool record_number64;
   int posix_fadvice;
   bool simulate_crashes;
+  int cache_policy;
+  uint32_t io_queue_depth;
+  uint32_t group_commit_delay;
+  uint32_t group_commit_size;
+  char workload;
+  uint64_t record_count;
+  uint32_t scan_length;
+  uint64_t compressed_cache_size;
+  uint32_t flush_threads;
+  uint64_t flush_rate_limit;
+  bool async_commit;
+  uint32_t journal_flush_interval;
 };
 
 #endif /* UPS_BENCH_CONFIGURATION_H */
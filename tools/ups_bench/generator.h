@@ -42,6 +42,10 @@ class Generator
       kCommandAbortTransaction,
       kCommandFlush,
       kCommandNop,
+      kCommandUpdate,
+      kCommandScan,
+      kCommandReadModifyWrite,
+      kCommandLoad,
       kCommandFullcheck = 999999 // avoid conflicts with ups_status_t
     };
 
@@ -175,6 +175,7 @@ ParserGenerator::insert(const char *keydata, const char *recdata,
   if (m_metrics.insert_latency_max < elapsed)
     m_metrics.insert_latency_max = elapsed;
   m_metrics.insert_latency_total += elapsed;
+  m_metrics.insert_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_DUPLICATE_KEY)
     m_success = false;
@@ -207,6 +208,7 @@ ParserGenerator::erase(const char *keydata)
   if (m_metrics.erase_latency_max < elapsed)
     m_metrics.erase_latency_max = elapsed;
   m_metrics.erase_latency_total += elapsed;
+  m_metrics.erase_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_KEY_NOT_FOUND)
     m_success = false;
@@ -235,6 +237,7 @@ ParserGenerator::find(const char *keydata)
   if (m_metrics.find_latency_max < elapsed)
     m_metrics.find_latency_max = elapsed;
   m_metrics.find_latency_total += elapsed;
+  m_metrics.find_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_KEY_NOT_FOUND)
     m_success = false;
@@ -325,6 +328,7 @@ ParserGenerator::txn_commit()
   if (m_metrics.txn_commit_latency_max < elapsed)
     m_metrics.txn_commit_latency_max = elapsed;
   m_metrics.txn_commit_latency_total += elapsed;
+  m_metrics.txn_commit_latency_histogram.add(elapsed);
 
   if (m_last_status != 0)
     m_success = false;
@@ -30,7 +30,8 @@
 RuntimeGenerator::RuntimeGenerator(int id, Configuration *conf, Database *db,
                 bool show_progress)
   : Generator(id, conf, db), m_state(0), m_opcount(0),
-    m_datasource(0), m_u01(m_rng), m_elapsed_seconds(0.0), m_txn(0),
+    m_datasource(0), m_workload(0), m_key_chooser(0), m_key_count(0),
+    m_load_count(0), m_u01(m_rng), m_elapsed_seconds(0.0), m_txn(0),
     m_cursor(0), m_progress(0), m_success(true), m_erase_only(false)
 {
   if (conf->seed)
@@ -41,6 +42,9 @@ RuntimeGenerator::RuntimeGenerator(int id, Configuration *conf, Database *db,
   m_metrics.erase_latency_min = 9999999.99;
   m_metrics.find_latency_min = 9999999.99;
   m_metrics.txn_commit_latency_min = 9999999.99;
+  m_metrics.update_latency_min = 9999999.99;
+  m_metrics.scan_latency_min = 9999999.99;
+  m_metrics.rmw_latency_min = 9999999.99;
 
   if (show_progress) {
     if (!conf->no_progress && !conf->quiet && !conf->verbose)
@@ -52,6 +56,26 @@ RuntimeGenerator::RuntimeGenerator(int id, Configuration *conf, Database *db,
   if (!m_config->tee_file.empty())
     m_tee.open(m_config->tee_file.c_str(), std::ios::out);
 
+  // a workload generates its own keys; if the Environment is opened then
+  // the keys were already loaded
+  if (conf->workload) {
+    m_workload = Workload::get(conf->workload);
+    if (conf->open)
+      m_key_count = m_load_count = conf->record_count;
+    switch (conf->distribution) {
+      case Configuration::kDistributionZipfian:
+        m_key_chooser = new ZipfianKeyChooser(conf->record_count);
+        break;
+      case Configuration::kDistributionLatest:
+        m_key_chooser = new LatestKeyChooser(conf->record_count);
+        break;
+      default:
+        m_key_chooser = new UniformKeyChooser();
+        break;
+    }
+    return;
+  }
+
   switch (conf->key_type) {
     case Configuration::kKeyUint8:
       switch (conf->distribution) {
@@ -277,6 +301,19 @@ RuntimeGenerator::execute()
     case Generator::kCommandCommitTransaction:
       commit_latency = txn_commit();
       break;
+    case Generator::kCommandUpdate:
+      insert_latency = update();
+      break;
+    case Generator::kCommandScan:
+      find_latency = scan();
+      break;
+    case Generator::kCommandReadModifyWrite:
+      find_latency = read_modify_write();
+      break;
+    case Generator::kCommandLoad:
+      // the load phase is not part of the workload; do not count it
+      load();
+      return (true);
     default:
       assert(!"shouldn't be here");
   }
@@ -379,7 +416,9 @@ RuntimeGenerator::close()
 double
 RuntimeGenerator::insert()
 {
-  ups_key_t key = generate_key();
+  ups_key_t key = m_workload
+                    ? generate_workload_key(m_key_count++)
+                    : generate_key();
   ups_record_t rec = generate_record();
 
   tee("INSERT", &key, &rec);
@@ -400,6 +439,7 @@ RuntimeGenerator::insert()
   if (m_metrics.insert_latency_max < elapsed)
     m_metrics.insert_latency_max = elapsed;
   m_metrics.insert_latency_total += elapsed;
+  m_metrics.insert_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_DUPLICATE_KEY)
     m_success = false;
@@ -438,6 +478,7 @@ RuntimeGenerator::erase()
   if (m_metrics.erase_latency_max < elapsed)
     m_metrics.erase_latency_max = elapsed;
   m_metrics.erase_latency_total += elapsed;
+  m_metrics.erase_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_KEY_NOT_FOUND)
     m_success = false;
@@ -450,7 +491,9 @@ RuntimeGenerator::erase()
 double
 RuntimeGenerator::find()
 {
-  ups_key_t key = generate_key();
+  ups_key_t key = m_workload
+                    ? generate_workload_key(choose_key())
+                    : generate_key();
   ups_record_t m_record = {0};
   memset(&m_record, 0, sizeof(m_record));
 
@@ -472,6 +515,7 @@ RuntimeGenerator::find()
   if (m_metrics.find_latency_max < elapsed)
     m_metrics.find_latency_max = elapsed;
   m_metrics.find_latency_total += elapsed;
+  m_metrics.find_latency_histogram.add(elapsed);
 
   if (m_last_status != 0 && m_last_status != UPS_KEY_NOT_FOUND)
     m_success = false;
@@ -508,6 +552,162 @@ RuntimeGenerator::tablescan()
     m_db->cursor_close(cursor);
 }
 
+void
+RuntimeGenerator::load()
+{
+  ups_key_t key = generate_workload_key(m_load_count);
+  ups_record_t rec = generate_record();
+
+  tee("LOAD", &key, &rec);
+
+  m_last_status = m_db->insert(m_txn, &key, &rec);
+  if (m_last_status != 0)
+    m_success = false;
+
+  m_load_count++;
+  m_key_count++;
+
+  // the workload starts now
+  if (m_load_count == m_config->record_count) {
+    m_start = Timer<boost::chrono::system_clock>();
+    m_elapsed_seconds = 0.0;
+  }
+}
+
+double
+RuntimeGenerator::update()
+{
+  ups_key_t key = generate_workload_key(choose_key());
+  ups_record_t rec = generate_record();
+
+  tee("UPDATE", &key, &rec);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+
+  if (m_cursor)
+    m_last_status = m_db->cursor_insert(m_cursor, &key, &rec);
+  else
+    m_last_status = m_db->insert(m_txn, &key, &rec);
+
+  double elapsed = t.seconds();
+
+  m_opspersec[kCommandInsert]++;
+
+  if (m_metrics.update_latency_min > elapsed)
+    m_metrics.update_latency_min = elapsed;
+  if (m_metrics.update_latency_max < elapsed)
+    m_metrics.update_latency_max = elapsed;
+  m_metrics.update_latency_total += elapsed;
+  m_metrics.update_latency_histogram.add(elapsed);
+
+  if (m_last_status != 0)
+    m_success = false;
+
+  m_metrics.update_ops++;
+
+  return (elapsed);
+}
+
+double
+RuntimeGenerator::scan()
+{
+  ups_key_t key = generate_workload_key(choose_key());
+  uint32_t length = 1 + (uint32_t)(m_u01() * m_config->scan_length);
+  if (length > m_config->scan_length)
+    length = m_config->scan_length;
+
+  tee("SCAN", &key);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+
+  Database::Cursor *cursor = m_cursor;
+  if (!cursor)
+    cursor = m_db->cursor_create();
+
+  // position the cursor on the first key, then move forward
+  uint32_t count = 0;
+  ups_record_t rec = {0};
+  m_last_status = m_db->cursor_find(cursor, &key, &rec);
+  if (m_last_status == 0) {
+    for (count = 1; count < length; count++) {
+      ups_key_t k = {0};
+      ups_record_t r = {0};
+      ups_status_t st = m_db->cursor_get_next(cursor, &k, &r, false);
+      if (st == UPS_KEY_NOT_FOUND)
+        break;
+      if (st != 0) {
+        m_last_status = st;
+        break;
+      }
+    }
+  }
+
+  if (!m_cursor)
+    m_db->cursor_close(cursor);
+
+  double elapsed = t.seconds();
+
+  m_opspersec[kCommandFind]++;
+
+  if (m_metrics.scan_latency_min > elapsed)
+    m_metrics.scan_latency_min = elapsed;
+  if (m_metrics.scan_latency_max < elapsed)
+    m_metrics.scan_latency_max = elapsed;
+  m_metrics.scan_latency_total += elapsed;
+  m_metrics.scan_latency_histogram.add(elapsed);
+
+  if (m_last_status != 0)
+    m_success = false;
+
+  m_metrics.scan_keys += count;
+  m_metrics.scan_ops++;
+
+  return (elapsed);
+}
+
+double
+RuntimeGenerator::read_modify_write()
+{
+  ups_key_t key = generate_workload_key(choose_key());
+  ups_record_t record = {0};
+
+  tee("READ_MODIFY_WRITE", &key);
+
+  Timer<boost::chrono::high_resolution_clock> t;
+
+  if (m_cursor)
+    m_last_status = m_db->cursor_find(m_cursor, &key, &record);
+  else
+    m_last_status = m_db->find(m_txn, &key, &record);
+
+  if (m_last_status == 0) {
+    ups_record_t rec = generate_record();
+    if (m_cursor)
+      m_last_status = m_db->cursor_insert(m_cursor, &key, &rec);
+    else
+      m_last_status = m_db->insert(m_txn, &key, &rec);
+  }
+
+  double elapsed = t.seconds();
+
+  m_opspersec[kCommandInsert]++;
+
+  if (m_metrics.rmw_latency_min > elapsed)
+    m_metrics.rmw_latency_min = elapsed;
+  if (m_metrics.rmw_latency_max < elapsed)
+    m_metrics.rmw_latency_max = elapsed;
+  m_metrics.rmw_latency_total += elapsed;
+  m_metrics.rmw_latency_histogram.add(elapsed);
+
+  if (m_last_status != 0)
+    m_success = false;
+
+  m_metrics.find_bytes += record.size;
+  m_metrics.rmw_ops++;
+
+  return (elapsed);
+}
+
 void
 RuntimeGenerator::txn_begin()
 {
@@ -572,6 +772,7 @@ RuntimeGenerator::txn_commit()
   if (m_metrics.txn_commit_latency_max < elapsed)
     m_metrics.txn_commit_latency_max = elapsed;
   m_metrics.txn_commit_latency_total += elapsed;
+  m_metrics.txn_commit_latency_histogram.add(elapsed);
 
   if (m_last_status != 0)
     m_success = false;
@@ -595,6 +796,55 @@ RuntimeGenerator::generate_key()
   return (key);
 }
 
+ups_key_t
+RuntimeGenerator::generate_workload_key(uint64_t id)
+{
+  ups_key_t key = {0};
+
+  switch (m_config->key_type) {
+    case Configuration::kKeyUint32: {
+      uint32_t value = workload_mix32((uint32_t)id);
+      m_key_data.resize(sizeof(value));
+      ::memcpy(&m_key_data[0], &value, sizeof(value));
+      break;
+    }
+    case Configuration::kKeyUint64: {
+      uint64_t value = workload_mix64(id);
+      m_key_data.resize(sizeof(value));
+      ::memcpy(&m_key_data[0], &value, sizeof(value));
+      break;
+    }
+    default: {
+      // "user" followed by 20 decimal digits, like the YCSB keys
+      const char *prefix = "user";
+      m_key_data.assign(prefix, prefix + 4);
+      m_key_data.resize(4 + 20);
+      uint64_t value = workload_mix64(id);
+      for (int i = 20 - 1; i >= 0; i--) {
+        m_key_data[4 + i] = (uint8_t)('0' + value % 10);
+        value /= 10;
+      }
+      if (m_config->key_is_fixed_size)
+        m_key_data.resize(m_config->key_size, 0);
+      break;
+    }
+  }
+
+  // append terminating 0 byte
+  m_key_data.resize(m_key_data.size() + 1);
+  m_key_data[m_key_data.size() - 1] = 0;
+
+  key.data = &m_key_data[0];
+  key.size = m_key_data.size() - 1;
+  return (key);
+}
+
+uint64_t
+RuntimeGenerator::choose_key()
+{
+  return (m_key_chooser->next(m_u01(), m_key_count));
+}
+
 ups_record_t
 RuntimeGenerator::generate_record()
 {
@@ -643,6 +893,10 @@ RuntimeGenerator::get_next_command()
       return (Generator::kCommandCreate);
   }
 
+  // load the keys of the workload before the workload starts
+  if (m_workload && m_load_count < m_config->record_count)
+    return (Generator::kCommandLoad);
+
   // begin/abort/commit transactions!
   if (m_config->transactions_nth) {
     if (!m_txn)
@@ -652,6 +906,23 @@ RuntimeGenerator::get_next_command()
       return (Generator::kCommandCommitTransaction);
   }
 
+  // perform the operations of the workload
+  if (m_workload) {
+    double d = m_u01() * 100;
+    if (d < m_workload->read_pct)
+      return (Generator::kCommandFind);
+    d -= m_workload->read_pct;
+    if (d < m_workload->update_pct)
+      return (Generator::kCommandUpdate);
+    d -= m_workload->update_pct;
+    if (d < m_workload->insert_pct)
+      return (Generator::kCommandInsert);
+    d -= m_workload->insert_pct;
+    if (d < m_workload->scan_pct)
+      return (Generator::kCommandScan);
+    return (Generator::kCommandReadModifyWrite);
+  }
+
   // perform "real" work
   if (m_config->erase_pct || m_config->find_pct || m_config->table_scan_pct) {
     double d = m_u01();
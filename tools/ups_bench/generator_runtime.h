@@ -29,6 +29,7 @@
 #include "generator.h"
 #include "datasource.h"
 #include "database.h"
+#include "workload.h"
 
 //
 // generates data based on configuration settings
@@ -51,6 +52,7 @@ class RuntimeGenerator : public ::Generator
       assert(m_txn == 0);
       assert(m_cursor == 0);
       delete m_datasource;
+      delete m_key_chooser;
       delete m_progress;
     }
 
@@ -103,6 +105,18 @@ class RuntimeGenerator : public ::Generator
     // perform a table scan
     void tablescan();
 
+    // inserts a key of the workload before the workload starts
+    void load();
+
+    // overwrites the record of an existing key
+    double update();
+
+    // performs a short range scan
+    double scan();
+
+    // looks up an existing key, then overwrites its record
+    double read_modify_write();
+
     // begins a new transaction
     void txn_begin();
 
@@ -115,6 +129,12 @@ class RuntimeGenerator : public ::Generator
     // generates a new key, based on the Datasource
     ups_key_t generate_key();
 
+    // generates the key with the specified |id| (for workloads)
+    ups_key_t generate_workload_key(uint64_t id);
+
+    // chooses the id of an existing key (for workloads)
+    uint64_t choose_key();
+
     // generates a new record
     ups_record_t generate_record();
 
@@ -130,9 +150,21 @@ class RuntimeGenerator : public ::Generator
     // counting the number of operations
     uint64_t m_opcount;
 
-    // the datasource
+    // the datasource; null if a workload is running
     Datasource *m_datasource;
 
+    // the workload; null if none is running
+    const Workload *m_workload;
+
+    // chooses the keys of the workload's operations
+    KeyChooser *m_key_chooser;
+
+    // the number of keys of the workload
+    uint64_t m_key_count;
+
+    // the number of keys loaded before the workload started
+    uint64_t m_load_count;
+
     // a vector which temporarily stores the data from the Datasource
     std::vector<uint8_t> m_key_data;
 
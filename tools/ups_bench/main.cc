@@ -39,6 +39,7 @@
 #include "metrics.h"
 #include "misc.h"
 #include "os.h"
+#include "workload.h"
 
 
 #define ARG_HELP                                1
@@ -95,6 +96,18 @@
 #define ARG_RECORD_NUMBER64                     70
 #define ARG_POSIX_FADVICE                       71
 #define ARG_SIMULATE_CRASHES                    72
+#define ARG_CACHE_POLICY                        73
+#define ARG_IO_QUEUE_DEPTH                      74
+#define ARG_GROUP_COMMIT_DELAY                  75
+#define ARG_GROUP_COMMIT_SIZE                   76
+#define ARG_WORKLOAD                            77
+#define ARG_RECORD_COUNT                        78
+#define ARG_SCAN_LENGTH                         79
+#define ARG_COMPRESSED_CACHE                    80
+#define ARG_FLUSH_THREADS                       81
+#define ARG_FLUSH_RATE_LIMIT                    82
+#define ARG_ASYNC_COMMIT                        83
+#define ARG_JOURNAL_FLUSH_INTERVAL              84
 
 /*
  * command line parameters
@@ -159,7 +172,8 @@ static option_t opts[] = {
     0,
     "distribution",
     "Sets the distribution of the key values ('random', 'ascending',\n"
-            "\t'descending', 'clustered')",
+            "\t'descending', 'zipfian', 'clustered', 'latest' (only with\n"
+            "\t--workload))",
     GETOPTS_NEED_ARGUMENT },
   {
     ARG_INMEMORY,
@@ -432,6 +446,84 @@ static option_t opts[] = {
     "simulate-crashes",
     "Simulates a crash after every operation, then performs a fullcheck",
     0 },
+  {
+    ARG_CACHE_POLICY,
+    0,
+    "cache-policy",
+    "Sets the cache replacement policy: 'lru' (default), '2q'",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_IO_QUEUE_DEPTH,
+    0,
+    "io-queue-depth",
+    "Enables asynchronous page I/O (io_uring) with this queue depth",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_GROUP_COMMIT_DELAY,
+    0,
+    "group-commit-delay",
+    "Max. delay (in usec) of a journal fsync to collect more commits",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_GROUP_COMMIT_SIZE,
+    0,
+    "group-commit-size",
+    "Number of waiting commits which end the group commit delay",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_WORKLOAD,
+    0,
+    "workload",
+    "Runs a YCSB workload ('a': 50% reads, 50% updates; 'b': 95% reads,\n"
+            "\t5% updates; 'c': reads only; 'd': 95% reads of the latest\n"
+            "\tkeys, 5% inserts; 'e': 95% short range scans, 5% inserts;\n"
+            "\t'f': 50% reads, 50% read-modify-writes). The keys are loaded\n"
+            "\tbefore the workload starts.",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_RECORD_COUNT,
+    0,
+    "record-count",
+    "Number of keys which are loaded before a --workload starts\n"
+            "\t(default: 100000)",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_SCAN_LENGTH,
+    0,
+    "scan-length",
+    "Max. number of keys of the range scans of --workload=e\n"
+            "\t(default: 100)",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_COMPRESSED_CACHE,
+    0,
+    "compressed-cache",
+    "Sets the size of the compressed cache tier (in bytes)",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_FLUSH_THREADS,
+    0,
+    "flush-threads",
+    "Sets the number of threads which flush dirty pages",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_FLUSH_RATE_LIMIT,
+    0,
+    "flush-rate-limit",
+    "Limits the throughput of background flushes (in bytes per second)",
+    GETOPTS_NEED_ARGUMENT },
+  {
+    ARG_ASYNC_COMMIT,
+    0,
+    "async-commit",
+    "Commits Transactions asynchronously (UPS_TXN_ASYNC_COMMIT)",
+    0 },
+  {
+    ARG_JOURNAL_FLUSH_INTERVAL,
+    0,
+    "journal-flush-interval",
+    "Interval (in milliseconds) of the background journal flush",
+    GETOPTS_NEED_ARGUMENT },
   {0, 0}
 };
 
@@ -460,11 +552,15 @@ parse_compression_type(std::string param)
     return (UPS_COMPRESSOR_UINT32_STREAMVBYTE);
   if (param == "zint32_maskedvbyte")
     return (UPS_COMPRESSOR_UINT32_MASKEDVBYTE);
+  if (param == "zint64_varbyte")
+    return (UPS_COMPRESSOR_UINT64_VARBYTE);
+  if (param == "zint64_for")
+    return (UPS_COMPRESSOR_UINT64_FOR);
   ::printf("invalid compression specifier '%s': expecting 'none', 'zlib', "
               "'snappy', 'lzf', 'zint32_varbyte', 'zint32_simdcomp', "
               "'zint32_groupvarint', 'zint32_streamvbyte', "
               "'zint32_maskedvbyte', 'zint32_for', "
-              "'zint32_simdfor'\n",
+              "'zint32_simdfor', 'zint64_varbyte', 'zint64_for'\n",
               param.c_str());
   ::exit(-1);
 }
@@ -474,6 +570,7 @@ parse_config(int argc, char **argv, Configuration *c)
 {
   unsigned opt;
   const char *param;
+  bool has_distribution = false;
 	
   getopts_init(argc, argv, "ups_bench");
 
@@ -496,6 +593,7 @@ parse_config(int argc, char **argv, Configuration *c)
       c->inmemory = true;
     }
     else if (opt == ARG_DISTRIBUTION) {
+      has_distribution = true;
       if (param && !strcmp(param, "random"))
         c->distribution = Configuration::kDistributionRandom;
       else if (param && !strcmp(param, "ascending"))
@@ -506,6 +604,8 @@ parse_config(int argc, char **argv, Configuration *c)
         c->distribution = Configuration::kDistributionZipfian;
       else if (param && !strcmp(param, "clustered"))
         c->distribution = Configuration::kDistributionClustered;
+      else if (param && !strcmp(param, "latest"))
+        c->distribution = Configuration::kDistributionLatest;
       else {
         ::printf("[FAIL] invalid parameter for --distribution\n");
         ::exit(-1);
@@ -818,6 +918,66 @@ parse_config(int argc, char **argv, Configuration *c)
         exit(-1);
       }
     }
+    else if (opt == ARG_CACHE_POLICY) {
+      if (!strcmp(param, "lru"))
+        c->cache_policy = UPS_CACHE_POLICY_LRU;
+      else if (!strcmp(param, "2q"))
+        c->cache_policy = UPS_CACHE_POLICY_2Q;
+      else {
+        printf("[FAIL] invalid parameter for 'cache-policy'\n");
+        exit(-1);
+      }
+    }
+    else if (opt == ARG_IO_QUEUE_DEPTH) {
+      c->io_queue_depth = strtoul(param, 0, 0);
+      if (!c->io_queue_depth) {
+        printf("[FAIL] invalid parameter for 'io-queue-depth'\n");
+        exit(-1);
+      }
+    }
+    else if (opt == ARG_GROUP_COMMIT_DELAY) {
+      c->group_commit_delay = strtoul(param, 0, 0);
+    }
+    else if (opt == ARG_GROUP_COMMIT_SIZE) {
+      c->group_commit_size = strtoul(param, 0, 0);
+    }
+    else if (opt == ARG_WORKLOAD) {
+      if (param && ::strlen(param) == 1 && Workload::get(param[0]))
+        c->workload = param[0];
+      else {
+        printf("[FAIL] invalid parameter for 'workload'\n");
+        exit(-1);
+      }
+    }
+    else if (opt == ARG_RECORD_COUNT) {
+      c->record_count = strtoull(param, 0, 0);
+      if (!c->record_count) {
+        printf("[FAIL] invalid parameter for 'record-count'\n");
+        exit(-1);
+      }
+    }
+    else if (opt == ARG_SCAN_LENGTH) {
+      c->scan_length = strtoul(param, 0, 0);
+      if (!c->scan_length) {
+        printf("[FAIL] invalid parameter for 'scan-length'\n");
+        exit(-1);
+      }
+    }
+    else if (opt == ARG_COMPRESSED_CACHE) {
+      c->compressed_cache_size = strtoull(param, 0, 0);
+    }
+    else if (opt == ARG_FLUSH_THREADS) {
+      c->flush_threads = strtoul(param, 0, 0);
+    }
+    else if (opt == ARG_FLUSH_RATE_LIMIT) {
+      c->flush_rate_limit = strtoull(param, 0, 0);
+    }
+    else if (opt == ARG_ASYNC_COMMIT) {
+      c->async_commit = true;
+    }
+    else if (opt == ARG_JOURNAL_FLUSH_INTERVAL) {
+      c->journal_flush_interval = strtoul(param, 0, 0);
+    }
     else if (opt == ARG_ENABLE_CRC32) {
       c->enable_crc32 = true;
     }
@@ -867,6 +1027,70 @@ parse_config(int argc, char **argv, Configuration *c)
     printf("[FAIL] '--duplicate=first' needs 'use-cursors'\n");
     exit(-1);
   }
+
+  if (c->workload) {
+    if (!c->filename.empty() || c->bulk_erase) {
+      printf("[FAIL] '--workload' not supported with test files or "
+                      "'--bulk-erase'\n");
+      exit(-1);
+    }
+    if (c->duplicate) {
+      printf("[FAIL] '--workload' not supported with '--duplicate'\n");
+      exit(-1);
+    }
+    if (c->erase_pct || c->find_pct || c->table_scan_pct) {
+      printf("[FAIL] '--workload' defines the operations; '--erase-pct', "
+                      "'--find-pct' and '--table-scan-pct' are not "
+                      "supported\n");
+      exit(-1);
+    }
+    if (c->key_type != Configuration::kKeyBinary
+        && c->key_type != Configuration::kKeyCustom
+        && c->key_type != Configuration::kKeyString
+        && c->key_type != Configuration::kKeyUint32
+        && c->key_type != Configuration::kKeyUint64) {
+      printf("[FAIL] '--workload' needs binary, string, uint32 or "
+                      "uint64 keys\n");
+      exit(-1);
+    }
+    if (c->key_is_fixed_size
+        && (c->key_type == Configuration::kKeyBinary
+            || c->key_type == Configuration::kKeyCustom
+            || c->key_type == Configuration::kKeyString)
+        && c->key_size < 24) {
+      printf("[FAIL] '--workload' needs a key size of at least 24 bytes\n");
+      exit(-1);
+    }
+    // workload d reads the latest keys, all others use a zipfian
+    // distribution
+    if (!has_distribution)
+      c->distribution = c->workload == 'd'
+                          ? Configuration::kDistributionLatest
+                          : Configuration::kDistributionZipfian;
+    if (c->distribution != Configuration::kDistributionRandom
+        && c->distribution != Configuration::kDistributionZipfian
+        && c->distribution != Configuration::kDistributionLatest) {
+      printf("[FAIL] '--workload' supports the distributions 'random', "
+                      "'zipfian' and 'latest'\n");
+      exit(-1);
+    }
+    // updates overwrite the existing keys
+    c->overwrite = true;
+  }
+  else if (c->distribution == Configuration::kDistributionLatest) {
+    printf("[FAIL] '--distribution=latest' needs '--workload'\n");
+    exit(-1);
+  }
+}
+
+static void
+print_percentiles(const char *name, const char *op,
+                const LatencyHistogram *histogram)
+{
+  std::string label = std::string(op) + "_latency (p50, p99, p999)";
+  printf("\t%s %-30s %f, %f, %f\n", name, label.c_str(),
+                  histogram->percentile(0.5), histogram->percentile(0.99),
+                  histogram->percentile(0.999));
 }
 
 static void
@@ -875,13 +1099,18 @@ print_metrics(Metrics *metrics, Configuration *conf)
   const char *name = metrics->name;
   double total = metrics->insert_latency_total + metrics->find_latency_total
                   + metrics->erase_latency_total
-                  + metrics->txn_commit_latency_total;
+                  + metrics->txn_commit_latency_total
+                  + metrics->update_latency_total
+                  + metrics->scan_latency_total
+                  + metrics->rmw_latency_total;
 
   printf("\t%s elapsed time (sec)             %f\n", name, total);
   printf("\t%s total_#ops                     %lu\n",
                   name, (long unsigned int)(metrics->insert_ops
                   + metrics->erase_ops + metrics->find_ops
                   + metrics->txn_commit_ops
+                  + metrics->update_ops + metrics->scan_ops
+                  + metrics->rmw_ops
                   + metrics->other_ops));
   if (metrics->insert_ops) {
     printf("\t%s insert_#ops                    %lu (%f/sec)\n",
@@ -894,6 +1123,17 @@ print_metrics(Metrics *metrics, Configuration *conf)
                   name, metrics->insert_latency_min,
                   metrics->insert_latency_total / metrics->insert_ops,
                   metrics->insert_latency_max);
+    print_percentiles(name, "insert", &metrics->insert_latency_histogram);
+  }
+  if (metrics->update_ops) {
+    printf("\t%s update_#ops                    %lu (%f/sec)\n",
+                  name, (long unsigned int)metrics->update_ops,
+                  (double)metrics->update_ops / metrics->update_latency_total);
+    printf("\t%s update_latency (min, avg, max) %f, %f, %f\n",
+                  name, metrics->update_latency_min,
+                  metrics->update_latency_total / metrics->update_ops,
+                  metrics->update_latency_max);
+    print_percentiles(name, "update", &metrics->update_latency_histogram);
   }
   if (metrics->find_ops) {
     printf("\t%s find_#ops                      %lu (%f/sec)\n",
@@ -906,6 +1146,29 @@ print_metrics(Metrics *metrics, Configuration *conf)
                   name, metrics->find_latency_min,
                   metrics->find_latency_total / metrics->find_ops,
                   metrics->find_latency_max);
+    print_percentiles(name, "find", &metrics->find_latency_histogram);
+  }
+  if (metrics->scan_ops) {
+    printf("\t%s scan_#ops                      %lu (%f/sec)\n",
+                  name, (long unsigned int)metrics->scan_ops,
+                  (double)metrics->scan_ops / metrics->scan_latency_total);
+    printf("\t%s scan_#keys                     %lu\n",
+                  name, (long unsigned int)metrics->scan_keys);
+    printf("\t%s scan_latency (min, avg, max)   %f, %f, %f\n",
+                  name, metrics->scan_latency_min,
+                  metrics->scan_latency_total / metrics->scan_ops,
+                  metrics->scan_latency_max);
+    print_percentiles(name, "scan", &metrics->scan_latency_histogram);
+  }
+  if (metrics->rmw_ops) {
+    printf("\t%s rmw_#ops                       %lu (%f/sec)\n",
+                  name, (long unsigned int)metrics->rmw_ops,
+                  (double)metrics->rmw_ops / metrics->rmw_latency_total);
+    printf("\t%s rmw_latency (min, avg, max)    %f, %f, %f\n",
+                  name, metrics->rmw_latency_min,
+                  metrics->rmw_latency_total / metrics->rmw_ops,
+                  metrics->rmw_latency_max);
+    print_percentiles(name, "rmw", &metrics->rmw_latency_histogram);
   }
   if (metrics->erase_ops) {
     printf("\t%s erase_#ops                     %lu (%f/sec)\n",
@@ -915,6 +1178,13 @@ print_metrics(Metrics *metrics, Configuration *conf)
                   name, metrics->erase_latency_min,
                   metrics->erase_latency_total / metrics->erase_ops,
                   metrics->erase_latency_max);
+    print_percentiles(name, "erase", &metrics->erase_latency_histogram);
+  }
+  if (metrics->txn_commit_ops) {
+    printf("\t%s txn_commit_#ops                %lu\n",
+                  name, (long unsigned int)metrics->txn_commit_ops);
+    print_percentiles(name, "txn_commit",
+                  &metrics->txn_commit_latency_histogram);
   }
   if (!conf->inmemory) {
     if (!strcmp(name, "upscaledb"))
@@ -969,6 +1239,8 @@ print_metrics(Metrics *metrics, Configuration *conf)
           (long unsigned int)metrics->upscaledb_metrics.mem_peak_usage);
   printf("\tupscaledb page_count_fetched          %lu\n",
           (long unsigned int)metrics->upscaledb_metrics.page_count_fetched);
+  printf("\tupscaledb page_count_prefetched       %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.page_count_prefetched);
   printf("\tupscaledb page_count_flushed          %lu\n",
           (long unsigned int)metrics->upscaledb_metrics.page_count_flushed);
   printf("\tupscaledb page_count_type_index       %lu\n",
@@ -985,6 +1257,24 @@ print_metrics(Metrics *metrics, Configuration *conf)
           (long unsigned int)metrics->upscaledb_metrics.cache_hits);
   printf("\tupscaledb cache_misses                %lu\n",
           (long unsigned int)metrics->upscaledb_metrics.cache_misses);
+  printf("\tupscaledb compressed_cache_hits       %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.compressed_cache_hits);
+  printf("\tupscaledb compressed_cache_misses     %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.compressed_cache_misses);
+  printf("\tupscaledb compressed_cache_pages      %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.compressed_cache_pages);
+  printf("\tupscaledb compressed_cache_bytes      %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.compressed_cache_bytes);
+  printf("\tupscaledb cache_hits_cold             %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.cache_hits_cold);
+  printf("\tupscaledb cache_hits_hot              %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.cache_hits_hot);
+  printf("\tupscaledb cache_misses_ghost          %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.cache_misses_ghost);
+  printf("\tupscaledb cache_pages_cold            %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.cache_pages_cold);
+  printf("\tupscaledb cache_pages_hot             %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.cache_pages_hot);
   printf("\tupscaledb blob_total_allocated        %lu\n",
           (long unsigned int)metrics->upscaledb_metrics.blob_total_allocated);
   printf("\tupscaledb blob_total_read             %lu\n",
@@ -999,6 +1289,14 @@ print_metrics(Metrics *metrics, Configuration *conf)
           (long unsigned int)metrics->upscaledb_metrics.extended_duptables);
   printf("\tupscaledb journal_bytes_flushed       %lu\n",
           (long unsigned int)metrics->upscaledb_metrics.journal_bytes_flushed);
+  printf("\tupscaledb journal_commits             %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.journal_commits);
+  printf("\tupscaledb journal_fsyncs              %lu\n",
+          (long unsigned int)metrics->upscaledb_metrics.journal_fsyncs);
+  if (metrics->upscaledb_metrics.journal_fsyncs)
+    printf("\tupscaledb journal_commits_per_fsync   %f\n",
+          (double)metrics->upscaledb_metrics.journal_commits
+              / metrics->upscaledb_metrics.journal_fsyncs);
   printf("\tupscaledb simd_lane_width             %d\n",
           metrics->upscaledb_metrics.simd_lane_width);
 }
@@ -1054,6 +1352,21 @@ add_metrics(Metrics *metrics, const Metrics *other)
   metrics->erase_latency_total += other->erase_latency_total;
   metrics->find_latency_total += other->find_latency_total;
   metrics->txn_commit_latency_total += other->txn_commit_latency_total;
+  metrics->update_ops += other->update_ops;
+  metrics->scan_ops += other->scan_ops;
+  metrics->rmw_ops += other->rmw_ops;
+  metrics->scan_keys += other->scan_keys;
+  metrics->update_latency_total += other->update_latency_total;
+  metrics->scan_latency_total += other->scan_latency_total;
+  metrics->rmw_latency_total += other->rmw_latency_total;
+  metrics->insert_latency_histogram.merge(&other->insert_latency_histogram);
+  metrics->update_latency_histogram.merge(&other->update_latency_histogram);
+  metrics->erase_latency_histogram.merge(&other->erase_latency_histogram);
+  metrics->find_latency_histogram.merge(&other->find_latency_histogram);
+  metrics->scan_latency_histogram.merge(&other->scan_latency_histogram);
+  metrics->rmw_latency_histogram.merge(&other->rmw_latency_histogram);
+  metrics->txn_commit_latency_histogram.merge(
+                  &other->txn_commit_latency_histogram);
 }
 
 template<typename DatabaseType, typename GeneratorType>
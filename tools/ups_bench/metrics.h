@@ -21,6 +21,76 @@
 #include <ups/upscaledb_int.h>
 #include <boost/cstdint.hpp> // MSVC 2008 does not have stdint.h
 
+//
+// A histogram of operation latencies with logarithmic buckets; each power
+// of two is split into |kSubBuckets| linear buckets, therefore the
+// relative error of the percentiles is below 1/16. Has no constructor
+// because the Metrics are initialized with memset.
+//
+struct LatencyHistogram {
+  enum {
+    // number of linear buckets per power of two
+    kSubBuckets = 16,
+
+    // total number of buckets (covers 64bit values)
+    kBuckets = 62 * kSubBuckets
+  };
+
+  // Adds a latency (in seconds)
+  void add(double seconds) {
+    buckets[index((uint64_t)(seconds * 1000000000.0))]++;
+    count++;
+  }
+
+  // Merges the values of |other|
+  void merge(const LatencyHistogram *other) {
+    for (int i = 0; i < kBuckets; i++)
+      buckets[i] += other->buckets[i];
+    count += other->count;
+  }
+
+  // Returns the latency (in seconds) below which |percentile|
+  // (0.0 - 1.0) of the values are
+  double percentile(double percentile) const {
+    if (count == 0)
+      return (0.0);
+    uint64_t threshold = (uint64_t)(percentile * count);
+    if (threshold == 0)
+      threshold = 1;
+    uint64_t sum = 0;
+    for (int i = 0; i < kBuckets; i++) {
+      sum += buckets[i];
+      if (sum >= threshold)
+        return (upper_bound(i) / 1000000000.0);
+    }
+    return (upper_bound(kBuckets - 1) / 1000000000.0);
+  }
+
+  // Returns the bucket of a value (in nanoseconds)
+  static int index(uint64_t value) {
+    if (value < kSubBuckets)
+      return ((int)value);
+    int exponent = 4;
+    while (exponent < 63 && (value >> (exponent + 1)))
+      exponent++;
+    return ((exponent - 3) * kSubBuckets
+                + (int)((value >> (exponent - 4)) & (kSubBuckets - 1)));
+  }
+
+  // Returns the largest value (in nanoseconds) of a bucket
+  static double upper_bound(int index) {
+    if (index < kSubBuckets)
+      return (index);
+    int exponent = index / kSubBuckets + 3;
+    double lower = (double)(kSubBuckets + index % kSubBuckets)
+                * (double)((uint64_t)1 << (exponent - 4));
+    return (lower + (double)((uint64_t)1 << (exponent - 4)) - 1);
+  }
+
+  uint64_t count;
+  uint64_t buckets[kBuckets];
+};
+
 struct Metrics {
   const char *name;
   uint64_t insert_ops; 
@@ -43,6 +113,26 @@ struct Metrics {
   double txn_commit_latency_min;
   double txn_commit_latency_max;
   double txn_commit_latency_total;
+  uint64_t update_ops;
+  uint64_t scan_ops;
+  uint64_t rmw_ops;
+  uint64_t scan_keys;
+  double update_latency_min;
+  double update_latency_max;
+  double update_latency_total;
+  double scan_latency_min;
+  double scan_latency_max;
+  double scan_latency_total;
+  double rmw_latency_min;
+  double rmw_latency_max;
+  double rmw_latency_total;
+  LatencyHistogram insert_latency_histogram;
+  LatencyHistogram update_latency_histogram;
+  LatencyHistogram erase_latency_histogram;
+  LatencyHistogram find_latency_histogram;
+  LatencyHistogram scan_latency_histogram;
+  LatencyHistogram rmw_latency_histogram;
+  LatencyHistogram txn_commit_latency_histogram;
   ups_env_metrics_t upscaledb_metrics;
 };
 
@@ -72,7 +72,7 @@ UpscaleDatabase::do_create_env()
 {
   ups_status_t st = 0;
   uint32_t flags = 0;
-  ups_parameter_t params[6] = {{0, 0}};
+  ups_parameter_t params[13] = {{0, 0}};
 
   ScopedLock lock(ms_mutex);
 
@@ -92,6 +92,44 @@ UpscaleDatabase::do_create_env()
     params[p].name = UPS_PARAM_POSIX_FADVISE;
     params[p].value = m_config->posix_fadvice;
     p++;
+    params[p].name = UPS_PARAM_CACHE_POLICY;
+    params[p].value = m_config->cache_policy;
+    p++;
+    if (m_config->io_queue_depth) {
+      params[p].name = UPS_PARAM_IO_QUEUE_DEPTH;
+      params[p].value = m_config->io_queue_depth;
+      p++;
+    }
+    if (m_config->group_commit_delay) {
+      params[p].name = UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY;
+      params[p].value = m_config->group_commit_delay;
+      p++;
+    }
+    if (m_config->group_commit_size) {
+      params[p].name = UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE;
+      params[p].value = m_config->group_commit_size;
+      p++;
+    }
+    if (m_config->compressed_cache_size) {
+      params[p].name = UPS_PARAM_COMPRESSED_CACHE_SIZE;
+      params[p].value = m_config->compressed_cache_size;
+      p++;
+    }
+    if (m_config->flush_threads) {
+      params[p].name = UPS_PARAM_FLUSH_THREADS;
+      params[p].value = m_config->flush_threads;
+      p++;
+    }
+    if (m_config->flush_rate_limit) {
+      params[p].name = UPS_PARAM_FLUSH_RATE_LIMIT;
+      params[p].value = m_config->flush_rate_limit;
+      p++;
+    }
+    if (m_config->journal_flush_interval) {
+      params[p].name = UPS_PARAM_JOURNAL_FLUSH_INTERVAL;
+      params[p].value = m_config->journal_flush_interval;
+      p++;
+    }
     if (m_config->use_encryption) {
       params[p].name = UPS_PARAM_ENCRYPTION_KEY;
       params[p].value = (uint64_t)"1234567890123456";
@@ -154,7 +192,7 @@ UpscaleDatabase::do_open_env()
 {
   ups_status_t st = 0;
   uint32_t flags = 0;
-  ups_parameter_t params[6] = {{0, 0}};
+  ups_parameter_t params[13] = {{0, 0}};
 
   ScopedLock lock(ms_mutex);
 
@@ -172,6 +210,44 @@ UpscaleDatabase::do_open_env()
     params[p].name = UPS_PARAM_POSIX_FADVISE;
     params[p].value = m_config->posix_fadvice;
     p++;
+    params[p].name = UPS_PARAM_CACHE_POLICY;
+    params[p].value = m_config->cache_policy;
+    p++;
+    if (m_config->io_queue_depth) {
+      params[p].name = UPS_PARAM_IO_QUEUE_DEPTH;
+      params[p].value = m_config->io_queue_depth;
+      p++;
+    }
+    if (m_config->group_commit_delay) {
+      params[p].name = UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY;
+      params[p].value = m_config->group_commit_delay;
+      p++;
+    }
+    if (m_config->group_commit_size) {
+      params[p].name = UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE;
+      params[p].value = m_config->group_commit_size;
+      p++;
+    }
+    if (m_config->compressed_cache_size) {
+      params[p].name = UPS_PARAM_COMPRESSED_CACHE_SIZE;
+      params[p].value = m_config->compressed_cache_size;
+      p++;
+    }
+    if (m_config->flush_threads) {
+      params[p].name = UPS_PARAM_FLUSH_THREADS;
+      params[p].value = m_config->flush_threads;
+      p++;
+    }
+    if (m_config->flush_rate_limit) {
+      params[p].name = UPS_PARAM_FLUSH_RATE_LIMIT;
+      params[p].value = m_config->flush_rate_limit;
+      p++;
+    }
+    if (m_config->journal_flush_interval) {
+      params[p].name = UPS_PARAM_JOURNAL_FLUSH_INTERVAL;
+      params[p].value = m_config->journal_flush_interval;
+      p++;
+    }
     if (m_config->use_encryption) {
       params[p].name = UPS_PARAM_ENCRYPTION_KEY;
       params[p].value = (uint64_t)"1234567890123456";
@@ -265,7 +341,7 @@ ups_status_t
 UpscaleDatabase::do_create_db(int id)
 {
   ups_status_t st;
-  ups_parameter_t params[8] = {{0, 0}};
+  ups_parameter_t params[10] = {{0, 0}};
 
   int n = 0;
   params[n].name = UPS_PARAM_KEY_SIZE;
@@ -399,7 +475,7 @@ UpscaleDatabase::do_create_db(int id)
 ups_status_t
 UpscaleDatabase::do_open_db(int id)
 {
-  ups_parameter_t params[6] = {{0, 0}};
+  ups_parameter_t params[10] = {{0, 0}};
   ups_register_compare("cmp", compare_keys);
 
   ups_status_t st = ups_env_open_db(m_env ? m_env : ms_env,
@@ -499,7 +575,8 @@ UpscaleDatabase::do_txn_commit(Transaction *txn)
 {
   assert((ups_txn_t *)txn == m_txn);
 
-  ups_status_t st = ups_txn_commit((ups_txn_t *)txn, 0);
+  ups_status_t st = ups_txn_commit((ups_txn_t *)txn,
+                  m_config->async_commit ? UPS_TXN_ASYNC_COMMIT : 0);
   if (st)
     LOG_ERROR(("ups_txn_commit failed with error %d (%s)\n",
                 st, ups_strerror(st)));
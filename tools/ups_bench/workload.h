@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+#ifndef UPS_BENCH_WORKLOAD_H
+#define UPS_BENCH_WORKLOAD_H
+
+#include <cmath>
+#include <cassert>
+#include <boost/cstdint.hpp> // MSVC 2008 does not have stdint
+
+//
+// The operation mix of a YCSB workload (in percent). The workloads are
+// described in "Benchmarking Cloud Serving Systems with YCSB"
+// (Cooper et al., SoCC 2010).
+//
+struct Workload
+{
+  // the name of the workload ('a' - 'f')
+  char name;
+
+  // percentage of lookups
+  int read_pct;
+
+  // percentage of overwrites of existing keys
+  int update_pct;
+
+  // percentage of inserts of new keys
+  int insert_pct;
+
+  // percentage of short range scans
+  int scan_pct;
+
+  // percentage of read-modify-write operations
+  int rmw_pct;
+
+  // Returns the workload with the specified |name|, or null if the
+  // name is unknown
+  static const Workload *get(char name) {
+    static const Workload workloads[] = {
+      // update heavy
+      {'a', 50, 50,  0,  0,  0},
+      // read mostly
+      {'b', 95,  5,  0,  0,  0},
+      // read only
+      {'c', 100, 0,  0,  0,  0},
+      // read latest
+      {'d', 95,  0,  5,  0,  0},
+      // short ranges
+      {'e',  0,  0,  5, 95,  0},
+      // read-modify-write
+      {'f', 50,  0,  0,  0, 50},
+    };
+
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++)
+      if (workloads[i].name == name)
+        return (&workloads[i]);
+    return (0);
+  }
+};
+
+//
+// A bijective mix function; spreads the (sequential) ids of the keys
+// over the whole key space
+//
+inline uint64_t
+workload_mix64(uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return (x);
+}
+
+// the 32bit version of |workload_mix64()|
+inline uint32_t
+workload_mix32(uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x85ebca6bu;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35u;
+  x ^= x >> 16;
+  return (x);
+}
+
+//
+// Zipfian distribution over the integers [0, items). Based on the
+// algorithm of Gray et al. ("Quickly Generating Billion-Record Synthetic
+// Databases", SIGMOD 1994), which is also used by YCSB. In contrast to
+// the ZipfianGenerator in datasource_numeric.h, the number of items
+// can grow, and no values are precomputed.
+//
+struct IncrementalZipfianGenerator
+{
+  IncrementalZipfianGenerator(uint64_t items, double theta = 0.99)
+    : items_(0), theta_(theta), zetan_(0) {
+    zeta2_ = 1.0 + 1.0 / std::pow(2.0, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    grow(items);
+  }
+
+  // Increases the number of items to |items|; the zeta constant is
+  // updated incrementally
+  void grow(uint64_t items) {
+    if (items <= items_)
+      return;
+    for (uint64_t i = items_; i < items; i++)
+      zetan_ += 1.0 / std::pow((double)(i + 1), theta_);
+    items_ = items;
+    eta_ = (1.0 - std::pow(2.0 / items_, 1.0 - theta_))
+                / (1.0 - zeta2_ / zetan_);
+  }
+
+  // Returns the next value; |u| is uniformly distributed in [0, 1).
+  // Small values are the most popular ones.
+  uint64_t next(double u) const {
+    double uz = u * zetan_;
+    if (uz < 1.0)
+      return (0);
+    if (uz < 1.0 + std::pow(0.5, theta_))
+      return (items_ > 1 ? 1 : 0);
+    uint64_t value = (uint64_t)(items_
+                        * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    return (value < items_ ? value : items_ - 1);
+  }
+
+  uint64_t items_;
+  double theta_;
+  double zetan_;
+  double zeta2_;
+  double alpha_;
+  double eta_;
+};
+
+//
+// Chooses the ids of existing keys for the lookups, updates and scans
+// of a workload. The keys have the ids [0, count).
+//
+struct KeyChooser
+{
+  // virtual destructor - can be overwritten
+  virtual ~KeyChooser() {
+  }
+
+  // Returns the next id; |u| is uniformly distributed in [0, 1)
+  virtual uint64_t next(double u, uint64_t count) = 0;
+};
+
+//
+// Each key is chosen with the same probability
+//
+struct UniformKeyChooser : public KeyChooser
+{
+  // Returns the next id
+  virtual uint64_t next(double u, uint64_t count) {
+    uint64_t id = (uint64_t)(u * count);
+    return (id < count ? id : count - 1);
+  }
+};
+
+//
+// A few keys are very popular, the majority of the keys is rarely used.
+// The popular keys are scattered over the key space.
+//
+struct ZipfianKeyChooser : public KeyChooser
+{
+  ZipfianKeyChooser(uint64_t count)
+    : zipf_(count) {
+  }
+
+  // Returns the next id
+  virtual uint64_t next(double u, uint64_t count) {
+    zipf_.grow(count);
+    return (workload_mix64(zipf_.next(u)) % count);
+  }
+
+  IncrementalZipfianGenerator zipf_;
+};
+
+//
+// The most recently inserted keys are the most popular ones
+//
+struct LatestKeyChooser : public KeyChooser
+{
+  LatestKeyChooser(uint64_t count)
+    : zipf_(count) {
+  }
+
+  // Returns the next id
+  virtual uint64_t next(double u, uint64_t count) {
+    zipf_.grow(count);
+    return (count - 1 - zipf_.next(u));
+  }
+
+  IncrementalZipfianGenerator zipf_;
+};
+
+#endif /* UPS_BENCH_WORKLOAD_H */
@@ -82,7 +82,7 @@ class BinaryImporter : public Importer {
   public:
     BinaryImporter(FILE *f, ups_env_t *env, const char *outfilename)
       : Importer(f, env, outfilename), m_db(0), m_insert_flags(0),
-        m_db_counter(0), m_item_counter(0) {
+        m_db_counter(0), m_item_counter(0), m_has_pending(false) {
       m_buffer = (char *)malloc(1024 * 1024);
     }
 
@@ -95,33 +95,19 @@ class BinaryImporter : public Importer {
     }
 
     virtual void run() {
-      while (!feof(m_f)) {
-        // read the next message from the stream
-        uint32_t size = read_size();
-        if (!size)
-          return;
-
-        m_buffer = (char *)realloc(0, size);
-        if (size != fread(m_buffer, 1, size, m_f)) {
-          fprintf(stderr, "Error reading %u bytes: %s\n", size,
-                  strerror(errno));
-          exit(-1);
-        }
-
-        // unpack serialized datum
-        HamsterTool::Datum datum;
-        datum.ParseFromArray(m_buffer, size);
+      while (m_has_pending || read_datum()) {
+        m_has_pending = false;
 
-        switch (datum.type()) {
+        switch (m_datum.type()) {
           case HamsterTool::Datum::ENVIRONMENT:
-            read_environment(datum);
+            read_environment(m_datum);
             break;
           case HamsterTool::Datum::DATABASE:
-            read_database(datum);
+            read_database(m_datum);
             m_db_counter++;
             break;
           case HamsterTool::Datum::ITEM:
-            read_item(datum);
+            read_item(m_datum);
             m_item_counter++;
             break;
           default:
@@ -193,6 +179,34 @@ class BinaryImporter : public Importer {
       st = ups_env_create_db(m_env, &m_db, db.name(), db.flags(), &params[0]);
       if (st)
         error("ups_env_create_db", st);
+
+      // the database is new and empty, and the exported items are sorted:
+      // load them with a bulk load instead of inserting them one by one
+      st = ups_db_bulk_load(m_db, bulk_load_item, this, 0, 0);
+      if (st)
+        error("ups_db_bulk_load", st);
+    }
+
+    // Callback for ups_db_bulk_load; returns the next item of the stream.
+    // Stops at the first datum which is not an item.
+    static ups_status_t UPS_CALLCONV
+    bulk_load_item(ups_db_t *db, ups_key_t *key, ups_record_t *record,
+                    void *context) {
+      BinaryImporter *importer = (BinaryImporter *)context;
+      if (!importer->read_datum())
+        return (UPS_KEY_NOT_FOUND);
+      if (importer->m_datum.type() != HamsterTool::Datum::ITEM) {
+        importer->m_has_pending = true;
+        return (UPS_KEY_NOT_FOUND);
+      }
+
+      const HamsterTool::Item &item = importer->m_datum.item();
+      key->data = (void *)item.key().data();
+      key->size = item.key().size();
+      record->data = (void *)item.record().data();
+      record->size = item.record().size();
+      importer->m_item_counter++;
+      return (0);
     }
 
     void read_item(HamsterTool::Datum &datum) {
@@ -213,6 +227,27 @@ class BinaryImporter : public Importer {
         error("ups_db_insert", st);
     }
 
+    // Reads the next message from the stream; returns false at the end
+    bool read_datum() {
+      if (feof(m_f))
+        return (false);
+
+      uint32_t size = read_size();
+      if (!size)
+        return (false);
+
+      m_buffer = (char *)realloc(m_buffer, size);
+      if (size != fread(m_buffer, 1, size, m_f)) {
+        fprintf(stderr, "Error reading %u bytes: %s\n", size,
+                strerror(errno));
+        exit(-1);
+      }
+
+      // unpack serialized datum
+      m_datum.ParseFromArray(m_buffer, size);
+      return (true);
+    }
+
     uint32_t read_size() {
       int n;
       uint32_t size;
@@ -232,6 +267,8 @@ class BinaryImporter : public Importer {
     uint32_t m_insert_flags;
     size_t m_db_counter;
     size_t m_item_counter;
+    HamsterTool::Datum m_datum;
+    bool m_has_pending;
 };
 
 int
@@ -96,6 +96,10 @@ get_compressor_name(int library) {
       return ("for");
     case UPS_COMPRESSOR_UINT32_MASKEDVBYTE:
       return ("maskedvbyte");
+    case UPS_COMPRESSOR_UINT64_VARBYTE:
+      return ("varbyte64");
+    case UPS_COMPRESSOR_UINT64_FOR:
+      return ("for64");
     default:
       return ("???");
   }
@@ -20,11 +20,13 @@
 #include <stdlib.h>
 
 #include <ups/upscaledb.h>
+#include <ups/upscaledb_int.h>
 
 #include "getopts.h"
 #include "common.h"
 
 #define ARG_HELP      1
+#define ARG_THREADS   2
 
 /*
  * command line parameters
@@ -36,6 +38,12 @@ static option_t opts[] = {
     "help",         // long option
     "this help screen",   // help string
     0 },          // no flags
+  {
+    ARG_THREADS,
+    "t",
+    "threads",
+    "number of recovery threads",
+    GETOPTS_NEED_ARGUMENT },
   { 0, 0, 0, 0, 0 } /* terminating element */
 };
 
@@ -49,6 +57,8 @@ int
 main(int argc, char **argv) {
   unsigned opt;
   const char *param, *filename = 0;
+  char *endptr = 0;
+  uint32_t threads = 0;
 
   ups_status_t st;
   ups_env_t *env;
@@ -65,12 +75,21 @@ main(int argc, char **argv) {
         }
         filename = param;
         break;
+      case ARG_THREADS:
+        threads = (uint32_t)strtoul(param, &endptr, 0);
+        if (endptr && *endptr) {
+          printf("Invalid parameter `threads'; numerical value "
+             "expected.\n");
+          return (-1);
+        }
+        break;
       case ARG_HELP:
         print_banner("ups_recover");
 
-        printf("usage: ups_recover file\n");
+        printf("usage: ups_recover [-t=N] file\n");
         printf("usage: ups_recover -h\n");
         printf("     -h:     this help screen (alias: --help)\n");
+        printf("     -t=N:   use N recovery threads (alias: --threads=N)\n");
         return (0);
       default:
         printf("Invalid or unknown parameter `%s'. "
@@ -98,11 +117,24 @@ main(int argc, char **argv) {
     error("ups_env_open", st);
 
   /* now start the recovery */
+  ups_parameter_t params[] = {
+    {UPS_PARAM_RECOVERY_THREADS, threads},
+    {0, 0}
+  };
   st = ups_env_open(&env, filename,
-        UPS_AUTO_RECOVERY | UPS_ENABLE_TRANSACTIONS, 0);
+        UPS_AUTO_RECOVERY | UPS_ENABLE_TRANSACTIONS, &params[0]);
   if (st)
     error("ups_env_open", st);
 
+  ups_env_metrics_t metrics;
+  st = ups_env_get_metrics(env, &metrics);
+  if (st)
+    error("ups_env_get_metrics", st);
+  printf("Recovered `%s' in %.3f sec (%llu pages, %llu operations)\n",
+        filename, metrics.journal_recovery_time_usec / 1000000.0,
+        (unsigned long long)metrics.journal_recovered_pages,
+        (unsigned long long)metrics.journal_recovered_operations);
+
   /* we're already done */
   st = ups_env_close(env, 0);
   if (st != UPS_SUCCESS)
@@ -835,6 +835,10 @@ main(int argc, char **argv) {
   if (params) {
     cfg.port = params->globals.port;
     hlog(LOG_DBG, "Config: port is %u\n", cfg.port);
+    cfg.io_threads = params->globals.io_threads;
+    cfg.worker_threads = params->globals.worker_threads;
+    hlog(LOG_DBG, "Config: %u io threads, %u worker threads\n",
+        cfg.io_threads, cfg.worker_threads);
     if (params->globals.enable_access_log) {
       cfg.access_log_path = params->globals.access_log;
       hlog(LOG_DBG, "Config: http access hlog is %s\n",
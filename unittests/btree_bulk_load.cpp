@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2005-2016 Christoph Rupp (chris@crupp.de).
+ * All Rights Reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * See the file COPYING for License information.
+ */
+
+#include "3rdparty/catch/catch.hpp"
+
+#include "utils.h"
+#include "os.hpp"
+
+#include "4env/env_local.h"
+
+using namespace upscaledb;
+
+// Generates the keys |begin| .. |end| - 1 for ups_db_bulk_load. Each key
+// has |duplicates| records. If |binary| is true then the keys are
+// 20-byte strings, otherwise 32bit integers.
+struct BulkLoadGenerator {
+  BulkLoadGenerator(uint32_t begin_, uint32_t end_, bool binary_ = false,
+                  int duplicates_ = 1)
+    : current(begin_), end(end_), binary(binary_), duplicates(duplicates_),
+      duplicate(0), status(0) {
+  }
+
+  static ups_status_t UPS_CALLCONV
+  next(ups_db_t *db, ups_key_t *key, ups_record_t *record, void *context) {
+    BulkLoadGenerator *g = (BulkLoadGenerator *)context;
+    if (g->status)
+      return g->status;
+    if (g->current >= g->end)
+      return UPS_KEY_NOT_FOUND;
+
+    if (g->binary) {
+      ::sprintf(g->key_buffer, "%020u", g->current);
+      *key = ups_make_key(g->key_buffer, 20);
+    }
+    else {
+      g->key_value = g->current;
+      *key = ups_make_key(&g->key_value, sizeof(g->key_value));
+    }
+    g->record_value = g->current * 10 + g->duplicate;
+    *record = ups_make_record(&g->record_value, sizeof(g->record_value));
+
+    if (++g->duplicate == g->duplicates) {
+      g->duplicate = 0;
+      g->current++;
+    }
+    return 0;
+  }
+
+  uint32_t current;
+  uint32_t end;
+  bool binary;
+  int duplicates;
+  int duplicate;
+  ups_status_t status;
+  uint32_t key_value;
+  uint32_t record_value;
+  char key_buffer[32];
+};
+
+struct BulkLoadFixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  BulkLoadFixture(uint32_t env_flags = 0, uint32_t db_flags = 0,
+                  uint32_t key_type = UPS_TYPE_UINT32)
+    : m_db(0), m_env(0) {
+    ups_parameter_t env_params[] = {
+      { UPS_PARAM_PAGESIZE, 1024 },
+      { 0, 0 }
+    };
+    ups_parameter_t db_params[] = {
+      { UPS_PARAM_KEY_TYPE, key_type },
+      { 0, 0 }
+    };
+    if (key_type == 0)
+      db_params[0].name = 0;
+
+    os::unlink(Utils::opath(".test"));
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"), env_flags,
+                            0644, &env_params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, db_flags,
+                            &db_params[0]));
+  }
+
+  ~BulkLoadFixture() {
+    if (m_env)
+      REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  uint64_t index_pages() {
+    ups_env_metrics_t metrics = {0};
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    return metrics.page_count_type_index;
+  }
+
+  void verify(uint32_t count, bool binary = false, int duplicates = 1) {
+    REQUIRE(0 == ups_db_check_integrity(m_db, 0));
+
+    uint64_t keys = 0;
+    REQUIRE(0 == ups_db_count(m_db, 0, 0, &keys));
+    REQUIRE(keys == (uint64_t)count * duplicates);
+
+    // all keys are returned in the correct order
+    ups_cursor_t *cursor;
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    REQUIRE(0 == ups_cursor_create(&cursor, m_db, 0, 0));
+    for (uint32_t i = 0; i < count; i++) {
+      for (int d = 0; d < duplicates; d++) {
+        REQUIRE(0 == ups_cursor_move(cursor, &key, &record,
+                                UPS_CURSOR_NEXT));
+        if (binary) {
+          char buffer[32];
+          ::sprintf(buffer, "%020u", i);
+          REQUIRE(key.size == 20);
+          REQUIRE(0 == ::memcmp(key.data, buffer, 20));
+        }
+        else
+          REQUIRE(*(uint32_t *)key.data == i);
+        REQUIRE(*(uint32_t *)record.data == i * 10 + d);
+      }
+    }
+    REQUIRE(UPS_KEY_NOT_FOUND == ups_cursor_move(cursor, &key, &record,
+                                UPS_CURSOR_NEXT));
+    REQUIRE(0 == ups_cursor_close(cursor));
+
+    // point lookups
+    for (uint32_t i = 0; i < count; i += 97) {
+      char buffer[32];
+      if (binary) {
+        ::sprintf(buffer, "%020u", i);
+        key = ups_make_key(buffer, 20);
+      }
+      else
+        key = ups_make_key(&i, sizeof(i));
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(*(uint32_t *)record.data == i * 10);
+    }
+  }
+
+  void reopen(uint32_t env_flags = 0) {
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 == ups_env_open(&m_env, Utils::opath(".test"), env_flags, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+  }
+
+  void uint32Test() {
+    const uint32_t kCount = 50000;
+    BulkLoadGenerator g(0, kCount);
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+    verify(kCount);
+    reopen();
+    verify(kCount);
+  }
+
+  void binaryTest() {
+    const uint32_t kCount = 20000;
+    BulkLoadGenerator g(0, kCount, true);
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+    verify(kCount, true);
+    reopen();
+    verify(kCount, true);
+  }
+
+  void fillFactorTest() {
+    const uint32_t kCount = 20000;
+    uint64_t before = index_pages();
+    BulkLoadGenerator g(0, kCount);
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 50, 0));
+    uint64_t half_filled = index_pages() - before;
+    verify(kCount);
+
+    // a second database is loaded with completely filled pages, and
+    // requires about half as many pages
+    ups_db_t *db2;
+    ups_parameter_t params[] = {
+      { UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32 },
+      { 0, 0 }
+    };
+    REQUIRE(0 == ups_env_create_db(m_env, &db2, 2, 0, &params[0]));
+    before = index_pages();
+    BulkLoadGenerator g2(0, kCount);
+    REQUIRE(0 == ups_db_bulk_load(db2, BulkLoadGenerator::next, &g2, 100, 0));
+    uint64_t filled = index_pages() - before;
+    REQUIRE(0 == ups_db_check_integrity(db2, 0));
+    uint64_t expected = filled * 3 / 2;
+    REQUIRE(expected < half_filled);
+
+    // and it requires fewer pages than regular inserts
+    ups_db_t *db3;
+    REQUIRE(0 == ups_env_create_db(m_env, &db3, 3, 0, &params[0]));
+    before = index_pages();
+    for (uint32_t i = 0; i < kCount; i++) {
+      uint32_t k = (i * 7919) % kCount; // random order
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t record = ups_make_record(&k, sizeof(k));
+      REQUIRE(0 == ups_db_insert(db3, 0, &key, &record, 0));
+    }
+    uint64_t inserted = index_pages() - before;
+    REQUIRE(filled < inserted);
+  }
+
+  void duplicateTest() {
+    const uint32_t kCount = 5000;
+    BulkLoadGenerator g(0, kCount, false, 5);
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+    verify(kCount, false, 5);
+    reopen();
+    verify(kCount, false, 5);
+  }
+
+  void transactionTest() {
+    const uint32_t kCount = 20000;
+
+    // a committed transaction in another database is flushed
+    ups_db_t *db2;
+    ups_txn_t *txn;
+    uint32_t k = 1;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t record = ups_make_record(&k, sizeof(k));
+    REQUIRE(0 == ups_env_create_db(m_env, &db2, 2, 0, 0));
+    REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+    REQUIRE(0 == ups_db_insert(db2, txn, &key, &record, 0));
+
+    // ... but an active transaction blocks the bulk load
+    BulkLoadGenerator g(0, kCount);
+    REQUIRE(UPS_TXN_STILL_OPEN
+                == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+    REQUIRE(0 == ups_txn_commit(txn, 0));
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+    verify(kCount);
+
+    // insert and erase keys after the load
+    for (uint32_t i = kCount; i < kCount + 100; i++) {
+      uint32_t r = i * 10;
+      key = ups_make_key(&i, sizeof(i));
+      record = ups_make_record(&r, sizeof(r));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+    for (uint32_t i = kCount; i < kCount + 100; i++) {
+      key = ups_make_key(&i, sizeof(i));
+      REQUIRE(0 == ups_db_erase(m_db, 0, &key, 0));
+    }
+
+    reopen(UPS_ENABLE_TRANSACTIONS);
+    verify(kCount);
+    REQUIRE(0 == ups_env_open_db(m_env, &db2, 2, 0, 0));
+    key = ups_make_key(&k, sizeof(k));
+    REQUIRE(0 == ups_db_find(db2, 0, &key, &record, 0));
+  }
+
+  void recnoTest() {
+    const uint32_t kCount = 1000;
+    BulkLoadGenerator g(1, kCount + 1);
+    REQUIRE(0 == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+
+    // the next record number follows the loaded keys
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    REQUIRE(*(uint32_t *)key.data == kCount + 1);
+    REQUIRE(0 == ups_db_check_integrity(m_db, 0));
+  }
+
+  void negativeTest() {
+    BulkLoadGenerator g(0, 10);
+    REQUIRE(UPS_INV_PARAMETER
+                == ups_db_bulk_load(0, BulkLoadGenerator::next, &g, 0, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_db_bulk_load(m_db, 0, &g, 0, 0));
+    REQUIRE(UPS_INV_PARAMETER
+                == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g,
+                        101, 0));
+
+    // errors of the callback are returned
+    g.status = UPS_IO_ERROR;
+    REQUIRE(UPS_IO_ERROR
+                == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+
+    // the database is no longer empty
+    uint32_t k = 1;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t record = ups_make_record(&k, sizeof(k));
+    REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    g.status = 0;
+    REQUIRE(UPS_INV_PARAMETER
+                == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+  }
+
+  void unsortedTest() {
+    struct Unsorted {
+      static ups_status_t UPS_CALLCONV
+      next(ups_db_t *db, ups_key_t *key, ups_record_t *record, void *ctxt) {
+        static uint32_t keys[] = {1, 2, 3, 2};
+        int *i = (int *)ctxt;
+        if (*i == 4)
+          return UPS_KEY_NOT_FOUND;
+        *key = ups_make_key(&keys[*i], sizeof(uint32_t));
+        *record = ups_make_record(0, 0);
+        (*i)++;
+        return 0;
+      }
+    };
+
+    int i = 0;
+    REQUIRE(UPS_INV_PARAMETER
+                == ups_db_bulk_load(m_db, Unsorted::next, &i, 0, 0));
+  }
+
+  void duplicateKeyTest() {
+    BulkLoadGenerator g(0, 10, false, 2);
+    REQUIRE(UPS_DUPLICATE_KEY
+                == ups_db_bulk_load(m_db, BulkLoadGenerator::next, &g, 0, 0));
+  }
+};
+
+TEST_CASE("BtreeBulkLoad/uint32Test", "")
+{
+  BulkLoadFixture f;
+  f.uint32Test();
+}
+
+TEST_CASE("BtreeBulkLoad/binaryTest", "")
+{
+  BulkLoadFixture f(0, 0, UPS_TYPE_BINARY);
+  f.binaryTest();
+}
+
+TEST_CASE("BtreeBulkLoad/fillFactorTest", "")
+{
+  BulkLoadFixture f;
+  f.fillFactorTest();
+}
+
+TEST_CASE("BtreeBulkLoad/duplicateTest", "")
+{
+  BulkLoadFixture f(0, UPS_ENABLE_DUPLICATE_KEYS);
+  f.duplicateTest();
+}
+
+TEST_CASE("BtreeBulkLoad/transactionTest", "")
+{
+  BulkLoadFixture f(UPS_ENABLE_TRANSACTIONS);
+  f.transactionTest();
+}
+
+TEST_CASE("BtreeBulkLoad/recnoTest", "")
+{
+  BulkLoadFixture f(0, UPS_RECORD_NUMBER32, 0);
+  f.recnoTest();
+}
+
+TEST_CASE("BtreeBulkLoad/negativeTest", "")
+{
+  BulkLoadFixture f;
+  f.negativeTest();
+}
+
+TEST_CASE("BtreeBulkLoad/unsortedTest", "")
+{
+  BulkLoadFixture f;
+  f.unsortedTest();
+}
+
+TEST_CASE("BtreeBulkLoad/duplicateKeyTest", "")
+{
+  BulkLoadFixture f;
+  f.duplicateKeyTest();
+}
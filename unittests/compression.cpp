@@ -17,6 +17,10 @@
 
 #include "3rdparty/catch/catch.hpp"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "utils.h"
 
 #include "1base/dynamic_array.h"
@@ -473,3 +477,164 @@ TEST_CASE("Compression/unknownCompressorTest", "")
 
   REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
 }
+
+static std::string
+prefix_key(int i)
+{
+  char buffer[512];
+  if (i % 50 == 0) // a few keys with a different prefix
+    ::sprintf(buffer, "ftp://upscaledb.com/%06d", i);
+  else
+    ::sprintf(buffer, "http://www.upscaledb.com/docs/%06d", i);
+  std::string s(buffer);
+  if (i % 100 == 1) // and a few extended keys
+    s.append(300, 'x');
+  return s;
+}
+
+static ups_key_t
+string_key(const std::string &s)
+{
+  ups_key_t key = ups_make_key((void *)s.data(), (uint16_t)s.size());
+  return key;
+}
+
+static void
+prefix_key_test(uint32_t page_size)
+{
+  ups_parameter_t env_params[] = {
+    {UPS_PARAM_PAGE_SIZE, page_size},
+    {0, 0}
+  };
+  ups_parameter_t params[] = {
+    {UPS_PARAM_KEY_COMPRESSION, UPS_COMPRESSOR_PREFIX},
+    {0, 0}
+  };
+  ups_db_t *db;
+  ups_env_t *env;
+  REQUIRE(0 == ups_env_create(&env, Utils::opath("test.db"), 0, 0,
+                          &env_params[0]));
+  REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, &params[0]));
+
+  const int count = 5000;
+  std::vector<std::string> keys;
+  for (int i = 0; i < count; i++)
+    keys.push_back(prefix_key(i));
+
+  // insert in pseudo-random order
+  for (int i = 0; i < count; i++) {
+    int j = (i * 7919) % count;
+    ups_key_t key = string_key(keys[j]);
+    ups_record_t rec = ups_make_record(&j, sizeof(j));
+    REQUIRE(0 == ups_db_insert(db, 0, &key, &rec, 0));
+  }
+  REQUIRE(0 == ups_db_check_integrity(db, 0));
+
+  // lookup
+  for (int i = 0; i < count; i++) {
+    ups_key_t key = string_key(keys[i]);
+    ups_record_t rec = {0};
+    REQUIRE(0 == ups_db_find(db, 0, &key, &rec, 0));
+    REQUIRE(rec.size == sizeof(int));
+    REQUIRE(i == *(int *)rec.data);
+  }
+
+  // keys which do not exist, and approximate matching
+  std::string missing = "http://www.upscaledb.com/docs/000002a";
+  ups_key_t key = string_key(missing);
+  ups_record_t rec = {0};
+  REQUIRE(UPS_KEY_NOT_FOUND == ups_db_find(db, 0, &key, &rec, 0));
+  REQUIRE(0 == ups_db_find(db, 0, &key, &rec, UPS_FIND_GEQ_MATCH));
+  REQUIRE(3 == *(int *)rec.data);
+  missing = "http://www.upscaledb";
+  key = string_key(missing);
+  REQUIRE(UPS_KEY_NOT_FOUND == ups_db_find(db, 0, &key, &rec, 0));
+
+  // a cursor returns all keys in sorted order
+  std::vector<std::string> sorted(keys);
+  std::sort(sorted.begin(), sorted.end());
+  ups_cursor_t *cursor;
+  REQUIRE(0 == ups_cursor_create(&cursor, db, 0, 0));
+  for (int i = 0; i < count; i++) {
+    REQUIRE(0 == ups_cursor_move(cursor, &key, &rec, UPS_CURSOR_NEXT));
+    REQUIRE(std::string((const char *)key.data, key.size) == sorted[i]);
+  }
+  REQUIRE(UPS_KEY_NOT_FOUND == ups_cursor_move(cursor, &key, &rec,
+                          UPS_CURSOR_NEXT));
+  REQUIRE(0 == ups_cursor_close(cursor));
+
+  // the keys use less space than without compression
+  ups_env_metrics_t metrics;
+  REQUIRE(0 == ups_env_get_metrics(env, &metrics));
+  REQUIRE(metrics.key_bytes_after_compression
+                  < metrics.key_bytes_before_compression);
+
+  // erase every second key (this triggers merges)
+  for (int i = 0; i < count; i += 2) {
+    key = string_key(keys[i]);
+    REQUIRE(0 == ups_db_erase(db, 0, &key, 0));
+  }
+  REQUIRE(0 == ups_db_check_integrity(db, 0));
+
+  REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+
+  // reopen and verify
+  REQUIRE(0 == ups_env_open(&env, Utils::opath("test.db"), 0, 0));
+  REQUIRE(0 == ups_env_open_db(env, &db, 1, 0, 0));
+
+  params[0].value = 0;
+  REQUIRE(0 == ups_db_get_parameters(db, &params[0]));
+  REQUIRE(UPS_COMPRESSOR_PREFIX == (int)params[0].value);
+
+  for (int i = 0; i < count; i++) {
+    key = string_key(keys[i]);
+    if (i % 2 == 0)
+      REQUIRE(UPS_KEY_NOT_FOUND == ups_db_find(db, 0, &key, &rec, 0));
+    else {
+      REQUIRE(0 == ups_db_find(db, 0, &key, &rec, 0));
+      REQUIRE(i == *(int *)rec.data);
+    }
+  }
+  REQUIRE(0 == ups_db_check_integrity(db, 0));
+
+  REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+}
+
+TEST_CASE("Compression/prefixKeyTest", "")
+{
+  prefix_key_test(1024 * 16);
+}
+
+TEST_CASE("Compression/prefixKeySmallPageTest", "")
+{
+  prefix_key_test(1024);
+}
+
+TEST_CASE("Compression/negativePrefixKeyTest", "")
+{
+  ups_parameter_t param1[] = {
+    {UPS_PARAM_KEY_COMPRESSION, UPS_COMPRESSOR_PREFIX},
+    {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT64},
+    {0, 0}
+  };
+
+  ups_parameter_t param2[] = {
+    {UPS_PARAM_KEY_COMPRESSION, UPS_COMPRESSOR_PREFIX},
+    {UPS_PARAM_KEY_SIZE, 16},
+    {0, 0}
+  };
+
+  ups_parameter_t param3[] = {
+    {UPS_PARAM_RECORD_COMPRESSION, UPS_COMPRESSOR_PREFIX},
+    {0, 0}
+  };
+
+  ups_db_t *db;
+  ups_env_t *env;
+
+  REQUIRE(0 == ups_env_create(&env, Utils::opath("test.db"), 0, 0, 0));
+  REQUIRE(UPS_INV_PARAMETER == ups_env_create_db(env, &db, 1, 0, &param1[0]));
+  REQUIRE(UPS_INV_PARAMETER == ups_env_create_db(env, &db, 1, 0, &param2[0]));
+  REQUIRE(UPS_INV_PARAMETER == ups_env_create_db(env, &db, 1, 0, &param3[0]));
+  REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+}
@@ -18,6 +18,7 @@
 #include "3rdparty/catch/catch.hpp"
 
 #include "2device/device.h"
+#include "2device/device_uring.h"
 #include "4env/env_local.h"
 
 #include "utils.h"
@@ -31,12 +32,16 @@ struct DeviceFixture
   ups_env_t *m_env;
   Device *m_dev;
 
-  DeviceFixture(bool inmemory) {
+  DeviceFixture(bool inmemory, uint32_t io_queue_depth = 0) {
     (void)os::unlink(Utils::opath(".test"));
 
+    ups_parameter_t params[] = {
+        {UPS_PARAM_IO_QUEUE_DEPTH, io_queue_depth},
+        {0, 0}
+    };
     REQUIRE(0 ==
         ups_env_create(&m_env, Utils::opath(".test"),
-            inmemory ? UPS_IN_MEMORY : 0, 0644, 0));
+            inmemory ? UPS_IN_MEMORY : 0, 0644, &params[0]));
     REQUIRE(0 ==
         ups_env_create_db(m_env, &m_db, 1, 0, 0));
     m_dev = ((LocalEnvironment *)m_env)->device();
@@ -195,6 +200,97 @@ struct DeviceFixture
       delete pages[i];
     }
   }
+
+  void writePagesTest() {
+    const int kNumPages = 40;
+    std::vector<Page *> pages;
+    uint32_t ps = UPS_DEFAULT_PAGE_SIZE;
+
+    EnvConfig &cfg = const_cast<EnvConfig &>(((LocalEnvironment *)m_env)->config());
+    cfg.flags |= UPS_DISABLE_MMAP;
+
+    REQUIRE(1 == m_dev->is_open());
+    m_dev->truncate(ps * kNumPages);
+    // the batch is flushed in reverse order; Page::flush sorts it
+    for (int i = kNumPages - 1; i >= 0; i--) {
+      Page *page = new Page(((LocalEnvironment *)m_env)->device());
+      page->set_address(ps * i);
+      m_dev->read_page(page, ps * i);
+      memset(page->payload(), i + 1, ps - Page::kSizeofPersistentHeader);
+      // every third page stays clean and is not written (except for the
+      // first two pages, which are not empty)
+      page->set_dirty(i < 2 || i % 3 != 0);
+      pages.push_back(page);
+    }
+    Page::flush(pages);
+    for (int i = 0; i < kNumPages; i++) {
+      REQUIRE(pages[i]->is_dirty() == false);
+      delete pages[i];
+    }
+
+    for (int i = 0; i < kNumPages; i++) {
+      char temp[UPS_DEFAULT_PAGE_SIZE];
+      memset(temp, i < 2 || i % 3 != 0 ? i + 1 : 0, sizeof(temp));
+      Page page(((LocalEnvironment *)m_env)->device());
+      page.set_address(ps * i);
+      m_dev->read_page(&page, ps * i);
+      REQUIRE(0 == memcmp(page.payload(), temp,
+                              ps - Page::kSizeofPersistentHeader));
+    }
+  }
+
+  void uringParameterTest() {
+    ups_parameter_t params[] = {
+        {UPS_PARAM_IO_QUEUE_DEPTH, 0},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(16u == params[0].value);
+    REQUIRE(dynamic_cast<UringDevice *>(m_dev) != 0);
+  }
+
+  void uringInvalidParameterTest() {
+    ups_env_t *env;
+    ups_parameter_t params[] = {
+        {UPS_PARAM_IO_QUEUE_DEPTH, IoUring::kMaxQueueDepth + 1},
+        {0, 0}
+    };
+    REQUIRE(UPS_INV_PARAMETER ==
+        ups_env_create(&env, Utils::opath(".test2"), 0, 0644, &params[0]));
+  }
+
+  void uringInsertFindTest() {
+    const int kNumKeys = 20000;
+    ups_parameter_t params[] = {
+        {UPS_PARAM_CACHE_SIZE, 64 * 1024},
+        {UPS_PARAM_IO_QUEUE_DEPTH, 16},
+        {0, 0}
+    };
+
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+
+    // the small cache forces page flushes and cache misses
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"),
+                            UPS_DISABLE_MMAP, 0644, &params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, 0, 0));
+    for (int i = 0; i < kNumKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&i, sizeof(i));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+
+    REQUIRE(0 == ups_env_open(&m_env, Utils::opath(".test"),
+                            UPS_DISABLE_MMAP, &params[0]));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    for (int i = 0; i < kNumKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(record.size == sizeof(i));
+      REQUIRE(*(int *)record.data == i);
+    }
+  }
 };
 
 TEST_CASE("Device/newDelete", "")
@@ -251,6 +347,50 @@ TEST_CASE("Device/readWritePage", "")
   f. readWritePageTest();
 }
 
+TEST_CASE("Device/writePages", "")
+{
+  DeviceFixture f(false);
+  f. writePagesTest();
+}
+
+#ifdef HAVE_LINUX_IO_URING_H
+TEST_CASE("Device-uring/createClose", "")
+{
+  DeviceFixture f(false, 16);
+  f. createCloseTest();
+}
+
+TEST_CASE("Device-uring/readWritePage", "")
+{
+  DeviceFixture f(false, 16);
+  f. readWritePageTest();
+}
+
+TEST_CASE("Device-uring/writePages", "")
+{
+  DeviceFixture f(false, 16);
+  f. writePagesTest();
+}
+
+TEST_CASE("Device-uring/parameter", "")
+{
+  DeviceFixture f(false, 16);
+  f. uringParameterTest();
+}
+
+TEST_CASE("Device-uring/invalidParameter", "")
+{
+  DeviceFixture f(false, 16);
+  f. uringInvalidParameterTest();
+}
+
+TEST_CASE("Device-uring/insertFind", "")
+{
+  DeviceFixture f(false, 16);
+  f. uringInsertFindTest();
+}
+#endif
+
 
 TEST_CASE("Device-inmem/newDelete", "")
 {
@@ -17,6 +17,9 @@
 
 #include "3rdparty/catch/catch.hpp"
 
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
 #include "2lsn_manager/lsn_manager.h"
 #include "3journal/journal.h"
 #include "4txn/txn.h"
@@ -75,6 +78,29 @@ struct EraseLogEntry : public LogEntry {
   ups_key_t *key;
 };
 
+// Commits |count| small transactions; used by
+// JournalFixture::groupCommitTest(). Catch's macros are not thread-safe,
+// therefore errors are only counted.
+static void
+group_committer(ups_env_t *env, ups_db_t *db, int id, int count,
+                boost::atomic<int> *errors)
+{
+  for (int i = 0; i < count; i++) {
+    int k = id * count + i;
+    ups_txn_t *txn;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t rec = ups_make_record(&k, sizeof(k));
+    if (ups_txn_begin(&txn, env, 0, 0, 0) != 0) {
+      (*errors)++;
+      continue;
+    }
+    if (ups_db_insert(db, txn, &key, &rec, 0) != 0)
+      (*errors)++;
+    if (ups_txn_commit(txn, 0) != 0)
+      (*errors)++;
+  }
+}
+
 struct JournalFixture {
   ups_db_t *m_db;
   ups_env_t *m_env;
@@ -1356,6 +1382,419 @@ struct JournalFixture {
 
     m_env = 0; // do not close again when tearing down
   }
+  void groupCommitTest() {
+    teardown();
+
+    const int kThreads = 4;
+    const int kCommits = 50;
+    ups_parameter_t params[] = {
+      {UPS_PARAM_JOURNAL_GROUP_COMMIT_DELAY, 2000},
+      {UPS_PARAM_JOURNAL_GROUP_COMMIT_SIZE, kThreads},
+      {0, 0}
+    };
+
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_ENABLE_FSYNC, 0644,
+                &params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, 0, 0));
+
+    // verify the parameters through ups_env_get_parameters
+    params[0].value = 0;
+    params[1].value = 0;
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(params[0].value == 2000);
+    REQUIRE(params[1].value == (uint64_t)kThreads);
+
+    boost::atomic<int> errors(0);
+    std::vector<boost::thread *> threads;
+    for (int i = 0; i < kThreads; i++)
+      threads.push_back(new boost::thread(group_committer, m_env, m_db,
+                              i, kCommits, &errors));
+    for (int i = 0; i < kThreads; i++) {
+      threads[i]->join();
+      delete threads[i];
+    }
+    REQUIRE(errors.load() == 0);
+
+    // concurrent commits share their fsyncs
+    ups_env_metrics_t metrics = {0};
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_commits == (uint64_t)(kThreads * kCommits));
+    REQUIRE(metrics.journal_fsyncs > 0);
+    REQUIRE(metrics.journal_fsyncs < metrics.journal_commits);
+
+    // reopen and verify that all committed keys are there
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 == ups_env_open(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_AUTO_RECOVERY, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    for (int k = 0; k < kThreads * kCommits; k++) {
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t rec = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+      REQUIRE(*(int *)rec.data == k);
+    }
+  }
+
+  // Commits |count| transactions with UPS_TXN_ASYNC_COMMIT
+  void async_commit(int first, int count) {
+    for (int k = first; k < first + count; k++) {
+      ups_txn_t *txn;
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t rec = ups_make_record(&k, sizeof(k));
+      REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+      REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+      REQUIRE(0 == ups_txn_commit(txn, UPS_TXN_ASYNC_COMMIT));
+    }
+  }
+
+  // Waits (up to 10 seconds) till the background flusher made the most
+  // recent commit durable
+  bool wait_for_flusher() {
+    for (int i = 0; i < 1000; i++) {
+      uint64_t durable_lsn, commit_lsn;
+      REQUIRE(0 == ups_env_get_durable_lsn(m_env, &durable_lsn, &commit_lsn));
+      if (durable_lsn >= commit_lsn)
+        return true;
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    return false;
+  }
+
+  void asyncCommitTest() {
+    teardown();
+
+    // disable the background flusher; the transactions are not flushed,
+    // therefore the commits remain in the journal buffers
+    ups_parameter_t params[] = {
+      {UPS_PARAM_JOURNAL_FLUSH_INTERVAL, 0},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_DONT_FLUSH_TRANSACTIONS, 0644,
+                &params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, 0, 0));
+    m_lenv = (LocalEnvironment *)m_env;
+
+    ups_parameter_t query[] = {
+      {UPS_PARAM_JOURNAL_FLUSH_INTERVAL, 1},
+      {UPS_PARAM_JOURNAL_FLUSH_SIZE, 1},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &query[0]));
+    REQUIRE(query[0].value == 0);
+    REQUIRE(query[1].value == 0);
+
+    Journal *j = m_lenv->journal();
+    uint64_t size = j->state.files[0].file_size()
+            + j->state.files[1].file_size();
+
+    async_commit(0, 5);
+
+    // the commits are not yet written
+    uint64_t durable_lsn, commit_lsn;
+    REQUIRE(0 == ups_env_get_durable_lsn(m_env, &durable_lsn, &commit_lsn));
+    REQUIRE(commit_lsn == get_lsn() - 1);
+    REQUIRE(durable_lsn < commit_lsn);
+    REQUIRE(size == j->state.files[0].file_size()
+            + j->state.files[1].file_size());
+
+    ups_env_metrics_t metrics = {0};
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_commits == 5);
+    REQUIRE(metrics.journal_async_commits == 5);
+    REQUIRE(metrics.journal_fsyncs == 0);
+
+    // wait till the most recent commit is durable
+    REQUIRE(0 == ups_env_wait_durable_lsn(m_env, 0));
+    REQUIRE(0 == ups_env_get_durable_lsn(m_env, &durable_lsn, 0));
+    REQUIRE(durable_lsn >= commit_lsn);
+    REQUIRE(size < j->state.files[0].file_size()
+            + j->state.files[1].file_size());
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_fsyncs > 0);
+
+    // no further fsync if the lsn is already durable
+    uint64_t fsyncs = metrics.journal_fsyncs;
+    REQUIRE(0 == ups_env_wait_durable_lsn(m_env, commit_lsn));
+    REQUIRE(0 == ups_env_wait_durable_lsn(m_env, commit_lsn + 1000));
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_fsyncs == fsyncs);
+
+    // a synchronous commit also writes the pending asynchronous commits
+    async_commit(5, 1);
+    REQUIRE(0 == ups_env_get_durable_lsn(m_env, &durable_lsn, &commit_lsn));
+    REQUIRE(durable_lsn < commit_lsn);
+    ups_txn_t *txn;
+    int k = 6;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t rec = ups_make_record(&k, sizeof(k));
+    REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+    REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+    REQUIRE(0 == ups_txn_commit(txn, 0));
+    REQUIRE(j->state.buffer[0].size() == 0);
+    REQUIRE(j->state.buffer[1].size() == 0);
+
+    // reopen and verify that all committed keys are there
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 == ups_env_open(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_AUTO_RECOVERY, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    for (k = 0; k <= 6; k++) {
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t rec = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+      REQUIRE(*(int *)rec.data == k);
+    }
+  }
+
+  void asyncCommitFlusherTest(uint32_t interval, uint64_t size) {
+    teardown();
+
+    ups_parameter_t params[] = {
+      {UPS_PARAM_JOURNAL_FLUSH_INTERVAL, interval},
+      {UPS_PARAM_JOURNAL_FLUSH_SIZE, size},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS, 0644, &params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, 0, 0));
+    m_lenv = (LocalEnvironment *)m_env;
+
+    params[0].value = 0;
+    params[1].value = 0;
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(params[0].value == interval);
+    REQUIRE(params[1].value == size);
+
+    async_commit(0, 20);
+    REQUIRE(wait_for_flusher());
+
+    ups_env_metrics_t metrics = {0};
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_async_commits == 20);
+    REQUIRE(metrics.journal_background_flushes > 0);
+
+    // the flusher is stopped when the Environment is closed
+    async_commit(20, 20);
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 == ups_env_open(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_AUTO_RECOVERY, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    for (int k = 0; k < 40; k++) {
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t rec = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+    }
+  }
+
+  void recoverWithThreadsTest(uint32_t threads) {
+#ifndef WIN32
+    ups_txn_t *txn;
+    const int kCount = 2000;
+
+    // do not immediately flush the changeset after a commit
+    teardown();
+    setup(UPS_DONT_FLUSH_TRANSACTIONS);
+
+    char buffer[200] = {0};
+    for (int i = 0; i < kCount; i++) {
+      REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+
+      *(int *)&buffer[0] = i;
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t rec = ups_make_record(&buffer[0], sizeof(buffer));
+
+      REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+      if (i % 10 == 0)
+        REQUIRE(0 == ups_db_erase(m_db, txn, &key, 0));
+      REQUIRE(0 == ups_txn_commit(txn, 0));
+    }
+
+    /* backup the files */
+    REQUIRE(true == os::copy(Utils::opath(".test"),
+          Utils::opath(".test.bak")));
+    REQUIRE(true == os::copy(Utils::opath(".test.jrn0"),
+          Utils::opath(".test.bak0")));
+    REQUIRE(true == os::copy(Utils::opath(".test.jrn1"),
+          Utils::opath(".test.bak1")));
+
+    /* close the environment, then restore the files */
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak"),
+          Utils::opath(".test")));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak0"),
+          Utils::opath(".test.jrn0")));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak1"),
+          Utils::opath(".test.jrn1")));
+
+    /* open the environment */
+    ups_parameter_t params[] = {
+      {UPS_PARAM_RECOVERY_THREADS, threads},
+      {0, 0}
+    };
+    REQUIRE(0 ==
+        ups_env_open(&m_env, Utils::opath(".test"),
+            UPS_ENABLE_TRANSACTIONS | UPS_AUTO_RECOVERY, &params[0]));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+
+    ups_parameter_t query[] = {
+      {UPS_PARAM_RECOVERY_THREADS, 0},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &query[0]));
+    REQUIRE(query[0].value == threads);
+
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_recovered_operations > 0);
+
+    /* now verify that the database is complete */
+    for (int i = 0; i < kCount; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t rec = {0};
+      if (i % 10 == 0) {
+        REQUIRE(UPS_KEY_NOT_FOUND == ups_db_find(m_db, 0, &key, &rec, 0));
+        continue;
+      }
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+      REQUIRE(rec.size == sizeof(buffer));
+      REQUIRE(i == *(int *)rec.data);
+    }
+#endif
+  }
+
+  void commit_keys(int first, int count) {
+    for (int k = first; k < first + count; k++) {
+      ups_txn_t *txn;
+      ups_key_t key = ups_make_key(&k, sizeof(k));
+      ups_record_t rec = ups_make_record(&k, sizeof(k));
+      REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+      REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+      REQUIRE(0 == ups_txn_commit(txn, 0));
+    }
+  }
+
+  uint64_t journal_size() {
+    Journal *j = m_lenv->journal();
+    return j->state.files[0].file_size() + j->state.files[1].file_size();
+  }
+
+  void checkpointTest() {
+#ifndef WIN32
+    // do not immediately flush the changeset after a commit
+    teardown();
+    setup(UPS_DONT_FLUSH_TRANSACTIONS);
+
+    Journal *j = m_lenv->journal();
+    commit_keys(0, 10);
+    REQUIRE(journal_size() > sizeof(PJournalEntry));
+
+    // all transactions are flushed; only the checkpoint record remains
+    j->checkpoint();
+    REQUIRE(journal_size() == sizeof(PJournalEntry));
+
+    Journal::Iterator it;
+    PJournalEntry entry;
+    ByteArray auxbuffer;
+    j->test_read_entry(&it, &entry, &auxbuffer);
+    REQUIRE(entry.type == (uint32_t)Journal::kEntryTypeCheckpoint);
+    REQUIRE(entry.lsn == get_lsn() - 1);
+
+    // the file of an open transaction is not truncated
+    ups_txn_t *txn;
+    int k = 100;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t rec = ups_make_record(&k, sizeof(k));
+    REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+    REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+    commit_keys(10, 10);
+    j->checkpoint();
+    REQUIRE(journal_size() > sizeof(PJournalEntry));
+    REQUIRE(0 == ups_txn_commit(txn, 0));
+
+    ups_env_metrics_t metrics = {0};
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.journal_checkpoints == 2);
+
+    /* backup the files */
+    REQUIRE(true == os::copy(Utils::opath(".test"),
+          Utils::opath(".test.bak")));
+    REQUIRE(true == os::copy(Utils::opath(".test.jrn0"),
+          Utils::opath(".test.bak0")));
+    REQUIRE(true == os::copy(Utils::opath(".test.jrn1"),
+          Utils::opath(".test.bak1")));
+
+    /* close the environment, then restore the files */
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak"),
+          Utils::opath(".test")));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak0"),
+          Utils::opath(".test.jrn0")));
+    REQUIRE(true == os::copy(Utils::opath(".test.bak1"),
+          Utils::opath(".test.jrn1")));
+
+    /* recover and verify that the database is complete */
+    REQUIRE(0 ==
+        ups_env_open(&m_env, Utils::opath(".test"),
+            UPS_ENABLE_TRANSACTIONS | UPS_AUTO_RECOVERY, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    for (k = 0; k < 20; k++) {
+      key = ups_make_key(&k, sizeof(k));
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+    }
+    k = 100;
+    key = ups_make_key(&k, sizeof(k));
+    REQUIRE(0 == ups_db_find(m_db, 0, &key, &rec, 0));
+#endif
+  }
+
+  void backgroundCheckpointTest() {
+    teardown();
+
+    ups_parameter_t params[] = {
+      {UPS_PARAM_JOURNAL_CHECKPOINT_SIZE, 16 * 1024},
+      {UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL, 60},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"),
+                UPS_ENABLE_TRANSACTIONS | UPS_DONT_FLUSH_TRANSACTIONS, 0644,
+                &params[0]));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, 0, 0));
+    m_lenv = (LocalEnvironment *)m_env;
+
+    ups_parameter_t query[] = {
+      {UPS_PARAM_JOURNAL_CHECKPOINT_SIZE, 0},
+      {UPS_PARAM_JOURNAL_CHECKPOINT_INTERVAL, 0},
+      {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &query[0]));
+    REQUIRE(query[0].value == 16 * 1024);
+    REQUIRE(query[1].value == 60);
+
+    // the background thread performs checkpoints while the journal grows
+    ups_env_metrics_t metrics = {0};
+    for (int i = 0; i < 1000 && metrics.journal_checkpoints == 0; i++) {
+      commit_keys(i * 10, 10);
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+      REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    }
+    REQUIRE(metrics.journal_checkpoints > 0);
+  }
+
+  void durableLsnWithoutJournalTest() {
+    teardown();
+
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"), 0, 0644, 0));
+
+    uint64_t durable_lsn;
+    REQUIRE(UPS_INV_PARAMETER == ups_env_get_durable_lsn(0, &durable_lsn, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_env_get_durable_lsn(m_env, 0, 0));
+    REQUIRE(UPS_INV_PARAMETER
+            == ups_env_get_durable_lsn(m_env, &durable_lsn, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_env_wait_durable_lsn(0, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_env_wait_durable_lsn(m_env, 0));
+  }
 };
 
 TEST_CASE("Journal/createCloseTest", "")
@@ -1526,5 +1965,58 @@ TEST_CASE("Journal/issue71Test", "")
   f.issue71Test();
 }
 
-} // namespace upscaledb
+TEST_CASE("Journal/groupCommitTest", "")
+{
+  JournalFixture f;
+  f.groupCommitTest();
+}
 
+TEST_CASE("Journal/asyncCommitTest", "")
+{
+  JournalFixture f;
+  f.asyncCommitTest();
+}
+
+TEST_CASE("Journal/asyncCommitIntervalTest", "")
+{
+  JournalFixture f;
+  f.asyncCommitFlusherTest(1, 0);
+}
+
+TEST_CASE("Journal/asyncCommitSizeTest", "")
+{
+  JournalFixture f;
+  f.asyncCommitFlusherTest(0, 1);
+}
+
+TEST_CASE("Journal/durableLsnWithoutJournalTest", "")
+{
+  JournalFixture f;
+  f.durableLsnWithoutJournalTest();
+}
+
+TEST_CASE("Journal/recoverWithThreadsTest", "")
+{
+  JournalFixture f;
+  f.recoverWithThreadsTest(4);
+}
+
+TEST_CASE("Journal/recoverWithoutThreadsTest", "")
+{
+  JournalFixture f;
+  f.recoverWithThreadsTest(0);
+}
+
+TEST_CASE("Journal/checkpointTest", "")
+{
+  JournalFixture f;
+  f.checkpointTest();
+}
+
+TEST_CASE("Journal/backgroundCheckpointTest", "")
+{
+  JournalFixture f;
+  f.backgroundCheckpointTest();
+}
+
+} // namespace upscaledb
@@ -120,6 +120,31 @@ TEST_CASE("OsTest/readWriteTest",
   }
 }
 
+TEST_CASE("OsTest/pwritevTest",
+           "Tests the operating system functions in os*")
+{
+  File f;
+  // more buffers than a single vectored write can handle
+  const int kCount = 100;
+  char buffers[kCount][128], orig[128];
+  void *ptrs[kCount];
+
+  f.create(Utils::opath(".test"), 0664);
+  for (int i = 0; i < kCount; i++) {
+    memset(buffers[i], i, sizeof(buffers[i]));
+    ptrs[i] = buffers[i];
+  }
+  f.pwritev(128, &ptrs[0], kCount, sizeof(buffers[0]));
+  REQUIRE(f.file_size() == 128u * (kCount + 1));
+
+  for (int i = 0; i < kCount; i++) {
+    memset(orig, i, sizeof(orig));
+    memset(buffers[0], 0xff, sizeof(buffers[0]));
+    f.pread(128 + i * sizeof(orig), buffers[0], sizeof(orig));
+    REQUIRE(0 == memcmp(buffers[0], orig, sizeof(orig)));
+  }
+}
+
 TEST_CASE("OsTest/mmapTest",
            "Tests the operating system functions in os*")
 {
@@ -256,6 +256,69 @@ struct PageManagerFixture {
     REQUIRE(false == pm->state->cache.is_cache_full());
   }
 
+  void cache2QTest() {
+    LocalEnvironment *lenv = (LocalEnvironment *)m_env;
+
+    EnvConfig config;
+    config.cache_size_bytes = 8 * config.page_size_bytes;
+    config.cache_policy = UPS_CACHE_POLICY_2Q;
+    Cache cache(config);
+    REQUIRE(cache.state.policy->type() == UPS_CACHE_POLICY_2Q);
+    CachePolicy *policy = cache.state.policy.get();
+
+    PPageData pers;
+    memset(&pers, 0, sizeof(pers));
+    std::vector<Page *> v;
+
+    for (unsigned int i = 0; i < 8; i++) {
+      Page *p = new Page(lenv->device());
+      p->set_without_header(true);
+      p->assign_allocated_buffer(&pers, i + 1);
+      v.push_back(p);
+      cache.put(p);
+    }
+
+    // a hit in the cold queue does not change the order
+    REQUIRE(v[0] == cache.get(1));
+    REQUIRE(v[0] == policy->first_victim());
+
+    ups_env_metrics_t metrics = {0};
+    cache.fill_metrics(&metrics);
+    REQUIRE(metrics.cache_policy == UPS_CACHE_POLICY_2Q);
+    REQUIRE(metrics.cache_hits_cold == 1);
+    REQUIRE(metrics.cache_pages_cold == 8);
+    REQUIRE(metrics.cache_pages_hot == 0);
+
+    // purge the page, then fetch it again: now it's "hot"
+    cache.del(v[0]);
+    cache.put(v[0]);
+    REQUIRE(v[0] == cache.get(1));
+
+    cache.fill_metrics(&metrics);
+    REQUIRE(metrics.cache_misses_ghost == 1);
+    REQUIRE(metrics.cache_hits_hot == 1);
+    REQUIRE(metrics.cache_pages_cold == 7);
+    REQUIRE(metrics.cache_pages_hot == 1);
+
+    // the hot page is the last candidate for eviction
+    Page *last = 0;
+    int count = 0;
+    for (Page *p = policy->first_victim(); p != 0;
+                    p = policy->next_victim(p)) {
+      last = p;
+      count++;
+    }
+    REQUIRE(count == 8);
+    REQUIRE(last == v[0]);
+
+    for (unsigned int i = 0; i < v.size(); i++) {
+      cache.del(v[i]);
+      v[i]->set_data(0);
+      delete v[i];
+    }
+    REQUIRE(0 == cache.current_elements());
+  }
+
   void storeStateTest() {
     LocalEnvironment *lenv = (LocalEnvironment *)m_env;
     PageManagerState *state = lenv->page_manager()->state.get();
@@ -509,6 +572,12 @@ TEST_CASE("PageManager/cacheFullTest", "")
   f.cacheFullTest();
 }
 
+TEST_CASE("PageManager/cache2QTest", "")
+{
+  PageManagerFixture f;
+  f.cache2QTest();
+}
+
 TEST_CASE("PageManager/storeStateTest", "")
 {
   PageManagerFixture f(false, 16 * UPS_DEFAULT_PAGE_SIZE);
@@ -557,4 +626,490 @@ TEST_CASE("PageManager-inmem/allocPage", "")
   f.allocPageTest();
 }
 
+struct ReadaheadFixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  enum {
+    kKeys = 20000
+  };
+
+  ReadaheadFixture()
+      : m_db(0), m_env(0) {
+    ups_parameter_t params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {0, 0}
+    };
+
+    REQUIRE(0 ==
+        ups_env_create(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP,
+                0644, 0));
+    REQUIRE(0 ==
+        ups_env_create_db(m_env, &m_db, 1, 0, &params[0]));
+
+    // the records are stored in blobs
+    char buffer[32] = {0};
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&buffer[0], sizeof(buffer));
+      *(uint32_t *)&buffer[0] = i;
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    // reopen the Environment; the cache is now empty
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 ==
+        ups_env_open(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+  }
+
+  ~ReadaheadFixture() {
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  // Closes the database (which waits for pending readahead requests),
+  // then returns the number of pages that were read ahead
+  uint64_t closeAndGetPrefetchedPages() {
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_db_close(m_db, 0));
+    m_db = 0;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    return metrics.page_count_prefetched;
+  }
+
+  void cursorTest() {
+    ups_cursor_t *cursor;
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    REQUIRE(0 == ups_cursor_create(&cursor, m_db, 0, 0));
+
+    uint32_t i = 0;
+    while (0 == ups_cursor_move(cursor, &key, &record, UPS_CURSOR_NEXT)) {
+      REQUIRE(*(uint32_t *)key.data == i);
+      REQUIRE(record.size == 32u);
+      REQUIRE(*(uint32_t *)record.data == i);
+      i++;
+    }
+    REQUIRE(i == (uint32_t)kKeys);
+    REQUIRE(0 == ups_cursor_close(cursor));
+
+    REQUIRE(closeAndGetPrefetchedPages() > 0);
+  }
+
+  void randomAccessTest() {
+    ups_cursor_t *cursor;
+    ups_key_t key = {0};
+    REQUIRE(0 == ups_cursor_create(&cursor, m_db, 0, 0));
+
+    // lookups do not trigger readahead
+    for (uint32_t i = 0; i < kKeys; i += 97) {
+      key = ups_make_key(&i, sizeof(i));
+      REQUIRE(0 == ups_cursor_find(cursor, &key, 0, 0));
+    }
+    REQUIRE(0 == ups_cursor_close(cursor));
+
+    REQUIRE(closeAndGetPrefetchedPages() == 0);
+  }
+
+  void countTest() {
+    uint64_t count;
+    REQUIRE(0 == ups_db_count(m_db, 0, 0, &count));
+    REQUIRE(count == (uint64_t)kKeys);
+
+    REQUIRE(closeAndGetPrefetchedPages() > 0);
+  }
+};
+
+TEST_CASE("PageManager/readaheadCursorTest", "")
+{
+  ReadaheadFixture f;
+  f.cursorTest();
+}
+
+TEST_CASE("PageManager/readaheadRandomAccessTest", "")
+{
+  ReadaheadFixture f;
+  f.randomAccessTest();
+}
+
+TEST_CASE("PageManager/readaheadCountTest", "")
+{
+  ReadaheadFixture f;
+  f.countTest();
+}
+
+struct WarmupFixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  enum {
+    kKeys = 5000
+  };
+
+  WarmupFixture()
+      : m_db(0), m_env(0) {
+    ups_parameter_t env_params[] = {
+        {UPS_PARAM_CACHE_WARMUP, 1},
+        {0, 0}
+    };
+    ups_parameter_t db_params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {0, 0}
+    };
+
+    REQUIRE(0 ==
+        ups_env_create(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP,
+                0644, &env_params[0]));
+    REQUIRE(0 ==
+        ups_env_create_db(m_env, &m_db, 1, 0, &db_params[0]));
+
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&i, sizeof(i));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    // stores the addresses of the cached pages
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  ~WarmupFixture() {
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  void open(bool enable_warmup) {
+    ups_parameter_t params[] = {
+        {UPS_PARAM_CACHE_WARMUP, enable_warmup ? 1u : 0u},
+        {0, 0}
+    };
+    REQUIRE(0 ==
+        ups_env_open(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP,
+                &params[0]));
+  }
+
+  // Waits till the cache warm-up is completed
+  void waitForWarmup(ups_env_metrics_t *metrics) {
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(0 == ups_env_get_metrics(m_env, metrics));
+      if (metrics->cache_warmup_pages_total > 0
+            && metrics->cache_warmup_pages_processed
+                == metrics->cache_warmup_pages_total)
+        return;
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    FAIL("cache warm-up did not complete");
+  }
+
+  // Looks up all keys, returns the number of pages fetched from disk
+  uint64_t lookupAllKeys() {
+    ups_env_metrics_t before, after;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &before));
+
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(*(uint32_t *)record.data == i);
+    }
+
+    REQUIRE(0 == ups_env_get_metrics(m_env, &after));
+    return after.page_count_fetched - before.page_count_fetched;
+  }
+
+  void warmupTest() {
+    open(true);
+
+    ups_parameter_t params[] = {
+        {UPS_PARAM_CACHE_WARMUP, 0},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(params[0].value == 1u);
+
+    ups_env_metrics_t metrics;
+    waitForWarmup(&metrics);
+
+    // all pages were preloaded
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    REQUIRE(lookupAllKeys() == 0);
+  }
+
+  void disabledTest() {
+    open(false);
+
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.cache_warmup_pages_total == 0u);
+
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    REQUIRE(lookupAllKeys() > 0);
+  }
+
+  void reopenTest() {
+    // the list is persisted again when the Environment is closed
+    open(true);
+    ups_env_metrics_t metrics;
+    waitForWarmup(&metrics);
+    uint64_t total = metrics.cache_warmup_pages_total;
+    REQUIRE(0 == ups_env_close(m_env, 0));
+
+    open(true);
+    waitForWarmup(&metrics);
+    REQUIRE(metrics.cache_warmup_pages_total == total);
+
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    REQUIRE(lookupAllKeys() == 0);
+  }
+};
+
+TEST_CASE("PageManager/warmupTest", "")
+{
+  WarmupFixture f;
+  f.warmupTest();
+}
+
+TEST_CASE("PageManager/warmupDisabledTest", "")
+{
+  WarmupFixture f;
+  f.disabledTest();
+}
+
+TEST_CASE("PageManager/warmupReopenTest", "")
+{
+  WarmupFixture f;
+  f.reopenTest();
+}
+
+struct CompressedCacheFixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  enum {
+    kKeys = 20000
+  };
+
+  CompressedCacheFixture(uint64_t compressed_cache_size = 8 * 1024 * 1024)
+      : m_db(0), m_env(0) {
+    ups_parameter_t env_params[] = {
+        {UPS_PARAM_CACHE_SIZE, 64 * 1024},
+        {UPS_PARAM_COMPRESSED_CACHE_SIZE, compressed_cache_size},
+        {0, 0}
+    };
+    ups_parameter_t db_params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {UPS_PARAM_RECORD_SIZE, 32},
+        {0, 0}
+    };
+
+    REQUIRE(0 ==
+        ups_env_create(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP,
+                0644, &env_params[0]));
+    REQUIRE(0 ==
+        ups_env_create_db(m_env, &m_db, 1, 0, &db_params[0]));
+  }
+
+  ~CompressedCacheFixture() {
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  // Inserts (or overwrites) all keys; the records are easy to compress
+  void insertKeys(uint32_t value) {
+    uint8_t buffer[32] = {0};
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ::memcpy(&buffer[0], &value, sizeof(value));
+      ::memcpy(&buffer[4], &i, sizeof(i));
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&buffer[0], sizeof(buffer));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, UPS_OVERWRITE));
+    }
+  }
+
+  // Looks up all keys and verifies the records
+  void lookupKeys(uint32_t value) {
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(record.size == 32u);
+      REQUIRE(*(uint32_t *)record.data == value);
+      REQUIRE(*(uint32_t *)((uint8_t *)record.data + 4) == i);
+    }
+  }
+
+  void lookupTest() {
+    insertKeys(1);
+    lookupKeys(1);
+
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.compressed_cache_hits > 0u);
+    REQUIRE(metrics.compressed_cache_pages > 0u);
+    REQUIRE(metrics.compressed_cache_bytes > 0u);
+    REQUIRE(metrics.compressed_cache_bytes <= 8u * 1024 * 1024);
+    // the pages were fetched from the compressed tier, not from disk
+    REQUIRE(metrics.compressed_cache_misses < metrics.compressed_cache_hits);
+  }
+
+  void overwriteTest() {
+    // pages which are modified after they were loaded from the compressed
+    // tier must not be served from a stale copy
+    insertKeys(1);
+    lookupKeys(1);
+    insertKeys(2);
+    lookupKeys(2);
+    insertKeys(3);
+    lookupKeys(3);
+  }
+
+  void limitTest() {
+    insertKeys(1);
+    lookupKeys(1);
+
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.compressed_cache_bytes <= 64u * 1024);
+    REQUIRE(metrics.compressed_cache_pages > 0u);
+  }
+
+  void parameterTest() {
+    ups_parameter_t params[] = {
+        {UPS_PARAM_COMPRESSED_CACHE_SIZE, 0},
+        {UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR, 0},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(params[0].value == 8u * 1024 * 1024);
+    REQUIRE(params[1].value == (uint64_t)UPS_COMPRESSOR_LZF);
+  }
+};
+
+TEST_CASE("PageManager/compressedCacheLookupTest", "")
+{
+  CompressedCacheFixture f;
+  f.lookupTest();
+}
+
+TEST_CASE("PageManager/compressedCacheOverwriteTest", "")
+{
+  CompressedCacheFixture f;
+  f.overwriteTest();
+}
+
+TEST_CASE("PageManager/compressedCacheLimitTest", "")
+{
+  CompressedCacheFixture f(64 * 1024);
+  f.limitTest();
+}
+
+TEST_CASE("PageManager/compressedCacheParameterTest", "")
+{
+  CompressedCacheFixture f;
+  f.parameterTest();
+}
+
+TEST_CASE("PageManager/compressedCacheInvalidParameterTest", "")
+{
+  ups_env_t *env;
+  ups_parameter_t params[] = {
+      {UPS_PARAM_COMPRESSED_CACHE_SIZE, 1024 * 1024},
+      {0, 0}
+  };
+  REQUIRE(UPS_INV_PARAMETER ==
+      ups_env_create(&env, 0, UPS_IN_MEMORY, 0, &params[0]));
+
+  ups_parameter_t params2[] = {
+      {UPS_PARAM_COMPRESSED_CACHE_SIZE, 1024 * 1024},
+      {UPS_PARAM_COMPRESSED_CACHE_COMPRESSOR, UPS_COMPRESSOR_UINT32_VARBYTE},
+      {0, 0}
+  };
+  REQUIRE(UPS_INV_PARAMETER ==
+      ups_env_create(&env, Utils::opath(".test"), 0, 0644, &params2[0]));
+}
+
+struct FlushThreadsFixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  enum {
+    kKeys = 20000
+  };
+
+  FlushThreadsFixture(uint32_t flush_threads, uint64_t rate_limit)
+      : m_db(0), m_env(0) {
+    ups_parameter_t env_params[] = {
+        {UPS_PARAM_CACHE_SIZE, 64 * 1024},
+        {UPS_PARAM_FLUSH_THREADS, flush_threads},
+        {UPS_PARAM_FLUSH_RATE_LIMIT, rate_limit},
+        {0, 0}
+    };
+    ups_parameter_t db_params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {0, 0}
+    };
+
+    REQUIRE(0 ==
+        ups_env_create(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP,
+                0644, &env_params[0]));
+    REQUIRE(0 ==
+        ups_env_create_db(m_env, &m_db, 1, 0, &db_params[0]));
+
+    ups_parameter_t params[] = {
+        {UPS_PARAM_FLUSH_THREADS, 0},
+        {UPS_PARAM_FLUSH_RATE_LIMIT, 0},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &params[0]));
+    REQUIRE(params[0].value == flush_threads);
+    REQUIRE(params[1].value == rate_limit);
+  }
+
+  ~FlushThreadsFixture() {
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  void insertReopenTest() {
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&i, sizeof(i));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    // the pages were flushed while the cache was purged
+    ups_env_metrics_t metrics;
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.page_count_flushed > 0u);
+
+    REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 ==
+        ups_env_open(&m_env, Utils::opath(".test"), UPS_DISABLE_MMAP, 0));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+    REQUIRE(0 == ups_db_check_integrity(m_db, 0));
+
+    for (uint32_t i = 0; i < kKeys; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = {0};
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(*(uint32_t *)record.data == i);
+    }
+  }
+};
+
+TEST_CASE("PageManager/flushThreadsTest", "")
+{
+  FlushThreadsFixture f(4, 0);
+  f.insertReopenTest();
+}
+
+TEST_CASE("PageManager/flushRateLimitTest", "")
+{
+  FlushThreadsFixture f(0, 64 * 1024 * 1024);
+  f.insertReopenTest();
+}
+
+TEST_CASE("PageManager/flushThreadsRateLimitTest", "")
+{
+  FlushThreadsFixture f(2, 64 * 1024 * 1024);
+  f.insertReopenTest();
+}
+
 } // namespace upscaledb
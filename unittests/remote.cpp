@@ -19,6 +19,9 @@
 
 #include "3rdparty/catch/catch.hpp"
 
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
 #include <ups/upscaledb_srv.h>
 #include <ups/upscaledb_uqi.h>
 
@@ -31,16 +34,62 @@ using namespace upscaledb;
 
 #define SERVER_URL "ups://localhost:8989/test.db"
 
+// A client of RemoteFixture::concurrentClientsTest(); each client uses its
+// own Database. Catch's macros are not thread-safe, therefore errors are
+// only counted.
+static void
+remote_client(int id, int count, boost::atomic<int> *errors)
+{
+  ups_env_t *env;
+  ups_db_t *db;
+
+  if (ups_env_open(&env, SERVER_URL, 0, 0) != 0) {
+    (*errors)++;
+    return;
+  }
+  if (ups_env_create_db(env, &db, (uint16_t)(100 + id), 0, 0) != 0) {
+    (*errors)++;
+    ups_env_close(env, 0);
+    return;
+  }
+
+  for (int i = 0; i < count; i++) {
+    int k = id * count + i;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t rec = ups_make_record(&k, sizeof(k));
+    if (ups_db_insert(db, 0, &key, &rec, 0) != 0)
+      (*errors)++;
+  }
+
+  for (int i = 0; i < count; i++) {
+    int k = id * count + i;
+    ups_key_t key = ups_make_key(&k, sizeof(k));
+    ups_record_t rec = {0};
+    if (ups_db_find(db, 0, &key, &rec, 0) != 0
+        || rec.size != sizeof(k) || *(int *)rec.data != k)
+      (*errors)++;
+  }
+
+  uint64_t keycount = 0;
+  if (ups_db_count(db, 0, 0, &keycount) != 0 || keycount != (uint64_t)count)
+    (*errors)++;
+
+  ups_db_close(db, 0);
+  ups_env_close(env, 0);
+}
+
 struct RemoteFixture {
   ups_env_t *m_env;
   ups_db_t *m_db;
   ups_srv_t *m_srv;
 
-  RemoteFixture()
+  RemoteFixture(uint32_t io_threads = 0, uint32_t worker_threads = 0)
     : m_env(0), m_db(0), m_srv(0) {
     ups_srv_config_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     cfg.port = 8989;
+    cfg.io_threads = io_threads;
+    cfg.worker_threads = worker_threads;
 
     REQUIRE(0 == ups_env_create(&m_env, "test.db",
             UPS_ENABLE_TRANSACTIONS, 0644, 0));
@@ -378,6 +427,44 @@ struct RemoteFixture {
     REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
   }
 
+  void insertFindManyTest() {
+    ups_db_t *db;
+    ups_env_t *env;
+    uint32_t values[100];
+    ups_key_t keys[100];
+    ups_record_t records[100];
+    ups_status_t results[100];
+
+    REQUIRE(0 == ups_env_create(&env, SERVER_URL, 0, 0664, 0));
+    REQUIRE(0 == ups_env_create_db(env, &db, 22, 0, 0));
+
+    for (int i = 0; i < 100; i++) {
+      values[i] = (uint32_t)(i * 7 % 50);
+      keys[i] = ups_make_key(&values[i], sizeof(values[i]));
+      records[i] = ups_make_record(&values[i], sizeof(values[i]));
+    }
+    REQUIRE(0 == ups_db_insert_many(db, 0, 100, keys, records, results, 0));
+    for (int i = 0; i < 100; i++)
+      REQUIRE(results[i] == (i < 50 ? 0 : UPS_DUPLICATE_KEY));
+
+    for (int i = 0; i < 100; i++) {
+      values[i] = (uint32_t)i;
+      records[i] = ups_make_record(0, 0);
+    }
+    REQUIRE(0 == ups_db_find_many(db, 0, 100, keys, records, results, 0));
+    for (int i = 0; i < 100; i++) {
+      if (i < 50) {
+        REQUIRE(results[i] == 0);
+        REQUIRE(records[i].size == sizeof(uint32_t));
+        REQUIRE(*(uint32_t *)records[i].data == (uint32_t)i);
+      }
+      else
+        REQUIRE(results[i] == UPS_KEY_NOT_FOUND);
+    }
+
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+  }
+
   void insertFindBigTest() {
 #define BUFSIZE (1024 * 16 + 10)
     ups_db_t *db;
@@ -1158,6 +1245,29 @@ struct RemoteFixture {
     REQUIRE(0 == ups_env_close(env, 0));
   }
 
+  void concurrentClientsTest() {
+    const int kThreads = 8;
+    const int kKeys = 500;
+
+    boost::atomic<int> errors(0);
+    std::vector<boost::thread *> threads;
+    for (int i = 0; i < kThreads; i++)
+      threads.push_back(new boost::thread(remote_client, i, kKeys, &errors));
+    for (int i = 0; i < kThreads; i++) {
+      threads[i]->join();
+      delete threads[i];
+    }
+    REQUIRE(errors.load() == 0);
+
+    // the Databases were created in the server's Environment
+    for (int i = 0; i < kThreads; i++) {
+      uint64_t keycount = 0;
+      REQUIRE(0 == ups_env_open_db(m_env, &m_db, (uint16_t)(100 + i), 0, 0));
+      REQUIRE(0 == ups_db_count(m_db, 0, 0, &keycount));
+      REQUIRE(keycount == (uint64_t)kKeys);
+      REQUIRE(0 == ups_db_close(m_db, 0));
+    }
+  }
 };
 
 TEST_CASE("Remote/invalidUrlTest", "")
@@ -1274,6 +1384,12 @@ TEST_CASE("Remote/insertFindBigTest", "")
   f.insertFindBigTest();
 }
 
+TEST_CASE("Remote/insertFindManyTest", "")
+{
+  RemoteFixture f;
+  f.insertFindManyTest();
+}
+
 TEST_CASE("Remote/insertRecno64Test", "")
 {
   RemoteFixture f;
@@ -1430,4 +1546,16 @@ TEST_CASE("Remote/uqiTest", "")
   f.uqiTest();
 }
 
+TEST_CASE("Remote/concurrentClientsTest", "")
+{
+  RemoteFixture f(4, 4);
+  f.concurrentClientsTest();
+}
+
+TEST_CASE("Remote/concurrentClientsWithoutWorkersTest", "")
+{
+  RemoteFixture f(4, 0);
+  f.concurrentClientsTest();
+}
+
 #endif // UPS_ENABLE_REMOTE
@@ -17,77 +17,207 @@
 
 #ifdef __SSE__
 
+#include <limits>
+#include <vector>
+
 #include "3rdparty/catch/catch.hpp"
 
 #include "utils.h"
 
 #include "2simd/simd.h"
+#include "2simd/simd_aggregate.h"
 
 using namespace upscaledb;
 
 template<typename T>
 void
-test_linear_search_sse()
+test_linear_search(int (*function)(T *, int, int, T), int count)
 {
-#undef MAX
-#define MAX 16
-  T arr[MAX];
-  for (int i = 0; i < MAX; i++)
-    arr[i] = i + 1;
+  T arr[16];
+  for (int i = 0; i < count; i++)
+    arr[i] = (T)(i + 1);
+
+  REQUIRE(-1 == function(&arr[0], 0, count, (T)0));
 
-  REQUIRE(-1 == linear_search_sse<T>(&arr[0], 0, MAX, (T)0));
+  REQUIRE(-1 == function(&arr[0], 0, count, (T)(count + 1)));
 
-  REQUIRE(-1 == linear_search_sse<T>(&arr[0], 0, MAX, (T)MAX + 1));
+  for (int i = 0; i < count; i++)
+    REQUIRE(i == function(&arr[0], 0, count, (T)(i + 1)));
+}
 
-  for (int i = 0; i < MAX; i++)
-    REQUIRE(i == linear_search_sse<T>(&arr[0], 0, MAX, (T)(i + 1)));
+// Searches every key (and every gap between two keys) of nodes with
+// different sizes; the kernel is selected at run time
+template<typename T>
+void
+test_find_simd()
+{
+  std::vector<T> arr;
+  for (int count = 1; count < 200; count += 7) {
+    arr.resize(count);
+    for (int i = 0; i < count; i++)
+      arr[i] = (T)(2 * i + 2);
+
+    for (int i = 0; i < count; i++) {
+      T key = (T)(2 * i + 2);
+      ups_key_t hkey = ups_make_key(&key, sizeof(key));
+      REQUIRE(i == find_simd<T>(count, &arr[0], &hkey));
+      key = (T)(2 * i + 1);
+      REQUIRE(-1 == find_simd<T>(count, &arr[0], &hkey));
+    }
+  }
 }
 
 TEST_CASE("Simd/uint16SseTest", "")
 {
-  test_linear_search_sse<uint16_t>();
+  test_linear_search<uint16_t>(linear_search_sse2, 16);
 }
 
 TEST_CASE("Simd/uint32SseTest", "")
 {
-  test_linear_search_sse<uint32_t>();
+  test_linear_search<uint32_t>(linear_search_sse2, 16);
 }
 
 TEST_CASE("Simd/uint64SseTest", "")
 {
-#undef MAX
-#define MAX 4
-  uint64_t arr[MAX];
-  for (int i = 0; i < MAX; i++)
-    arr[i] = i + 1;
+  if (os_has_sse41())
+    test_linear_search<uint64_t>(linear_search_sse41, 4);
+}
 
-  REQUIRE(-1 == linear_search_sse<uint64_t>(&arr[0], 0, MAX, 0));
+TEST_CASE("Simd/floatSseTest", "")
+{
+  test_linear_search<float>(linear_search_sse2, 16);
+}
 
-  REQUIRE(-1 == linear_search_sse<uint64_t>(&arr[0], 0, MAX, MAX + 1));
+TEST_CASE("Simd/doubleSseTest", "")
+{
+  test_linear_search<double>(linear_search_sse2, 4);
+}
 
-  for (int i = 0; i < MAX; i++)
-    REQUIRE(i == linear_search_sse<uint64_t>(&arr[0], 0, MAX, (i + 1)));
+TEST_CASE("Simd/avx2Test", "")
+{
+  if (!os_has_avx2())
+    return;
+
+  test_linear_search<uint16_t>(linear_search_avx2, 16);
+  test_linear_search<uint32_t>(linear_search_avx2, 16);
+  test_linear_search<uint64_t>(linear_search_avx2, 8);
+  test_linear_search<float>(linear_search_avx2, 16);
+  test_linear_search<double>(linear_search_avx2, 8);
 }
 
-TEST_CASE("Simd/floatSseTest", "")
+TEST_CASE("Simd/findSimdTest", "")
 {
-  test_linear_search_sse<float>();
+  test_find_simd<uint16_t>();
+  test_find_simd<uint32_t>();
+  test_find_simd<uint64_t>();
+  test_find_simd<float>();
+  test_find_simd<double>();
 }
 
-TEST_CASE("Simd/doubleSseTest", "")
+// Compares the aggregation kernels with the scalar implementation; the
+// values are small integers, therefore floating point sums are exact
+template<typename T>
+void
+test_aggregate(const AggregateKernels<T> &kernels)
 {
-#undef MAX
-#define MAX 4
-  double arr[MAX];
-  for (int i = 0; i < MAX; i++)
-    arr[i] = i + 1;
+  std::vector<T> arr;
+  for (size_t length = 1; length < 300; length += 13) {
+    arr.resize(length);
+    for (size_t i = 0; i < length; i++)
+      arr[i] = (T)((i * 7919 + length) % 100 + 1);
+    // place the extremes at different positions
+    arr[length / 2] = (T)0;
+    arr[length - 1] = (T)std::numeric_limits<uint8_t>::max();
+
+    REQUIRE(kernels.sum(&arr[0], length) == scalar_sum(&arr[0], length));
+    REQUIRE(kernels.min(&arr[0], length)
+                    == scalar_extreme<T, false>(&arr[0], length));
+    REQUIRE(kernels.max(&arr[0], length)
+                    == scalar_extreme<T, true>(&arr[0], length));
+  }
+
+  REQUIRE(kernels.sum(&arr[0], 0) == 0);
+}
 
-  REQUIRE(-1 == linear_search_sse<double>(&arr[0], 0, MAX, 0));
+// Checks that the sums of large values do not overflow the vector lanes
+template<typename T>
+void
+test_aggregate_limits(const AggregateKernels<T> &kernels)
+{
+  T max = std::numeric_limits<T>::max();
+  std::vector<T> arr(1000, max);
+  arr[500] = (T)(max - 1);
 
-  REQUIRE(-1 == linear_search_sse<double>(&arr[0], 0, MAX, MAX + 1));
+  REQUIRE(kernels.sum(&arr[0], arr.size()) == scalar_sum(&arr[0], arr.size()));
+  REQUIRE(kernels.min(&arr[0], arr.size()) == (T)(max - 1));
+  REQUIRE(kernels.max(&arr[0], arr.size()) == max);
+}
 
-  for (int i = 0; i < MAX; i++)
-    REQUIRE(i == linear_search_sse<double>(&arr[0], 0, MAX, (i + 1)));
+TEST_CASE("Simd/aggregateTest", "")
+{
+  test_aggregate(aggregate_kernels<uint8_t>());
+  test_aggregate(aggregate_kernels<uint16_t>());
+  test_aggregate(aggregate_kernels<uint32_t>());
+  test_aggregate(aggregate_kernels<uint64_t>());
+  test_aggregate(aggregate_kernels<float>());
+  test_aggregate(aggregate_kernels<double>());
+
+  test_aggregate_limits(aggregate_kernels<uint8_t>());
+  test_aggregate_limits(aggregate_kernels<uint16_t>());
+  test_aggregate_limits(aggregate_kernels<uint32_t>());
+  test_aggregate_limits(aggregate_kernels<uint64_t>());
+}
+
+TEST_CASE("Simd/aggregateSseTest", "")
+{
+  AggregateKernels<uint8_t> k8 = {sum_sse2, extreme_sse2<false>,
+                                  extreme_sse2<true>};
+  test_aggregate(k8);
+  AggregateKernels<uint16_t> k16 = {sum_sse2, extreme_sse2<false>,
+                                    extreme_sse2<true>};
+  test_aggregate(k16);
+  test_aggregate_limits(k16);
+  AggregateKernels<float> kf = {sum_sse2, extreme_sse2<false>,
+                                extreme_sse2<true>};
+  test_aggregate(kf);
+  AggregateKernels<double> kd = {sum_sse2, extreme_sse2<false>,
+                                 extreme_sse2<true>};
+  test_aggregate(kd);
+
+  if (os_has_sse41()) {
+    AggregateKernels<uint32_t> k32 = {sum_sse2, extreme_sse41<false>,
+                                      extreme_sse41<true>};
+    test_aggregate(k32);
+    test_aggregate_limits(k32);
+  }
+}
+
+TEST_CASE("Simd/aggregateAvx2Test", "")
+{
+  if (!os_has_avx2())
+    return;
+
+  AggregateKernels<uint8_t> k8 = {sum_avx2, extreme_avx2<false>,
+                                  extreme_avx2<true>};
+  test_aggregate(k8);
+  AggregateKernels<uint16_t> k16 = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+  test_aggregate(k16);
+  test_aggregate_limits(k16);
+  AggregateKernels<uint32_t> k32 = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+  test_aggregate(k32);
+  test_aggregate_limits(k32);
+  AggregateKernels<uint64_t> k64 = {sum_avx2, extreme_avx2<false>,
+                                    extreme_avx2<true>};
+  test_aggregate(k64);
+  test_aggregate_limits(k64);
+  AggregateKernels<float> kf = {sum_avx2, extreme_avx2<false>,
+                                extreme_avx2<true>};
+  test_aggregate(kf);
+  AggregateKernels<double> kd = {sum_avx2, extreme_avx2<false>,
+                                 extreme_avx2<true>};
+  test_aggregate(kd);
 }
 
 #endif // __SSE__
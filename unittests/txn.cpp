@@ -154,21 +154,21 @@ struct TxnFixture {
     ups_key_t key2 = ups_make_key((void *)"world", 5);
 
     REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
-    node1 = new TransactionNode(m_dbp, &key1);
+    node1 = m_dbp->txn_index()->create_node(&key1);
     m_dbp->txn_index()->store(node1);
     node2 = m_dbp->txn_index()->get(&key1, 0);
     REQUIRE(node1 == node2);
     node2 = m_dbp->txn_index()->get(&key2, 0);
     REQUIRE((TransactionNode *)NULL == node2);
-    node2 = new TransactionNode(m_dbp, &key2);
+    node2 = m_dbp->txn_index()->create_node(&key2);
     m_dbp->txn_index()->store(node2);
     REQUIRE(node1 != node2);
 
     // clean up
     m_dbp->txn_index()->remove(node1);
-    delete node1;
+    m_dbp->txn_index()->destroy_node(node1);
     m_dbp->txn_index()->remove(node2);
-    delete node2;
+    m_dbp->txn_index()->destroy_node(node2);
 
     REQUIRE(0 == ups_txn_commit(txn, 0));
   }
@@ -187,20 +187,20 @@ struct TxnFixture {
     key3.size = 5;
 
     REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
-    node1 = new TransactionNode(m_dbp, &key1);
+    node1 = m_dbp->txn_index()->create_node(&key1);
     m_dbp->txn_index()->store(node1);
-    node2 = new TransactionNode(m_dbp, &key2);
+    node2 = m_dbp->txn_index()->create_node(&key2);
     m_dbp->txn_index()->store(node2);
-    node3 = new TransactionNode(m_dbp, &key3);
+    node3 = m_dbp->txn_index()->create_node(&key3);
     m_dbp->txn_index()->store(node3);
 
     // clean up
     m_dbp->txn_index()->remove(node1);
-    delete node1;
+    m_dbp->txn_index()->destroy_node(node1);
     m_dbp->txn_index()->remove(node2);
-    delete node2;
+    m_dbp->txn_index()->destroy_node(node2);
     m_dbp->txn_index()->remove(node3);
-    delete node3;
+    m_dbp->txn_index()->destroy_node(node3);
 
     REQUIRE(0 == ups_txn_commit(txn, 0));
   }
@@ -213,7 +213,7 @@ struct TxnFixture {
     ups_record_t rec = ups_make_record((void *)"world", 5);
 
     REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
-    node = new TransactionNode(m_dbp, &key);
+    node = m_dbp->txn_index()->create_node(&key);
     m_dbp->txn_index()->store(node);
     op1 = node->append((LocalTransaction *)txn, 
                 0, TransactionOperation::kInsertDuplicate, 55, &key, &rec);
@@ -541,6 +541,45 @@ struct TxnFixture {
           ups_db_erase(m_db, txn2, &key, 0));
     REQUIRE(0 == ups_txn_commit(txn2, 0));
   }
+
+  void arenaMetricsTest() {
+    ups_txn_t *txn;
+    ups_env_metrics_t metrics;
+    std::vector<uint8_t> buffer(64 * 1024);
+    ups_record_t rec = ups_make_record(&buffer[0], 0);
+
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.txn_arena_usage == 0);
+
+    // the operations are released in bulk when the Transaction is aborted
+    REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+    for (uint32_t i = 0; i < 1000; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      rec.size = (i % 100 == 0) ? (uint32_t)buffer.size() : 16;
+      REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+    }
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.txn_arena_usage > 1000 * (sizeof(TransactionOperation)
+                                + sizeof(TransactionNode)));
+    REQUIRE(metrics.txn_arena_size >= metrics.txn_arena_usage);
+    REQUIRE(0 == ups_txn_abort(txn, 0));
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.txn_arena_usage == 0);
+    uint64_t size = metrics.txn_arena_size;
+
+    // ... or when they are flushed; the memory is re-used
+    REQUIRE(0 == ups_txn_begin(&txn, m_env, 0, 0, 0));
+    for (uint32_t i = 0; i < 1000; i++) {
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      rec.size = 16;
+      REQUIRE(0 == ups_db_insert(m_db, txn, &key, &rec, 0));
+    }
+    REQUIRE(0 == ups_txn_commit(txn, 0));
+    REQUIRE(0 == ups_env_flush(m_env, 0));
+    REQUIRE(0 == ups_env_get_metrics(m_env, &metrics));
+    REQUIRE(metrics.txn_arena_usage == 0);
+    REQUIRE(metrics.txn_arena_size <= size);
+  }
 };
 
 TEST_CASE("Txn/checkIfLogCreatedTest", "")
@@ -681,6 +720,12 @@ TEST_CASE("Txn/txnInsertFindErase4Test", "")
   f.txnInsertFindErase4Test();
 }
 
+TEST_CASE("Txn/arenaMetricsTest", "")
+{
+  TxnFixture f;
+  f.arenaMetricsTest();
+}
+
 
 struct HighLevelTxnFixture {
   ups_db_t *m_db;
@@ -57,7 +57,7 @@ struct TxnCursorFixture {
 
   TransactionNode *create_transaction_node(ups_key_t *key) {
     LocalDatabase *ldb = (LocalDatabase *)m_db;
-    TransactionNode *node = new TransactionNode(ldb, key);
+    TransactionNode *node = ldb->txn_index()->create_node(key);
     ldb->txn_index()->store(node);
     return (node);
   }
@@ -17,6 +17,11 @@
 
 #include "3rdparty/catch/catch.hpp"
 
+#include <set>
+
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
 #include "1os/file.h"
 #include "1errorinducer/errorinducer.h"
 #include "2page/page.h"
@@ -62,6 +67,50 @@ struct my_rec_t {
   uint32_t val2[15];
 };
 
+// Performs lookups and full scans in a separate thread; used by
+// UpscaledbFixture::concurrentReadTest(). Catch's macros are not
+// thread-safe, therefore errors are only counted.
+static void
+concurrent_reader(ups_db_t *db, int num_keys, int seed,
+                boost::atomic<int> *errors)
+{
+  char buffer[512];
+  ups_key_t key = {0};
+  ups_record_t record = {0};
+
+  ::srand(seed);
+  for (int i = 0; i < 500; i++) {
+    int k = ::rand() % num_keys;
+    ::sprintf(buffer, "%0500d", k);
+    key = ups_make_key(buffer, (uint16_t)::strlen(buffer));
+    if (ups_db_find(db, 0, &key, &record, 0) != 0
+        || record.size != sizeof(k)
+        || *(int *)record.data != k)
+      (*errors)++;
+  }
+
+  for (int direction = 0; direction < 2; direction++) {
+    ups_cursor_t *cursor;
+    if (ups_cursor_create(&cursor, db, 0, 0) != 0) {
+      (*errors)++;
+      return;
+    }
+    int count = 0;
+    while (ups_cursor_move(cursor, &key, &record, direction == 0
+                                ? UPS_CURSOR_NEXT
+                                : UPS_CURSOR_PREVIOUS) == 0) {
+      int k = *(int *)record.data;
+      ::sprintf(buffer, "%0500d", k);
+      if (key.size != ::strlen(buffer) || ::memcmp(key.data, buffer, key.size))
+        (*errors)++;
+      count++;
+    }
+    if (count != num_keys)
+      (*errors)++;
+    ups_cursor_close(cursor);
+  }
+}
+
 struct UpscaledbFixture {
   ups_db_t *m_db;
   ups_env_t *m_env;
@@ -2348,6 +2397,245 @@ struct UpscaledbFixture {
     }
     REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
   }
+
+  void concurrentReadTest() {
+    const int kNumKeys = 5000;
+    const int kNumThreads = 4;
+    ups_env_t *env;
+    ups_db_t *db;
+    ups_parameter_t params[] = {
+        {UPS_PARAM_CACHE_SIZE, 256 * 1024},
+        {0, 0},
+    };
+    char buffer[512];
+
+    // the keys are extended keys; the small cache forces evictions
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644,
+                            &params[0]));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, 0));
+    REQUIRE(((Database *)db)->supports_concurrent_reads());
+
+    for (int i = 0; i < kNumKeys; i++) {
+      ::sprintf(buffer, "%0500d", i);
+      ups_key_t key = ups_make_key(buffer, (uint16_t)::strlen(buffer));
+      ups_record_t record = ups_make_record(&i, sizeof(i));
+      REQUIRE(0 == ups_db_insert(db, 0, &key, &record, 0));
+    }
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+
+    REQUIRE(0 == ups_env_open(&env, Utils::opath(".test"), 0, &params[0]));
+    REQUIRE(0 == ups_env_open_db(env, &db, 1, 0, 0));
+
+    boost::atomic<int> errors(0);
+    std::vector<boost::thread *> threads;
+    for (int i = 0; i < kNumThreads; i++)
+      threads.push_back(new boost::thread(concurrent_reader, db, kNumKeys,
+                              i, &errors));
+    for (int i = 0; i < kNumThreads; i++) {
+      threads[i]->join();
+      delete threads[i];
+    }
+    REQUIRE(errors.load() == 0);
+
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+
+    // transactional and duplicate databases still use the exclusive lock
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"),
+                            UPS_ENABLE_TRANSACTIONS, 0644, 0));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, 0));
+    REQUIRE(false == ((Database *)db)->supports_concurrent_reads());
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644, 0));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1,
+                            UPS_ENABLE_DUPLICATE_KEYS, 0));
+    REQUIRE(false == ((Database *)db)->supports_concurrent_reads());
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+  }
+
+  // Looks up a random batch of (existing and missing) keys with
+  // ups_db_find_many() and compares the results with ups_db_find()
+  void verifyFindMany(ups_db_t *db, ups_txn_t *txn, int max_key) {
+    const int kBatchSize = 300;
+    std::vector<uint32_t> values(kBatchSize);
+    std::vector<ups_key_t> keys(kBatchSize);
+    std::vector<ups_record_t> records(kBatchSize);
+    std::vector<ups_status_t> results(kBatchSize);
+    std::vector<uint64_t> buffers(kBatchSize);
+
+    for (int i = 0; i < kBatchSize; i++) {
+      values[i] = (uint32_t)(::rand() % max_key);
+      keys[i] = ups_make_key(&values[i], sizeof(values[i]));
+      // every other record is allocated by the caller
+      if (i % 2) {
+        records[i].data = &buffers[i];
+        records[i].flags = UPS_RECORD_USER_ALLOC;
+      }
+    }
+
+    REQUIRE(0 == ups_db_find_many(db, txn, kBatchSize, &keys[0],
+                            &records[0], &results[0], 0));
+
+    for (int i = 0; i < kBatchSize; i++) {
+      ups_key_t key = ups_make_key(&values[i], sizeof(values[i]));
+      ups_record_t record = {0};
+      ups_status_t st = ups_db_find(db, txn, &key, &record, 0);
+      REQUIRE(results[i] == st);
+      if (st == 0) {
+        REQUIRE(records[i].size == record.size);
+        REQUIRE(0 == ::memcmp(records[i].data, record.data, record.size));
+      }
+    }
+  }
+
+  void findManyTest() {
+    ups_env_t *env;
+    ups_db_t *db;
+    ups_parameter_t env_params[] = {
+        {UPS_PARAM_PAGE_SIZE, 1024},
+        {0, 0},
+    };
+    ups_parameter_t db_params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {0, 0},
+    };
+
+    // only even keys are inserted; the odd keys are not found
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644,
+                            &env_params[0]));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, &db_params[0]));
+    for (uint32_t i = 0; i < 20000; i += 2) {
+      uint64_t value = i * 3;
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&value, sizeof(value));
+      REQUIRE(0 == ups_db_insert(db, 0, &key, &record, 0));
+    }
+
+    ::srand(0);
+    for (int i = 0; i < 10; i++)
+      verifyFindMany(db, 0, 21000);
+
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    ups_status_t result;
+    REQUIRE(UPS_INV_PARAMETER == ups_db_find_many(0, 0, 1, &key, &record,
+                            &result, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_db_find_many(db, 0, 1, 0, &record,
+                            &result, 0));
+    REQUIRE(UPS_INV_PARAMETER == ups_db_find_many(db, 0, 1, &key, &record,
+                            &result, UPS_FIND_GEQ_MATCH));
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+
+    // pending transactions are looked up as well
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"),
+                            UPS_ENABLE_TRANSACTIONS, 0644, &env_params[0]));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, &db_params[0]));
+    ups_txn_t *txn;
+    REQUIRE(0 == ups_txn_begin(&txn, env, 0, 0, 0));
+    for (uint32_t i = 0; i < 2000; i += 2) {
+      uint64_t value = i * 3;
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&value, sizeof(value));
+      REQUIRE(0 == ups_db_insert(db, txn, &key, &record, 0));
+    }
+    verifyFindMany(db, txn, 2100);
+    REQUIRE(0 == ups_txn_commit(txn, 0));
+    verifyFindMany(db, 0, 2100);
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+  }
+
+  void insertManyTest() {
+    const int kBatchSize = 1000;
+    ups_env_t *env;
+    ups_db_t *db;
+    ups_parameter_t env_params[] = {
+        {UPS_PARAM_PAGE_SIZE, 1024},
+        {0, 0},
+    };
+    ups_parameter_t db_params[] = {
+        {UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32},
+        {0, 0},
+    };
+    std::vector<uint32_t> values(kBatchSize);
+    std::vector<ups_key_t> keys(kBatchSize);
+    std::vector<ups_record_t> records(kBatchSize);
+    std::vector<ups_status_t> results(kBatchSize);
+
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644,
+                            &env_params[0]));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, 0, &db_params[0]));
+
+    // a random batch; some keys are inserted twice
+    ::srand(0);
+    for (int i = 0; i < kBatchSize; i++) {
+      values[i] = (uint32_t)(::rand() % (kBatchSize * 4));
+      keys[i] = ups_make_key(&values[i], sizeof(values[i]));
+      records[i] = ups_make_record(&values[i], sizeof(values[i]));
+    }
+    REQUIRE(0 == ups_db_insert_many(db, 0, kBatchSize, &keys[0], &records[0],
+                            &results[0], 0));
+
+    std::set<uint32_t> inserted;
+    for (int i = 0; i < kBatchSize; i++) {
+      if (inserted.insert(values[i]).second)
+        REQUIRE(results[i] == 0);
+      else
+        REQUIRE(results[i] == UPS_DUPLICATE_KEY);
+    }
+
+    uint64_t count;
+    REQUIRE(0 == ups_db_count(db, 0, 0, &count));
+    REQUIRE(count == inserted.size());
+    REQUIRE(0 == ups_db_check_integrity(db, 0));
+
+    for (std::set<uint32_t>::iterator it = inserted.begin();
+            it != inserted.end(); it++) {
+      uint32_t value = *it;
+      ups_key_t key = ups_make_key(&value, sizeof(value));
+      ups_record_t record = {0};
+      REQUIRE(0 == ups_db_find(db, 0, &key, &record, 0));
+      REQUIRE(record.size == sizeof(value));
+      REQUIRE(*(uint32_t *)record.data == value);
+    }
+
+    // overwrite the whole batch
+    for (int i = 0; i < kBatchSize; i++)
+      values[i] = (uint32_t)i;
+    REQUIRE(0 == ups_db_insert_many(db, 0, kBatchSize, &keys[0], &records[0],
+                            &results[0], UPS_OVERWRITE));
+    for (int i = 0; i < kBatchSize; i++)
+      REQUIRE(results[i] == 0);
+    REQUIRE(0 == ups_db_check_integrity(db, 0));
+
+    // invalid key sizes are reported per key
+    uint64_t large = 0;
+    keys[0] = ups_make_key(&large, sizeof(large));
+    REQUIRE(0 == ups_db_insert_many(db, 0, 2, &keys[0], &records[0],
+                            &results[0], UPS_OVERWRITE));
+    REQUIRE(results[0] == UPS_INV_KEY_SIZE);
+    REQUIRE(results[1] == 0);
+
+    REQUIRE(UPS_INV_PARAMETER == ups_db_insert_many(db, 0, 1, &keys[0],
+                            &records[0], &results[0],
+                            UPS_OVERWRITE | UPS_DUPLICATE));
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+
+    // record number databases return the generated keys
+    REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644, 0));
+    REQUIRE(0 == ups_env_create_db(env, &db, 1, UPS_RECORD_NUMBER64, 0));
+    for (int i = 0; i < kBatchSize; i++) {
+      values[i] = (uint32_t)i;
+      keys[i] = ups_make_key(0, 0);
+      records[i] = ups_make_record(&values[i], sizeof(values[i]));
+    }
+    REQUIRE(0 == ups_db_insert_many(db, 0, kBatchSize, &keys[0], &records[0],
+                            &results[0], 0));
+    for (int i = 0; i < kBatchSize; i++) {
+      REQUIRE(results[i] == 0);
+      REQUIRE(keys[i].size == sizeof(uint64_t));
+      REQUIRE(*(uint64_t *)keys[i].data == (uint64_t)i + 1);
+    }
+    REQUIRE(0 == ups_env_close(env, UPS_AUTO_CLEANUP));
+  }
 };
 
 TEST_CASE("Upscaledb/versionTest", "")
@@ -2812,6 +3100,12 @@ TEST_CASE("Upscaledb/invalidRecordTypeTest", "")
   f.invalidRecordTypeTest();
 }
 
+TEST_CASE("Upscaledb/concurrentReadTest", "")
+{
+  UpscaledbFixture f;
+  f.concurrentReadTest();
+}
+
 TEST_CASE("Upscaledb/rafalsTest", "")
 {
   UpscaledbFixture f;
@@ -2820,4 +3114,16 @@ TEST_CASE("Upscaledb/rafalsTest", "")
     f.rafalsTest();
 }
 
+TEST_CASE("Upscaledb/findManyTest", "")
+{
+  UpscaledbFixture f;
+  f.findManyTest();
+}
+
+TEST_CASE("Upscaledb/insertManyTest", "")
+{
+  UpscaledbFixture f;
+  f.insertManyTest();
+}
+
 } // namespace upscaledb
@@ -1741,6 +1741,133 @@ struct QueryFixture
     compare_results(result, inserted_even);
     uqi_result_close(result);
   }
+
+  // Runs |query| single-threaded and with 4 threads; both results must
+  // be identical
+  void compare_parallel(std::string query) {
+    uqi_result_t *r1, *r2;
+    std::string parallel = query + " parallel 4";
+    REQUIRE(0 == uqi_select(m_env, query.c_str(), &r1));
+    REQUIRE(0 == uqi_select(m_env, parallel.c_str(), &r2));
+
+    REQUIRE(uqi_result_get_row_count(r1) == uqi_result_get_row_count(r2));
+    REQUIRE(uqi_result_get_key_type(r1) == uqi_result_get_key_type(r2));
+    REQUIRE(uqi_result_get_record_type(r1)
+                    == uqi_result_get_record_type(r2));
+
+    uint32_t size1, size2;
+    void *p1 = uqi_result_get_key_data(r1, &size1);
+    void *p2 = uqi_result_get_key_data(r2, &size2);
+    REQUIRE(size1 == size2);
+    REQUIRE(0 == ::memcmp(p1, p2, size1));
+    p1 = uqi_result_get_record_data(r1, &size1);
+    p2 = uqi_result_get_record_data(r2, &size2);
+    REQUIRE(size1 == size2);
+    REQUIRE(0 == ::memcmp(p1, p2, size1));
+
+    uqi_result_close(r1);
+    uqi_result_close(r2);
+  }
+
+  // Verifies that the leaf level is split into ranges
+  void check_partitions(size_t count) {
+    LocalDatabase *db = (LocalDatabase *)m_db;
+    Context context(db->lenv(), 0, db);
+    std::vector<uint64_t> ranges;
+    db->btree_index()->partition_leaves(&context, count, ranges);
+    REQUIRE(ranges.size() == count);
+    std::sort(ranges.begin(), ranges.end());
+    REQUIRE(std::unique(ranges.begin(), ranges.end()) == ranges.end());
+  }
+
+  void parallelTest() {
+    for (uint32_t i = 0; i < 100000; i++) {
+      uint64_t r = (i * 7919) % 100003;
+      ups_key_t key = ups_make_key(&i, sizeof(i));
+      ups_record_t record = ups_make_record(&r, sizeof(r));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    check_partitions(4);
+
+    uqi_plugin_t even_plugin = {0};
+    even_plugin.name = "even";
+    even_plugin.type = UQI_PLUGIN_PREDICATE;
+    even_plugin.pred = even_predicate;
+    REQUIRE(0 == uqi_register_plugin(&even_plugin));
+
+    compare_parallel("sum($key) from database 1");
+    compare_parallel("sum($record) from database 1 where even($key)");
+    compare_parallel("average($record) from database 1");
+    compare_parallel("average($key) from database 1 where even($key)");
+    compare_parallel("count($key) from database 1");
+    compare_parallel("count($key) from database 1 where even($key)");
+    compare_parallel("min($record) from database 1");
+    compare_parallel("max($record) from database 1 where even($key)");
+    compare_parallel("top($record) from database 1 limit 10");
+    compare_parallel("bottom($record) from database 1 where even($key) "
+                    "limit 20");
+    compare_parallel("top($key) from database 1 limit 5");
+
+    // a custom plugin does not merge partial results; the query is
+    // silently executed single-threaded
+    uqi_plugin_t plugin = {0};
+    plugin.name = "agg";
+    plugin.type = UQI_PLUGIN_AGGREGATE;
+    plugin.init = agg_init;
+    plugin.agg_single = agg_single;
+    plugin.agg_many = agg_many;
+    plugin.results = agg_results;
+    REQUIRE(0 == uqi_register_plugin(&plugin));
+    compare_parallel("agg($key) from database 1");
+
+    uqi_result_t *result;
+    REQUIRE(UPS_PARSER_ERROR == uqi_select(m_env,
+                "sum($key) from database 1 parallel -1", &result));
+
+    // the number of threads can also be set for the whole Environment
+    teardown();
+    ups_parameter_t params[] = {
+        {UPS_PARAM_QUERY_THREADS, 3},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_open(&m_env, "test.db", 0, &params[0]));
+    REQUIRE(0 == ups_env_open_db(m_env, &m_db, 1, 0, 0));
+
+    ups_parameter_t query[] = {
+        {UPS_PARAM_QUERY_THREADS, 0},
+        {0, 0}
+    };
+    REQUIRE(0 == ups_env_get_parameters(m_env, &query[0]));
+    REQUIRE(3u == query[0].value);
+
+    REQUIRE(0 == uqi_select(m_env, "sum($key) from database 1", &result));
+    uint32_t size;
+    uint64_t expected = 100000ull * 99999ull / 2;
+    REQUIRE(*(uint64_t *)uqi_result_get_record_data(result, &size)
+                == expected);
+    uqi_result_close(result);
+  }
+
+  void parallelBinaryTest() {
+    char buffer[16] = {0};
+    for (uint32_t i = 0; i < 20000; i++) {
+      ::sprintf(buffer, "%08u", i);
+      uint32_t r = (i * 7919) % 20011;
+      ups_key_t key = ups_make_key(buffer, sizeof(buffer));
+      ups_record_t record = ups_make_record(&r, sizeof(r));
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    check_partitions(3);
+
+    compare_parallel("count($key) from database 1");
+    compare_parallel("sum($record) from database 1");
+    compare_parallel("min($record) from database 1");
+    compare_parallel("max($record) from database 1");
+    compare_parallel("top($record) from database 1 limit 10");
+    compare_parallel("bottom($record) from database 1 limit 10");
+  }
 };
 
 // fixed length keys, fixed length records
@@ -1863,4 +1990,16 @@ TEST_CASE("Uqi/topBottomBinaryTest", "")
   f.topBottomBinaryTest();
 }
 
+TEST_CASE("Uqi/parallelTest", "")
+{
+  QueryFixture f(0, UPS_TYPE_UINT32, UPS_TYPE_UINT64);
+  f.parallelTest();
+}
+
+TEST_CASE("Uqi/parallelBinaryTest", "")
+{
+  QueryFixture f(0, UPS_TYPE_BINARY, UPS_TYPE_UINT32);
+  f.parallelBinaryTest();
+}
+
 } // namespace upscaledb
@@ -630,4 +630,216 @@ TEST_CASE("Zint32/Zint32/invalidPagesizeTest", "")
   ups_env_close(env, 0);
 }
 
+struct Zint64Fixture {
+  ups_db_t *m_db;
+  ups_env_t *m_env;
+
+  typedef std::vector<uint64_t> IntVector;
+
+  Zint64Fixture(uint64_t compressor, uint32_t flags = 0)
+    : m_db(0), m_env(0) {
+    ups_parameter_t p[] = {
+      { UPS_PARAM_RECORD_SIZE, 8 },
+      { UPS_PARAM_KEY_COMPRESSION, compressor },
+      { UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT64 },
+      { 0, 0 }
+    };
+
+    // record number databases already have the correct key type
+    if (flags & UPS_RECORD_NUMBER64) {
+      p[2].name = 0;
+      p[2].value = 0;
+    }
+
+    REQUIRE(0 == ups_env_create(&m_env, Utils::opath(".test"), 0, 0644, 0));
+    REQUIRE(0 == ups_env_create_db(m_env, &m_db, 1, flags, &p[0]));
+  }
+
+  ~Zint64Fixture() {
+    if (m_env)
+      REQUIRE(0 == ups_env_close(m_env, UPS_AUTO_CLEANUP));
+  }
+
+  void insertFindEraseFind(const IntVector &ivec) {
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+
+    for (IntVector::const_iterator it = ivec.begin(); it != ivec.end(); it++) {
+      uint64_t k = *it;
+      key.data = (void *)&k;
+      key.size = sizeof(k);
+      record.data = (void *)&k;
+      record.size = sizeof(k);
+
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+    }
+
+    // the keys are returned in sorted order
+    IntVector sorted(ivec);
+    std::sort(sorted.begin(), sorted.end());
+    ups_cursor_t *cursor;
+    REQUIRE(0 == ups_cursor_create(&cursor, m_db, 0, 0));
+    for (IntVector::const_iterator it = sorted.begin();
+                    it != sorted.end(); it++) {
+      REQUIRE(0 == ups_cursor_move(cursor, &key, &record, UPS_CURSOR_NEXT));
+      REQUIRE(key.size == sizeof(uint64_t));
+      REQUIRE(*(uint64_t *)key.data == *it);
+    }
+    REQUIRE(UPS_KEY_NOT_FOUND == ups_cursor_move(cursor, &key, &record,
+                            UPS_CURSOR_NEXT));
+    REQUIRE(0 == ups_cursor_close(cursor));
+
+    for (IntVector::const_iterator it = ivec.begin();
+                    it != ivec.end(); it++) {
+      uint64_t k = *it;
+      key.data = (void *)&k;
+      key.size = sizeof(k);
+
+      REQUIRE(0 == ups_db_find(m_db, 0, &key, &record, 0));
+      REQUIRE(record.size == sizeof(uint64_t));
+      REQUIRE(*(uint64_t *)record.data == k);
+    }
+
+    for (IntVector::const_iterator it = ivec.begin();
+                    it != ivec.end(); it++) {
+      uint64_t k = *it;
+      key.data = (void *)&k;
+      key.size = sizeof(k);
+
+      REQUIRE(0 == ups_db_erase(m_db, 0, &key, 0));
+    }
+
+    for (IntVector::const_iterator it = ivec.begin();
+                    it != ivec.end(); it++) {
+      uint64_t k = *it;
+      key.data = (void *)&k;
+      key.size = sizeof(k);
+
+      REQUIRE(UPS_KEY_NOT_FOUND == ups_db_find(m_db, 0, &key, &record, 0));
+    }
+  }
+
+  void recordNumberTest() {
+    ups_key_t key = {0};
+    ups_record_t record = {0};
+    uint64_t max = 50000;
+
+    for (uint64_t i = 0; i < max; i++) {
+      record.data = (void *)&i;
+      record.size = sizeof(i);
+      key.data = 0;
+      key.size = 0;
+      REQUIRE(0 == ups_db_insert(m_db, 0, &key, &record, 0));
+      REQUIRE(*(uint64_t *)key.data == i + 1);
+    }
+
+    uqi_result_t *result;
+    uint32_t size;
+
+    REQUIRE(0 == uqi_select(m_env, "SUM($key) from database 1", &result));
+    REQUIRE(*(uint64_t *)uqi_result_get_record_data(result, &size)
+                    == max * (max + 1) / 2);
+    uqi_result_close(result);
+  }
+};
+
+// Returns keys which do not fit into 32 bits, with random gaps
+static Zint64Fixture::IntVector
+zint64_keys(size_t count)
+{
+  Zint64Fixture::IntVector ivec;
+  uint64_t k = 1ull << 40;
+  std::srand(0); // make this reproducible
+  for (size_t i = 0; i < count; i++) {
+    k += 1 + (std::rand() % 1000);
+    // now and then a large gap, which requires a wider encoding
+    if (i % 997 == 0)
+      k += 1ull << 33;
+    ivec.push_back(k);
+  }
+  return (ivec);
+}
+
+TEST_CASE("Zint64/Varbyte/randomDataTest", "")
+{
+  Zint64Fixture::IntVector ivec = zint64_keys(30000);
+  std::random_shuffle(ivec.begin(), ivec.end());
+
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_VARBYTE);
+  f.insertFindEraseFind(ivec);
+}
+
+TEST_CASE("Zint64/Varbyte/ascendingDataTest", "")
+{
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_VARBYTE);
+  f.insertFindEraseFind(zint64_keys(30000));
+}
+
+TEST_CASE("Zint64/Varbyte/descendingDataTest", "")
+{
+  Zint64Fixture::IntVector ivec = zint64_keys(30000);
+  std::reverse(ivec.begin(), ivec.end());
+
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_VARBYTE);
+  f.insertFindEraseFind(ivec);
+}
+
+TEST_CASE("Zint64/Varbyte/recordNumberTest", "")
+{
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_VARBYTE, UPS_RECORD_NUMBER64);
+  f.recordNumberTest();
+}
+
+TEST_CASE("Zint64/FOR/randomDataTest", "")
+{
+  Zint64Fixture::IntVector ivec = zint64_keys(30000);
+  std::random_shuffle(ivec.begin(), ivec.end());
+
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_FOR);
+  f.insertFindEraseFind(ivec);
+}
+
+TEST_CASE("Zint64/FOR/ascendingDataTest", "")
+{
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_FOR);
+  f.insertFindEraseFind(zint64_keys(30000));
+}
+
+TEST_CASE("Zint64/FOR/descendingDataTest", "")
+{
+  Zint64Fixture::IntVector ivec = zint64_keys(30000);
+  std::reverse(ivec.begin(), ivec.end());
+
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_FOR);
+  f.insertFindEraseFind(ivec);
+}
+
+TEST_CASE("Zint64/FOR/recordNumberTest", "")
+{
+  Zint64Fixture f(UPS_COMPRESSOR_UINT64_FOR, UPS_RECORD_NUMBER64);
+  f.recordNumberTest();
+}
+
+TEST_CASE("Zint64/Zint64/invalidKeyTypeTest", "")
+{
+  ups_parameter_t p1[] = {
+    { UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT32 },
+    { UPS_PARAM_KEY_COMPRESSION, UPS_COMPRESSOR_UINT64_FOR },
+    { 0, 0 }
+  };
+  ups_parameter_t p2[] = {
+    { UPS_PARAM_KEY_TYPE, UPS_TYPE_UINT64 },
+    { UPS_PARAM_KEY_COMPRESSION, UPS_COMPRESSOR_UINT32_VARBYTE },
+    { 0, 0 }
+  };
+
+  ups_env_t *env;
+  ups_db_t *db;
+
+  REQUIRE(0 == ups_env_create(&env, Utils::opath(".test"), 0, 0644, 0));
+  REQUIRE(UPS_INV_PARAMETER == ups_env_create_db(env, &db, 1, 0, &p1[0]));
+  REQUIRE(UPS_INV_PARAMETER == ups_env_create_db(env, &db, 1, 0, &p2[0]));
+  ups_env_close(env, 0);
+}
+
 } // namespace upscaledb